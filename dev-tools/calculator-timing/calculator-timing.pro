@@ -0,0 +1,17 @@
+# Timing harness for the lumina-calculator equation engine
+TEMPLATE	= app
+LANGUAGE	= C++
+QT += core
+QT -= gui
+CONFIG	+= qt warn_on release console
+
+HEADERS	+= ../../src-qt5/desktop-utils/lumina-calculator/CalcEngine.h
+
+SOURCES	+= main.cpp \
+	../../src-qt5/desktop-utils/lumina-calculator/CalcEngine.cpp
+
+INSTALLS =
+
+TARGET  = calculator-timing
+
+INCLUDEPATH+= ../../src-qt5/desktop-utils/lumina-calculator
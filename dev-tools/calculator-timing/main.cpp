@@ -0,0 +1,45 @@
+// Simple timing harness for the lumina-calculator equation engine
+//  Usage: calculator-timing [evaluations]
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+#include <QDebug>
+
+#include "CalcEngine.h"
+
+int main(int argc, char ** argv){
+  QCoreApplication a(argc, argv);
+  int count = (argc>1) ? QString(argv[1]).toInt() : 1000000;
+  if(count<1){ count = 1000000; }
+
+  //Build a long, deeply-nested equation using all the different operations
+  QString eq = "t";
+  for(int i=1; i<=20; i++){
+    eq = QString("(%1+%2*sin(t/%3)-%4^0.5)/(1+%5%)").arg(eq, QString::number(i), QString::number(i+1), QString::number(i), QString::number(i));
+  }
+  qDebug() << "Equation Length:" << eq.length() << " Evaluations:" << count;
+
+  CalcEquation calc;
+  QElapsedTimer timer;
+  timer.start();
+  if(!calc.compile(eq, "t")){ qDebug() << "Could not compile:" << calc.errorString(); return 1; }
+  qDebug() << " - Compile:" << timer.nsecsElapsed()/1000 << "us";
+
+  timer.restart();
+  double sum = 0;
+  for(int i=0; i<count; i++){ sum += calc.evaluate(QList<double>(), i*0.001); }
+  qDebug() << " - Evaluate" << count << "times:" << timer.elapsed() << "ms" << "(checksum:" << sum << ")";
+
+  timer.restart();
+  QVector<double> vals = calc.evaluateRange(0, 0.001, count);
+  qint64 ms = timer.elapsed();
+  double rsum = 0;
+  for(int i=0; i<vals.length(); i++){ rsum += vals[i]; }
+  qDebug() << " - Range evaluation of" << count << "values:" << ms << "ms" << "(checksum:" << rsum << ")";
+
+  //Both ways of evaluating need to give the same results
+  bool ok = (vals.length()==count && qAbs(sum-rsum) <= 1e-9*qMax(qAbs(sum), 1.0));
+  qDebug() << "Range/single evaluation match:" << (ok ? "OK" : "FAILED");
+  return (ok ? 0 : 1);
+}
@@ -0,0 +1,15 @@
+# Timing harness for the libLumina LFileInfo class (construction, copies, lazy lookups)
+TEMPLATE	= app
+LANGUAGE	= C++
+QT += core gui widgets
+CONFIG	+= qt warn_on release console
+
+LIBS	+= -L../../src-qt5/core/libLumina -L/usr/local/lib -lLuminaUtils
+
+SOURCES	+= main.cpp
+
+INSTALLS =
+
+TARGET  = fileinfo-timing
+
+INCLUDEPATH+= ../../src-qt5/core/libLumina /usr/local/include
@@ -0,0 +1,46 @@
+// Simple timing harness for the construction/copying of LFileInfo lists (no GUI)
+//  Usage: fileinfo-timing [items] [directory]
+//  (defaults: 100000 items, using the files in /usr/bin over and over)
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QDebug>
+
+#include <LuminaXDG.h>
+
+int main(int argc, char ** argv){
+  QCoreApplication a(argc, argv);
+  int count = (argc>1) ? QString(argv[1]).toInt() : 100000;
+  if(count<1){ count = 100000; }
+  QString dir = (argc>2) ? QString(argv[2]) : QString("/usr/bin");
+
+  QFileInfoList files = QDir(dir).entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot, QDir::NoSort);
+  if(files.isEmpty()){ qDebug() << "No files in:" << dir; return 1; }
+  qDebug() << "LFileInfo Items:" << count << "(using" << files.length() << "files from" << dir << ")";
+  QElapsedTimer timer;
+  timer.start();
+  LFileInfoList list;
+  list.reserve(count);
+  for(int i=0; i<count; i++){ list << LFileInfo(files[i%files.length()]); }
+  qDebug() << " - Construct:" << timer.elapsed() << "ms";
+
+  timer.restart();
+  int num = 0;
+  for(int c=0; c<10; c++){
+    LFileInfoList copy;
+    copy.reserve(list.length());
+    for(int i=0; i<list.length(); i++){ copy << list[i]; } //element copies (same as a detached list copy)
+    num += copy.length();
+  }
+  qDebug() << " - Copy (x10):" << timer.elapsed() << "ms" << "(" << num << "copies)";
+
+  timer.restart();
+  int mimes = 0;
+  for(int i=0; i<list.length(); i++){ if(!list[i].mimetype().isEmpty()){ mimes++; } }
+  qDebug() << " - Resolve mimetypes:" << timer.elapsed() << "ms" << "(" << mimes << "with a mimetype)";
+
+  timer.restart();
+  for(int i=0; i<list.length(); i++){ list[i].iconfile(); }
+  qDebug() << " - Resolve icons (already loaded):" << timer.elapsed() << "ms";
+  return 0;
+}
@@ -0,0 +1,45 @@
+// Simple timing harness for the mime defaults table (lumina-config default applications page)
+//  Usage: mimedefaults-timing [runs]
+//  (uses the system mime database and the current user's default applications)
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QHash>
+#include <QDebug>
+
+#include <LuminaXDG.h>
+
+int main(int argc, char ** argv){
+  QCoreApplication a(argc, argv);
+  int runs = (argc>1) ? QString(argv[1]).toInt() : 10;
+  if(runs<1){ runs = 10; }
+  qDebug() << "Mime Defaults Runs:" << runs << "(mime dirs:" << LXDG::systemMimeDirs() << ")";
+
+  QElapsedTimer timer;
+  QStringList mimes;
+  QHash<QString, QStringList> exts;
+  timer.start();
+  for(int r=0; r<runs; r++){ exts = LXDG::groupMimeFileGlobs(&mimes); }
+  qDebug() << " - Group globs2 entries:" << timer.elapsed()/runs << "ms" << "(" << mimes.length() << "types )";
+
+  timer.restart();
+  QHash<QString, QString> defaults;
+  for(int r=0; r<runs; r++){ defaults = LXDG::findDefaultAppsForMimes(mimes); }
+  qDebug() << " - Defaults (batched):" << timer.elapsed()/runs << "ms" << "(" << defaults.count() << "with a default )";
+
+  timer.restart();
+  QHash<QString, QString> comments;
+  for(int r=0; r<runs; r++){ comments = LXDG::findMimeComments(mimes); }
+  qDebug() << " - Comments (batched):" << timer.elapsed()/runs << "ms" << "(" << comments.count() << "with a comment )";
+
+  timer.restart();
+  int rows = 0;
+  for(int r=0; r<runs; r++){ rows = LXDG::listFileMimeDefaults().length(); }
+  qDebug() << " - Full table:" << timer.elapsed()/runs << "ms" << "(" << rows << "rows )";
+
+  //Per-type lookups (one set of file reads per type) for comparison
+  timer.restart();
+  for(int i=0; i<mimes.length(); i++){ LXDG::findDefaultAppForMime(mimes[i]); LXDG::findMimeComment(mimes[i]); }
+  qDebug() << " - Per-type lookups (single run):" << timer.elapsed() << "ms";
+  return 0;
+}
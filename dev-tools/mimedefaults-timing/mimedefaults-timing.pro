@@ -0,0 +1,15 @@
+# Timing harness for the lumina-config mime defaults table (libLumina mime lookups)
+TEMPLATE	= app
+LANGUAGE	= C++
+QT += core gui widgets
+CONFIG	+= qt warn_on release console
+
+LIBS	+= -L../../src-qt5/core/libLumina -L/usr/local/lib -lLuminaUtils
+
+SOURCES	+= main.cpp
+
+INSTALLS =
+
+TARGET  = mimedefaults-timing
+
+INCLUDEPATH+= ../../src-qt5/core/libLumina /usr/local/include
@@ -0,0 +1,101 @@
+// Load test for the lumina-desktop notification server
+//  Usage: notification-timing [messages]
+//  Starts a private dbus-daemon, floods the server from a second connection and prints the ingestion rate and server statistics
+#include <QApplication>
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusArgument>
+#include <QDBusPendingCall>
+#include <QDebug>
+
+#include "NotificationServer.h"
+
+int main(int argc, char ** argv){
+  QApplication a(argc, argv); //the server shows popups
+  int count = (argc>1) ? QString(argv[1]).toInt() : 10000;
+  if(count<1){ count = 10000; }
+  //Start a private session bus (nothing gets sent to the real session)
+  QProcess daemon;
+  daemon.start("dbus-daemon", QStringList() << "--session" << "--nofork" << "--print-address");
+  if(!daemon.waitForStarted(5000) || !daemon.waitForReadyRead(5000)){
+    qDebug() << "Could not start a private dbus-daemon";
+    return 1;
+  }
+  QString address = QString::fromLocal8Bit(daemon.readLine()).trimmed();
+  int ret = 0;
+  { //scope for the connections/server
+  QDBusConnection serverBus = QDBusConnection::connectToBus(address, "lumina-notify-bench-server");
+  QDBusConnection clientBus = QDBusConnection::connectToBus(address, "lumina-notify-bench-client");
+  NotificationServer server;
+  if(!clientBus.isConnected() || !server.start(serverBus)){
+    qDebug() << "Could not setup the notification server on the private bus:" << address;
+    ret = 1;
+  }else{
+    //Icon image for some of the messages (raw image-data hint)
+    QImage img(48, 48, QImage::Format_RGBA8888);
+      img.fill(Qt::darkCyan);
+    QDBusArgument imgarg;
+      imgarg.beginStructure();
+      imgarg << img.width() << img.height() << img.bytesPerLine() << true << 8 << 4 << QByteArray((const char*) img.constBits(), img.byteCount());
+      imgarg.endStructure();
+    QList<QDBusPendingCall> calls;
+    int finished = 0, errors = 0;
+    const int window = 1000; //max calls waiting for a reply
+    QElapsedTimer timer;
+    timer.start();
+    for(int i=0; i<count; i++){
+      while(i-finished >= window){
+        if(calls[finished].isFinished()){ if(calls[finished].isError()){ errors++; } finished++; }
+        else{ QCoreApplication::processEvents(QEventLoop::AllEvents, 50); }
+      }
+      QVariantMap hints;
+      uint replaces = 0;
+      QString summary, body;
+      switch(i%4){
+	case 0: //unique message
+	  summary = QString("Message %1").arg(QString::number(i));
+	  body = "Unique message body";
+	  break;
+	case 1: //identical messages (build tool/chat client spam)
+	  summary = "Build Progress";
+	  body = "Compiling...";
+	  break;
+	case 2: //progress updates which replace the first message
+	  replaces = 1;
+	  summary = "Download";
+	  body = QString("%1% done").arg(QString::number(i%100));
+	  break;
+	default: //message with an icon image
+	  summary = QString("Contact %1").arg(QString::number(i%20));
+	  body = "New message";
+	  hints.insert("image-data", QVariant::fromValue(imgarg));
+      }
+      QDBusMessage msg = QDBusMessage::createMethodCall("org.freedesktop.Notifications", "/org/freedesktop/Notifications", "org.freedesktop.Notifications", "Notify");
+      msg << QString("lumina-benchmark") << replaces << QString("dialog-information") << summary << body << QStringList() << hints << (int) 3000;
+      calls << clientBus.asyncCall(msg);
+    }
+    //Wait for the rest of the replies
+    while(finished<calls.length()){
+      if(calls[finished].isFinished()){ if(calls[finished].isError()){ errors++; } finished++; }
+      else{ QCoreApplication::processEvents(QEventLoop::AllEvents, 50); }
+    }
+    qint64 elapsed = timer.elapsed();
+    //Let the batched UI updates/popups/icons finish too
+    timer.restart();
+    while(timer.elapsed() < 1000){ QCoreApplication::processEvents(QEventLoop::AllEvents, 50); }
+    qDebug() << "Notification Load Test:" << count << "messages," << errors << "errors";
+    qDebug() << " - Ingestion:" << elapsed << "ms" << "(" << qRound(count*1000.0/qMax(elapsed, (qint64) 1)) << "messages per second )";
+    QStringList info = server.stats();
+    for(int i=0; i<info.length(); i++){ qDebug() << " -" << info[i].toLocal8Bit().constData(); }
+    if(errors>0){ ret = 1; }
+  }
+  } //end of the connection/server scope
+  QDBusConnection::disconnectFromBus("lumina-notify-bench-server");
+  QDBusConnection::disconnectFromBus("lumina-notify-bench-client");
+  daemon.kill();
+  daemon.waitForFinished(1000);
+  return ret;
+}
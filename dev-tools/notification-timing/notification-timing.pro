@@ -0,0 +1,21 @@
+# Load test for the lumina-desktop notification server
+#  (starts a private dbus-daemon - nothing gets sent to the real session bus)
+TEMPLATE	= app
+LANGUAGE	= C++
+QT += core gui widgets dbus concurrent
+CONFIG	+= qt warn_on release
+
+LIBS	+= -L../../src-qt5/core/libLumina -L/usr/local/lib -lLuminaUtils
+
+HEADERS	+= ../../src-qt5/core/lumina-desktop/NotificationServer.h \
+	../../src-qt5/core/lumina-desktop/NotificationPopup.h
+
+SOURCES	+= main.cpp \
+	../../src-qt5/core/lumina-desktop/NotificationServer.cpp \
+	../../src-qt5/core/lumina-desktop/NotificationPopup.cpp
+
+INSTALLS =
+
+TARGET  = notification-timing
+
+INCLUDEPATH+= ../../src-qt5/core/libLumina ../../src-qt5/core/lumina-desktop /usr/local/include
@@ -0,0 +1,67 @@
+// Simple timing harness for the desktop plugin settings (old per-value sync vs LPluginSettings)
+//  Usage: plugin-settings-timing [items]
+//  (uses temporary settings files - the real desktop settings are never touched)
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QSettings>
+#include <QStringList>
+#include <QRect>
+#include <QDebug>
+
+#include "LPluginSettings.h"
+
+//Same key layout as LDPlugin: "<plugin ID with / replaced>/<setting>"
+static QString prefixFor(int num){
+  return QString("applauncher::/home/user/Desktop/item%1.desktop---0").arg(num).replace("/","_")+"/";
+}
+
+int main(int argc, char ** argv){
+  QCoreApplication a(argc, argv);
+  int count = (argc>1) ? QString(argv[1]).toInt() : 500;
+  if(count<1){ count = 500; }
+  QTemporaryDir dir;
+  if(!dir.isValid()){ qDebug() << "Could not create a temporary directory"; return 1; }
+  qDebug() << "Desktop items:" << count;
+
+  //Old behavior: sync() after every value, allKeys() scan for every removal
+  QSettings oldset(dir.path()+"/old.conf", QSettings::IniFormat);
+  QElapsedTimer timer;
+  timer.start();
+  for(int i=0; i<count; i++){
+    QString pre = prefixFor(i);
+    oldset.setValue(pre+"geometry", QRect(i%20, i/20, 1, 1)); oldset.sync();
+    oldset.setValue(pre+"IconSize", 64); oldset.sync();
+  }
+  qDebug() << " - Old: save" << count << "items:" << timer.elapsed() << "ms";
+  timer.restart();
+  for(int i=0; i<count; i++){
+    QString pre = prefixFor(i);
+    QStringList keys = oldset.allKeys().filter(pre);
+    for(int j=0; j<keys.length(); j++){ oldset.remove(keys[j]); }
+    oldset.sync();
+  }
+  qDebug() << " - Old: remove" << count << "items:" << timer.elapsed() << "ms";
+
+  //New behavior: index + write-behind, flushed once
+  QSettings newset(dir.path()+"/new.conf", QSettings::IniFormat);
+  LPluginSettings store(&newset);
+  timer.restart();
+  for(int i=0; i<count; i++){
+    QString pre = prefixFor(i);
+    store.setValue(pre+"geometry", QRect(i%20, i/20, 1, 1));
+    store.setValue(pre+"IconSize", 64);
+  }
+  store.flush();
+  qDebug() << " - LPluginSettings: save" << count << "items:" << timer.elapsed() << "ms";
+  bool ok = (newset.allKeys().length()==2*count);
+  timer.restart();
+  for(int i=0; i<count; i++){ store.removeGroup(prefixFor(i)); }
+  store.flush();
+  qDebug() << " - LPluginSettings: remove" << count << "items:" << timer.elapsed() << "ms";
+
+  //Both ways need to end up with the same (empty) file
+  ok = ok && oldset.allKeys().isEmpty() && newset.allKeys().isEmpty();
+  qDebug() << "Saved/removed keys match:" << (ok ? "OK" : "FAILED");
+  return (ok ? 0 : 1);
+}
@@ -0,0 +1,17 @@
+# Timing harness for the lumina-desktop plugin settings store
+TEMPLATE	= app
+LANGUAGE	= C++
+QT += core
+QT -= gui
+CONFIG	+= qt warn_on release console
+
+HEADERS	+= ../../src-qt5/core/lumina-desktop/LPluginSettings.h
+
+SOURCES	+= main.cpp \
+	../../src-qt5/core/lumina-desktop/LPluginSettings.cpp
+
+INSTALLS =
+
+TARGET  = plugin-settings-timing
+
+INCLUDEPATH+= ../../src-qt5/core/lumina-desktop
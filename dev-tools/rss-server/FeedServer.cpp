@@ -0,0 +1,120 @@
+#include "FeedServer.h"
+
+#include <QLocale>
+#include <QStringList>
+#include <QDebug>
+
+#define CHUNK_DELAY 20 //milliseconds between body chunks
+
+FeedServer::FeedServer(int nitems, int nchunk, QObject *parent) : QTcpServer(parent){
+  items = nitems;
+  chunk = nchunk;
+  revision = 0;
+  fullReplies = notModified = 0;
+  modified = QDateTime::currentDateTimeUtc();
+  chunkTimer = new QTimer(this);
+    chunkTimer->setInterval(CHUNK_DELAY);
+    connect(chunkTimer, SIGNAL(timeout()), this, SLOT(sendChunk()) );
+  connect(this, SIGNAL(newConnection()), this, SLOT(newClient()) );
+}
+
+void FeedServer::bump(){
+  revision++;
+  modified = QDateTime::currentDateTimeUtc();
+}
+
+QByteArray FeedServer::etag(){
+  return "\"lumina-test-"+QByteArray::number(revision)+"\"";
+}
+
+QByteArray FeedServer::feed(){
+  QByteArray out;
+  out.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<rss version=\"2.0\">\n<channel>\n");
+  out.append("<title>Lumina Test Feed</title>\n<link>http://localhost/</link>\n<description>Local RSS test feed</description>\n");
+  out.append("<ttl>1</ttl>\n");
+  out.append("<lastBuildDate>"+QLocale::c().toString(modified, "ddd, dd MMM yyyy hh:mm:ss").toLatin1()+" GMT</lastBuildDate>\n");
+  for(int i=items+revision; i>0; i--){
+    out.append("<item>\n<title>Test Item "+QByteArray::number(i)+"</title>\n");
+    out.append("<link>http://localhost/item"+QByteArray::number(i)+"</link>\n");
+    out.append("<description>Item "+QByteArray::number(i)+" of revision "+QByteArray::number(revision)+"</description>\n");
+    out.append("<guid>lumina-test-"+QByteArray::number(i)+"</guid>\n</item>\n");
+  }
+  out.append("</channel>\n</rss>\n");
+  return out;
+}
+
+void FeedServer::reply(QTcpSocket *sock, QByteArray request){
+  QList<QByteArray> lines = request.split('\n');
+  QByteArray path = lines.first().split(' ').value(1);
+  QByteArray lastmod = QLocale::c().toString(modified, "ddd, dd MMM yyyy hh:mm:ss").toLatin1()+" GMT";
+  bool current = false;
+  for(int i=1; i<lines.length(); i++){
+    QByteArray line = lines[i].trimmed();
+    QByteArray name = line.left(line.indexOf(':')).trimmed().toLower();
+    QByteArray val = line.mid(line.indexOf(':')+1).trimmed();
+    if(name=="if-none-match"){ current = (val==etag()); break; } //takes precedence over the date
+    else if(name=="if-modified-since"){ current = (val==lastmod); }
+  }
+  QByteArray head;
+  QByteArray body;
+  if(path=="/update"){
+    bump();
+    head = "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\n";
+    body = "Feed revision: "+QByteArray::number(revision)+"\n";
+  }else if(current){
+    notModified++;
+    head = "HTTP/1.0 304 Not Modified\r\n";
+  }else{
+    fullReplies++;
+    body = feed();
+    head = "HTTP/1.0 200 OK\r\nContent-Type: application/rss+xml\r\n";
+  }
+  head.append("ETag: "+etag()+"\r\nLast-Modified: "+lastmod+"\r\n");
+  head.append("Content-Length: "+QByteArray::number(body.size())+"\r\nConnection: close\r\n\r\n");
+  qDebug() << "Request:" << path << "->" << head.left(head.indexOf('\r')) << "(" << body.size() << "bytes )";
+  sock->write(head);
+  outgoing.insert(sock, body);
+  if(!chunkTimer->isActive()){ chunkTimer->start(); }
+}
+
+// === PRIVATE SLOTS ===
+void FeedServer::newClient(){
+  while(hasPendingConnections()){
+    QTcpSocket *sock = nextPendingConnection();
+    connect(sock, SIGNAL(readyRead()), this, SLOT(readClient()) );
+    connect(sock, SIGNAL(disconnected()), this, SLOT(clientGone()) );
+    requests.insert(sock, QByteArray());
+  }
+}
+
+void FeedServer::readClient(){
+  QTcpSocket *sock = qobject_cast<QTcpSocket*>(sender());
+  if(sock==0 || !requests.contains(sock)){ return; }
+  requests[sock].append(sock->readAll());
+  if(!requests[sock].contains("\r\n\r\n")){ return; } //headers not complete yet
+  QByteArray req = requests.take(sock);
+  req.replace("\r\n", "\n");
+  reply(sock, req);
+}
+
+void FeedServer::sendChunk(){
+  QList<QTcpSocket*> socks = outgoing.keys();
+  for(int i=0; i<socks.length(); i++){
+    QByteArray &data = outgoing[socks[i]];
+    socks[i]->write(data.left(chunk));
+    data.remove(0, chunk);
+    if(data.isEmpty()){
+      outgoing.remove(socks[i]);
+      socks[i]->disconnectFromHost(); //closes once everything is written
+    }
+  }
+  if(outgoing.isEmpty()){ chunkTimer->stop(); }
+}
+
+void FeedServer::clientGone(){
+  QTcpSocket *sock = qobject_cast<QTcpSocket*>(sender());
+  if(sock==0){ return; }
+  requests.remove(sock);
+  outgoing.remove(sock);
+  sock->deleteLater();
+}
@@ -0,0 +1,41 @@
+// Minimal HTTP/1.0 server which serves a generated RSS 2.0 feed
+//  - Every reply carries ETag/Last-Modified, and conditional requests get "304 Not Modified"
+//  - The body gets sent in small chunks with a short delay in between (exercises the streaming parser)
+//  - "/update" bumps the feed revision (new item, new ETag) so the next sync downloads it again
+#ifndef _LUMINA_DEVTOOLS_RSS_FEED_SERVER_H
+#define _LUMINA_DEVTOOLS_RSS_FEED_SERVER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QTimer>
+
+class FeedServer : public QTcpServer{
+	Q_OBJECT
+public:
+	FeedServer(int items, int chunk, QObject *parent = 0);
+
+	void bump(); //new feed revision
+	int fullReplies, notModified; //reply counters
+
+private:
+	int items, chunk, revision;
+	QDateTime modified;
+	QHash<QTcpSocket*, QByteArray> requests; //partial request headers
+	QHash<QTcpSocket*, QByteArray> outgoing; //data not sent yet
+	QTimer *chunkTimer;
+
+	QByteArray etag();
+	QByteArray feed();
+	void reply(QTcpSocket *sock, QByteArray request);
+
+private slots:
+	void newClient();
+	void readClient();
+	void sendChunk();
+	void clientGone();
+};
+
+#endif
@@ -0,0 +1,72 @@
+// Local HTTP stand-in for testing the desktop RSS reader
+//  Usage: rss-server [port] [items] [chunk bytes]
+//    Serves a generated feed at http://127.0.0.1:<port>/feed.xml (default port: 8088)
+//    Add that URL to the RSS reader desktop plugin, then open http://127.0.0.1:<port>/update to publish a new revision
+//  Usage: rss-server --check
+//    Runs the same request sequence the reader uses (full GET, conditional GET, new revision) and verifies the replies
+#include <QCoreApplication>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "FeedServer.h"
+
+//Blocking GET (with the same validators RSSReader sends for cached feeds)
+static int fetch(QNetworkAccessManager *NMAN, QString url, QByteArray *etag, QByteArray *lastmod, qint64 *bytes){
+  QNetworkRequest req( (QUrl(url)) );
+  if(!etag->isEmpty()){ req.setRawHeader("If-None-Match", *etag); }
+  if(!lastmod->isEmpty()){ req.setRawHeader("If-Modified-Since", *lastmod); }
+  QNetworkReply *reply = NMAN->get(req);
+  QEventLoop loop;
+  QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()) );
+  loop.exec();
+  int code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  *bytes = reply->readAll().size();
+  if(code==200){ *etag = reply->rawHeader("ETag"); *lastmod = reply->rawHeader("Last-Modified"); }
+  reply->deleteLater();
+  return code;
+}
+
+static int check(){
+  FeedServer server(200, 512);
+  if(!server.listen(QHostAddress::LocalHost, 0)){ qDebug() << "Could not start the server:" << server.errorString(); return 1; }
+  QString base = "http://127.0.0.1:"+QString::number(server.serverPort());
+  QNetworkAccessManager NMAN;
+  QByteArray etag, lastmod;
+  qint64 bytes = 0;
+  bool ok = true;
+  QElapsedTimer timer;
+  timer.start();
+  int code = fetch(&NMAN, base+"/feed.xml", &etag, &lastmod, &bytes);
+  qDebug() << " - Initial download:" << code << bytes << "bytes in" << timer.elapsed() << "ms";
+  ok = ok && (code==200) && bytes>0 && !etag.isEmpty();
+  timer.restart();
+  code = fetch(&NMAN, base+"/feed.xml", &etag, &lastmod, &bytes);
+  qDebug() << " - Conditional request (unchanged):" << code << bytes << "bytes in" << timer.elapsed() << "ms";
+  ok = ok && (code==304) && bytes==0;
+  QByteArray none1, none2;
+  fetch(&NMAN, base+"/update", &none1, &none2, &bytes);
+  timer.restart();
+  code = fetch(&NMAN, base+"/feed.xml", &etag, &lastmod, &bytes);
+  qDebug() << " - Conditional request (new revision):" << code << bytes << "bytes in" << timer.elapsed() << "ms";
+  ok = ok && (code==200) && bytes>0;
+  qDebug() << "Full replies:" << server.fullReplies << " Not modified:" << server.notModified;
+  qDebug() << "Conditional GET sequence:" << (ok ? "OK" : "FAILED");
+  return (ok ? 0 : 1);
+}
+
+int main(int argc, char ** argv){
+  QCoreApplication a(argc, argv);
+  if(argc>1 && QString(argv[1])=="--check"){ return check(); }
+  int port = (argc>1) ? QString(argv[1]).toInt() : 8088;
+  int items = (argc>2) ? QString(argv[2]).toInt() : 50;
+  int chunk = (argc>3) ? QString(argv[3]).toInt() : 512;
+  FeedServer server( (items>0 ? items : 50), (chunk>0 ? chunk : 512) );
+  if(!server.listen(QHostAddress::LocalHost, port)){ qDebug() << "Could not start the server:" << server.errorString(); return 1; }
+  qDebug() << "Serving:" << QString("http://127.0.0.1:%1/feed.xml").arg(QString::number(server.serverPort()));
+  qDebug() << "New revision:" << QString("http://127.0.0.1:%1/update").arg(QString::number(server.serverPort()));
+  return a.exec();
+}
@@ -0,0 +1,15 @@
+# Local HTTP stand-in for testing the desktop RSS reader (feed cache, conditional GET, streaming parser)
+TEMPLATE	= app
+LANGUAGE	= C++
+QT += core network
+QT -= gui
+CONFIG	+= qt warn_on release console
+
+HEADERS	+= FeedServer.h
+
+SOURCES	+= main.cpp \
+	FeedServer.cpp
+
+INSTALLS =
+
+TARGET  = rss-server
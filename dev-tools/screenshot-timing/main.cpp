@@ -0,0 +1,102 @@
+// Simple timing harness for the lumina-screenshot capture and save stages
+//  Usage: screenshot-timing [iterations] [output directory]
+#include <QApplication>
+#include <QDesktopWidget>
+#include <QScreen>
+#include <QLabel>
+#include <QPainter>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+#include <LuminaX11.h>
+#include <LuminaUtils.h>
+#include "ImageEncoder.h"
+
+//Something which looks (and compresses) roughly like a real desktop
+static QImage testPattern(QSize sz){
+  QImage img(sz, QImage::Format_RGB32);
+  QPainter P(&img);
+  QLinearGradient grad(0,0, sz.width(), sz.height());
+  grad.setColorAt(0, QColor(30,60,120)); grad.setColorAt(1, QColor(200,120,40));
+  P.fillRect(img.rect(), grad);
+  qsrand(1);
+  for(int i=0; i<200; i++){
+    QRect win(qrand()%sz.width(), qrand()%sz.height(), 300+qrand()%1200, 200+qrand()%800);
+    P.fillRect(win, QColor(qrand()%256, qrand()%256, qrand()%256));
+    P.setPen(Qt::black);
+    P.drawText(win.adjusted(10,10,-10,-10), Qt::TextWordWrap, QString("Lumina screenshot timing test window %1 - the quick brown fox jumps over the lazy dog. ").repeated(20).arg(i) );
+  }
+  return img;
+}
+
+static void report(QString label, qint64 msecs, QString file = ""){
+  QString size;
+  if(!file.isEmpty()){ size = LUtils::BytesToDisplaySize( QFileInfo(file).size() ); }
+  qDebug() << qPrintable(label.leftJustified(40, ' ')) << msecs << "ms" << qPrintable(size);
+}
+
+int main(int argc, char ** argv){
+  QApplication a(argc, argv);
+  int iters = (argc>1) ? QString(argv[1]).toInt() : 5;
+  if(iters<1){ iters = 1; }
+  QString outdir = (argc>2) ? QString(argv[2]) : QDir::tempPath();
+
+  //Cover the screen with the test pattern
+  QRect screen = QApplication::desktop()->screenGeometry();
+  QLabel label;
+  label.setWindowFlags(Qt::FramelessWindowHint | Qt::X11BypassWindowManagerHint);
+  label.setGeometry(screen);
+  label.setPixmap( QPixmap::fromImage(testPattern(screen.size())) );
+  label.show();
+  for(int i=0; i<20; i++){ a.processEvents(); }
+  qDebug() << "Screen:" << screen.width() << "x" << screen.height() << " Iterations:" << iters;
+
+  // === Capture ===
+  LXCB XCB;
+  QElapsedTimer timer;
+  QImage img;
+  timer.start();
+  for(int i=0; i<iters; i++){ img = QApplication::screens().at(0)->grabWindow(QApplication::desktop()->winId()).toImage(); }
+  report("QScreen::grabWindow (full)", timer.elapsed()/iters);
+  QRect region(screen.width()/4, screen.height()/4, 1920, 1080);
+  timer.restart();
+  for(int i=0; i<iters; i++){ img = QApplication::screens().at(0)->grabWindow(QApplication::desktop()->winId()).toImage().copy(region); }
+  report("QScreen::grabWindow (full) + crop", timer.elapsed()/iters);
+  timer.restart();
+  for(int i=0; i<iters; i++){ img = XCB.WindowImage(0, region); }
+  report("LXCB::WindowImage (1920x1080 region)", timer.elapsed()/iters);
+  timer.restart();
+  for(int i=0; i<iters; i++){ img = XCB.WindowImage(); }
+  report("LXCB::WindowImage (full)", timer.elapsed()/iters);
+
+  // === Save ===
+  QString file = outdir+"/screenshot-timing.png";
+  timer.restart();
+  img.save(file, "png");
+  report("QImage::save (png)", timer.elapsed(), file);
+  int levels[3] = {1, 6, 9};
+  for(int i=0; i<3; i++){
+    timer.restart();
+    ImageEncoder::SavePNG(img, file, levels[i], false);
+    report(QString("ImageEncoder png level %1").arg(levels[i]), timer.elapsed(), file);
+    timer.restart();
+    ImageEncoder::SavePNG(img, file, levels[i], true);
+    report(QString("ImageEncoder png level %1 (threaded)").arg(levels[i]), timer.elapsed(), file);
+  }
+  QStringList formats = ImageEncoder::availableFormats();
+  for(int i=0; i<formats.length(); i++){
+    if(formats[i]=="png"){ continue; }
+    file = outdir+"/screenshot-timing."+formats[i];
+    timer.restart();
+    ImageEncoder::SaveWithQuality(img, file, formats[i].toLocal8Bit(), 90);
+    report(QString("ImageEncoder %1 quality 90").arg(formats[i]), timer.elapsed(), file);
+  }
+  //Make sure the written PNG decodes back to the same image
+  ImageEncoder::SavePNG(img, outdir+"/screenshot-timing.png", 6, true);
+  QImage check(outdir+"/screenshot-timing.png");
+  bool ok = (check.convertToFormat(QImage::Format_RGB32) == img.convertToFormat(QImage::Format_RGB32));
+  qDebug() << "PNG round-trip:" << (ok ? "OK" : "FAILED");
+  return (ok ? 0 : 1);
+}
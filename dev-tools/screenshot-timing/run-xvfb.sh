@@ -0,0 +1,11 @@
+#!/bin/sh
+# Run the screenshot timing harness on an 8K (7680x4320) virtual X screen
+# Usage: run-xvfb.sh [iterations] [output directory]
+DISP=:99
+Xvfb ${DISP} -screen 0 7680x4320x24 -nolisten tcp &
+XPID=$!
+sleep 2
+DISPLAY=${DISP} ./screenshot-timing "$@"
+RET=$?
+kill ${XPID}
+exit ${RET}
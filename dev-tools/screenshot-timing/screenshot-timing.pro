@@ -0,0 +1,19 @@
+# Timing harness for the lumina-screenshot capture/save pipeline
+#  (run it through "run-xvfb.sh" to get a reproducible 8K virtual screen)
+TEMPLATE	= app
+LANGUAGE	= C++
+QT += core gui widgets x11extras concurrent
+CONFIG	+= qt warn_on release
+
+LIBS	+= -L../../src-qt5/core/libLumina -L/usr/local/lib -lLuminaUtils -lz
+
+HEADERS	+= ../../src-qt5/desktop-utils/lumina-screenshot/ImageEncoder.h
+
+SOURCES	+= main.cpp \
+	../../src-qt5/desktop-utils/lumina-screenshot/ImageEncoder.cpp
+
+INSTALLS =
+
+TARGET  = screenshot-timing
+
+INCLUDEPATH+= ../../src-qt5/core/libLumina ../../src-qt5/desktop-utils/lumina-screenshot /usr/local/include
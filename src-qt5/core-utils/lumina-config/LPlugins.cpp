@@ -220,6 +220,13 @@ void LPlugins::LoadDesktopPlugins(){
     info.ID = "rssreader";
     info.icon = "application-rss+xml";
   DESKTOP.insert(info.ID, info);
+  //Message Center Plugin
+  info = LPI(); //clear it
+    info.name = QObject::tr("Message Center");
+    info.description = QObject::tr("Review the history of desktop notifications");
+    info.ID = "messagecenter";
+    info.icon = "preferences-desktop-notification";
+  DESKTOP.insert(info.ID, info);
   //Available QtQuick scripts
   /*QStringList quickID = LUtils::listQuickPlugins();
   for(int i=0; i<quickID.length(); i++){
@@ -1,7 +1,7 @@
 include("$${PWD}/../../OS-detect.pri")
 
 QT       += core gui
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets x11extras network
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets x11extras network concurrent
 
 
 TARGET = lumina-config
@@ -0,0 +1,156 @@
+//===========================================
+//  Lumina Desktop Source Code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "ThumbnailLoader.h"
+
+#include <QtConcurrent>
+#include <QImageReader>
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDir>
+#include <QUrl>
+
+#include <stdlib.h>
+
+#define ICON_SIZE 64
+#define THUMB_SIZE 128 //freedesktop "normal" thumbnail size
+#define PREVIEW_SIZE 1024 //mid-size render used for the preview
+
+static QString thumbnailDir(){
+  QString base = QString(getenv("XDG_CACHE_HOME"));
+  if(base.isEmpty()){ base = QDir::homePath()+"/.cache"; }
+  return base+"/thumbnails";
+}
+
+ThumbnailLoader::ThumbnailLoader(QObject *parent) : QObject(parent){
+  iconWatcher = new QFutureWatcher<ThumbImage>(this);
+    connect(iconWatcher, SIGNAL(resultReadyAt(int)), this, SLOT(iconReadyAt(int)) );
+    connect(iconWatcher, SIGNAL(finished()), this, SLOT(iconsFinished()) );
+  previewWatcher = new QFutureWatcher<ThumbImage>(this);
+    connect(previewWatcher, SIGNAL(finished()), this, SLOT(previewFinished()) );
+}
+
+ThumbnailLoader::~ThumbnailLoader(){
+  iconQueue.clear();
+  iconWatcher->cancel();
+  iconWatcher->waitForFinished();
+  previewWatcher->waitForFinished();
+}
+
+void ThumbnailLoader::requestIcons(QStringList files){
+  files.removeDuplicates();
+  for(int i=0; i<files.length(); i++){
+    if(!iconQueue.contains(files[i])){ iconQueue << files[i]; }
+  }
+  if(!iconWatcher->isRunning()){ startIcons(); }
+}
+
+void ThumbnailLoader::requestPreview(QString file){
+  if(previewWatcher->isRunning()){ previewQueue = file; return; } //start it as soon as the current one finishes
+  previewQueue.clear();
+  previewWatcher->setFuture( QtConcurrent::run(createPreview, file) );
+}
+
+void ThumbnailLoader::clear(){
+  iconQueue.clear();
+  previewQueue.clear();
+  if(iconWatcher->isRunning()){ iconWatcher->cancel(); }
+}
+
+// === Worker functions ===
+QImage ThumbnailLoader::loadScaled(QString file, QSize max){
+  QImageReader reader(file);
+  QSize sz = reader.size();
+  if(sz.isValid() && (sz.width()>max.width() || sz.height()>max.height()) ){
+    //Let the image plugin decode at the reduced size directly (JPEG can skip most of the work)
+    reader.setScaledSize( sz.scaled(max, Qt::KeepAspectRatio) );
+  }
+  return reader.read();
+}
+
+QImage ThumbnailLoader::cachedThumbnail(QString file, QString *thumbfile){
+  QFileInfo info(file);
+  QString uri = QUrl::fromLocalFile(info.absoluteFilePath()).toEncoded();
+  QString name = QCryptographicHash::hash(uri.toUtf8(), QCryptographicHash::Md5).toHex()+".png";
+  QString dir = thumbnailDir();
+  if(thumbfile!=0){ *thumbfile = dir+"/normal/"+name; }
+  QString mtime = QString::number(info.lastModified().toTime_t());
+  QStringList sizes; sizes << "normal" << "large";
+  for(int i=0; i<sizes.length(); i++){
+    QImageReader reader(dir+"/"+sizes[i]+"/"+name, "png");
+    if(!reader.canRead()){ continue; }
+    //Stale if the file has been modified since the thumbnail was made
+    if(reader.text("Thumb::MTime")!=mtime){ continue; }
+    QImage img = reader.read();
+    if(!img.isNull()){ return img; }
+  }
+  return QImage();
+}
+
+ThumbImage ThumbnailLoader::createIcon(const QString &file){
+  ThumbImage out;
+  out.file = file;
+  QString thumbfile;
+  QImage img = cachedThumbnail(file, &thumbfile);
+  if(img.isNull()){
+    img = loadScaled(file, QSize(THUMB_SIZE, THUMB_SIZE));
+    if(!img.isNull() && !file.startsWith(thumbnailDir()+"/") ){
+      //Save it into the thumbnail cache for the next time (and for other applications)
+      QFileInfo info(file);
+      QImage thumb = img;
+        thumb.setText("Thumb::URI", QUrl::fromLocalFile(info.absoluteFilePath()).toEncoded());
+        thumb.setText("Thumb::MTime", QString::number(info.lastModified().toTime_t()));
+      QString dir = thumbfile.section("/",0,-2);
+      if(!QFile::exists(dir)){
+        QDir().mkpath(dir);
+        QFile::setPermissions(dir, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+      }
+      QSaveFile save(thumbfile);
+      if(save.open(QIODevice::WriteOnly) && thumb.save(&save, "png") ){ save.commit(); }
+    }
+  }
+  if(img.width()>ICON_SIZE || img.height()>ICON_SIZE){
+    img = img.scaled(ICON_SIZE, ICON_SIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  }
+  out.img = img;
+  return out;
+}
+
+ThumbImage ThumbnailLoader::createPreview(QString file){
+  ThumbImage out;
+  out.file = file;
+  out.img = loadScaled(file, QSize(PREVIEW_SIZE, PREVIEW_SIZE));
+  return out;
+}
+
+// === PRIVATE ===
+void ThumbnailLoader::startIcons(){
+  if(iconQueue.isEmpty()){ return; }
+  QStringList files = iconQueue;
+  iconQueue.clear();
+  iconWatcher->setFuture( QtConcurrent::mapped(files, createIcon) );
+}
+
+// === PRIVATE SLOTS ===
+void ThumbnailLoader::iconReadyAt(int index){
+  ThumbImage res = iconWatcher->resultAt(index);
+  if(!res.img.isNull()){ emit IconReady(res.file, res.img); }
+}
+
+void ThumbnailLoader::iconsFinished(){
+  startIcons(); //anything which came in while the last batch was running
+}
+
+void ThumbnailLoader::previewFinished(){
+  ThumbImage res = previewWatcher->result();
+  emit PreviewReady(res.file, res.img);
+  if(!previewQueue.isEmpty()){
+    QString file = previewQueue;
+    requestPreview(file);
+  }
+}
@@ -0,0 +1,64 @@
+//===========================================
+//  Lumina Desktop Source Code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Background image thumbnailer for the wallpaper page
+//   - Icons: re-uses the freedesktop thumbnail cache (~/.cache/thumbnails) when valid,
+//       otherwise decodes at reduced size and saves a new cached thumbnail
+//   - Previews: a mid-size render of a single image (the page scales this to fit)
+//  All the decoding happens on worker threads, results are streamed back with signals
+//===========================================
+#ifndef _LUMINA_CONFIG_THUMBNAIL_LOADER_H
+#define _LUMINA_CONFIG_THUMBNAIL_LOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QImage>
+#include <QSize>
+#include <QFutureWatcher>
+
+struct ThumbImage{
+	QString file;
+	QImage img;
+};
+
+class ThumbnailLoader : public QObject{
+	Q_OBJECT
+public:
+	ThumbnailLoader(QObject *parent = 0);
+	~ThumbnailLoader();
+
+	//Queue up icon generation (IconReady() is emitted for each file as it finishes)
+	void requestIcons(QStringList files);
+	//Render a mid-size version of a file (only the latest request is kept if one is already running)
+	void requestPreview(QString file);
+	//Drop anything which has not been started yet
+	void clear();
+
+	//Worker functions (thread-safe)
+	static QImage loadScaled(QString file, QSize max);
+	static QImage cachedThumbnail(QString file, QString *thumbfile = 0);
+	static ThumbImage createIcon(const QString &file);
+	static ThumbImage createPreview(QString file);
+
+private:
+	QFutureWatcher<ThumbImage> *iconWatcher, *previewWatcher;
+	QStringList iconQueue;
+	QString previewQueue;
+
+	void startIcons();
+
+private slots:
+	void iconReadyAt(int);
+	void iconsFinished();
+	void previewFinished();
+
+signals:
+	void IconReady(QString, QImage);
+	void PreviewReady(QString, QImage);
+};
+
+#endif
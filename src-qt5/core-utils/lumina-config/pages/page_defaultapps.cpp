@@ -23,6 +23,9 @@ page_defaultapps::page_defaultapps(QWidget *parent) : PageWidget(parent), ui(new
   connect(ui->tool_defaults_set, SIGNAL(clicked()), this, SLOT(setdefaultitem()) );
   connect(ui->tool_defaults_setbin, SIGNAL(clicked()), this, SLOT(setdefaultbinary()) );
   connect(ui->tree_defaults, SIGNAL(itemSelectionChanged()), this, SLOT(checkdefaulticons()) );
+  mimeLoader = new XDGMimeDefaults(this);
+  connect(mimeLoader, SIGNAL(RowsReady(QStringList)), this, SLOT(addDefaultRows(QStringList)) );
+  connect(mimeLoader, SIGNAL(Finished()), this, SLOT(defaultRowsDone()) );
   updateIcons();
   ui->tabWidget_apps->setCurrentWidget(ui->tab_auto);
 }
@@ -129,57 +132,11 @@ void page_defaultapps::LoadSettings(int){
       ui->tool_default_email->setIcon( LXDG::findIcon("application-x-executable","") );
   }
   
-  //Now load the XDG mime defaults
+  //Now load the XDG mime defaults (built in the background - the rows get added as they come in)
   ui->tree_defaults->clear();
-  QStringList defMimeList = LXDG::listFileMimeDefaults();
-  //qDebug() << "Mime List:\n" << defMimeList.join("\n");
-  defMimeList.sort(); //sort by group/mime
-  //Now fill the tree by group/mime
-  QTreeWidgetItem *group = new QTreeWidgetItem(0); //nothing at the moment
-  QString ccat;
-  for(int i=0; i<defMimeList.length(); i++){
-    //Get the info from this entry
-    QString mime = defMimeList[i].section("::::",0,0);
-    QString cat = mime.section("/",0,0);
-    QString extlist = defMimeList[i].section("::::",1,1);
-    QString def = defMimeList[i].section("::::",2,2);
-    QString comment = defMimeList[i].section("::::",3,50);
-    //Now check if this is a new category
-    if(ccat!=cat){
-	//New group
-	group = new QTreeWidgetItem(0);
-	    group->setText(0, cat); //add translations for known/common groups later
-	ui->tree_defaults->addTopLevelItem(group);
-	ccat = cat;
-    }
-    //Now create the entry
-    QTreeWidgetItem *it = new QTreeWidgetItem();
-      it->setWhatsThis(0,mime); // full mimetype
-      it->setText(0, QString(tr("%1 (%2)")).arg(mime.section("/",-1), extlist) );
-      it->setText(2,comment);
-      it->setToolTip(0, comment); it->setToolTip(1,comment);
-      //Now load the default (if there is one)
-      it->setWhatsThis(1,def); //save for later
-      if(def.endsWith(".desktop")){
-	XDGDesktop file(def);
-	if(file.type == XDGDesktop::BAD){
-	  //Might be a binary - just print out the raw "path"
-	  it->setText(1,def.section("/",-1));
-	  it->setIcon(1, LXDG::findIcon("application-x-executable","") );
-	}else{
-	  it->setText(1, file.name);
-	  it->setIcon(1, LXDG::findIcon(file.icon,"") );
-	}     
-      }else if(!def.isEmpty()){
-	//Binary/Other default
-	it->setText(1, def.section("/",-1));
-	it->setIcon(1, LXDG::findIcon("application-x-executable","") );
-      }
-      group->addChild(it);
-  }
-  
-  ui->tree_defaults->sortItems(0,Qt::AscendingOrder);
-  
+  mimeGroups.clear();
+  appCache.clear();
+  mimeLoader->start();
   checkdefaulticons();
 }
 
@@ -354,3 +311,55 @@ void page_defaultapps::checkdefaulticons(){
   ui->tool_defaults_clear->setEnabled(it!=0);
   ui->tool_defaults_setbin->setEnabled(it!=0);
 }
+
+void page_defaultapps::addDefaultRows(QStringList rows){
+  //Rows come sorted by mimetype: <mimetype>::::<extensions>::::<default>::::<localized comment>
+  for(int i=0; i<rows.length(); i++){
+    //Get the info from this entry
+    QString mime = rows[i].section("::::",0,0);
+    QString cat = mime.section("/",0,0);
+    QString extlist = rows[i].section("::::",1,1);
+    QString def = rows[i].section("::::",2,2);
+    QString comment = rows[i].section("::::",3,50);
+    //Now check if this is a new category
+    QTreeWidgetItem *group = mimeGroups.value(cat, 0);
+    if(group==0){
+	//New group
+	group = new QTreeWidgetItem(0);
+	    group->setText(0, cat); //add translations for known/common groups later
+	ui->tree_defaults->addTopLevelItem(group);
+	mimeGroups.insert(cat, group);
+    }
+    //Now create the entry
+    QTreeWidgetItem *it = new QTreeWidgetItem();
+      it->setWhatsThis(0,mime); // full mimetype
+      it->setText(0, QString(tr("%1 (%2)")).arg(mime.section("/",-1), extlist) );
+      it->setText(2,comment);
+      it->setToolTip(0, comment); it->setToolTip(1,comment);
+      //Now load the default (if there is one)
+      it->setWhatsThis(1,def); //save for later
+      if(!def.isEmpty()){
+        if(!appCache.contains(def)){
+          if(def.endsWith(".desktop")){
+	    XDGDesktop file(def);
+	    if(file.type == XDGDesktop::BAD){
+	      //Might be a binary - just print out the raw "path"
+	      appCache.insert(def, qMakePair(def.section("/",-1), LXDG::findIcon("application-x-executable","")) );
+	    }else{
+	      appCache.insert(def, qMakePair(file.name, LXDG::findIcon(file.icon,"")) );
+	    }
+          }else{
+	    //Binary/Other default
+	    appCache.insert(def, qMakePair(def.section("/",-1), LXDG::findIcon("application-x-executable","")) );
+          }
+        }
+        it->setText(1, appCache[def].first);
+        it->setIcon(1, appCache[def].second);
+      }
+      group->addChild(it);
+  }
+}
+
+void page_defaultapps::defaultRowsDone(){
+  ui->tree_defaults->sortItems(0,Qt::AscendingOrder);
+}
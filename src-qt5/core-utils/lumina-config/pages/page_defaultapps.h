@@ -26,6 +26,9 @@ public slots:
 
 private:
 	Ui::page_defaultapps *ui;
+	XDGMimeDefaults *mimeLoader; //builds the advanced defaults table in the background
+	QHash<QString, QTreeWidgetItem*> mimeGroups; //category -> tree item
+	QHash<QString, QPair<QString, QIcon> > appCache; //default app -> name/icon (the same apps are used for many types)
 
 	QString getSysApp(bool allowreset);
 
@@ -42,6 +45,8 @@ private slots:
 	void setdefaultitem();
 	void setdefaultbinary();
 	void checkdefaulticons();
+	void addDefaultRows(QStringList);
+	void defaultRowsDone();
 
 };
 #endif
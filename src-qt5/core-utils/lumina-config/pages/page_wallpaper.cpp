@@ -14,6 +14,9 @@
 page_wallpaper::page_wallpaper(QWidget *parent) : PageWidget(parent), ui(new Ui::page_wallpaper()){
   ui->setupUi(this);
   DEFAULTBG = LOS::LuminaShare()+"/desktop-background.jpg";
+  thumbs = new ThumbnailLoader(this);
+  connect(thumbs, SIGNAL(IconReady(QString, QImage)), this, SLOT(iconReady(QString, QImage)) );
+  connect(thumbs, SIGNAL(PreviewReady(QString, QImage)), this, SLOT(previewReady(QString, QImage)) );
   updateIcons();
   connect(ui->combo_desk_bg, SIGNAL(currentIndexChanged(int)), this, SLOT(deskbgchanged()) );
   connect(ui->radio_desk_multi, SIGNAL(toggled(bool)), this, SLOT(desktimechanged()) );
@@ -61,13 +64,14 @@ void page_wallpaper::LoadSettings(int screennum){
   QString DPrefix = "desktop-"+screenID+"/";
 
   QStringList bgs = settings.value(DPrefix+"background/filelist", QStringList()<<"default").toStringList();
+  thumbs->clear(); //drop anything still pending from a different screen
   ui->combo_desk_bg->clear();
   for(int i=0; i<bgs.length(); i++){
-    if(bgs[i]=="default"){ ui->combo_desk_bg->addItem( QIcon(DEFAULTBG), tr("System Default"), bgs[i] ); }
+    if(bgs[i]=="default"){ ui->combo_desk_bg->addItem( tr("System Default"), bgs[i] ); }
     else if(bgs[i].startsWith("rgb(")){ui->combo_desk_bg->addItem(QString(tr("Solid Color: %1")).arg(bgs[i]), bgs[i]); }
-    //else{ ui->combo_desk_bg->addItem( QIcon(QPixmap(bgs[i]).scaled(64,64)), bgs[i].section("/",-1), bgs[i] ); }
-    else{ ui->combo_desk_bg->addItem( bgs[i].section("/",-1), bgs[i] ); } //disable the thumbnail - takes a long time for large collections of files
+    else{ ui->combo_desk_bg->addItem( bgs[i].section("/",-1), bgs[i] ); }
   }
+  loadIcons(0); //thumbnails get filled in as they become available
 
   ui->radio_desk_multi->setEnabled(bgs.length()>1);
   if(bgs.length()>1){ ui->radio_desk_multi->setChecked(true);}
@@ -110,6 +114,29 @@ QString page_wallpaper::getColorStyle(QString current, bool allowTransparency){
   return out;
 }
 
+void page_wallpaper::loadIcons(int start){
+  QStringList files;
+  for(int i=start; i<ui->combo_desk_bg->count(); i++){
+    QString path = ui->combo_desk_bg->itemData(i).toString();
+    if(path=="default"){ path = DEFAULTBG; }
+    if(path.startsWith("/")){ files << path; }
+  }
+  thumbs->requestIcons(files);
+}
+
+void page_wallpaper::showPreview(){
+  QSize sz = ui->label_desk_bgview->size();
+  sz.setWidth( sz.width() - (2*ui->label_desk_bgview->frameWidth()) );
+  sz.setHeight( sz.height() - (2*ui->label_desk_bgview->frameWidth()) );
+  if(previewImg.isNull()){
+    ui->label_desk_bgview->setPixmap(QPixmap());
+    ui->label_desk_bgview->setText(tr("Could not read image"));
+  }else{
+    ui->label_desk_bgview->setPixmap( QPixmap::fromImage(previewImg.scaled(sz, Qt::KeepAspectRatio, Qt::SmoothTransformation)) );
+  }
+  ui->label_desk_bgview->setStyleSheet("");
+}
+
 //=================
 //    PRIVATE SLOTS
 //=================
@@ -146,14 +173,14 @@ void page_wallpaper::deskbgchanged(){
     QString path = ui->combo_desk_bg->itemData( ui->combo_desk_bg->currentIndex() ).toString();
     if(path=="default"){ path = DEFAULTBG; }
     if(QFile::exists(path)){
-      QSize sz = ui->label_desk_bgview->size();
-      sz.setWidth( sz.width() - (2*ui->label_desk_bgview->frameWidth()) );
-      sz.setHeight( sz.height() - (2*ui->label_desk_bgview->frameWidth()) );
-      //Update the preview/thumbnail for this item
-      QPixmap pix(path);
-      ui->label_desk_bgview->setPixmap( pix.scaled(sz, Qt::KeepAspectRatio, Qt::SmoothTransformation) );
-      ui->combo_desk_bg->setItemIcon(ui->combo_desk_bg->currentIndex(), pix.scaled(64,64) );
-      ui->label_desk_bgview->setStyleSheet("");
+      if(path==previewFile){ showPreview(); } //already rendered - just re-fit it to the label
+      else{
+        //Render the preview in the background
+        ui->label_desk_bgview->setPixmap(QPixmap());
+        ui->label_desk_bgview->setText(tr("Loading..."));
+        ui->label_desk_bgview->setStyleSheet("");
+        thumbs->requestPreview(path);
+      }
     }else if(path.startsWith("rgb(")){
       ui->label_desk_bgview->setPixmap(QPixmap());
       ui->label_desk_bgview->setText("");
@@ -202,9 +229,11 @@ void page_wallpaper::deskbgadded(){
   for(int i=0; i<imgs.length(); i++){ imgs[i].prepend("*."); }
   QStringList bgs = QFileDialog::getOpenFileNames(this, tr("Find Background Image(s)"), dir, "Images ("+imgs.join(" ")+");;All Files (*)");
   if(bgs.isEmpty()){ return; }
+  int start = ui->combo_desk_bg->count();
   for(int i=0; i<bgs.length(); i++){
-    ui->combo_desk_bg->addItem( QIcon(bgs[i]), bgs[i].section("/",-1), bgs[i]);
+    ui->combo_desk_bg->addItem( bgs[i].section("/",-1), bgs[i]);
   }
+  loadIcons(start);
   //Now move to the last item in the list (the new image(s));
   ui->combo_desk_bg->setCurrentIndex( ui->combo_desk_bg->count()-1 );
   //If multiple items selected, automatically enable the background rotation option
@@ -239,9 +268,11 @@ void page_wallpaper::deskbgdiradded(){
   QDir qdir(dir);
   QStringList bgs = qdir.entryList(imgs, QDir::Files | QDir::NoDotAndDotDot, QDir::Name);
   if(bgs.isEmpty()){ return; }
+  int start = ui->combo_desk_bg->count();
   for(int i=0; i<bgs.length(); i++){
     ui->combo_desk_bg->addItem( bgs[i], qdir.absoluteFilePath(bgs[i]));
   }
+  loadIcons(start);
   //Now move to the last item in the list (the new image(s));
   ui->combo_desk_bg->setCurrentIndex( ui->combo_desk_bg->count()-1 );
   //If multiple items selected, automatically enable the background rotation option
@@ -271,9 +302,11 @@ void page_wallpaper::deskbgdirradded(){
     for(int j=0; j<tmp.length(); j++){ bgs << qdir.absoluteFilePath(tmp[j]); }
   }
   //Now add all the files into the widget
+  int start = ui->combo_desk_bg->count();
   for(int i=0; i<bgs.length(); i++){
     ui->combo_desk_bg->addItem( bgs[i].section("/",-1), bgs[i] );
   }
+  loadIcons(start);
   //Now move to the last item in the list (the new image(s));
   ui->combo_desk_bg->setCurrentIndex( ui->combo_desk_bg->count()-1 );
   //If multiple items selected, automatically enable the background rotation option
@@ -282,3 +315,20 @@ void page_wallpaper::deskbgdirradded(){
   }
   emit HasPendingChanges(true);	
 }
+
+void page_wallpaper::iconReady(QString file, QImage img){
+  QIcon ico( QPixmap::fromImage(img) );
+  for(int i=0; i<ui->combo_desk_bg->count(); i++){
+    QString path = ui->combo_desk_bg->itemData(i).toString();
+    if(path==file || (path=="default" && file==DEFAULTBG) ){ ui->combo_desk_bg->setItemIcon(i, ico); }
+  }
+}
+
+void page_wallpaper::previewReady(QString file, QImage img){
+  previewFile = file;
+  previewImg = img;
+  //Only show it if that item is still the one selected
+  QString path = ui->combo_desk_bg->currentData().toString();
+  if(path=="default"){ path = DEFAULTBG; }
+  if(path==file){ showPreview(); }
+}
@@ -8,6 +8,7 @@
 #define _LUMINA_CONFIG_PAGE_WALLPAPER_H
 #include "../globals.h"
 #include "PageWidget.h"
+#include "ThumbnailLoader.h"
 
 namespace Ui{
 	class page_wallpaper;
@@ -31,8 +32,13 @@ private:
 	int cScreen, cBG; //current screen number/background
 	QString DEFAULTBG;
 	bool loading;
+	ThumbnailLoader *thumbs;
+	QString previewFile; //file the preview image belongs to
+	QImage previewImg; //mid-size render (scaled to fit the preview label as needed)
 
 	QString getColorStyle(QString current, bool allowTransparency);
+	void loadIcons(int start); //queue up icons for all the items after the given index
+	void showPreview();
 
 private slots:
 	void updateMenus();
@@ -43,6 +49,8 @@ private slots:
 	void deskbgcoloradded();
 	void deskbgdiradded();
 	void deskbgdirradded();
+	void iconReady(QString, QImage);
+	void previewReady(QString, QImage);
 
 protected:
 	void resizeEvent(QResizeEvent*){
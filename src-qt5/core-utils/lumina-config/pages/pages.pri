@@ -13,7 +13,8 @@ HEADERS	+= 	$${PWD}/getPage.h \
 		$${PWD}/page_interface_panels.h \
 		$${PWD}/page_session_locale.h \
 		$${PWD}/page_session_options.h \
-		$${PWD}/page_compton.h
+		$${PWD}/page_compton.h \
+		$${PWD}/ThumbnailLoader.h
 
 
 SOURCES	+=	$${PWD}/page_main.cpp \
@@ -28,7 +29,8 @@ SOURCES	+=	$${PWD}/page_main.cpp \
 		$${PWD}/page_interface_panels.cpp \
 		$${PWD}/page_session_locale.cpp \
 		$${PWD}/page_session_options.cpp \
-		$${PWD}/page_compton.cpp
+		$${PWD}/page_compton.cpp \
+		$${PWD}/ThumbnailLoader.cpp
 
 		
 FORMS	+=	$${PWD}/page_main.ui \
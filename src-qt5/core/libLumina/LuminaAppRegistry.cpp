@@ -0,0 +1,195 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LuminaAppRegistry.h"
+#include "LuminaXDG.h"
+
+#include <QSharedMemory>
+#include <QDataStream>
+#include <QByteArray>
+#include <QDateTime>
+#include <QDebug>
+
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+
+#define REGISTRY_MAGIC 0x4C415050 //"LAPP"
+#define REGISTRY_VERSION 2 //increment whenever the serialized format changes
+#define REGISTRY_MINSIZE 1048576 //1MB (the segment gets re-created if a snapshot does not fit)
+
+//Fixed header at the start of the shared memory segment
+struct LAppRegistryHeader{
+  quint32 magic;
+  quint32 version;
+  quint32 generation;
+  quint32 size; //payload bytes (follow the header)
+  qint64 pid; //publishing session
+};
+
+//Publisher state (session process only)
+static QSharedMemory *pubMem = 0;
+static quint32 pubGen = 0;
+
+static QString registryKey(){
+  return "lumina-app-registry-"+QString::number(getuid());
+}
+
+static bool processRunning(qint64 pid){
+  if(pid<=0){ return false; }
+  return (kill(pid,0)==0 || errno==EPERM);
+}
+
+static void writeApp(QDataStream &out, XDGDesktop *app){
+  out << app->filePath << app->lastRead << (qint32) app->type;
+  out << app->name << app->genericName << app->comment << app->icon;
+  out << app->showInList << app->notShowInList << app->isHidden;
+  out << app->exec << app->tryexec << app->path << app->startupWM;
+  out << app->actionList << app->mimeList << app->catList << app->keyList;
+  out << app->useTerminal << app->startupNotify << app->useVGL << app->url;
+  out << app->startPhase << app->startAfter << (qint32) app->startDelay;
+  out << (qint32) app->actions.length();
+  for(int i=0; i<app->actions.length(); i++){
+    out << app->actions[i].ID << app->actions[i].name << app->actions[i].icon << app->actions[i].exec;
+  }
+}
+
+static XDGDesktop* readApp(QDataStream &in, QObject *parent){
+  XDGDesktop *app = new XDGDesktop("", parent); //empty path: nothing gets read from disk
+  qint32 type, nact, delay;
+  in >> app->filePath >> app->lastRead >> type;
+  app->type = (XDGDesktop::XDGDesktopType) type;
+  in >> app->name >> app->genericName >> app->comment >> app->icon;
+  in >> app->showInList >> app->notShowInList >> app->isHidden;
+  in >> app->exec >> app->tryexec >> app->path >> app->startupWM;
+  in >> app->actionList >> app->mimeList >> app->catList >> app->keyList;
+  in >> app->useTerminal >> app->startupNotify >> app->useVGL >> app->url;
+  in >> app->startPhase >> app->startAfter >> delay;
+  app->startDelay = delay;
+  in >> nact;
+  for(int i=0; i<nact && in.status()==QDataStream::Ok; i++){
+    XDGDesktopAction act;
+    in >> act.ID >> act.name >> act.icon >> act.exec;
+    app->actions << act;
+  }
+  return app;
+}
+
+//Copy the snapshot out of shared memory (header only if "payload" is null)
+static bool readSegment(LAppRegistryHeader *head, QByteArray *payload){
+  QSharedMemory mem(registryKey());
+  if(!mem.attach(QSharedMemory::ReadOnly)){ return false; } //no session running
+  bool ok = false;
+  if(mem.lock()){
+    if(mem.size() >= (int) sizeof(LAppRegistryHeader)){
+      memcpy(head, mem.constData(), sizeof(LAppRegistryHeader));
+      ok = (head->magic==REGISTRY_MAGIC && head->version==REGISTRY_VERSION && head->generation!=0 \
+		&& head->size <= (quint32) (mem.size()-sizeof(LAppRegistryHeader)) );
+      if(ok && payload!=0){
+        *payload = QByteArray( ((const char*) mem.constData())+sizeof(LAppRegistryHeader), head->size);
+      }
+    }
+    mem.unlock();
+  }
+  mem.detach();
+  //Ignore anything left behind by a session which is not running anymore
+  return (ok && processRunning(head->pid));
+}
+
+//===== Session side =====
+bool LAppRegistry::publish(QList<XDGDesktop*> apps){
+  //Serialize the apps and the association tables
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+  out << (qint32) apps.length();
+  QHash<QString, QStringList> mimes;
+  for(int i=0; i<apps.length(); i++){
+    writeApp(out, apps[i]);
+    for(int m=0; m<apps[i]->mimeList.length(); m++){ mimes[apps[i]->mimeList[m]] << apps[i]->filePath; }
+  }
+  QHash<QString, QList<XDGDesktop*> > sorted = LXDG::sortDesktopCats(apps);
+  QHash<QString, QStringList> cats;
+  QStringList catnames = sorted.keys();
+  for(int i=0; i<catnames.length(); i++){
+    QList<XDGDesktop*> list = sorted.value(catnames[i]);
+    for(int a=0; a<list.length(); a++){ cats[catnames[i]] << list[a]->filePath; }
+  }
+  out << cats << mimes;
+  //Make sure the segment is big enough
+  int needed = sizeof(LAppRegistryHeader) + payload.size();
+  if(pubMem==0){ pubMem = new QSharedMemory(registryKey()); }
+  if(pubMem->isAttached() && pubMem->size() < needed){ pubMem->detach(); } //grow: readers keep the old one until they detach
+  if(!pubMem->isAttached()){
+    int size = qMax(2*needed, REGISTRY_MINSIZE);
+    if(!pubMem->create(size)){
+      //Existing segment (crashed session, or a reader still holds the previous one) - re-use it if it is big enough
+      if( !(pubMem->error()==QSharedMemory::AlreadyExists && pubMem->attach() && pubMem->size()>=needed) ){
+        qWarning() << "Could not publish the application registry:" << pubMem->errorString();
+        if(pubMem->isAttached()){ pubMem->detach(); }
+        return false;
+      }
+    }
+  }
+  //Generations are seeded from the clock, so a new session never repeats the number a reader saw last
+  if(pubGen==0){ pubGen = (quint32) QDateTime::currentDateTime().toTime_t(); }
+  else{ pubGen++; }
+  if(pubGen==0){ pubGen = 1; } //0 is reserved for "no snapshot"
+  LAppRegistryHeader head;
+    head.magic = REGISTRY_MAGIC;
+    head.version = REGISTRY_VERSION;
+    head.generation = pubGen;
+    head.size = payload.size();
+    head.pid = getpid();
+  if(!pubMem->lock()){ return false; }
+  memcpy(pubMem->data(), &head, sizeof(LAppRegistryHeader));
+  memcpy( ((char*) pubMem->data())+sizeof(LAppRegistryHeader), payload.constData(), payload.size());
+  pubMem->unlock();
+  return true;
+}
+
+void LAppRegistry::unpublish(){
+  if(pubMem==0){ return; }
+  if(pubMem->isAttached()){
+    if(pubMem->lock()){
+      memset(pubMem->data(), 0, sizeof(LAppRegistryHeader)); //invalidate for anybody still attached
+      pubMem->unlock();
+    }
+    pubMem->detach(); //the segment gets removed once the last process detaches
+  }
+}
+
+//===== Client side =====
+quint32 LAppRegistry::generation(){
+  LAppRegistryHeader head;
+  if(!readSegment(&head, 0)){ return 0; }
+  return head.generation;
+}
+
+bool LAppRegistry::load(QObject *parent, QList<XDGDesktop*> &apps, quint32 *gen, QHash<QString, QStringList> *categories, QHash<QString, QStringList> *mimetypes){
+  LAppRegistryHeader head;
+  QByteArray payload;
+  if(!readSegment(&head, &payload)){ return false; }
+  QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_5_0);
+  qint32 num;
+  in >> num;
+  QList<XDGDesktop*> list;
+  for(int i=0; i<num && in.status()==QDataStream::Ok; i++){ list << readApp(in, parent); }
+  QHash<QString, QStringList> cats, mimes;
+  in >> cats >> mimes;
+  if(in.status()!=QDataStream::Ok){
+    //Corrupt/truncated snapshot
+    for(int i=0; i<list.length(); i++){ delete list[i]; }
+    return false;
+  }
+  apps = list;
+  if(gen!=0){ *gen = head.generation; }
+  if(categories!=0){ *categories = cats; }
+  if(mimetypes!=0){ *mimetypes = mimes; }
+  return true;
+}
@@ -0,0 +1,41 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Shared application registry
+//    The running session publishes the parsed application list (*.desktop files) into a
+//    read-only shared memory snapshot, together with the category and mimetype associations.
+//    Other Lumina processes load their application lists from that snapshot instead of
+//    reading/parsing every *.desktop file on the system.
+//  - Every new snapshot gets a new generation number (0: no snapshot available)
+//  - Snapshots from a session which is not running anymore are ignored
+//  NOTE: XDGDesktopList uses this automatically (see XDGDesktopList::setRegistryHost())
+//===========================================
+#ifndef _LUMINA_LIBRARY_APP_REGISTRY_H
+#define _LUMINA_LIBRARY_APP_REGISTRY_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+
+class XDGDesktop;
+
+class LAppRegistry{
+public:
+	//Session side
+	static bool publish(QList<XDGDesktop*> apps); //write a new snapshot
+	static void unpublish(); //remove the snapshot (session ending)
+
+	//Client side
+	static quint32 generation(); //generation of the current snapshot (0: none available)
+	// - the new structures are created with the given parent
+	// - categories: category -> app files (same grouping as LXDG::sortDesktopCats())
+	// - mimetypes: mimetype -> app files
+	static bool load(QObject *parent, QList<XDGDesktop*> &apps, quint32 *gen = 0, QHash<QString, QStringList> *categories = 0, QHash<QString, QStringList> *mimetypes = 0);
+};
+
+#endif
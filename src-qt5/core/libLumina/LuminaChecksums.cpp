@@ -0,0 +1,176 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LuminaChecksums.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QThread>
+#include <QFuture>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <fcntl.h>
+#include <string.h>
+
+#define CHECKSUM_BUFSIZE (4*1024*1024) //size of each sequential read
+
+// ==============
+//  xxHash (64-bit) streaming implementation
+// ==============
+static const quint64 XXP1 = 11400714785074694791ULL;
+static const quint64 XXP2 = 14029467366897019727ULL;
+static const quint64 XXP3 =  1609587929392839161ULL;
+static const quint64 XXP4 =  9650029242287828579ULL;
+static const quint64 XXP5 =  2870177450012600261ULL;
+
+static inline quint64 xxRotl(quint64 x, int r){ return (x << r) | (x >> (64-r)); }
+static inline quint64 xxRound(quint64 acc, quint64 input){
+  acc += input * XXP2;
+  acc = xxRotl(acc, 31);
+  return (acc * XXP1);
+}
+static inline quint64 xxMerge(quint64 acc, quint64 val){
+  acc ^= xxRound(0, val);
+  return (acc * XXP1 + XXP4);
+}
+
+class XXH64State{
+public:
+	XXH64State(quint64 seed = 0){
+	  v1 = seed + XXP1 + XXP2; v2 = seed + XXP2; v3 = seed; v4 = seed - XXP1;
+	  total = 0; memsize = 0;
+	}
+	void addData(const char *data, qint64 len){
+	  const uchar *p = (const uchar*) data;
+	  total += len;
+	  if(memsize + len < 32){ memcpy(mem+memsize, p, len); memsize += len; return; }
+	  if(memsize > 0){
+	    int fill = 32 - memsize;
+	    memcpy(mem+memsize, p, fill);
+	    stripe(mem);
+	    p += fill; len -= fill; memsize = 0;
+	  }
+	  while(len >= 32){ stripe(p); p += 32; len -= 32; }
+	  if(len > 0){ memcpy(mem, p, len); memsize = len; }
+	}
+	quint64 result(){
+	  quint64 h;
+	  if(total >= 32){
+	    h = xxRotl(v1,1) + xxRotl(v2,7) + xxRotl(v3,12) + xxRotl(v4,18);
+	    h = xxMerge(h,v1); h = xxMerge(h,v2); h = xxMerge(h,v3); h = xxMerge(h,v4);
+	  }else{
+	    h = v3 + XXP5; //v3 == seed
+	  }
+	  h += total;
+	  const uchar *p = mem;
+	  int rem = memsize;
+	  while(rem >= 8){ h ^= xxRound(0, qFromLittleEndian<quint64>(p)); h = xxRotl(h,27) * XXP1 + XXP4; p += 8; rem -= 8; }
+	  if(rem >= 4){ h ^= ((quint64) qFromLittleEndian<quint32>(p)) * XXP1; h = xxRotl(h,23) * XXP2 + XXP3; p += 4; rem -= 4; }
+	  while(rem > 0){ h ^= (*p) * XXP5; h = xxRotl(h,11) * XXP1; p++; rem--; }
+	  //Final avalanche
+	  h ^= h >> 33; h *= XXP2;
+	  h ^= h >> 29; h *= XXP3;
+	  h ^= h >> 32;
+	  return h;
+	}
+private:
+	quint64 v1, v2, v3, v4, total;
+	uchar mem[32];
+	int memsize;
+
+	inline void stripe(const uchar *p){
+	  v1 = xxRound(v1, qFromLittleEndian<quint64>(p));
+	  v2 = xxRound(v2, qFromLittleEndian<quint64>(p+8));
+	  v3 = xxRound(v3, qFromLittleEndian<quint64>(p+16));
+	  v4 = xxRound(v4, qFromLittleEndian<quint64>(p+24));
+	}
+};
+
+// ==============
+//  LChecksums
+// ==============
+LChecksums::LChecksums(QObject *parent) : QObject(parent){
+  pool = new QThreadPool(this);
+  //Leave a bit of headroom for the GUI, but keep the disk busy
+  pool->setMaxThreadCount( qMax(2, QThread::idealThreadCount()) );
+}
+
+LChecksums::~LChecksums(){
+  cancel();
+  pool->waitForDone();
+}
+
+void LChecksums::start(QStringList files, HashType type){
+  stopped.store(0);
+  pending.fetchAndAddOrdered(files.length());
+  for(int i=0; i<files.length(); i++){
+    QtConcurrent::run(pool, this, &LChecksums::hashJob, files[i], type);
+  }
+  if(files.isEmpty()){ emit Finished(); }
+}
+
+void LChecksums::cancel(){
+  stopped.store(1); //queued jobs return right away, running ones stop at the next read
+}
+
+bool LChecksums::isRunning(){
+  return (pending.load() > 0);
+}
+
+QString LChecksums::hashFile(QString path, HashType type, QAtomicInt *stopflag){
+  QFile file(path);
+  if( !file.open(QIODevice::ReadOnly | QIODevice::Unbuffered) ){ return ""; }
+#ifdef POSIX_FADV_SEQUENTIAL
+  ::posix_fadvise(file.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  QCryptographicHash::Algorithm alg = QCryptographicHash::Md5;
+  if(type==SHA1){ alg = QCryptographicHash::Sha1; }
+  else if(type==SHA256){ alg = QCryptographicHash::Sha256; }
+  QCryptographicHash chash(alg);
+  XXH64State xxhash;
+  QByteArray buf(CHECKSUM_BUFSIZE, Qt::Uninitialized);
+  qint64 num = 0;
+  while( (num = file.read(buf.data(), buf.size())) > 0 ){
+    if(stopflag!=0 && stopflag->load()!=0){ return ""; }
+    if(type==XXH64){ xxhash.addData(buf.constData(), num); }
+    else{ chash.addData(buf.constData(), num); }
+  }
+  if(num<0){ return ""; } //read error
+  if(type==XXH64){ return QString::number(xxhash.result(), 16).rightJustified(16, '0'); }
+  return QString(chash.result().toHex());
+}
+
+QStringList LChecksums::hashFiles(QStringList paths, HashType type){
+  //Hash the files in parallel, but keep the output in the same order as the input
+  QThreadPool pool;
+  pool.setMaxThreadCount( qMax(2, QThread::idealThreadCount()) );
+  QList< QFuture<QString> > jobs;
+  for(int i=0; i<paths.length(); i++){
+    jobs << QtConcurrent::run(&pool, &LChecksums::hashFile, paths[i], type, (QAtomicInt*) 0);
+  }
+  QStringList out;
+  for(int i=0; i<jobs.length(); i++){ out << jobs[i].result(); }
+  return out;
+}
+
+QString LChecksums::typeName(HashType type){
+  switch(type){
+    case SHA1: return "SHA-1";
+    case SHA256: return "SHA-256";
+    case XXH64: return "XXH64";
+    default: return "MD5";
+  }
+}
+
+// === PRIVATE ===
+void LChecksums::hashJob(QString path, HashType type){
+  if(stopped.load()==0){
+    QString sum = hashFile(path, type, &stopped);
+    if(stopped.load()==0){ emit FileFinished(path, sum); }
+  }
+  if( !pending.deref() ){ emit Finished(); } //last job done
+}
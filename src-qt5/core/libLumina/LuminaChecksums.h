@@ -0,0 +1,56 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  This is the in-process file checksum service
+//    Files are read with large sequential reads and hashed on a thread pool,
+//    with the result for each file reported as soon as it is finished.
+//===========================================
+//EXAMPLE USAGE:
+//
+// LChecksums *sums = new LChecksums(this);
+// connect(sums, SIGNAL(FileFinished(QString, QString)), this, SLOT(<some slot>) ); //file path, checksum
+// connect(sums, SIGNAL(Finished()), this, SLOT(<some slot>) );
+// sums->start(files, LChecksums::SHA256);
+//===========================================
+#ifndef _LUMINA_LIBRARY_CHECKSUMS_H
+#define _LUMINA_LIBRARY_CHECKSUMS_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QAtomicInt>
+
+class LChecksums : public QObject{
+	Q_OBJECT
+public:
+	enum HashType{ MD5, SHA1, SHA256, XXH64 }; //XXH64 = fast non-cryptographic hash (xxHash, 64-bit)
+
+	LChecksums(QObject *parent = 0);
+	~LChecksums(); //cancels and waits for any running jobs
+
+	//Asynchronous checksums (results come through the FileFinished() signal, in completion order)
+	void start(QStringList files, HashType type = MD5);
+	void cancel();
+	bool isRunning();
+
+	//Synchronous routines
+	static QString hashFile(QString path, HashType type = MD5, QAtomicInt *stopflag = 0); //Returns: hex checksum (empty on error)
+	static QStringList hashFiles(QStringList paths, HashType type = MD5); //Returns: checksum of each file (same order) - files are hashed in parallel
+	static QString typeName(HashType type); //"MD5", "SHA-1", "SHA-256", "XXH64"
+
+private:
+	QThreadPool *pool;
+	QAtomicInt stopped, pending;
+
+	void hashJob(QString path, HashType type); //run on the pool
+
+signals:
+	void FileFinished(QString, QString); //file path, checksum (empty if the file could not be read)
+	void Finished(); //all files are done (or the operation was cancelled)
+};
+
+#endif
@@ -0,0 +1,512 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LuminaFileWatcher.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDebug>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+//Note: IN_MODIFY is not used - files get reported once they are closed after writing (IN_CLOSE_WRITE)
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO \
+	| IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK)
+#endif
+
+#define WATCH_DELAY 100 //default time to wait for more events (milliseconds)
+#define WATCH_MAXDELAY 4 //a continuous stream of events gets delivered after (WATCH_MAXDELAY * delay) at the latest
+
+static QString parentDir(QString path){
+  QString dir = path.section("/",0,-2);
+  return (dir.isEmpty() ? "/" : dir);
+}
+
+static QString childPath(QString dir, QString name){
+  return (dir.endsWith("/") ? dir+name : dir+"/"+name);
+}
+
+//===========================
+//  LFileWatcher
+//===========================
+LFileWatcher::LFileWatcher(QObject *parent) : QObject(parent){
+  service = LWatchService::instance();
+  pendingSince = 0;
+  timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setInterval(WATCH_DELAY);
+    connect(timer, SIGNAL(timeout()), this, SLOT(sendEvents()) );
+}
+
+LFileWatcher::~LFileWatcher(){
+  clear();
+}
+
+bool LFileWatcher::watchPath(QString path, bool recursive){
+  path = QDir::cleanPath(path);
+  if(path.isEmpty()){ return false; }
+  if(files.contains(path) || (roots.contains(path) && dirs.contains(path)) ){ return true; } //already watched
+  roots.remove(path); //root which went away (re-created directory)
+  if(QFileInfo(path).isDir()){
+    roots.insert(path, recursive);
+    if(recursive){ watchTree(path, path, false); }
+    else if(!dirs.contains(path) && service->watchDir(path, this)){ dirs.insert(path, path); }
+    if(!dirs.contains(path)){ roots.remove(path); return false; }
+  }else{
+    //Files (or paths which do not exist yet) are watched through the parent directory
+    if(!service->watchFile(path, this)){ return false; }
+    files.insert(path);
+  }
+  return true;
+}
+
+void LFileWatcher::unwatchPath(QString path){
+  path = QDir::cleanPath(path);
+  if(files.remove(path)){ service->unwatchFile(path, this); }
+  roots.remove(path);
+  QStringList keys = dirs.keys(path); //all directories which belong to this watch
+  for(int i=0; i<keys.length(); i++){
+    service->unwatchDir(keys[i], this);
+    dirs.remove(keys[i]);
+  }
+}
+
+void LFileWatcher::clear(){
+  QStringList list = files.toList();
+  for(int i=0; i<list.length(); i++){ service->unwatchFile(list[i], this); }
+  list = dirs.keys();
+  for(int i=0; i<list.length(); i++){ service->unwatchDir(list[i], this); }
+  files.clear(); roots.clear(); dirs.clear();
+  pchanged.clear(); premoved.clear(); ptouched.clear(); prescan.clear(); pmoves.clear();
+  timer->stop();
+}
+
+QStringList LFileWatcher::paths(){
+  return (files.toList() + roots.keys());
+}
+
+void LFileWatcher::setDelay(int ms){
+  timer->setInterval(qMax(ms, 0));
+}
+
+// === PRIVATE ===
+bool LFileWatcher::covers(QString path, QString dir){
+  return (dirs.contains(dir) || files.contains(path));
+}
+
+void LFileWatcher::touch(QString path, QString dir){
+  if(files.contains(path)){ ptouched.insert(path); }
+  if(dirs.contains(dir)){ ptouched.insert(dirs.value(dir)); }
+}
+
+void LFileWatcher::watchTree(QString dir, QString root, bool reportContents){
+  QStringList found; found << dir;
+  QDirIterator it(dir, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+  while(it.hasNext()){ found << it.next(); }
+  for(int i=0; i<found.length(); i++){
+    if(!dirs.contains(found[i]) && service->watchDir(found[i], this)){ dirs.insert(found[i], root); }
+    if(reportContents){
+      //New directory: anything created before the watch was added did not generate an event
+      QStringList items = QDir(found[i]).entryList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDir::NoSort);
+      for(int j=0; j<items.length(); j++){ pchanged.insert( childPath(found[i], items[j]) ); }
+    }
+  }
+}
+
+void LFileWatcher::unwatchTree(QString dir){
+  QStringList keys = dirs.keys();
+  for(int i=0; i<keys.length(); i++){
+    if(keys[i]==dir || keys[i].startsWith(dir+"/")){
+      service->unwatchDir(keys[i], this);
+      dirs.remove(keys[i]);
+    }
+  }
+  //Watched roots within the removed tree are gone too (a re-created directory needs a new watchPath())
+  keys = roots.keys();
+  for(int i=0; i<keys.length(); i++){
+    if(keys[i]==dir || keys[i].startsWith(dir+"/")){ roots.remove(keys[i]); }
+  }
+}
+
+void LFileWatcher::startTimer(){
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if(!timer->isActive()){ pendingSince = now; timer->start(); }
+  else if(now-pendingSince < WATCH_MAXDELAY*timer->interval()){ timer->start(); } //wait for the burst to settle down
+}
+
+void LFileWatcher::addEvent(QString path, QString dir, bool removed, bool isdir){
+  if(!covers(path, dir)){ return; }
+  touch(path, dir);
+  if(removed){
+    pchanged.remove(path);
+    premoved.insert(path);
+    if(isdir){ unwatchTree(path); }
+  }else{
+    premoved.remove(path);
+    pchanged.insert(path);
+    if(isdir && !dirs.contains(path) && dirs.contains(dir) && roots.value(dirs.value(dir)) ){
+      watchTree(path, dirs.value(dir), true); //new sub-directory within a recursive watch
+    }
+  }
+  startTimer();
+}
+
+void LFileWatcher::addMove(QString from, QString fromDir, QString to, QString toDir, bool isdir){
+  bool seeFrom = covers(from, fromDir);
+  bool seeTo = covers(to, toDir);
+  if(seeFrom && seeTo){
+    touch(from, fromDir);
+    touch(to, toDir);
+    pmoves << qMakePair(from, to);
+    if(pchanged.remove(from)){ pchanged.insert(to); } //pending change follows the item
+    premoved.remove(to);
+    if(isdir){
+      unwatchTree(from);
+      if(dirs.contains(toDir) && roots.value(dirs.value(toDir)) ){ watchTree(to, dirs.value(toDir), false); }
+    }
+    startTimer();
+  }else if(seeFrom){
+    addEvent(from, fromDir, true, isdir); //moved out of the watched paths
+  }else if(seeTo){
+    addEvent(to, toDir, false, isdir); //moved in from somewhere else
+  }
+}
+
+void LFileWatcher::dirGone(QString dir){
+  dirs.remove(dir);
+  //Watched files in this directory lost their watch as well
+  QStringList list = files.toList();
+  for(int i=0; i<list.length(); i++){
+    if(parentDir(list[i])==dir){
+      files.remove(list[i]);
+      service->unwatchFile(list[i], this);
+    }
+  }
+  if(roots.remove(dir)>0){
+    //Watched root went away (deleted/moved/unmounted): drop what is left of it, so paths() does not list it
+    QStringList keys = dirs.keys(dir);
+    for(int i=0; i<keys.length(); i++){
+      service->unwatchDir(keys[i], this);
+      dirs.remove(keys[i]);
+    }
+  }
+}
+
+void LFileWatcher::rescan(){
+  //Events were lost: pick up any new sub-directories, and have everything re-loaded
+  QStringList keys = roots.keys();
+  for(int i=0; i<keys.length(); i++){
+    if(roots.value(keys[i])){ watchTree(keys[i], keys[i], false); }
+    else if(!dirs.contains(keys[i]) && service->watchDir(keys[i], this)){ dirs.insert(keys[i], keys[i]); }
+    prescan.insert(keys[i]);
+    ptouched.insert(keys[i]);
+  }
+  QStringList list = files.toList();
+  for(int i=0; i<list.length(); i++){ prescan.insert(list[i]); ptouched.insert(list[i]); }
+  startTimer();
+}
+
+// === PRIVATE SLOTS ===
+void LFileWatcher::sendEvents(){
+  QStringList rescans = prescan.toList();
+  QList< QPair<QString, QString> > moves = pmoves;
+  QStringList removed = premoved.toList();
+  QStringList changed = pchanged.toList();
+  QStringList touched = ptouched.toList();
+  prescan.clear(); pmoves.clear(); premoved.clear(); pchanged.clear(); ptouched.clear();
+  for(int i=0; i<rescans.length(); i++){ emit RescanNeeded(rescans[i]); }
+  for(int i=0; i<moves.length(); i++){ emit ItemMoved(moves[i].first, moves[i].second); }
+  if(!removed.isEmpty()){ emit ItemsRemoved(removed); }
+  if(!changed.isEmpty()){ emit ItemsChanged(changed); }
+  for(int i=0; i<touched.length(); i++){ emit PathChanged(touched[i]); }
+}
+
+//===========================
+//  LWatchService
+//===========================
+LWatchService* LWatchService::instance(){
+  static LWatchService *service = 0;
+  if(service==0){ service = new LWatchService(); }
+  return service;
+}
+
+LWatchService::LWatchService() : QObject(){
+  notifier = 0;
+  fsw = 0;
+  nextWD = 1;
+  warned = false;
+#ifdef __linux__
+  fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#else
+  fd = -1;
+#endif
+  if(fd>=0){
+    notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(notifier, SIGNAL(activated(int)), this, SLOT(readEvents()) );
+  }else{
+    fsw = new QFileSystemWatcher(this);
+    connect(fsw, SIGNAL(directoryChanged(const QString&)), this, SLOT(fswDirChanged(QString)) );
+    connect(fsw, SIGNAL(fileChanged(const QString&)), this, SLOT(fswFileChanged(QString)) );
+  }
+}
+
+LWatchService::~LWatchService(){
+  if(fd>=0){ ::close(fd); }
+}
+
+bool LWatchService::watchDir(QString dir, LFileWatcher *sub){
+  int wd = pathWD.value(dir, -1);
+  if(wd<0){
+    wd = addWatch(dir);
+    if(wd<0){ return false; }
+    pathWD.insert(dir, wd);
+  }
+  watches[wd].users[sub]++;
+  watches[wd].paths[dir]++;
+  return true;
+}
+
+void LWatchService::unwatchDir(QString dir, LFileWatcher *sub){
+  int wd = pathWD.value(dir, -1);
+  if(wd<0 || !watches[wd].users.contains(sub)){ return; }
+  Watch &W = watches[wd];
+  W.users[sub]--;
+  if(W.users.value(sub)<=0){ W.users.remove(sub); }
+  W.paths[dir]--;
+  if(W.paths.value(dir)<=0){
+    //Nobody watches the directory under this path anymore
+    W.paths.remove(dir);
+    pathWD.remove(dir);
+    if(W.path==dir && !W.paths.isEmpty()){ W.path = W.paths.keys().first(); }
+  }
+  if(W.users.isEmpty()){ dropWatch(wd, true); }
+}
+
+bool LWatchService::watchFile(QString file, LFileWatcher *sub){
+  if(!watchDir(parentDir(file), sub)){ return false; }
+  if(fsw!=0){
+    //Fallback: directory changes do not cover modifications of the file contents
+    if(fileUsers.value(file,0)==0 && QFile::exists(file)){ fsw->addPath(file); }
+    fileUsers[file]++;
+  }
+  return true;
+}
+
+void LWatchService::unwatchFile(QString file, LFileWatcher *sub){
+  unwatchDir(parentDir(file), sub);
+  if(fsw!=0 && fileUsers.contains(file)){
+    fileUsers[file]--;
+    if(fileUsers.value(file)<=0){ fileUsers.remove(file); fsw->removePath(file); }
+  }
+}
+
+// === PRIVATE ===
+int LWatchService::addWatch(QString dir){
+#ifdef __linux__
+  if(fd>=0){
+    int wd = inotify_add_watch(fd, QFile::encodeName(dir).constData(), WATCH_MASK);
+    if(wd<0){
+      if(errno==ENOSPC && !warned){ qWarning() << "Inotify watch limit reached (fs.inotify.max_user_watches) - not watching:" << dir; warned = true; }
+      return -1;
+    }
+    //The same directory can show up under another path (moved/linked): events get reported under every path
+    if(!watches.contains(wd)){ watches.insert(wd, Watch()); }
+    watches[wd].path = dir;
+    struct stat st;
+    watches[wd].inode = (::stat(QFile::encodeName(dir).constData(), &st)==0 ? (quint64) st.st_ino : 0);
+    return wd;
+  }
+#endif
+  if(fsw==0 || !QFileInfo(dir).isDir() || !fsw->addPath(dir) ){ return -1; }
+  int wd = nextWD;
+  nextWD++;
+  Watch W;
+    W.path = dir;
+    W.inode = 0;
+    W.snap = snapshot(dir);
+  watches.insert(wd, W);
+  return wd;
+}
+
+void LWatchService::dropWatch(int wd, bool rmwatch){
+  if(!watches.contains(wd)){ return; }
+  if(rmwatch){
+#ifdef __linux__
+    if(fd>=0){ inotify_rm_watch(fd, wd); }
+#endif
+    if(fsw!=0){ fsw->removePath(watches[wd].path); }
+  }
+  QStringList keys = watches[wd].paths.keys();
+  for(int i=0; i<keys.length(); i++){ pathWD.remove(keys[i]); }
+  watches.remove(wd);
+}
+
+void LWatchService::dispatch(int wd, QString name, bool removed, bool isdir){
+  if(!watches.contains(wd)){ return; }
+  //Watchers might add/remove directories while handling the event - work from a copy of the lists
+  //  (the event goes out under every path of the directory - each watcher only picks up the paths it watches)
+  QStringList dirs = watches[wd].paths.keys();
+  QList<LFileWatcher*> subs = watches[wd].users.keys();
+  for(int d=0; d<dirs.length(); d++){
+    QString path = (name.isEmpty() ? dirs[d] : childPath(dirs[d], name));
+    for(int i=0; i<subs.length(); i++){ subs[i]->addEvent(path, dirs[d], removed, isdir); }
+  }
+}
+
+QHash<QString, qint64> LWatchService::snapshot(QString dir){
+  QHash<QString, qint64> out;
+  QFileInfoList list = QDir(dir).entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDir::NoSort);
+  for(int i=0; i<list.length(); i++){
+    out.insert(list[i].fileName(), (qint64) ((quint64) list[i].lastModified().toMSecsSinceEpoch()*31 + (quint64) list[i].size()) );
+  }
+  return out;
+}
+
+// === PRIVATE SLOTS ===
+#ifdef __linux__
+struct LWatchMove{
+  QString name;
+  QStringList dirs; //paths of the source directory
+  bool isdir;
+  int wd;
+};
+#endif
+
+void LWatchService::readEvents(){
+#ifdef __linux__
+  char buf[64*1024] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  QHash<quint32, LWatchMove> moves; //cookie -> IN_MOVED_FROM event waiting for the IN_MOVED_TO half
+  bool overflow = false;
+  while(true){
+    ssize_t len = ::read(fd, buf, sizeof(buf));
+    if(len<=0){ break; } //queue empty (EAGAIN)
+    for(char *ptr = buf; ptr < buf+len; ){
+      const struct inotify_event *ev = (const struct inotify_event*) ptr;
+      ptr += sizeof(struct inotify_event) + ev->len;
+      if(ev->mask & IN_Q_OVERFLOW){ overflow = true; continue; }
+      if(!watches.contains(ev->wd)){ continue; } //removed in the meantime
+      QString dir = watches[ev->wd].path;
+      QStringList dirs = watches[ev->wd].paths.keys();
+      dirs.sort();
+      if(ev->mask & IN_IGNORED){
+        //Watch removed by the kernel (directory deleted, or the filesystem got unmounted)
+        QList<LFileWatcher*> subs = watches[ev->wd].users.keys();
+        dropWatch(ev->wd, false);
+        for(int i=0; i<subs.length(); i++){
+          for(int d=0; d<dirs.length(); d++){ subs[i]->dirGone(dirs[d]); }
+        }
+        continue;
+      }
+      if(ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)){
+        if(ev->mask & IN_MOVE_SELF){
+          //Moved within the watched paths: the watch was already re-assigned to the new path
+          struct stat st;
+          if(::stat(QFile::encodeName(dir).constData(), &st)==0 && (quint64) st.st_ino==watches[ev->wd].inode){ continue; }
+        }
+        dispatch(ev->wd, "", true, true);
+        if( (ev->mask & IN_MOVE_SELF) && watches.contains(ev->wd) ){
+          //Events for this watch would use the old path now - drop it
+          QList<LFileWatcher*> subs = watches[ev->wd].users.keys();
+          dropWatch(ev->wd, true);
+          for(int i=0; i<subs.length(); i++){
+            for(int d=0; d<dirs.length(); d++){ subs[i]->dirGone(dirs[d]); }
+          }
+        }
+        continue;
+      }
+      if(ev->len==0){ continue; } //other events for the directory itself (attributes)
+      QString name = QFile::decodeName(ev->name);
+      bool isdir = (ev->mask & IN_ISDIR);
+      if(ev->mask & IN_MOVED_FROM){
+        LWatchMove M;
+          M.name = name; M.dirs = dirs; M.isdir = isdir; M.wd = ev->wd;
+        moves.insert(ev->cookie, M);
+      }else if( (ev->mask & IN_MOVED_TO) && moves.contains(ev->cookie) ){
+        //Rename pair: every watcher which can see either side gets the move
+        LWatchMove M = moves.take(ev->cookie);
+        QSet<LFileWatcher*> subs = watches[ev->wd].users.keys().toSet();
+        if(watches.contains(M.wd)){ subs.unite( watches[M.wd].users.keys().toSet() ); }
+        QList<LFileWatcher*> list = subs.toList();
+        for(int i=0; i<list.length(); i++){
+          //Use the paths this watcher knows the two directories by (first path when it only sees one side)
+          QStringList from, to;
+          for(int d=0; d<M.dirs.length(); d++){
+            if(list[i]->covers(childPath(M.dirs[d], M.name), M.dirs[d])){ from << M.dirs[d]; }
+          }
+          for(int d=0; d<dirs.length(); d++){
+            if(list[i]->covers(childPath(dirs[d], name), dirs[d])){ to << dirs[d]; }
+          }
+          if(from.isEmpty() && !M.dirs.isEmpty()){ from << M.dirs.first(); }
+          if(to.isEmpty() && !dirs.isEmpty()){ to << dirs.first(); }
+          for(int p=0; p<qMin(from.length(), to.length()); p++){
+            list[i]->addMove(childPath(from[p], M.name), from[p], childPath(to[p], name), to[p], isdir);
+          }
+        }
+      }else{
+        dispatch(ev->wd, name, (ev->mask & IN_DELETE), isdir);
+      }
+    }
+  }
+  //Moved out of the watched directories (no IN_MOVED_TO half)
+  QHash<quint32, LWatchMove>::const_iterator it;
+  for(it = moves.constBegin(); it!=moves.constEnd(); ++it){
+    dispatch(it.value().wd, it.value().name, true, it.value().isdir);
+  }
+  if(overflow){
+    qWarning() << "Inotify event queue overflow - re-scanning all watched paths";
+    QSet<LFileWatcher*> subs;
+    QHash<int, Watch>::const_iterator wit;
+    for(wit = watches.constBegin(); wit!=watches.constEnd(); ++wit){ subs.unite( wit.value().users.keys().toSet() ); }
+    QList<LFileWatcher*> list = subs.toList();
+    for(int i=0; i<list.length(); i++){ list[i]->rescan(); }
+  }
+#endif
+}
+
+void LWatchService::fswDirChanged(QString dir){
+  int wd = pathWD.value(dir, -1);
+  if(wd<0){ return; }
+  if(!QFileInfo(dir).isDir()){
+    //Directory removed
+    dispatch(wd, "", true, true);
+    if(watches.contains(wd)){
+      QList<LFileWatcher*> subs = watches[wd].users.keys();
+      dropWatch(wd, true);
+      for(int i=0; i<subs.length(); i++){ subs[i]->dirGone(dir); }
+    }
+    return;
+  }
+  //Compare the contents with the last snapshot
+  QHash<QString, qint64> snap = snapshot(dir);
+  QHash<QString, qint64> old = watches[wd].snap;
+  watches[wd].snap = snap;
+  QHash<QString, qint64>::const_iterator it;
+  for(it = old.constBegin(); it!=old.constEnd(); ++it){
+    if(snap.contains(it.key())){ continue; }
+    dispatch(wd, it.key(), true, pathWD.contains(childPath(dir, it.key())) );
+  }
+  for(it = snap.constBegin(); it!=snap.constEnd(); ++it){
+    if(old.contains(it.key()) && old.value(it.key())==it.value()){ continue; }
+    QString path = childPath(dir, it.key());
+    if(fileUsers.contains(path) && !fsw->files().contains(path)){ fsw->addPath(path); } //watched file re-created
+    dispatch(wd, it.key(), false, QFileInfo(path).isDir());
+  }
+}
+
+void LWatchService::fswFileChanged(QString file){
+  int wd = pathWD.value(parentDir(file), -1);
+  if(wd<0){ return; }
+  bool removed = !QFile::exists(file);
+  if(!removed && !fsw->files().contains(file)){ fsw->addPath(file); } //replaced by a new file
+  dispatch(wd, file.section("/",-1), removed, false);
+}
@@ -0,0 +1,134 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Shared file monitoring service (replacement for per-path QFileSystemWatcher instances)
+//    All the watchers in an application share a single inotify descriptor (Linux), and
+//    kernel watches are only placed on directories (reference-counted between watchers):
+//    - watching a file watches its parent directory (the events get filtered by name), so
+//       files which get replaced (write to a temporary file + rename) stay watched
+//    - directories can be watched recursively (new sub-directories get picked up automatically)
+//    - rename pairs (IN_MOVED_FROM/IN_MOVED_TO) are reported as a single move
+//    - events are coalesced per watcher, and delivered after a short delay (setDelay())
+//    - if the kernel event queue overflows, every watcher gets asked to re-scan its paths
+//  Other systems use a single QFileSystemWatcher on the directories, with a snapshot of
+//    the contents to find the items which changed (no move detection).
+//===========================================
+//EXAMPLE USAGE:
+//
+// LFileWatcher *watcher = new LFileWatcher(this);
+// connect(watcher, SIGNAL(PathChanged(QString)), this, SLOT(<some slot>) ); //any change for a watched path
+// connect(watcher, SIGNAL(ItemsChanged(QStringList)), this, SLOT(<some slot>) ); //created/modified items
+// watcher->watchPath("/some/file");
+// watcher->watchPath("/some/directory", true); //recursive
+//===========================================
+#ifndef _LUMINA_LIBRARY_FILE_WATCHER_H
+#define _LUMINA_LIBRARY_FILE_WATCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QPair>
+#include <QTimer>
+#include <QSocketNotifier>
+#include <QFileSystemWatcher>
+
+class LWatchService;
+
+class LFileWatcher : public QObject{
+	Q_OBJECT
+public:
+	LFileWatcher(QObject *parent = 0);
+	~LFileWatcher();
+
+	//Watch a file, or the contents of a directory (returns false if the path could not be watched)
+	bool watchPath(QString path, bool recursive = false);
+	void unwatchPath(QString path);
+	void clear();
+	QStringList paths(); //all watched files/directories (not including sub-directories of recursive watches)
+
+	void setDelay(int ms); //Time to wait for more events before notifying (default: 100ms)
+
+private:
+	LWatchService *service;
+	QSet<QString> files; //watched files
+	QHash<QString, bool> roots; //watched directories (recursive flag)
+	QHash<QString, QString> dirs; //every watched directory (including sub-directories) -> watched root
+	//Pending notifications
+	QSet<QString> pchanged, premoved, ptouched, prescan;
+	QList< QPair<QString, QString> > pmoves;
+	QTimer *timer;
+	qint64 pendingSince;
+
+	bool covers(QString path, QString dir);
+	void touch(QString path, QString dir);
+	void watchTree(QString dir, QString root, bool reportContents);
+	void unwatchTree(QString dir);
+	void startTimer();
+
+	//Event input from the watch service
+	friend class LWatchService;
+	void addEvent(QString path, QString dir, bool removed, bool isdir);
+	void addMove(QString from, QString fromDir, QString to, QString toDir, bool isdir);
+	void dirGone(QString dir);
+	void rescan();
+
+private slots:
+	void sendEvents();
+
+signals:
+	void PathChanged(QString); //watched file or directory changed (or anything inside a watched directory)
+	void ItemsChanged(QStringList); //created or modified items
+	void ItemsRemoved(QStringList); //removed items
+	void ItemMoved(QString, QString); //renamed item (from, to)
+	void RescanNeeded(QString); //events were lost: everything under this watched path needs to be re-loaded
+};
+
+//Internal: the shared event source (one per application)
+class LWatchService : public QObject{
+	Q_OBJECT
+public:
+	static LWatchService* instance(); //created on first use (never deleted)
+
+	bool watchDir(QString dir, LFileWatcher *sub);
+	void unwatchDir(QString dir, LFileWatcher *sub);
+	bool watchFile(QString file, LFileWatcher *sub);
+	void unwatchFile(QString file, LFileWatcher *sub);
+
+private:
+	LWatchService();
+	~LWatchService();
+
+	struct Watch{
+	  QString path; //newest path (used to validate the watch after a move)
+	  QHash<QString, int> paths; //every path the directory is watched under (moved/linked) -> reference count
+	  QHash<LFileWatcher*, int> users; //watcher -> reference count
+	  quint64 inode; //used to validate the path after a move (Linux)
+	  QHash<QString, qint64> snap; //directory contents (fallback backend): name -> modification stamp
+	};
+	QHash<int, Watch> watches; //watch descriptor -> info
+	QHash<QString, int> pathWD; //directory -> watch descriptor (several paths are possible for moved/linked directories)
+	QHash<QString, int> fileUsers; //watched files (fallback backend only)
+	int fd; //inotify descriptor (-1: using the fallback)
+	QSocketNotifier *notifier;
+	QFileSystemWatcher *fsw;
+	int nextWD; //fallback backend
+	bool warned;
+
+	int addWatch(QString dir);
+	void dropWatch(int wd, bool rmwatch);
+	void dispatch(int wd, QString name, bool removed, bool isdir); //empty name: the directory itself
+	QHash<QString, qint64> snapshot(QString dir);
+
+private slots:
+	void readEvents(); //inotify
+	void fswDirChanged(QString); //fallback
+	void fswFileChanged(QString); //fallback
+};
+
+#endif
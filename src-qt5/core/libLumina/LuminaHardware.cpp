@@ -0,0 +1,232 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LuminaHardware.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QX11Info>
+#include <QDebug>
+
+#include <xcb/xcb.h>
+#include <xcb/randr.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#ifdef HAVE_ALSA
+#include <alsa/asoundlib.h>
+#elif defined(__FreeBSD__) || defined(__DragonFly__)
+#define HAVE_OSS
+#include <sys/soundcard.h>
+#endif
+
+// ===================
+//  AUDIO (internal)
+// ===================
+#ifdef HAVE_ALSA
+static snd_mixer_t *alsaMixer = 0;
+static snd_mixer_elem_t *alsaElem = 0;
+static bool alsaFailed = false;
+
+static bool openMixer(){
+  if(alsaElem!=0){
+    snd_mixer_handle_events(alsaMixer); //pick up any changes made by other programs
+    return true;
+  }
+  if(alsaFailed){ return false; }
+  alsaFailed = true; //only try to open the mixer once
+  if(snd_mixer_open(&alsaMixer, 0) < 0){ alsaMixer = 0; return false; }
+  if(snd_mixer_attach(alsaMixer, "default") < 0 || snd_mixer_selem_register(alsaMixer, NULL, NULL) < 0 || snd_mixer_load(alsaMixer) < 0){
+    snd_mixer_close(alsaMixer); alsaMixer = 0;
+    return false;
+  }
+  snd_mixer_selem_id_t *sid;
+  snd_mixer_selem_id_alloca(&sid);
+  snd_mixer_selem_id_set_index(sid, 0);
+  snd_mixer_selem_id_set_name(sid, "Master");
+  alsaElem = snd_mixer_find_selem(alsaMixer, sid);
+  if(alsaElem==0 || !snd_mixer_selem_has_playback_volume(alsaElem)){
+    alsaElem = 0;
+    snd_mixer_close(alsaMixer); alsaMixer = 0;
+    return false;
+  }
+  alsaFailed = false;
+  return true;
+}
+#endif
+
+#ifdef HAVE_OSS
+static int ossMixer = -1;
+static bool ossFailed = false;
+
+static bool openMixer(){
+  if(ossMixer>=0){ return true; }
+  if(ossFailed){ return false; }
+  ossMixer = ::open("/dev/mixer", O_RDWR | O_CLOEXEC);
+  if(ossMixer<0){ ossFailed = true; return false; }
+  return true;
+}
+#endif
+
+bool LHardware::hasNativeAudio(){
+#if defined(HAVE_ALSA) || defined(HAVE_OSS)
+  return openMixer();
+#else
+  return false;
+#endif
+}
+
+int LHardware::audioVolume(){
+#ifdef HAVE_ALSA
+  if(!openMixer()){ return -1; }
+  long min, max, val;
+  snd_mixer_selem_get_playback_volume_range(alsaElem, &min, &max);
+  if(max<=min){ return -1; }
+  if(snd_mixer_selem_get_playback_volume(alsaElem, SND_MIXER_SCHN_FRONT_LEFT, &val) < 0){ return -1; }
+  return qRound( (val-min)*100.0/(max-min) );
+#elif defined(HAVE_OSS)
+  if(!openMixer()){ return -1; }
+  int val = 0;
+  if( ::ioctl(ossMixer, SOUND_MIXER_READ_VOLUME, &val) < 0){ return -1; }
+  //Left channel in the low byte, right channel in the next byte
+  return qMax(val & 0x7F, (val >> 8) & 0x7F);
+#else
+  return -1;
+#endif
+}
+
+bool LHardware::setAudioVolume(int percent){
+  if(percent<0){ percent = 0; }
+  else if(percent>100){ percent = 100; }
+#ifdef HAVE_ALSA
+  if(!openMixer()){ return false; }
+  long min, max;
+  snd_mixer_selem_get_playback_volume_range(alsaElem, &min, &max);
+  if(max<=min){ return false; }
+  return (snd_mixer_selem_set_playback_volume_all(alsaElem, min + qRound( (max-min)*percent/100.0) ) >= 0);
+#elif defined(HAVE_OSS)
+  if(!openMixer()){ return false; }
+  int val = percent | (percent << 8);
+  return (::ioctl(ossMixer, SOUND_MIXER_WRITE_VOLUME, &val) >= 0);
+#else
+  return false;
+#endif
+}
+
+// ===================
+//  BACKLIGHT (internal)
+// ===================
+static bool blChecked = false;
+static QString blSysDir; //sysfs device directory
+static int blSysMax = 0;
+static xcb_randr_output_t blOutput = 0; //XRandR output with a backlight property
+static xcb_atom_t blAtom = 0;
+static int blMin = 0, blMax = 0;
+
+static void findBacklight(){
+  if(blChecked){ return; }
+  blChecked = true;
+  //Linux sysfs interface first (only usable if the user can write to it - udev/group rules)
+  QDir dir("/sys/class/backlight");
+  QStringList devs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+  for(int i=0; i<devs.length(); i++){
+    QString path = dir.absoluteFilePath(devs[i]);
+    if( !QFileInfo(path+"/brightness").isWritable() ){ continue; }
+    QFile file(path+"/max_brightness");
+    if( !file.open(QIODevice::ReadOnly) ){ continue; }
+    int max = QString(file.readAll()).simplified().toInt();
+    file.close();
+    if(max>0){ blSysDir = path; blSysMax = max; return; }
+  }
+  //XRandR output property (same interface as the xbacklight utility)
+  xcb_connection_t *conn = QX11Info::connection();
+  if(conn==0){ return; }
+  const char *names[2] = {"Backlight", "BACKLIGHT"};
+  for(int n=0; n<2 && blOutput==0; n++){
+    xcb_intern_atom_reply_t *areply = xcb_intern_atom_reply(conn, xcb_intern_atom(conn, 1, strlen(names[n]), names[n]), NULL);
+    if(areply==0){ continue; }
+    xcb_atom_t atom = areply->atom;
+    free(areply);
+    if(atom==XCB_ATOM_NONE){ continue; }
+    xcb_randr_get_screen_resources_current_reply_t *res = xcb_randr_get_screen_resources_current_reply(conn, \
+		xcb_randr_get_screen_resources_current(conn, QX11Info::appRootWindow()), NULL);
+    if(res==0){ return; }
+    xcb_randr_output_t *outputs = xcb_randr_get_screen_resources_current_outputs(res);
+    int num = xcb_randr_get_screen_resources_current_outputs_length(res);
+    for(int i=0; i<num && blOutput==0; i++){
+      xcb_randr_query_output_property_reply_t *prop = xcb_randr_query_output_property_reply(conn, \
+		xcb_randr_query_output_property(conn, outputs[i], atom), NULL);
+      if(prop==0){ continue; }
+      if(prop->range && xcb_randr_query_output_property_valid_values_length(prop)==2){
+        int32_t *range = xcb_randr_query_output_property_valid_values(prop);
+        if(range[1]>range[0]){
+          blOutput = outputs[i]; blAtom = atom;
+          blMin = range[0]; blMax = range[1];
+        }
+      }
+      free(prop);
+    }
+    free(res);
+  }
+}
+
+bool LHardware::hasNativeBacklight(){
+  findBacklight();
+  return (!blSysDir.isEmpty() || blOutput!=0);
+}
+
+QString LHardware::backlightInterface(){
+  findBacklight();
+  if(!blSysDir.isEmpty()){ return "sysfs"; }
+  else if(blOutput!=0){ return "xrandr"; }
+  return "";
+}
+
+int LHardware::backlight(){
+  findBacklight();
+  if(!blSysDir.isEmpty()){
+    QFile file(blSysDir+"/brightness");
+    if( !file.open(QIODevice::ReadOnly) ){ return -1; }
+    int val = QString(file.readAll()).simplified().toInt();
+    return qRound(val*100.0/blSysMax);
+  }else if(blOutput!=0){
+    xcb_connection_t *conn = QX11Info::connection();
+    xcb_randr_get_output_property_reply_t *reply = xcb_randr_get_output_property_reply(conn, \
+		xcb_randr_get_output_property(conn, blOutput, blAtom, XCB_ATOM_NONE, 0, 4, 0, 0), NULL);
+    if(reply==0){ return -1; }
+    int val = -1;
+    if(reply->type==XCB_ATOM_INTEGER && reply->num_items==1 && reply->format==32){
+      val = *( (int32_t*) xcb_randr_get_output_property_data(reply) );
+      val = qRound( (val-blMin)*100.0/(blMax-blMin) );
+    }
+    free(reply);
+    return val;
+  }
+  return -1;
+}
+
+bool LHardware::setBacklight(int percent){
+  if(percent<0){ percent = 0; }
+  else if(percent>100){ percent = 100; }
+  findBacklight();
+  if(!blSysDir.isEmpty()){
+    QFile file(blSysDir+"/brightness");
+    if( !file.open(QIODevice::WriteOnly) ){ return false; }
+    return (file.write( QByteArray::number( qRound(blSysMax*percent/100.0) ) ) > 0);
+  }else if(blOutput!=0){
+    xcb_connection_t *conn = QX11Info::connection();
+    int32_t val = blMin + qRound( (blMax-blMin)*percent/100.0 );
+    xcb_randr_change_output_property(conn, blOutput, blAtom, XCB_ATOM_INTEGER, 32, XCB_PROP_MODE_REPLACE, 1, (unsigned char*) &val);
+    xcb_flush(conn);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,34 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Native (in-process) access to the audio mixer and screen backlight
+//  These do not run any external utilities, and return -1/false when
+//    no native interface is available (use the LOS:: functions as the fallback)
+//  Backends:
+//    Audio: ALSA simple-mixer "Master" control (Linux, if built with alsa) or the OSS mixer ioctl (FreeBSD/DragonFly)
+//    Backlight: /sys/class/backlight (Linux, if writable) or the XRandR "Backlight" output property
+//  NOTE: Not thread-safe - only use these from one thread (the device handles are kept open between calls)
+//===========================================
+#ifndef _LUMINA_LIBRARY_HARDWARE_H
+#define _LUMINA_LIBRARY_HARDWARE_H
+
+#include <QString>
+
+class LHardware{
+public:
+	//Audio Volume
+	static bool hasNativeAudio();
+	static int audioVolume(); //Returns: audio volume as a percentage (0-100, -1 if not available)
+	static bool setAudioVolume(int percent);
+
+	//Screen Backlight
+	static bool hasNativeBacklight();
+	static int backlight(); //Returns: backlight level as a percentage (0-100, -1 if not available)
+	static bool setBacklight(int percent);
+	static QString backlightInterface(); //"sysfs", "xrandr", or empty if not available
+};
+
+#endif
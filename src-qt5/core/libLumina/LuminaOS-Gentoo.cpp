@@ -228,16 +228,7 @@ int LOS::batterySecondsLeft(){ //Returns: estimated number of seconds remaining
 
 //File Checksums
 QStringList LOS::Checksums(QStringList filepaths){ //Return: checksum of the input file
-  QStringList info = LUtils::getCmdOutput("md5sum \""+filepaths.join("\" \"")+"\"");
-  for(int i=0; i<info.length(); i++){
-    // first: md5sum: = error ; second: there's always one empty entry generated by getCmdOutput
-    if( info[i].startsWith("md5sum:") || info[i].isEmpty()){ info.removeAt(i); i--; }
-    else{
-      //Strip out the extra information
-      info[i] = info[i].section(" ",0,0);
-    }
-  }
- return info;
+  return LChecksums::hashFiles(filepaths, LChecksums::MD5); //in-process (parallel) MD5 sums
 }
 
 //file system capacity
@@ -132,20 +132,7 @@ int LOS::batterySecondsLeft(){ //Returns: estimated number of seconds remaining
 
 //File Checksums
 QStringList LOS::Checksums(QStringList filepaths){ //Return: checksum of the input file
-  //on NetBSD md5(1) has the following layout
-  //$ md5 DESCR Makefile
-  //MD5 (DESCR) = 6aaa128cf0466792be6f6d15e4589dfb
-  //MD5 (Makefile) = 4787f3145bba2a3cc393cdd812c5d18b
-
-  QStringList info = LUtils::getCmdOutput("md5 \""+filepaths.join("\" \"")+"\"");
-  for(int i=0; i<info.length(); i++){
-    if( !info[i].contains(" = ") ){ info.removeAt(i); i--; }
-    else{
-      //Strip out the extra information
-      info[i] = info[i].section(" = ",1,1);
-    }
-  }
-  return info;
+  return LChecksums::hashFiles(filepaths, LChecksums::MD5); //in-process (parallel) MD5 sums
 }
 
 //file system capacity
@@ -19,6 +19,7 @@
 #include <QObject>
 
 #include "LuminaUtils.h"
+#include "LuminaChecksums.h"
 
 class LOS{
 public:
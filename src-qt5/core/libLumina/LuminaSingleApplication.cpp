@@ -12,16 +12,17 @@
 #include <QX11Info>
 
 #include <unistd.h> //for getlogin()
+#include <stdlib.h>
+
+#define INPUT_SEPARATOR "::::" //between the inputs in a forwarded message
 
 LSingleApplication::LSingleApplication(int &argc, char **argv, QString appname) : QApplication(argc, argv){
   //Load the proper translation systems
   if(appname!="lumina-desktop"){ cTrans = LUtils::LoadTranslation(this, appname); }//save the translator for later
   //Initialize a couple convenience internal variables
-  cfile = QDir::tempPath()+"/.LSingleApp-%1-%2-%3";
-  QString username = QString(getlogin());
   //For locking the process use the official process name - not the user input (no masking)
   appname = this->applicationName();
-  cfile = cfile.arg( username, appname, QString::number(QX11Info::appScreen()) );
+  cfile = serverPath(appname, QX11Info::appScreen());
   lockfile = new QLockFile(cfile+"-lock");
     lockfile->setStaleLockTime(0); //long-lived processes
   for(int i=1; i<argc; i++){ 
@@ -59,6 +60,27 @@ bool LSingleApplication::isPrimaryProcess(){
   return (isActive || isBypass);	
 }
 
+QString LSingleApplication::serverPath(QString appname, int screen){
+  QString path = QDir::tempPath()+"/.LSingleApp-%1-%2-%3";
+  return path.arg( QString(getlogin()), appname, QString::number(screen) );
+}
+
+bool LSingleApplication::sendInputs(QString appname, QStringList inputs, int screen){
+  if(screen<0){
+    QString num = QString(getenv("DISPLAY")).section(":",-1).section(".",1,1);
+    screen = (num.isEmpty() ? 0 : num.toInt());
+  }
+  QString path = serverPath(appname, screen);
+  if(!QFile::exists(path)){ return false; }
+  QLocalSocket socket;
+    socket.connectToServer(path);
+    if(!socket.waitForConnected(200)){ return false; }
+    socket.write( inputs.join(INPUT_SEPARATOR).toLocal8Bit() );
+    socket.waitForBytesWritten(200);
+    socket.disconnectFromServer();
+  return true;
+}
+
 void LSingleApplication::PerformLockChecks(){
   bool primary = lockfile->tryLock();
   //qDebug() << "Try Lock: " << primary;
@@ -113,7 +135,7 @@ void LSingleApplication::PerformLockChecks(){
 	} 
 	
     qDebug() << " - Forwarding inputs to locking process and closing down this instance...";	
-	socket.write( inputlist.join("::::").toLocal8Bit() );
+	socket.write( inputlist.join(INPUT_SEPARATOR).toLocal8Bit() );
 	socket.waitForDisconnected(500); //max out at 1/2 second (only hits this if no inputs)
   }
   
@@ -130,7 +152,7 @@ void LSingleApplication::newInputsAvailable(){
 	bytes.append( sock->readAll() );
     }
     sock->disconnectFromServer();
-    QStringList inputs = QString::fromLocal8Bit(bytes).split("::::");
+    QStringList inputs = QString::fromLocal8Bit(bytes).split(INPUT_SEPARATOR);
     //qDebug() << " - New Inputs Detected:" << inputs;
     emit InputsAvailable(inputs);
   }
@@ -37,6 +37,12 @@ public:
 
 	bool isPrimaryProcess();
 
+	//Socket used by the primary process of an application (per user and X screen)
+	static QString serverPath(QString appname, int screen);
+	//Send inputs to the primary process from outside of the framework (screen -1: from $DISPLAY)
+	//  Returns false if no primary process could be reached
+	static bool sendInputs(QString appname, QStringList inputs, int screen = -1);
+
 	QStringList inputlist; //in case the app wants access to modified inputs (relative path fixes and such)
 
 private:
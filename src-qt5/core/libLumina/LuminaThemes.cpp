@@ -14,6 +14,10 @@
 #include <QObject>
 #include <QPainter>
 #include <QPen>
+#include <QHash>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QCryptographicHash>
 
 #include "LuminaXDG.h"
 
@@ -216,51 +220,122 @@ bool LTHEME::setCursorTheme(QString cursorname){
     return LUtils::writeFile(QDir::homePath()+"/.icons/default/index.theme", info, true);
 }
 
-  //Return the complete stylesheet for a given theme/colors
-QString LTHEME::assembleStyleSheet(QString themepath, QString colorpath, QString font, QString fontsize){
-  QString stylesheet = LUtils::readFile(themepath).join("\n");
-  QStringList colors = LUtils::readFile(colorpath);
-  //qDebug() << "Found Theme:" << themepath << stylesheet;
-  //qDebug() << "Found Colors:" << colorpath << colors;
-  QStringList systhemes = availableSystemThemes();
-  QStringList locthemes = availableLocalThemes();
-  //Now do any inheritance between themes
-  int start = stylesheet.indexOf("INHERITS=");
-  while(start>=0){
-    QString line = stylesheet.mid(start, stylesheet.indexOf("\n",start)-start); //only get this line
-    QString inherit = line.section("=",1,1);
-    QString rStyle; //replacement stylesheet
-    if(!locthemes.filter(inherit+"::::").isEmpty()){
-       rStyle = LUtils::readFile(locthemes.filter(inherit+"::::").first().section("::::",1,1)).join("\n");
-    }else if(!systhemes.filter(inherit+"::::").isEmpty()){
-      rStyle = LUtils::readFile(systhemes.filter(inherit+"::::").first().section("::::",1,1)).join("\n");
+// === Stylesheet compiler (internal) ===
+//Read a theme template and insert any inherited themes ("INHERITS=<name>" lines)
+// - deps: list of "<msecs> <path>" entries for every file which the result depends on (-1: file does not exist)
+static QStringList readThemeTemplate(QString path, QStringList *deps, int depth = 0){
+  QFileInfo info(path);
+  deps->append( QString::number(info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1)+" "+path );
+  QStringList lines = LUtils::readFile(path);
+  if(depth>10){ return lines; } //circular inheritance - stop here
+  for(int i=0; i<lines.length(); i++){
+    int index = lines[i].indexOf("INHERITS=");
+    if(index<0){ continue; }
+    QString inherit = lines[i].mid(index).section("=",1,1).simplified();
+    //Local themes override the system themes with the same name
+    QString ipath = QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/themes/"+inherit+".qss.template";
+    if(!QFile::exists(ipath)){
+      deps->append("-1 "+ipath); //watch for a local theme showing up later
+      ipath = LOS::LuminaShare()+"themes/"+inherit+".qss.template";
+    }
+    QStringList rStyle = readThemeTemplate(ipath, deps, depth+1);
+    if(rStyle.isEmpty()){ rStyle << ""; }
+    rStyle[0].prepend( lines[i].left(index) ); //keep anything before the INHERITS= on that line
+    lines.removeAt(i);
+    for(int j=rStyle.length()-1; j>=0; j--){ lines.insert(i, rStyle[j]); }
+    i += rStyle.length()-1; //inherited themes are already expanded
+  }
+  return lines;
+}
+
+//Replace all the "%%KEY%%" tokens with the matching variable (one pass through the text)
+static QString expandTemplate(const QString &in, const QHash<QString, QString> &vars){
+  QString out;
+  out.reserve(in.length() + in.length()/4);
+  int pos = 0;
+  while(pos < in.length()){
+    int start = in.indexOf("%%", pos);
+    if(start<0){ break; }
+    int end = in.indexOf("%%", start+2);
+    if(end<0){ break; }
+    QString key = in.mid(start+2, end-start-2);
+    if(vars.contains(key)){
+      out.append(in.midRef(pos, start-pos));
+      out.append(vars.value(key));
+      pos = end+2;
+    }else{
+      //Not a variable - keep the first character and check again from the next one
+      out.append(in.midRef(pos, start+1-pos));
+      pos = start+1;
     }
-    stylesheet.replace(line, rStyle);
-    //Now look for the next one
-    start = stylesheet.indexOf("INHERITS=");
   }
-  //Now perform the color replacements
+  out.append(in.midRef(pos));
+  return out;
+}
+
+static QString styleSheetCacheFile(QString themepath, QString colorpath, QString font, QString fontsize){
+  QString cachedir = QString(getenv("XDG_CACHE_HOME"));
+  if(cachedir.isEmpty()){ cachedir = QDir::homePath()+"/.cache"; }
+  QByteArray id = QCryptographicHash::hash( QStringList(QStringList() << themepath << colorpath << font << fontsize).join("\n").toUtf8(), QCryptographicHash::Md5).toHex();
+  return cachedir+"/lumina-desktop/stylesheets/"+QString(id)+".qss";
+}
+
+//Return the complete stylesheet for a given theme/colors (no caching)
+QString LTHEME::compileStyleSheet(QString themepath, QString colorpath, QString font, QString fontsize, QStringList *deps){
+  QStringList tmpdeps;
+  if(deps==0){ deps = &tmpdeps; }
+  QString stylesheet = readThemeTemplate(themepath, deps).join("\n");
+  //Now load all the variables
+  QFileInfo cinfo(colorpath);
+  deps->append( QString::number(cinfo.exists() ? cinfo.lastModified().toMSecsSinceEpoch() : -1)+" "+colorpath );
+  QStringList colors = LUtils::readFile(colorpath);
+  QHash<QString, QString> vars;
   for(int i=0; i<colors.length(); i++){
-    if(colors[i].isEmpty() || colors[i].startsWith("#")){ continue; }
-    else if(colors[i].startsWith("PRIMARYCOLOR=")){ stylesheet = stylesheet.replace("%%PRIMARYCOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("SECONDARYCOLOR=")){ stylesheet = stylesheet.replace("%%SECONDARYCOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("HIGHLIGHTCOLOR=")){ stylesheet = stylesheet.replace("%%HIGHLIGHTCOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("ACCENTCOLOR=")){ stylesheet = stylesheet.replace("%%ACCENTCOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("PRIMARYDISABLECOLOR=")){ stylesheet = stylesheet.replace("%%PRIMARYDISABLECOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("SECONDARYDISABLECOLOR=")){ stylesheet = stylesheet.replace("%%SECONDARYDISABLECOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("HIGHLIGHTDISABLECOLOR=")){ stylesheet = stylesheet.replace("%%HIGHLIGHTDISABLECOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("ACCENTDISABLECOLOR=")){ stylesheet = stylesheet.replace("%%ACCENTDISABLECOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("BASECOLOR=")){ stylesheet = stylesheet.replace("%%BASECOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("ALTBASECOLOR=")){ stylesheet = stylesheet.replace("%%ALTBASECOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("TEXTCOLOR=")){ stylesheet = stylesheet.replace("%%TEXTCOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("TEXTDISABLECOLOR=")){ stylesheet = stylesheet.replace("%%TEXTDISABLECOLOR%%", colors[i].section("=",1,1).simplified()); }
-    else if(colors[i].startsWith("TEXTHIGHLIGHTCOLOR=")){ stylesheet = stylesheet.replace("%%TEXTHIGHLIGHTCOLOR%%", colors[i].section("=",1,1).simplified()); }
+    if(colors[i].isEmpty() || colors[i].startsWith("#") || !colors[i].contains("=")){ continue; }
+    QString key = colors[i].section("=",0,0).simplified();
+    if(!vars.contains(key)){ vars.insert(key, colors[i].section("=",1,1).simplified()); } //first definition wins
+  }
+  vars.insert("FONT", "\""+font+"\"");
+  vars.insert("FONTSIZE", fontsize);
+  return expandTemplate(stylesheet, vars);
+}
+
+//Return the complete stylesheet for a given theme/colors
+QString LTHEME::assembleStyleSheet(QString themepath, QString colorpath, QString font, QString fontsize){
+  //Cache file format: "/*", one "<msecs> <path>" line per input file, "*/", then the stylesheet
+  QString cfile = styleSheetCacheFile(themepath, colorpath, font, fontsize);
+  QFile file(cfile);
+  if(file.open(QIODevice::ReadOnly | QIODevice::Text)){
+    QString contents = QString::fromUtf8(file.readAll());
+    file.close();
+    int end = contents.indexOf("\n*/\n");
+    if(contents.startsWith("/*\n") && end>0){
+      QStringList deps = contents.mid(3, end-3).split("\n", QString::SkipEmptyParts);
+      bool valid = !deps.isEmpty();
+      for(int i=0; i<deps.length() && valid; i++){
+        QFileInfo info(deps[i].section(" ",1,-1));
+        qint64 mtime = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+        valid = (deps[i].section(" ",0,0).toLongLong() == mtime);
+      }
+      if(valid){ return contents.mid(end+4); }
+    }
+  }
+  //Need to (re)compile the stylesheet
+  QStringList deps;
+  QString stylesheet = compileStyleSheet(themepath, colorpath, font, fontsize, &deps);
+  QDir dir;
+  if(dir.mkpath(cfile.section("/",0,-2))){
+    QSaveFile out(cfile);
+    if(out.open(QIODevice::WriteOnly | QIODevice::Text)){
+      out.write( QString("/*\n"+deps.join("\n")+"\n*/\n").toUtf8() );
+      out.write( stylesheet.toUtf8() );
+      out.commit();
+    }
   }
-  stylesheet = stylesheet.replace("%%FONT%%", "\""+font+"\"");
-  stylesheet = stylesheet.replace("%%FONTSIZE%%", fontsize);
   //qDebug() << "Assembled Style Sheet:\n" << stylesheet;
   return stylesheet;
 }
+
 // Extra information about a cursor theme
 QStringList LTHEME::cursorInformation(QString name){
   //returns: [Name, Comment, Sample Image File]
@@ -420,7 +495,8 @@ LuminaThemeEngine::LuminaThemeEngine(QApplication *app){
   theme = current[0]; colors=current[1]; icons=current[2]; font=current[3]; fontsize=current[4];
   cursors = LTHEME::currentCursor();
   if(application->applicationFilePath().section("/",-1)=="lumina-desktop"){
-    application->setStyleSheet( LTHEME::assembleStyleSheet(theme, colors, font, fontsize) );
+    stylesheet = LTHEME::assembleStyleSheet(theme, colors, font, fontsize);
+    application->setStyleSheet(stylesheet);
   }else{
     //Non-Desktop binary - only use alternate Qt methods (skip stylesheets)
     QFont tmp = application->font();
@@ -441,11 +517,9 @@ LuminaThemeEngine::LuminaThemeEngine(QApplication *app){
   }
 
   //setenv("XCURSOR_THEME", cursors.toLocal8Bit(),1);
-  watcher = new QFileSystemWatcher(this);
-	watcher->addPath( QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/envsettings.conf" );
-	watcher->addPath( QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/themesettings.cfg" );
-	watcher->addPaths( QStringList() << theme << colors << QDir::homePath()+"/.icons/default/index.theme" ); //also watch these files for changes
-  connect(watcher, SIGNAL(fileChanged(QString)), this, SLOT(watcherChange(QString)) );
+  watcher = new LFileWatcher(this);
+  updateWatched();
+  connect(watcher, SIGNAL(PathChanged(QString)), this, SLOT(watcherChange(QString)) );
   connect(syncTimer, SIGNAL(timeout()), this, SLOT(reloadFiles()) );
 }
 
@@ -460,7 +534,6 @@ void LuminaThemeEngine::refresh(){
 void LuminaThemeEngine::watcherChange(QString file){
   if(syncTimer->isActive()){ syncTimer->stop(); }
   syncTimer->start();
-  if(!watcher->files().contains(file)){ watcher->addPath(file); }
 }
 
 void LuminaThemeEngine::reloadFiles(){
@@ -468,7 +541,12 @@ void LuminaThemeEngine::reloadFiles(){
   if(lastcheck < QFileInfo(QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/themesettings.cfg").lastModified().addSecs(1) ){
     QStringList current = LTHEME::currentSettings();
     if(application->applicationFilePath().section("/",-1)=="lumina-desktop"){
-      application->setStyleSheet( LTHEME::assembleStyleSheet(current[0], current[1], current[3], current[4]) );	
+      QString ss = LTHEME::assembleStyleSheet(current[0], current[1], current[3], current[4]);
+      //Only apply it if something changed (every widget gets re-polished when the stylesheet is set)
+      if(ss != stylesheet){
+        stylesheet = ss;
+        application->setStyleSheet(stylesheet);
+      }
     }
     if(icons!=current[2]){
       QIcon::setThemeName(current[2]); //make sure this sets set within this environment
@@ -514,7 +592,22 @@ void LuminaThemeEngine::reloadFiles(){
   }
   lastcheck = QDateTime::currentDateTime();
   
-  //Now update the watched files to ensure nothing is missed
-  watcher->removePaths( QStringList() << theme << colors << QDir::homePath()+"/.icons/default/index.theme" << QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/envsettings.conf");
-  watcher->addPaths( QStringList() << theme << colors << QDir::homePath()+"/.icons/default/index.theme" << QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/envsettings.conf");
+  //Now update the watched files (the theme/colors files might be different now)
+  updateWatched();
+}
+
+void LuminaThemeEngine::updateWatched(){
+  QStringList files;
+    files << QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/envsettings.conf";
+    files << QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/themesettings.cfg";
+    files << theme << colors << QDir::homePath()+"/.icons/default/index.theme";
+  for(int i=0; i<files.length(); i++){ files[i] = QDir::cleanPath(files[i]); }
+  files.removeAll("");
+  QStringList watched = watcher->paths();
+  for(int i=0; i<watched.length(); i++){
+    if(!files.contains(watched[i])){ watcher->unwatchPath(watched[i]); }
+  }
+  for(int i=0; i<files.length(); i++){
+    if(!watched.contains(files[i])){ watcher->watchPath(files[i]); }
+  }
 }
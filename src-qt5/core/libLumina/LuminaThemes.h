@@ -12,7 +12,6 @@
 
 #include <QApplication>
 #include <QObject>
-#include <QFileSystemWatcher>
 #include <QString>
 #include <QFile>
 #include <QDir>
@@ -21,6 +20,8 @@
 #include <QStyle>
 #include <QProxyStyle>
 
+#include "LuminaFileWatcher.h"
+
 class LTHEME{
 public:
   //Read the Themes/Colors/Icons that are available on the system
@@ -44,7 +45,9 @@ public:
   static bool setCursorTheme(QString cursorname);
 
   //Return the complete stylesheet for a given theme/colors
+  // - assembleStyleSheet() re-uses the compiled version in $XDG_CACHE_HOME until one of the input files changes
   static QString assembleStyleSheet(QString themepath, QString colorpath, QString font, QString fontsize);
+  static QString compileStyleSheet(QString themepath, QString colorpath, QString font, QString fontsize, QStringList *deps = 0); //no cache (deps: input files)
   
   //Additional info for a cursor theme
   static QStringList cursorInformation(QString name); //returns: [Name, Comment, Sample Image File]
@@ -96,12 +99,15 @@ public:
 
 private:
 	QApplication *application;
-	QFileSystemWatcher *watcher;
+	LFileWatcher *watcher;
 	QString theme,colors,icons, font, fontsize, cursors; //current settings
+	QString stylesheet; //currently applied stylesheet
 	QTimer *syncTimer;
 	QDateTime lastcheck;
 	//LuminaThemeStyle *style;
 
+	void updateWatched(); //watch the current settings/theme/colors files
+
 private slots:
 	void watcherChange(QString);
 	void reloadFiles();
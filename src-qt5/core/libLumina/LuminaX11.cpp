@@ -27,6 +27,13 @@
 #include <xcb/xcb_aux.h>
 #include <xcb/composite.h>
 #include <xcb/damage.h>
+#include <xcb/shm.h>
+
+//MIT-SHM includes
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <string.h> //memcpy
 
 //XLib includes
 #include <X11/extensions/Xdamage.h>
@@ -481,32 +488,48 @@ int LXCB::WindowIsFullscreen(WId win){
 }
 
 // === WindowIcon() ===
-QIcon LXCB::WindowIcon(WId win){
+QIcon LXCB::WindowIcon(WId win, int size){
   //Fetch the _NET_WM_ICON for the window and return it as a QIcon
+  // - size>0: only convert the image which is closest to (but not smaller than) that size
   if(DEBUG){ qDebug() << "XCB: WindowIcon()"; }
   QIcon icon;
   if(win==0){ return icon; }
   xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_icon_unchecked(&EWMH, win);
   xcb_ewmh_get_wm_icon_reply_t reply;
   if(1 == xcb_ewmh_get_wm_icon_reply(&EWMH, cookie, &reply, NULL)){
+    //First scan the list of available images (size/data pointers only)
+    QList<xcb_ewmh_wm_icon_iterator_t> images;
     xcb_ewmh_wm_icon_iterator_t iter = xcb_ewmh_get_wm_icon_iterator(&reply);
-    //Just use the first
-    bool done =false;
+    bool done = false;
     while(!done){
-      //Now convert the current data into a Qt image
-      // - first 2 elements are width and height (removed via XCB functions)
-      // - data in rows from left to right and top to bottom
-      QImage image(iter.width, iter.height, QImage::Format_ARGB32); //initial setup
-	uint* dat = iter.data;
-	//dat+=2; //remember the first 2 element offset
-	for(int i=0; i<image.byteCount()/4; ++i, ++dat){
-	  ((uint*)image.bits())[i] = *dat; 
-	}
-      icon.addPixmap(QPixmap::fromImage(image)); //layer this pixmap onto the icon
-      //Now see if there are any more icons available
+      if(iter.width>0 && iter.height>0){ images << iter; }
       done = (iter.rem<1); //number of icons remaining
       if(!done){ xcb_ewmh_get_wm_icon_next(&iter); } //get the next icon data
     }
+    if(size>0 && images.length()>1){
+      //Pick the smallest image which is at least the requested size (or the largest available)
+      int best = 0;
+      for(int i=1; i<images.length(); i++){
+        int cur = qMin(images[i].width, images[i].height);
+        int bcur = qMin(images[best].width, images[best].height);
+        if( (bcur<size && cur>bcur) || (cur>=size && cur<bcur) ){ best = i; }
+      }
+      xcb_ewmh_wm_icon_iterator_t tmp = images[best];
+      images.clear();
+      images << tmp;
+    }
+    for(int i=0; i<images.length(); i++){
+      //Now convert the data into a Qt image
+      // - data is one 32-bit ARGB value per pixel, in rows from left to right and top to bottom
+      //   (the same layout as QImage::Format_ARGB32 - so just copy it over a row at a time)
+      QImage image(images[i].width, images[i].height, QImage::Format_ARGB32);
+      const uint32_t *dat = images[i].data;
+      for(int y=0; y<image.height(); y++){
+        memcpy(image.scanLine(y), dat, image.width()*4);
+        dat += image.width();
+      }
+      icon.addPixmap(QPixmap::fromImage(image)); //layer this pixmap onto the icon
+    }
     xcb_ewmh_get_wm_icon_reply_wipe(&reply);
   }
   return icon;
@@ -1017,6 +1040,65 @@ QPixmap LXCB::TrayImage(WId win){
   //return QPixmap::fromImage(image.copy());
 }
 
+// ===== WindowImage() =====
+static void ShmImageCleanup(void *addr){
+  //Detach the shared memory segment once the QImage is done with it
+  shmdt(addr);
+}
+
+QImage LXCB::WindowImage(WId win, QRect geom){
+  xcb_connection_t *conn = QX11Info::connection();
+  if(win==0){ win = QX11Info::appRootWindow(); }
+  xcb_get_geometry_reply_t *greply = xcb_get_geometry_reply(conn, xcb_get_geometry(conn, win), NULL);
+  if(greply==0){ return QImage(); }
+  int depth = greply->depth;
+  if(!geom.isValid()){ geom = QRect(0, 0, greply->width, greply->height); }
+  else{ geom = geom.intersected( QRect(0, 0, greply->width, greply->height) ); } //GetImage fails on areas outside the window
+  free(greply);
+  if(geom.isEmpty()){ return QImage(); }
+  //Only 32 bits-per-pixel visuals (depth 24/32) are read directly - let Qt handle anything else
+  int bpp = 0;
+  xcb_format_iterator_t fiter = xcb_setup_pixmap_formats_iterator(xcb_get_setup(conn));
+  for( ; fiter.rem; xcb_format_next(&fiter)){
+    if(fiter.data->depth == depth){ bpp = fiter.data->bits_per_pixel; break; }
+  }
+  QImage::Format format = (depth==32) ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+  if( (depth!=24 && depth!=32) || bpp!=32 ){
+    return QApplication::screens().at(0)->grabWindow(win, geom.x(), geom.y(), geom.width(), geom.height()).toImage();
+  }
+  int stride = geom.width()*4;
+  //Try MIT-SHM first: the server writes the pixels straight into memory which the QImage then uses (no copies)
+  const xcb_query_extension_reply_t *shmext = xcb_get_extension_data(conn, &xcb_shm_id);
+  if(shmext!=0 && shmext->present){
+    int shmid = shmget(IPC_PRIVATE, stride*geom.height(), IPC_CREAT | 0600);
+    if(shmid>=0){
+      void *addr = shmat(shmid, 0, 0);
+      if(addr != (void*) -1){
+        xcb_shm_seg_t seg = xcb_generate_id(conn);
+        xcb_shm_attach(conn, seg, shmid, false);
+        xcb_shm_get_image_cookie_t cookie = xcb_shm_get_image(conn, win, geom.x(), geom.y(), geom.width(), geom.height(), ~0, XCB_IMAGE_FORMAT_Z_PIXMAP, seg, 0);
+        xcb_shm_get_image_reply_t *reply = xcb_shm_get_image_reply(conn, cookie, NULL);
+        xcb_shm_detach(conn, seg);
+        shmctl(shmid, IPC_RMID, 0); //gets removed once the last process detaches
+        if(reply!=0){
+          free(reply);
+          return QImage( (uchar*) addr, geom.width(), geom.height(), stride, format, ShmImageCleanup, addr);
+        }
+        shmdt(addr);
+      }else{
+        shmctl(shmid, IPC_RMID, 0);
+      }
+    }
+  }
+  //Fallback: plain GetImage request (pixels get copied out of the reply)
+  xcb_get_image_reply_t *reply = xcb_get_image_reply(conn, xcb_get_image(conn, XCB_IMAGE_FORMAT_Z_PIXMAP, win, geom.x(), geom.y(), geom.width(), geom.height(), ~0), NULL);
+  if(reply==0){ return QImage(); }
+  QImage img( (const uchar*) xcb_get_image_data(reply), geom.width(), geom.height(), stride, format);
+  img = img.copy(); //detach from the reply data
+  free(reply);
+  return img;
+}
+
 // ===== startSystemTray() =====
 WId LXCB::startSystemTray(int screen){
   qDebug() << "Starting System Tray:" << screen;
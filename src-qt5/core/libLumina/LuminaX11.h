@@ -127,7 +127,7 @@ public:
 	QString OldWindowIconName(WId win); //WM_ICON_NAME (old standard)
 	bool WindowIsMaximized(WId win);
 	int WindowIsFullscreen(WId win); //Returns the screen number if the window is fullscreen (or -1)
-	QIcon WindowIcon(WId win); //_NET_WM_ICON
+	QIcon WindowIcon(WId win, int size = 0); //_NET_WM_ICON (size>0: only load the image closest to that size)
 	
 	//Window Modification
 	// - SubStructure simplifications (not commonly used)
@@ -156,6 +156,9 @@ public:
 	uint EmbedWindow(WId win, WId container); //returns the damage ID (or 0 for an error)
 	bool UnembedWindow(WId win);
 	QPixmap TrayImage(WId win);
+
+	//Screen/Window capture
+	QImage WindowImage(WId win = 0, QRect geom = QRect()); //contents of the window (root window if 0) or just an area of it (window coordinates)
 	
 	//System Tray Management
 	WId startSystemTray(int screen = 0); //Startup the system tray (returns window ID for tray)
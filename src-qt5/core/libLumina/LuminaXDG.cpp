@@ -7,13 +7,19 @@
 #include "LuminaXDG.h"
 #include "LuminaOS.h"
 #include "LuminaUtils.h"
+#include "LuminaAppRegistry.h"
 #include <QObject>
 #include <QTimer>
 #include <QMediaPlayer>
 #include <QSvgRenderer>
+#include <QMutexLocker>
+#include <QXmlStreamReader>
+#include <QSet>
+#include <QtConcurrent>
 
 static QStringList mimeglobs;
 static qint64 mimechecktime;
+static QMutex globsLock; //guards the two above: loadMimeFileGlobs2() runs on worker threads (file manager items, mime defaults builder)
 
 //=============================
 //  XDGDesktop CLASS
@@ -23,6 +29,7 @@ XDGDesktop::XDGDesktop(QString file, QObject *parent) : QObject(parent){
   useTerminal=false;
   startupNotify=false;
   useVGL = false;
+  startDelay = 0;
   type = XDGDesktop::BAD;
   filePath = file;
   exec = tryexec = "";   // just to make sure this is initialized
@@ -36,6 +43,7 @@ void XDGDesktop::sync(){
   startupNotify=false;
   type = XDGDesktop::BAD;
   exec = tryexec = "";
+  startPhase.clear(); startAfter.clear(); startDelay = 0;
   //Read in the File
   if(!filePath.endsWith(".desktop")){ return; }
   lastRead = QDateTime::currentDateTime();
@@ -124,6 +132,9 @@ void XDGDesktop::sync(){
     else if(var=="StartupNotify" && insection){ startupNotify = (val.toLower()=="true"); }
     else if(var=="StartupWMClass" && insection){ startupWM = val; }
     else if(var=="URL" && insection){ url = val;}
+    else if( (var=="X-GNOME-Autostart-Phase" || var=="X-KDE-autostart-phase") && insection){ startPhase = val; }
+    else if(var=="X-GNOME-Autostart-Delay" && insection){ startDelay = val.toInt(); }
+    else if(var=="X-KDE-autostart-after" && insection){ startAfter = val.split(QRegExp("[,;]"),QString::SkipEmptyParts); }
     else if(var=="Type" && insection){
       if(val.toLower()=="application"){ type = XDGDesktop::APP; }
       else if(val.toLower()=="link"){ type = XDGDesktop::LINK; }
@@ -408,32 +419,84 @@ XDGDesktopList::XDGDesktopList(QObject *parent, bool watchdirs) : QObject(parent
   synctimer = new QTimer(this); //interval set automatically based on changes/interactions
     connect(synctimer, SIGNAL(timeout()), this, SLOT(updateList()) );
   keepsynced = watchdirs;
+  registryHost = false;
+  registryGen = 0;
   if(watchdirs){
-    watcher = new QFileSystemWatcher(this);
-    connect(watcher, SIGNAL(fileChanged(const QString&)), this, SLOT(watcherChanged()) );
-    connect(watcher, SIGNAL(directoryChanged(const QString&)), this, SLOT(watcherChanged()) );
+    watcher = new LFileWatcher(this);
+    connect(watcher, SIGNAL(PathChanged(QString)), this, SLOT(watcherChanged()) );
   }else{
     watcher = 0;
   }
 }
 
 XDGDesktopList::~XDGDesktopList(){
-  //nothing special to do here
+  if(registryHost){ LAppRegistry::unpublish(); }
+}
+
+void XDGDesktopList::setRegistryHost(bool host){
+  registryHost = host;
+  if(host){ registryGen = 0; }
+}
+
+bool XDGDesktopList::loadRegistry(bool *changed){
+  //Load the list from the session snapshot (returns false if no snapshot is available)
+  *changed = false;
+  quint32 gen = LAppRegistry::generation();
+  if(gen==0){ return false; }
+  if(gen==registryGen){ lastCheck = QDateTime::currentDateTime(); return true; } //nothing new
+  QList<XDGDesktop*> list;
+  if( !LAppRegistry::load(this, list, &gen) ){ return false; }
+  QStringList oldkeys = files.keys();
+  QStringList newfiles;
+  bool firstrun = lastCheck.isNull() || oldkeys.isEmpty();
+  lastCheck = QDateTime::currentDateTime();
+  for(int i=0; i<list.length(); i++){
+    QString path = list[i]->filePath;
+    oldkeys.removeAll(path);
+    if(files.contains(path) && files[path]->lastRead==list[i]->lastRead){ delete list[i]; continue; } //same entry - keep the current structure
+    if(files.contains(path)){ files.take(path)->deleteLater(); }
+    else{ newfiles << path; }
+    files.insert(path, list[i]);
+    *changed = true;
+  }
+  for(int i=0; i<oldkeys.length(); i++){ files.take(oldkeys[i])->deleteLater(); *changed = true; }
+  if(!firstrun){
+    removedApps = oldkeys;
+    newApps = newfiles;
+  }
+  registryGen = gen;
+  return true;
 }
 
 void XDGDesktopList::watcherChanged(){
   if(synctimer->isActive()){ synctimer->stop(); }
-  synctimer->setInterval(1000); //1 second delay before check kicks off
+  //1 second delay before check kicks off (2 seconds when using the session snapshot - so the session can publish the changes first)
+  synctimer->setInterval(registryGen==0 ? 1000 : 2000);
   synctimer->start();
 }
 
 void XDGDesktopList::updateList(){
   //run the check routine
   if(synctimer->isActive()){ synctimer->stop(); }
+  bool appschanged = false;
+  if(!registryHost && loadRegistry(&appschanged)){
+    //Loaded from the session snapshot - keep the directories watched in case the session goes away
+    if(watcher!=0){
+      QStringList appDirs = LXDG::systemApplicationDirs();
+      for(int i=0; i<appDirs.length(); i++){
+        QString dir = QDir::cleanPath(appDirs[i]);
+        if(!watcher->paths().contains(dir) && QFileInfo(dir).isDir()){ watcher->watchPath(dir); }
+      }
+      if(appschanged){ emit appsUpdated(); }
+      synctimer->setInterval(60000);
+      synctimer->start();
+    }
+    return;
+  }
+  registryGen = 0; //reading the files locally
   QStringList appDirs = LXDG::systemApplicationDirs(); //get all system directories
   QStringList found, newfiles; //for avoiding duplicate apps (might be files with same name in different priority directories)
   QStringList oldkeys = files.keys();
-  bool appschanged = false;
   bool firstrun = lastCheck.isNull() || oldkeys.isEmpty();
   lastCheck = QDateTime::currentDateTime();
   //Variables for internal loop use only (to prevent re-initializing variable on every iteration)
@@ -475,17 +538,53 @@ void XDGDesktopList::updateList(){
     //files.remove(oldkeys[i]);
     files.take(oldkeys[i])->deleteLater();
   }
+  //Share the list with the other Lumina processes
+  if(registryHost && (appschanged || firstrun)){ LAppRegistry::publish(files.values()); }
   //If this class is automatically managing the lists, update the watched files/dirs and send out notifications
   if(watcher!=0){
     if(appschanged){ qDebug() << "Auto App List Update:" << lastCheck  << "Files Found:" << files.count(); }
-    watcher->removePaths(QStringList() << watcher->files() << watcher->directories());
-    watcher->addPaths(appDirs);
+    //Only adjust the watched directories if the list changed (or a directory showed up)
+    QStringList watched = watcher->paths();
+    QStringList wanted;
+    for(int i=0; i<appDirs.length(); i++){ wanted << QDir::cleanPath(appDirs[i]); }
+    for(int i=0; i<watched.length(); i++){
+      if(!wanted.contains(watched[i])){ watcher->unwatchPath(watched[i]); }
+    }
+    for(int i=0; i<wanted.length(); i++){
+      if(!watched.contains(wanted[i]) && QFileInfo(wanted[i]).isDir()){ watcher->watchPath(wanted[i]); }
+    }
     if(appschanged){ emit appsUpdated(); }
     synctimer->setInterval(60000); //Update in 1 minute if nothing changes before then
     synctimer->start();
   }
 }
 
+QList<XDGDesktop*> XDGDesktopList::readSystemFiles(QThread *owner){
+  //Same directory scan as updateList() - but without touching any list (safe to use on a worker thread)
+  QList<XDGDesktop*> out;
+  QStringList appDirs = LXDG::systemApplicationDirs();
+  QDir dir; QStringList apps;
+  for(int i=0; i<appDirs.length(); i++){
+    if( !dir.cd(appDirs[i]) ){ continue; }
+    apps = dir.entryList(QStringList() << "*.desktop",QDir::Files, QDir::Name);
+    for(int a=0; a<apps.length(); a++){
+      XDGDesktop *dFile = new XDGDesktop(dir.absoluteFilePath(apps[a]), 0);
+      if(dFile->type==XDGDesktop::BAD){ delete dFile; continue; }
+      if(owner!=0){ dFile->moveToThread(owner); }
+      out << dFile;
+    }
+  }
+  return out;
+}
+
+void XDGDesktopList::addFiles(QList<XDGDesktop*> list){
+  for(int i=0; i<list.length(); i++){
+    if(files.contains(list[i]->filePath)){ list[i]->deleteLater(); continue; } //already loaded
+    list[i]->setParent(this);
+    files.insert(list[i]->filePath, list[i]);
+  }
+}
+
 QList<XDGDesktop*> XDGDesktopList::apps(bool showAll, bool showHidden){
   //showAll: include invalid files, showHidden: include NoShow/Hidden files
   QStringList keys = files.keys();
@@ -501,63 +600,85 @@ QList<XDGDesktop*> XDGDesktopList::apps(bool showAll, bool showHidden){
 }
 
 //==== LFileInfo Functions ====
+#define DESKCACHE_MAX 500 //max number of desktop entries kept in the shared cache
+
+//Shared cache of the parsed desktop entries (any thread)
+static QMutex deskCacheLock;
+static QHash<QString, QSharedPointer<XDGDesktop> > deskCache;
+
+static QSharedPointer<XDGDesktop> cachedDesktopFile(QString path, QDateTime modified){
+  QMutexLocker lock(&deskCacheLock);
+  QSharedPointer<XDGDesktop> desk = deskCache.value(path);
+  if(!desk.isNull() && desk->lastRead > modified){ return desk; } //file not changed since it was read
+  lock.unlock();
+  desk = QSharedPointer<XDGDesktop>( new XDGDesktop(path, 0) ); //no parent: can be used/released on any thread
+  lock.relock();
+  if(deskCache.count() >= DESKCACHE_MAX){ deskCache.clear(); } //entries still in use stay alive through their users
+  deskCache.insert(path, desk);
+  return desk;
+}
+
 //Need some extra information not usually available by a QFileInfo
 void LFileInfo::loadExtraInfo(){
-  desk = 0;
+  if(extra->loaded.loadAcquire()){ return; }
+  QMutexLocker lock(&extra->lock);
+  if(extra->loaded.load()){ return; } //loaded by another copy in the meantime
   //Now load the extra information
-  if(this->isDir()){
-    mime = "inode/directory";
+  if(this->filePath().isEmpty()){
+    //No file - nothing to load
+  }else if(this->isDir()){
+    extra->mime = "inode/directory";
     //Special directory icons
     QString name = this->fileName().toLower();
-    if(name=="desktop"){ icon = "user-desktop"; }
-    else if(name=="tmp"){ icon = "folder-temp"; }
-    else if(name=="video" || name=="videos"){ icon = "folder-video"; }
-    else if(name=="music" || name=="audio"){ icon = "folder-sound"; }
-    else if(name=="projects" || name=="devel"){ icon = "folder-development"; }
-    else if(name=="notes"){ icon = "folder-txt"; }
-    else if(name=="downloads"){ icon = "folder-downloads"; }
-    else if(name=="documents"){ icon = "folder-documents"; }
-    else if(name=="images" || name=="pictures"){ icon = "folder-image"; }
-    else if( !this->isReadable() ){ icon = "folder-locked"; }
+    if(name=="desktop"){ extra->icon = "user-desktop"; }
+    else if(name=="tmp"){ extra->icon = "folder-temp"; }
+    else if(name=="video" || name=="videos"){ extra->icon = "folder-video"; }
+    else if(name=="music" || name=="audio"){ extra->icon = "folder-sound"; }
+    else if(name=="projects" || name=="devel"){ extra->icon = "folder-development"; }
+    else if(name=="notes"){ extra->icon = "folder-txt"; }
+    else if(name=="downloads"){ extra->icon = "folder-downloads"; }
+    else if(name=="documents"){ extra->icon = "folder-documents"; }
+    else if(name=="images" || name=="pictures"){ extra->icon = "folder-image"; }
+    else if( !this->isReadable() ){ extra->icon = "folder-locked"; }
   }else if( this->suffix()=="desktop"){
-    mime = "application/x-desktop";
-    icon = "application-x-desktop"; //default value
-    desk = new XDGDesktop(this->absoluteFilePath(), 0);
-    if(desk->type!=XDGDesktop::BAD){
+    extra->mime = "application/x-desktop";
+    extra->icon = "application-x-desktop"; //default value
+    extra->desk = cachedDesktopFile(this->absoluteFilePath(), this->lastModified());
+    if(extra->desk->type!=XDGDesktop::BAD){
       //use the specific desktop file info (if possible)
-      if(!desk->icon.isEmpty()){ icon = desk->icon; }
+      if(!extra->desk->icon.isEmpty()){ extra->icon = extra->desk->icon; }
     }
   }else{
     //Generic file, just determine the mimetype
-    mime = LXDG::findAppMimeForFile(this->fileName());
+    extra->mime = LXDG::findAppMimeForFile(this->fileName());
   }
+  extra->loaded.storeRelease(1);
 }
-LFileInfo::LFileInfo(){
-  desk = 0;
+LFileInfo::LFileInfo() : extra(new LFileInfoData){
 }
-LFileInfo::LFileInfo(QString filepath){ //overloaded contructor
+LFileInfo::LFileInfo(QString filepath) : extra(new LFileInfoData){ //overloaded contructor
   this->setFile(filepath);
-  loadExtraInfo();
 }	
-LFileInfo::LFileInfo(QFileInfo info){ //overloaded contructor
+LFileInfo::LFileInfo(QFileInfo info) : extra(new LFileInfoData){ //overloaded contructor
   this->swap(info); //use the given QFileInfo without re-loading it
-  loadExtraInfo();
 }		
 
 //Functions for accessing the extra information
 // -- Return the mimetype for the file
 QString LFileInfo::mimetype(){
-  if(mime=="inode/directory"){ return ""; }
-  else{ return mime; }
+  loadExtraInfo();
+  if(extra->mime=="inode/directory"){ return ""; }
+  else{ return extra->mime; }
 }
 
 // -- Return the icon to use for this file
 QString LFileInfo::iconfile(){
-  if(!icon.isEmpty()){
-    return icon;
+  loadExtraInfo();
+  if(!extra->icon.isEmpty()){
+    return extra->icon;
   }else{
-    if(!mime.isEmpty()){
-      QString tmp = mime; 
+    if(!extra->mime.isEmpty()){
+      QString tmp = extra->mime; 
       tmp.replace("/","-");
       return tmp;
     }else if(this->isExecutable()){
@@ -569,24 +690,29 @@ QString LFileInfo::iconfile(){
 
 // -- Check if this is an XDG desktop file
 bool LFileInfo::isDesktopFile(){
-  if(desk==0){ return false; }
-  return (!desk->filePath.isEmpty());	
+  if(this->suffix()!="desktop"){ return false; } //quick return (no need to load anything)
+  loadExtraInfo();
+  if(extra->desk.isNull()){ return false; }
+  return (!extra->desk->filePath.isEmpty());	
 }
 
 // -- Allow access to the XDG desktop data structure
 XDGDesktop* LFileInfo::XDG(){
-  return desk;
+  loadExtraInfo();
+  return extra->desk.data();
 }
 
 // -- Check if this is a readable image file (for thumbnail support)
 bool LFileInfo::isImage(){
-  if(!mime.startsWith("image/")){ return false; } //quick return for non-image files
+  loadExtraInfo();
+  if(!extra->mime.startsWith("image/")){ return false; } //quick return for non-image files
   //Check the Qt subsystems to see if this image file can be read
   return ( !LUtils::imageExtensions().filter(this->suffix().toLower()).isEmpty() );
 }
 
 bool LFileInfo::isAVFile(){
-  return (mime.startsWith("audio/") || mime.startsWith("video/") );
+  loadExtraInfo();
+  return (extra->mime.startsWith("audio/") || extra->mime.startsWith("video/") );
 }
 
 
@@ -706,6 +832,52 @@ void LXDG::setEnvironmentVars(){
   //Don't set "XDG_RUNTIME_DIR" yet - need to look into the specs
 }
 
+//Icon file index (see LXDG::loadIconIndex())
+static QMutex iconIndexLock;
+static QString iconIndexTheme;
+static QSet<QString> iconIndexFiles; //"<search set>:<file name>" (same format as the findIcon() checks)
+static QSet<QString> iconIndexNames; //icon names (no extension)
+
+//The icon directories which findIcon() searches: current theme, Lumina base icon set, XDG fallback
+static void iconSearchDirs(QString cTheme, QStringList &theme, QStringList &oxy, QStringList &fall){
+  // - Get all the base icon directories
+  QStringList paths;
+    paths << QDir::homePath()+"/.icons/"; //ordered by priority - local user dirs first
+    QStringList xdd = QString(getenv("XDG_DATA_HOME")).split(":");
+      xdd << QString(getenv("XDG_DATA_DIRS")).split(":");
+      for(int i=0; i<xdd.length(); i++){
+        if(QFile::exists(xdd[i]+"/icons")){ paths << xdd[i]+"/icons/"; }
+      }
+  //Now load all the dirs into the search paths
+  for(int i=0; i<paths.length(); i++){
+    theme << LXDG::getChildIconDirs( paths[i]+cTheme);
+    oxy << LXDG::getChildIconDirs(paths[i]+"oxygen"); //Lumina base icon set
+    fall << LXDG::getChildIconDirs(paths[i]+"hicolor"); //XDG fallback (apps add to this)
+  }
+}
+
+void LXDG::loadIconIndex(QString theme){
+  //List the icon directories once, instead of checking each one for every icon lookup
+  if(theme.isEmpty()){ theme = "oxygen"; } //same default as findIcon()
+  QStringList dirs[3];
+  iconSearchDirs(theme, dirs[0], dirs[1], dirs[2]);
+  QStringList srch; srch << "icontheme" << "oxygen" << "fallback";
+  QSet<QString> files, names;
+  for(int s=0; s<3; s++){
+    for(int d=0; d<dirs[s].length(); d++){
+      QStringList list = QDir(dirs[s][d]).entryList(QStringList() << "*.png" << "*.svg", QDir::Files | QDir::NoDotAndDotDot, QDir::NoSort);
+      for(int i=0; i<list.length(); i++){
+        files.insert(srch[s]+":"+list[i]);
+        names.insert(list[i].section(".",0,-2));
+      }
+    }
+  }
+  QMutexLocker lock(&iconIndexLock);
+  iconIndexTheme = theme;
+  iconIndexFiles = files;
+  iconIndexNames = names;
+}
+
 QIcon LXDG::findIcon(QString iconName, QString fallback){
   //NOTE: This was re-written on 11/10/15 to avoid using the QIcon::fromTheme() framework
   //   -- Too many issues with SVG files and/or search paths with the built-in system
@@ -731,33 +903,26 @@ QIcon LXDG::findIcon(QString iconName, QString fallback){
   //Make sure the current search paths correspond to this theme
   if( QDir::searchPaths("icontheme").filter("/"+cTheme+"/").isEmpty() ){
     //Need to reset search paths: setup the "icontheme" "oxygen" and "fallback" sets
-    // - Get all the base icon directories
-    QStringList paths;
-      paths << QDir::homePath()+"/.icons/"; //ordered by priority - local user dirs first
-      QStringList xdd = QString(getenv("XDG_DATA_HOME")).split(":");
-        xdd << QString(getenv("XDG_DATA_DIRS")).split(":");
-        for(int i=0; i<xdd.length(); i++){
-          if(QFile::exists(xdd[i]+"/icons")){ paths << xdd[i]+"/icons/"; }
-        }
-    //Now load all the dirs into the search paths
     QStringList theme, oxy, fall;
-    for(int i=0; i<paths.length(); i++){
-      theme << getChildIconDirs( paths[i]+cTheme);
-      oxy << getChildIconDirs(paths[i]+"oxygen"); //Lumina base icon set
-      fall << getChildIconDirs(paths[i]+"hicolor"); //XDG fallback (apps add to this)
-    }
+    iconSearchDirs(cTheme, theme, oxy, fall);
     //fall << LOS::AppPrefix()+"share/pixmaps"; //always use this as well as a final fallback
     QDir::setSearchPaths("icontheme", theme);
     QDir::setSearchPaths("oxygen", oxy);
     QDir::setSearchPaths("fallback", fall);
     //qDebug() << "Setting Icon Search Paths:" << "\nicontheme:" << theme << "\noxygen:" << oxy << "\nfallback:" << fall;
   }
+  //Use the icon index if there is one for this theme (names it does not know about get checked on disk - installed later)
+  QSet<QString> index;
+  iconIndexLock.lock();
+  bool indexed = (iconIndexTheme==cTheme && iconIndexNames.contains(iconName));
+  if(indexed){ index = iconIndexFiles; } //implicitly shared - no copy
+  iconIndexLock.unlock();
   //Find the icon in the search paths
   QIcon ico;
   QStringList srch; srch << "icontheme" << "oxygen" << "fallback";
   for(int i=0; i<srch.length() && ico.isNull(); i++){
     //Look for a svg first
-    if(QFile::exists(srch[i]+":"+iconName+".svg") ){
+    if( indexed ? index.contains(srch[i]+":"+iconName+".svg") : QFile::exists(srch[i]+":"+iconName+".svg") ){
         //Be careful about how an SVG is loaded - needs to render the image onto a paint device
         QSvgRenderer svg;
         if( svg.load(srch[i]+":"+iconName+".svg") ){
@@ -776,7 +941,7 @@ QIcon LXDG::findIcon(QString iconName, QString fallback){
           qDebug() << "Found bad SVG file:" << iconName+".svg  Theme:" << srch[i];
         }
     }
-    if(QFile::exists(srch[i]+":"+iconName+".png")){
+    if( indexed ? index.contains(srch[i]+":"+iconName+".png") : QFile::exists(srch[i]+":"+iconName+".png") ){
       //simple PNG image - load directly into the QIcon structure
       ico.addFile(srch[i]+":"+iconName+".png");
     }
@@ -930,31 +1095,79 @@ QStringList LXDG::findFilesForMime(QString mime){
 QStringList LXDG::listFileMimeDefaults(){
   //This will spit out a itemized list of all the mimetypes and relevant info
   // Output format: <mimetype>::::<extension>::::<default>::::<localized comment>
-  QStringList mimes = LXDG::loadMimeFileGlobs2();
-  //Remove all the application files from the list (only a single app defines/uses this type in general)
-  /*QStringList apps = mimes.filter(":application/");
-  //qDebug() << "List Mime Defaults";
-  for(int i=0; i<apps.length(); i++){ mimes.removeAll(apps[i]); }*/
-  //Now start filling the output list
+  QStringList mimes;
+  QHash<QString, QStringList> exts = LXDG::groupMimeFileGlobs(&mimes);
+  QHash<QString, QString> defaults = LXDG::findDefaultAppsForMimes(mimes);
+  QHash<QString, QString> comments = LXDG::findMimeComments(mimes);
+  //Now fill the output list
   QStringList out;
   for(int i=0; i<mimes.length(); i++){
-    QString mimetype = mimes[i].section(":",1,1);
-    QStringList tmp = mimes.filter(mimetype);
-    //Collect all the different extensions with this mimetype
-    QStringList extlist;
-    for(int j=0; j<tmp.length(); j++){
-      mimes.removeAll(tmp[j]);
-      extlist << tmp[j].section(":",2,2);
+    out << mimes[i]+"::::"+exts.value(mimes[i]).join(", ")+"::::"+defaults.value(mimes[i])+"::::"+comments.value(mimes[i]);
+  }
+  return out;
+}
+
+QHash<QString, QStringList> LXDG::groupMimeFileGlobs(QStringList *mimes){
+  //Single pass over the globs2 entries (<weight>:<mime type>:<file extension>)
+  QStringList globs = LXDG::loadMimeFileGlobs2();
+  QHash<QString, QStringList> out;
+  for(int i=0; i<globs.length(); i++){
+    QString mimetype = globs[i].section(":",1,1);
+    if(mimetype.isEmpty()){ continue; }
+    QString ext = globs[i].section(":",2,2);
+    QStringList &extlist = out[mimetype];
+    if(!extlist.contains(ext)){ extlist << ext; } //only a couple extensions per type
+  }
+  if(mimes!=0){
+    *mimes = out.keys();
+    mimes->sort();
+  }
+  return out;
+}
+
+QHash<QString, QString> LXDG::findMimeComments(QStringList mimes){
+  //Read the comments out of the mime packages (every package file only gets parsed once)
+  // - same priority as findMimeComment(): directory order, then full language, short language, general comment
+  QHash<QString, QString> out;
+  QSet<QString> wanted = mimes.toSet();
+  QStringList dirs = LXDG::systemMimeDirs();
+  QString lang = QString(getenv("LANG")).section(".",0,0);
+  QString shortlang = lang.section("_",0,0);
+  for(int i=0; i<dirs.length() && !wanted.isEmpty(); i++){
+    QDir pkgdir(dirs[i]+"/packages");
+    QStringList pkgs = pkgdir.entryList(QStringList() << "*.xml", QDir::Files, QDir::Name);
+    for(int p=0; p<pkgs.length() && !wanted.isEmpty(); p++){ //done as soon as every type has a comment
+      QFile file(pkgdir.absoluteFilePath(pkgs[p]));
+      if(!file.open(QIODevice::ReadOnly)){ continue; }
+      QXmlStreamReader xml(&file);
+      QString type, comment;
+      int rank = 0; //0: none, 1: general comment, 2: short language, 3: full language
+      while(!xml.atEnd()){
+        xml.readNext();
+        if(xml.isStartElement()){
+          if(xml.name()==QLatin1String("mime-type")){
+            type = xml.attributes().value("type").toString();
+            if(!wanted.contains(type)){ type.clear(); xml.skipCurrentElement(); } //not needed (or already found)
+            comment.clear(); rank = 0;
+          }else if(xml.name()==QLatin1String("comment") && !type.isEmpty()){
+            QString clang = xml.attributes().value("xml:lang").toString();
+            int crank = clang.isEmpty() ? 1 : ( (clang==lang) ? 3 : ( (clang==shortlang) ? 2 : 0) );
+            QString text = xml.readElementText();
+            if(crank>rank){ rank = crank; comment = text; }
+          }
+        }else if(xml.isEndElement() && xml.name()==QLatin1String("mime-type")){
+          if(!type.isEmpty() && rank>0){ out.insert(type, comment); wanted.remove(type); }
+          type.clear();
+        }
+      }
+      file.close();
     }
-    extlist.removeDuplicates(); //just in case
-    //Now look for a current default for this mimetype
-    QString dapp = LXDG::findDefaultAppForMime(mimetype); //default app;
-    
-    //Create the output entry
-    //qDebug() << "Mime entry:" << i << mimetype << dapp;
-    out << mimetype+"::::"+extlist.join(", ")+"::::"+dapp+"::::"+LXDG::findMimeComment(mimetype);
-    
-    i--; //go back one (continue until the list is empty)
+  }
+  //Types which are not in any package (or no package files available): fall back on the individual files
+  QStringList missing = wanted.toList();
+  for(int i=0; i<missing.length(); i++){
+    QString comment = LXDG::findMimeComment(missing[i]);
+    if(!comment.isEmpty()){ out.insert(missing[i], comment); }
   }
   return out;
 }
@@ -980,8 +1193,9 @@ QString LXDG::findMimeComment(QString mime){
   return comment;
 }
 
-QString LXDG::findDefaultAppForMime(QString mime){
-  //First get the priority-ordered list of default file locations
+//Priority-ordered list of the mimeapps.list files (path, contents) - only the files which exist and are not empty
+static QList< QPair<QString, QStringList> > readMimeAppsLists(){
+  //Priority-ordered list of default file locations
   QStringList dirs;
   dirs << QString(getenv("XDG_CONFIG_HOME"))+"/lumina-mimeapps.list" \
 	 << QString(getenv("XDG_CONFIG_HOME"))+"/mimeapps.list";
@@ -994,15 +1208,24 @@ QString LXDG::findDefaultAppForMime(QString mime){
 	for(int i=0; i<tmp.length(); i++){ dirs << tmp[i]+"/applications/lumina-mimeapps.list"; }
 	for(int i=0; i<tmp.length(); i++){ dirs << tmp[i]+"/applications/mimeapps.list"; }
 	
-  //Now go through all the files in order of priority until a default is found
-  QString cdefault;
-  for(int i=0; i<dirs.length() && cdefault.isEmpty(); i++){
+  QList< QPair<QString, QStringList> > out;
+  for(int i=0; i<dirs.length(); i++){
     if(!QFile::exists(dirs[i])){ continue; }
     QStringList info = LUtils::readFile(dirs[i]);
-    if(info.isEmpty()){ continue; }
+    if(!info.isEmpty()){ out << qMakePair(dirs[i], info); }
+  }
+  return out;
+}
+
+//Find the default application for a mime-type within the (already loaded) mimeapps.list files
+static QString defaultAppFromLists(QString mime, const QList< QPair<QString, QStringList> > &lists){
+  //Now go through all the files in order of priority until a default is found
+  QString cdefault;
+  for(int i=0; i<lists.length() && cdefault.isEmpty(); i++){
+    const QStringList &info = lists[i].second;
     QStringList white; //lists to keep track of during the search (black unused at the moment)
-    QString workdir = dirs[i].section("/",0,-2); //just the directory
-   // qDebug() << "Check File:" << mime << dirs[i] << workdir;
+    QString workdir = lists[i].first.section("/",0,-2); //just the directory
+   // qDebug() << "Check File:" << mime << lists[i].first << workdir;
     int def = info.indexOf("[Default Applications]"); //find this line to start on
     if(def>=0){
       for(int d=def+1; d<info.length(); d++){
@@ -1079,6 +1302,21 @@ QString LXDG::findDefaultAppForMime(QString mime){
   return cdefault;
 }
 
+QString LXDG::findDefaultAppForMime(QString mime){
+  return defaultAppFromLists(mime, readMimeAppsLists());
+}
+
+QHash<QString, QString> LXDG::findDefaultAppsForMimes(QStringList mimes){
+  //Same as findDefaultAppForMime() - but the mimeapps.list files only get read once
+  QList< QPair<QString, QStringList> > lists = readMimeAppsLists();
+  QHash<QString, QString> out;
+  for(int i=0; i<mimes.length(); i++){
+    QString def = defaultAppFromLists(mimes[i], lists);
+    if(!def.isEmpty()){ out.insert(mimes[i], def); }
+  }
+  return out;
+}
+
 QStringList LXDG::findAvailableAppsForMime(QString mime){
   QStringList dirs = LXDG::systemApplicationDirs();
   QStringList out;
@@ -1149,6 +1387,7 @@ QStringList LXDG::findAVFileExtensions(){
 
 QStringList LXDG::loadMimeFileGlobs2(){
   //output format: <weight>:<mime type>:<file extension (*.something)>
+  QMutexLocker locker(&globsLock);
   if(mimeglobs.isEmpty() || (mimechecktime < (QDateTime::currentMSecsSinceEpoch()-30000)) ){
     //qDebug() << "Loading globs2 mime DB files";
     mimeglobs.clear();
@@ -1177,6 +1416,59 @@ QStringList LXDG::loadMimeFileGlobs2(){
   return mimeglobs;
 }
 
+//==== XDGMimeDefaults Functions ====
+#define MIMEROWS_BATCH 100 //rows sent out at a time
+
+XDGMimeDefaults::XDGMimeDefaults(QObject *parent) : QObject(parent){
+  runID = 0;
+  //Rows come from the worker thread
+  connect(this, SIGNAL(rowsBuilt(int, QStringList)), this, SLOT(sendRows(int, QStringList)), Qt::QueuedConnection );
+  connect(this, SIGNAL(buildDone(int)), this, SLOT(sendFinished(int)), Qt::QueuedConnection );
+}
+
+XDGMimeDefaults::~XDGMimeDefaults(){
+  stop();
+  future.waitForFinished(); //the worker uses this object
+}
+
+void XDGMimeDefaults::start(){
+  stop(); //the previous build (if any) quits at the next check - no need to wait for it
+  future = QtConcurrent::run(this, &XDGMimeDefaults::build, (int) runID.load());
+}
+
+void XDGMimeDefaults::stop(){
+  runID.fetchAndAddOrdered(1);
+}
+
+bool XDGMimeDefaults::isRunning(){
+  return future.isRunning();
+}
+
+void XDGMimeDefaults::build(int id){
+  //Same table as LXDG::listFileMimeDefaults() - but sent out in batches while the defaults get resolved
+  QStringList mimes;
+  QHash<QString, QStringList> exts = LXDG::groupMimeFileGlobs(&mimes);
+  if(runID.load()!=id){ return; }
+  QHash<QString, QString> comments = LXDG::findMimeComments(mimes);
+  QList< QPair<QString, QStringList> > lists = readMimeAppsLists();
+  QStringList rows;
+  for(int i=0; i<mimes.length(); i++){
+    if(runID.load()!=id){ return; } //aborted
+    rows << mimes[i]+"::::"+exts.value(mimes[i]).join(", ")+"::::"+defaultAppFromLists(mimes[i], lists)+"::::"+comments.value(mimes[i]);
+    if(rows.length()>=MIMEROWS_BATCH){ emit rowsBuilt(id, rows); rows.clear(); }
+  }
+  if(!rows.isEmpty()){ emit rowsBuilt(id, rows); }
+  emit buildDone(id);
+}
+
+void XDGMimeDefaults::sendRows(int id, QStringList rows){
+  if(id==runID.load()){ emit RowsReady(rows); } //drop rows from an old build
+}
+
+void XDGMimeDefaults::sendFinished(int id){
+  if(id==runID.load()){ emit Finished(); }
+}
+
 //Find all the autostart *.desktop files
 QList<XDGDesktop*> LXDG::findAutoStartFiles(bool includeInvalid){
 	
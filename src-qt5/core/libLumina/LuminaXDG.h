@@ -30,6 +30,14 @@
 #include <QTextStream>
 #include <QDateTime>
 #include <QDebug>
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QSharedData>
+#include <QSharedPointer>
+#include <QFuture>
+
+#include "LuminaFileWatcher.h"
 
 
 // ======================
@@ -66,6 +74,10 @@ public:
   QList<XDGDesktopAction> actions;
     //Type 1 Extensions for Lumina (Optional)
     bool useVGL; //X-VGL
+    //Autostart ordering (Optional)
+    QString startPhase; //X-GNOME-Autostart-Phase or X-KDE-autostart-phase
+    QStringList startAfter; //X-KDE-autostart-after (other autostart entries)
+    int startDelay; //X-GNOME-Autostart-Delay (seconds)
 
   //Type 2 (LINK) variables
   QString url;
@@ -96,6 +108,18 @@ public:
 	//Main Interface functions
 	QList<XDGDesktop*> apps(bool showAll, bool showHidden); //showAll: include invalid files, showHidden: include NoShow/Hidden files
 
+	//Background loading (for faster startups)
+	// - readSystemFiles() can be run on any thread: the returned structures have no parent and get moved to the "owner" thread
+	// - addFiles() (owner thread only) takes ownership of them before the first updateList() call, so they do not need to be read again
+	static QList<XDGDesktop*> readSystemFiles(QThread *owner);
+	void addFiles(QList<XDGDesktop*> list);
+
+	//Shared application registry (see LuminaAppRegistry.h)
+	// - by default the list gets loaded from the snapshot of the running session (no *.desktop parsing),
+	//     and falls back to reading the files when no session is available
+	// - the session list (host) reads the files itself, and publishes the snapshot whenever the list changes
+	void setRegistryHost(bool host);
+
 	//Administration variables (not typically used directly)
 	QDateTime lastCheck;
 	QStringList newApps, removedApps; //list of "new/removed" apps found during the last check
@@ -105,9 +129,13 @@ public slots:
 	void updateList(); //run the check routine
 
 private:
-	QFileSystemWatcher *watcher;
+	LFileWatcher *watcher; //application directories (shared inotify service)
 	QTimer *synctimer;
 	bool keepsynced;
+	bool registryHost;
+	quint32 registryGen; //generation of the loaded snapshot (0: files were read locally)
+
+	bool loadRegistry(bool *changed);
 
 private slots:
 	void watcherChanged();
@@ -115,14 +143,57 @@ signals:
 	void appsUpdated();
 };
 
+// ========================
+//  Streaming builder for the mime defaults table (same rows as LXDG::listFileMimeDefaults())
+//  - start() builds the table on a worker thread, and the rows get sent out in batches (RowsReady)
+//  - stop() (or calling start() again) aborts the current build: no more rows from that build get sent out
+// ========================
+class XDGMimeDefaults : public QObject{
+	Q_OBJECT
+public:
+	XDGMimeDefaults(QObject *parent = 0);
+	~XDGMimeDefaults();
+
+	void start();
+	void stop();
+	bool isRunning();
+
+private:
+	QFuture<void> future;
+	QAtomicInt runID; //current build (anything else is stale)
+
+	void build(int id); //worker thread
+
+private slots:
+	void sendRows(int id, QStringList rows);
+	void sendFinished(int id);
+
+signals:
+	void RowsReady(QStringList); //<mimetype>::::<extensions>::::<default>::::<localized comment> (sorted by mimetype)
+	void Finished();
+	//Internal (worker thread -> owner thread)
+	void rowsBuilt(int, QStringList);
+	void buildDone(int);
+};
+
 // ========================
 // File Information simplification class (combine QFileInfo with XDGDesktop)
 //  Need some extra information not usually available by a QFileInfo
+//  - Cheap to construct/copy: the extra information (mimetype/icon/desktop entry) is only
+//      loaded on the first use, and then shared between all copies (safe to use from any thread)
+//  - Desktop entries come from a shared cache (re-read when the file changes): treat them as read-only
 // ========================
+class LFileInfoData : public QSharedData{
+public:
+	QMutex lock;
+	QAtomicInt loaded;
+	QString mime, icon;
+	QSharedPointer<XDGDesktop> desk;
+};
+
 class LFileInfo : public QFileInfo{
 private:
-	QString mime, icon;
-	XDGDesktop *desk;
+	QExplicitlySharedDataPointer<LFileInfoData> extra;
 
 	void loadExtraInfo();
 	
@@ -131,9 +202,6 @@ public:
 	LFileInfo();
 	LFileInfo(QString filepath);
 	LFileInfo(QFileInfo info);
-	~LFileInfo(){ 
-	  desk->deleteLater(); 
-	}
 	
 	//Functions for accessing the extra information
 	// -- Return the mimetype for the file
@@ -145,7 +213,7 @@ public:
 	// -- Check if this is an XDG desktop file
 	bool isDesktopFile();
 	
-	// -- Allow access to the internal XDG desktop data structure
+	// -- Allow access to the internal XDG desktop data structure (shared: do not modify)
 	XDGDesktop* XDG();
 	
 	//Other file type identification routines
@@ -183,6 +251,8 @@ public:
 	static void setEnvironmentVars();
 	//Find an icon from the current/default theme
 	static QIcon findIcon(QString iconName, QString fallback = "");
+	//Index the icon files of a theme (can be run on any thread - findIcon() uses it instead of checking the disk)
+	static void loadIconIndex(QString theme);
 	//Recursivly compile a list of child directories with *.png files in them
 	static QStringList getChildIconDirs(QString parent);
 	//List all the mime-type directories
@@ -195,6 +265,10 @@ public:
 	static QStringList findFilesForMime(QString mime);
 	// Simplification function for finding all info regarding current mime defaults
 	static QStringList listFileMimeDefaults();
+	//Batched versions of the lookups below (for the mime defaults table - every file only gets read once)
+	static QHash<QString, QStringList> groupMimeFileGlobs(QStringList *mimes = 0); //mimetype -> file extensions (mimes: sorted list of types)
+	static QHash<QString, QString> findMimeComments(QStringList mimes);
+	static QHash<QString, QString> findDefaultAppsForMimes(QStringList mimes);
 	//Find the localized comment string for a particular mime-type
 	static QString findMimeComment(QString mime);
 	//Find the default application for a mime-type
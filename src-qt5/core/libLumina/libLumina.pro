@@ -25,13 +25,21 @@ HEADERS	+= LuminaXDG.h \
 	LuminaX11.h \
 	LuminaThemes.h \
 	LuminaOS.h \
-	LuminaSingleApplication.h
+	LuminaSingleApplication.h \
+	LuminaChecksums.h \
+	LuminaHardware.h \
+	LuminaFileWatcher.h \
+	LuminaAppRegistry.h
 
 SOURCES	+= LuminaXDG.cpp \
 	LuminaUtils.cpp \
 	LuminaX11.cpp \
 	LuminaThemes.cpp \
-	LuminaSingleApplication.cpp
+	LuminaSingleApplication.cpp \
+	LuminaChecksums.cpp \
+	LuminaHardware.cpp \
+	LuminaFileWatcher.cpp \
+	LuminaAppRegistry.cpp
 
 # Also load the OS template as available for
 # LuminaOS support functions (or fall back to generic one)
@@ -43,7 +51,14 @@ exists($${PWD}/LuminaOS-$${LINUX_DISTRO}.cpp){
   SOURCES += LuminaOS-template.cpp
 }
 
-LIBS	+= -lc -lxcb -lxcb-ewmh -lxcb-icccm -lxcb-image -lxcb-composite -lxcb-damage -lxcb-util -lXdamage 
+LIBS	+= -lc -lxcb -lxcb-ewmh -lxcb-icccm -lxcb-image -lxcb-composite -lxcb-damage -lxcb-util -lxcb-shm -lxcb-randr -lXdamage 
+
+#Native audio mixer access (ALSA on Linux, OSS on the BSDs does not need a library)
+packagesExist(alsa){
+  CONFIG += link_pkgconfig
+  PKGCONFIG += alsa
+  DEFINES += HAVE_ALSA
+}
 
 include.path=$${L_INCLUDEDIR}
 include.files=LuminaXDG.h \
@@ -51,7 +66,11 @@ include.files=LuminaXDG.h \
 	LuminaX11.h \
 	LuminaThemes.h \
 	LuminaOS.h \
-	LuminaSingleApplication.h
+	LuminaSingleApplication.h \
+	LuminaChecksums.h \
+	LuminaHardware.h \
+	LuminaFileWatcher.h \
+	LuminaAppRegistry.h
 
 colors.path=$${L_SHAREDIR}/lumina-desktop/colors
 colors.files=colors/*.qss.colors
@@ -12,11 +12,13 @@ AppMenu::AppMenu(QWidget* parent) : QMenu(parent){
   appstorelink = LOS::AppStoreShortcut(); //Default application "store" to display (AppCafe in TrueOS)
   controlpanellink = LOS::ControlPanelShortcut(); //Default control panel
   sysApps = new XDGDesktopList(this, true); //have this one automatically keep in sync
+    sysApps->setRegistryHost(true); //the session shares this list with the other Lumina utilities
   APPS.clear();
   //watcher = new QFileSystemWatcher(this);
     //connect(watcher, SIGNAL(directoryChanged(QString)), this, SLOT(watcherUpdate()) );
-  //QTimer::singleShot(200, this, SLOT(start()) ); //Now start filling the menu
-  start(); //do the initial run during session init so things are responsive immediately.
+  //Placeholder until the application list gets loaded (see loadApps() - the session reads the files in the background)
+  this->setTitle(tr("Applications"));
+  this->setIcon( LXDG::findIcon("system-run","") );
   connect(QApplication::instance(), SIGNAL(LocaleChanged()), this, SLOT(watcherUpdate()) );
   connect(QApplication::instance(), SIGNAL(IconThemeChanged()), this, SLOT(watcherUpdate()) );
 }
@@ -29,6 +31,11 @@ QHash<QString, QList<XDGDesktop*> >* AppMenu::currentAppHash(){
   return &APPS;
 }
 
+void AppMenu::loadApps(QList<XDGDesktop*> preloaded){
+  sysApps->addFiles(preloaded); //already read - no need to parse these files again
+  start();
+}
+
 //===========
 //  PRIVATE
 //===========
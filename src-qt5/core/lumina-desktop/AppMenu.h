@@ -32,6 +32,7 @@ public:
 	~AppMenu();
 
 	QHash<QString, QList<XDGDesktop*> > *currentAppHash();
+	void loadApps(QList<XDGDesktop*> preloaded); //initial fill (the menu is empty until this is called)
 	QDateTime lastHashUpdate;
 
 private:
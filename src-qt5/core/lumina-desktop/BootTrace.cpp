@@ -0,0 +1,91 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "BootTrace.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QHash>
+#include <QStringList>
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+#include <QCoreApplication>
+#include <QDebug>
+
+static QElapsedTimer traceClock;
+static QMutex traceMutex;
+static QString traceFile;
+static QStringList traceEvents; //JSON objects
+static QHash<QString, qint64> traceOpen; //stage name -> start time (microseconds)
+static bool traceWritten = false;
+
+static qint64 traceNow(){
+  return traceClock.nsecsElapsed()/1000;
+}
+
+static QString traceThread(){
+  return QString::number( (quintptr) QThread::currentThreadId() );
+}
+
+static QString traceEscape(QString str){
+  return str.replace("\\","\\\\").replace("\"","\\\"");
+}
+
+void BootTrace::init(){
+  QMutexLocker lock(&traceMutex);
+  if(traceClock.isValid()){ return; }
+  traceClock.start();
+  traceFile = QString::fromLocal8Bit( qgetenv("LUMINA_BOOT_TRACE") );
+}
+
+bool BootTrace::enabled(){
+  QMutexLocker lock(&traceMutex);
+  return !traceFile.isEmpty() && !traceWritten;
+}
+
+void BootTrace::start(QString stage){
+  if(!enabled()){ return; }
+  QMutexLocker lock(&traceMutex);
+  traceOpen.insert(stage, traceNow());
+}
+
+void BootTrace::finish(QString stage){
+  if(!enabled()){ return; }
+  QMutexLocker lock(&traceMutex);
+  if(!traceOpen.contains(stage)){ return; }
+  qint64 begin = traceOpen.take(stage);
+  traceEvents << QString("{\"name\":\"%1\",\"cat\":\"startup\",\"ph\":\"X\",\"ts\":%2,\"dur\":%3,\"pid\":%4,\"tid\":%5}") \
+	.arg(traceEscape(stage), QString::number(begin), QString::number(traceNow()-begin), QString::number(QCoreApplication::applicationPid()), traceThread());
+}
+
+void BootTrace::mark(QString event){
+  if(!enabled()){ return; }
+  QMutexLocker lock(&traceMutex);
+  traceEvents << QString("{\"name\":\"%1\",\"cat\":\"startup\",\"ph\":\"i\",\"s\":\"p\",\"ts\":%2,\"pid\":%3,\"tid\":%4}") \
+	.arg(traceEscape(event), QString::number(traceNow()), QString::number(QCoreApplication::applicationPid()), traceThread());
+}
+
+void BootTrace::write(){
+  if(!enabled()){ return; }
+  QMutexLocker lock(&traceMutex);
+  traceWritten = true;
+  //Close out any stages which never finished (so they are still visible)
+  QStringList open = traceOpen.keys();
+  for(int i=0; i<open.length(); i++){
+    qint64 begin = traceOpen.take(open[i]);
+    traceEvents << QString("{\"name\":\"%1 (unfinished)\",\"cat\":\"startup\",\"ph\":\"X\",\"ts\":%2,\"dur\":%3,\"pid\":%4,\"tid\":0}") \
+	.arg(traceEscape(open[i]), QString::number(begin), QString::number(traceNow()-begin), QString::number(QCoreApplication::applicationPid()));
+  }
+  QFile file(traceFile);
+  if( !file.open(QIODevice::WriteOnly | QIODevice::Truncate) ){ qDebug() << "Could not write boot trace:" << traceFile; return; }
+  QTextStream out(&file);
+  out << "{\"traceEvents\":[\n" << traceEvents.join(",\n") << "\n]}\n";
+  file.close();
+  qDebug() << "Boot trace saved:" << traceFile;
+  traceEvents.clear();
+}
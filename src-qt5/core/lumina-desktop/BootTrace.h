@@ -0,0 +1,29 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Startup timeline recorder for the session
+//  Set LUMINA_BOOT_TRACE=<file> to have the timeline written in the Chrome
+//   trace-event JSON format (load it in chrome://tracing to view)
+//  All functions are thread-safe and do nothing if the trace is not enabled
+//===========================================
+#ifndef _LUMINA_DESKTOP_BOOT_TRACE_H
+#define _LUMINA_DESKTOP_BOOT_TRACE_H
+
+#include <QString>
+
+class BootTrace{
+public:
+	static void init(); //start the clock (call as early as possible)
+	static bool enabled();
+
+	static void start(QString stage); //stage names must be unique
+	static void finish(QString stage);
+	static void mark(QString event); //single point in time
+
+	static void write(); //save the trace file (only the first call does anything)
+};
+
+#endif
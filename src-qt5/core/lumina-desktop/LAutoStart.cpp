@@ -0,0 +1,184 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LAutoStart.h"
+#include "BootTrace.h"
+
+#include <QProcess>
+#include <QDateTime>
+#include <QDebug>
+
+#include <LuminaXDG.h>
+#include <LuminaUtils.h>
+
+LAutoStart::LAutoStart(QObject *parent) : QObject(parent){
+  phase = Initialization;
+  finished = false;
+#ifdef __linux__
+  haveIonice = LUtils::isValidBinary("ionice");
+#else
+  haveIonice = false;
+#endif
+  delayTimer = new QTimer(this);
+    delayTimer->setSingleShot(true);
+    connect(delayTimer, SIGNAL(timeout()), this, SLOT(delayTimeout()) );
+}
+
+LAutoStart::~LAutoStart(){
+
+}
+
+QList<LAutoStartEntry> LAutoStart::readEntries(){
+  //Only the valid/enabled entries (overrides between the autostart directories already applied)
+  QList<XDGDesktop*> xdgapps = LXDG::findAutoStartFiles();
+  QList<LAutoStartEntry> out;
+  for(int i=0; i<xdgapps.length(); i++){
+    LAutoStartEntry entry;
+    entry.file = xdgapps[i]->filePath;
+    entry.id = entry.file.section("/",-1).section(".desktop",0,0);
+    //Generate command and clean up any stray "Exec" field codes (should not be any here)
+    entry.cmd = xdgapps[i]->getDesktopExec();
+    if(entry.cmd.contains("%")){ entry.cmd = entry.cmd.remove("%U").remove("%u").remove("%F").remove("%f").remove("%i").remove("%c").remove("%k").simplified(); }
+    entry.phase = phaseNumber(xdgapps[i]->startPhase);
+    entry.delay = qMax(xdgapps[i]->startDelay, 0)*1000;
+    entry.after = xdgapps[i]->startAfter;
+    entry.due = 0;
+    if(!entry.cmd.isEmpty()){ out << entry; }
+    delete xdgapps[i]; //no parent, created on this thread
+  }
+  return out;
+}
+
+void LAutoStart::start(QList<LAutoStartEntry> entries){
+  pending = entries;
+  delayed.clear();
+  launched.clear();
+  finished = false;
+  phase = Initialization;
+  BootTrace::start("autostart-"+phaseName(phase));
+  runPhase();
+}
+
+// ===================
+//  PRIVATE
+// ===================
+int LAutoStart::phaseNumber(QString phase){
+  //GNOME phase names and KDE phase numbers
+  phase = phase.toLower();
+  if(phase=="earlyinitialization" || phase=="predisplayserver" || phase=="initialization" || phase=="0"){ return Initialization; }
+  else if(phase=="windowmanager" || phase=="panel" || phase=="desktop" || phase=="1"){ return Desktop; }
+  return Applications; //default
+}
+
+QString LAutoStart::phaseName(int phase){
+  if(phase==Initialization){ return "initialization"; }
+  else if(phase==Desktop){ return "desktop"; }
+  return "applications";
+}
+
+QString LAutoStart::priorityPrefix(int phase){
+  //Initialization: normal priority (session services), Desktop: slightly lower, Applications: low (tray apps and such)
+  if(phase==Initialization){ return ""; }
+  QString prefix = "nice -n "+QString(phase==Desktop ? "5" : "10")+" ";
+  if(haveIonice){ prefix.prepend("ionice -c 2 -n "+QString(phase==Desktop ? "5" : "7")+" "); } //best-effort class, lower priority
+  return prefix;
+}
+
+bool LAutoStart::isReady(const LAutoStartEntry &entry){
+  //Wait for the "after" entries which still get launched in this (or an earlier) phase
+  for(int i=0; i<entry.after.length(); i++){
+    if(launched.contains(entry.after[i])){ continue; }
+    for(int p=0; p<pending.length(); p++){
+      if(pending[p].id==entry.after[i] && pending[p].phase<=phase){ return false; }
+    }
+    for(int d=0; d<delayed.length(); d++){
+      if(delayed[d].id==entry.after[i]){ return false; }
+    }
+    //Not an autostart entry (or only launched in a later phase) - nothing to wait for
+  }
+  return true;
+}
+
+void LAutoStart::launch(const LAutoStartEntry &entry){
+  QString cmd = priorityPrefix(entry.phase)+entry.cmd;
+  qDebug() << " - Auto-Starting File:" << entry.file << "Phase:" << phaseName(entry.phase);
+  BootTrace::start("autostart: "+entry.id);
+  QProcess::startDetached(cmd);
+  BootTrace::finish("autostart: "+entry.id);
+  launched << entry.id;
+}
+
+void LAutoStart::scheduleDelayed(){
+  if(delayed.isEmpty()){ return; }
+  qint64 next = delayed.first().due;
+  for(int i=1; i<delayed.length(); i++){ next = qMin(next, delayed[i].due); }
+  delayTimer->start( qMax(next-QDateTime::currentMSecsSinceEpoch(), (qint64) 0) );
+}
+
+// ===================
+//  PRIVATE SLOTS
+// ===================
+void LAutoStart::runPhase(){
+  if(finished){ return; }
+  if(phase<=Applications){
+    //Launch everything which is ready (launching one entry can make others ready)
+    bool changed = true;
+    while(changed){
+      changed = false;
+      for(int i=0; i<pending.length(); i++){
+        if(pending[i].phase!=phase || !isReady(pending[i])){ continue; }
+        LAutoStartEntry entry = pending.takeAt(i);
+        i--;
+        if(entry.delay>0){
+          entry.due = QDateTime::currentMSecsSinceEpoch()+entry.delay;
+          delayed << entry;
+        }else{
+          launch(entry);
+          changed = true;
+        }
+      }
+    }
+    //Only wait if something left in this phase depends on one of the delayed entries
+    bool left = false, waiting = false;
+    for(int i=0; i<pending.length() && !waiting; i++){
+      if(pending[i].phase!=phase){ continue; }
+      left = true;
+      for(int d=0; d<delayed.length() && !waiting; d++){ waiting = pending[i].after.contains(delayed[d].id); }
+    }
+    if(waiting){ scheduleDelayed(); return; } //waiting on a delayed entry
+    //Anything left in this phase waits on an entry which will never be launched (loop) - launch them anyway
+    for(int i=0; i<pending.length() && left; i++){
+      if(pending[i].phase!=phase){ continue; }
+      qDebug() << " - Auto-Start ordering loop:" << pending[i].file << pending[i].after;
+      launch(pending.takeAt(i));
+      i--;
+    }
+    //This phase is done - go to the next one (delayed entries do not hold up the later phases)
+    BootTrace::finish("autostart-"+phaseName(phase));
+    emit PhaseFinished(phase);
+    phase++;
+    if(phase<=Applications){
+      BootTrace::start("autostart-"+phaseName(phase));
+      QTimer::singleShot(0, this, SLOT(runPhase()) ); //let the session process events between the phases
+      scheduleDelayed();
+      return;
+    }
+  }
+  //All the phases were started - only the delayed entries are left
+  if(!delayed.isEmpty()){ scheduleDelayed(); return; }
+  finished = true;
+  emit Finished();
+}
+
+void LAutoStart::delayTimeout(){
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  for(int i=0; i<delayed.length(); i++){
+    if(delayed[i].due > now){ continue; }
+    launch(delayed.takeAt(i));
+    i--;
+  }
+  runPhase();
+}
@@ -0,0 +1,73 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  In-session XDG autostart (replaces "lumina-open -autostart-apps")
+//   - Entries get launched in phases: Initialization -> Desktop -> Applications
+//       (X-GNOME-Autostart-Phase / X-KDE-autostart-phase, "Applications" if not set)
+//   - Within a phase everything gets launched right away, except for entries which wait for
+//       another entry (X-KDE-autostart-after) or have a delay (X-GNOME-Autostart-Delay)
+//   - The later phases run with lower CPU/IO priority (nice/ionice), so they do not compete with the desktop
+//   - Every launch is recorded in the startup trace (see BootTrace.h)
+//===========================================
+#ifndef _LUMINA_DESKTOP_AUTOSTART_H
+#define _LUMINA_DESKTOP_AUTOSTART_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+
+struct LAutoStartEntry{
+	QString file; //*.desktop file
+	QString id; //file name without the extension (used by the "after" references)
+	QString cmd;
+	int phase;
+	int delay; //milliseconds
+	QStringList after; //entries which need to be launched first
+	qint64 due; //launch time for delayed entries (msecs since epoch)
+};
+
+class LAutoStart : public QObject{
+	Q_OBJECT
+public:
+	enum Phase{ Initialization = 0, Desktop = 1, Applications = 2 };
+
+	LAutoStart(QObject *parent = 0);
+	~LAutoStart();
+
+	//Read the autostart files (can be run on any thread)
+	static QList<LAutoStartEntry> readEntries();
+
+	void start(QList<LAutoStartEntry> entries);
+	bool isFinished(){ return finished; }
+
+private:
+	QList<LAutoStartEntry> pending, delayed;
+	QSet<QString> launched;
+	int phase; //current phase (after "Applications": only delayed entries left)
+	bool finished;
+	bool haveIonice;
+	QTimer *delayTimer;
+
+	static int phaseNumber(QString phase);
+	static QString phaseName(int phase);
+	QString priorityPrefix(int phase);
+	bool isReady(const LAutoStartEntry &entry);
+	void launch(const LAutoStartEntry &entry);
+	void scheduleDelayed();
+
+private slots:
+	void runPhase(); //launch everything which is ready in the current phase
+	void delayTimeout();
+
+signals:
+	void PhaseFinished(int); //everything in this phase was launched (except delayed entries)
+	void Finished(); //everything was launched
+};
+
+#endif
@@ -13,6 +13,7 @@
 #include "JsonMenu.h"
 
 #include <QScreen>
+#include <QStyle>
 
 #define DEBUG 0
 
@@ -32,6 +33,7 @@ LDesktop::LDesktop(int deskNum, bool setdefault) : QObject(){
   if(!QFile::exists(settings->fileName())){ settings->setValue(DPREFIX+"background/filelist",QStringList()<<"default"); settings->sync(); }
   //bgWindow = 0;
   bgDesktop = 0;
+  connect(LSession::handle(), SIGNAL(BackgroundsReady()), this, SLOT(UpdateBackground()) );
   QTimer::singleShot(1,this, SLOT(InitDesktop()) );
 
 }
@@ -165,10 +167,9 @@ void LDesktop::checkResolution(){
       plugs << "applauncher::"+files[i].absoluteFilePath()+"---"+DPREFIX;
     }
     //QString pspath = QDir::homePath()+"/.lumina/desktop-plugins/%1.conf";
-    QSettings *DP = LSession::handle()->DesktopPluginSettings();
-    QStringList keys = DP->allKeys();
+    LPluginSettings *DP = LSession::handle()->DesktopPluginStore();
     for(int i=0; i<plugs.length(); i++){
-      QStringList filter = keys.filter(plugs[i]);
+      QStringList filter = DP->keys(plugs[i].replace("/","_")+"/"); //same ID->prefix conversion as LDPlugin
       for(int j=0; j<filter.length(); j++){
         //Has existing settings - need to adjust it
 	  if(filter[j].endsWith("location/height")){ DP->setValue( filter[j], qRound(DP->value(filter[j]).toInt()*yscale) ); }
@@ -179,7 +180,7 @@ void LDesktop::checkResolution(){
 	  if(filter[j].endsWith("iconsize")){ DP->setValue( filter[j], qRound(DP->value(filter[j]).toInt()*yscale) ); }
       }
     }
-    DP->sync(); //make sure it gets saved to disk right away
+    DP->flush(); //make sure it gets saved to disk right away
     
   }
   issyncing = false;
@@ -319,7 +320,7 @@ void LDesktop::UpdateWinMenu(){
   for(int i=0; i<wins.length(); i++){
     LWinInfo info(wins[i]);
     bool junk;
-    QAction *act = winMenu->addAction( info.icon(junk), info.text() );
+    QAction *act = winMenu->addAction( info.icon(junk, winMenu->style()->pixelMetric(QStyle::PM_SmallIconSize)), info.text() );
       act->setData( QString::number(wins[i]) );
   }
 }
@@ -483,6 +484,7 @@ void LDesktop::UpdateDesktopPluginArea(){
 void LDesktop::UpdateBackground(){
   //Get the current Background
   if(bgupdating || bgDesktop==0){ return; } //prevent multiple calls to this at the same time
+  if(!LSession::handle()->backgroundsReady()){ return; } //startup: wallpapers still getting decoded
   bgupdating = true;
   if(DEBUG){ qDebug() << " - Update Desktop Background for screen:" << desktopnumber; }
   //Get the list of background(s) to show
@@ -9,6 +9,10 @@
 #include <QPainter>
 #include <QPaintEvent>
 #include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QHash>
+#include <QImage>
 
 #include "LSession.h"
 
@@ -24,6 +28,22 @@ void LDesktopBackground::paintEvent(QPaintEvent *ev) {
    }
 }
 
+//Images which were decoded ahead of time (used once, then dropped)
+static QMutex preloadMutex;
+static QHash<QString, QImage> preloaded;
+
+void LDesktopBackground::preloadImage(const QString &file){
+  QImage img(file);
+  if(img.isNull()){ return; }
+  QMutexLocker lock(&preloadMutex);
+  preloaded.insert(file, img);
+}
+
+void LDesktopBackground::clearPreloaded(){
+  QMutexLocker lock(&preloadMutex);
+  preloaded.clear();
+}
+
 QPixmap LDesktopBackground::setBackground(const QString& bgFile, const QString& format, QRect geom) {
     //if (bgPixmap != NULL) delete bgPixmap;
     QPixmap bgPixmap(geom.size());// = new QPixmap(size());
@@ -36,7 +56,12 @@ QPixmap LDesktopBackground::setBackground(const QString& bgFile, const QString&
         bgPixmap.fill(Qt::black);
 
         // Load the background file and scale
-        QPixmap bgImage(bgFile);
+        QPixmap bgImage;
+        preloadMutex.lock();
+        QImage img = preloaded.take(bgFile);
+        preloadMutex.unlock();
+        if(img.isNull()){ bgImage.load(bgFile); }
+        else{ bgImage = QPixmap::fromImage(img); }
         if (format == "stretch" || format == "full" || format == "fit") {
             Qt::AspectRatioMode mode;
             if (format == "stretch") {
@@ -19,6 +19,9 @@ public:
 
     virtual void paintEvent(QPaintEvent*);
     static QPixmap setBackground(const QString&, const QString&, QRect geom);
+    //Decode an image file ahead of time (thread-safe - used during session startup)
+    static void preloadImage(const QString &file);
+    static void clearPreloaded(); //drop the images which were not used
 
 private:
     QPixmap *bgPixmap;
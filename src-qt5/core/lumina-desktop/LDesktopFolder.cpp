@@ -0,0 +1,169 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LDesktopFolder.h"
+
+#include <QFile>
+#include <QMap>
+#include <QDateTime>
+#include <QImageReader>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+
+#define SCANDELAY 300 //milliseconds to wait for a burst of changes to settle down
+#define THUMBSIZE 256 //max size for thumbnails in memory
+
+// === Worker thread function ===
+static LDesktopThumb loadThumb(QString file){
+  LDesktopThumb out;
+  out.file = file;
+  out.stamp = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+  QImageReader reader(file);
+  QSize sz = reader.size();
+  if(sz.isValid() && (sz.width()>THUMBSIZE || sz.height()>THUMBSIZE) ){
+    reader.setScaledSize( sz.scaled(THUMBSIZE, THUMBSIZE, Qt::KeepAspectRatio) ); //decode at the reduced size directly
+  }
+  out.img = reader.read();
+  return out;
+}
+
+LDesktopFolder::LDesktopFolder(QObject *parent) : QObject(parent){
+  sortDirty = false;
+  scanTimer = new QTimer(this);
+    scanTimer->setSingleShot(true);
+    scanTimer->setInterval(SCANDELAY);
+    connect(scanTimer, SIGNAL(timeout()), this, SLOT(rescan()) );
+  thumbLoader = new QFutureWatcher<LDesktopThumb>(this);
+    connect(thumbLoader, SIGNAL(finished()), this, SLOT(thumbFinished()) );
+}
+
+LDesktopFolder::~LDesktopFolder(){
+  thumbQueue.clear();
+  thumbLoader->waitForFinished();
+}
+
+QFileInfoList LDesktopFolder::files(){
+  if(sortDirty){
+    QMap<QString, QString> order;
+    QHash<QString, Entry>::const_iterator it;
+    for(it = snapshot.constBegin(); it!=snapshot.constEnd(); ++it){
+      order.insert( sortKey(it.key(), it.value().isdir), it.key());
+    }
+    sorted.clear();
+    QMap<QString, QString>::const_iterator mit;
+    for(mit = order.constBegin(); mit!=order.constEnd(); ++mit){ sorted << QFileInfo(mit.value()); }
+    sortDirty = false;
+  }
+  return sorted;
+}
+
+QString LDesktopFolder::sortKey(QString file, bool isdir){
+  QString name = file.section("/",-1);
+  //Keep the original name at the end so that names which only differ in case do not collide
+  return (isdir ? "0" : "1")+name.toLower()+QChar(0)+name;
+}
+
+QImage LDesktopFolder::thumbnail(QString file){
+  qint64 stamp = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+  if(thumbs.contains(file) && thumbs[file].stamp==stamp){ return thumbs[file].img; }
+  if(thumbLoading!=file && !thumbQueue.contains(file)){
+    thumbQueue << file;
+    startNextThumb();
+  }
+  return QImage();
+}
+
+// ===================
+//  PUBLIC SLOTS
+// ===================
+void LDesktopFolder::setPath(QString path){
+  if(path==dirpath){ return; }
+  dirpath = path;
+  rescan();
+}
+
+void LDesktopFolder::scheduleRescan(){
+  scanTimer->start(); //restart the countdown
+}
+
+void LDesktopFolder::rescan(){
+  if(scanTimer->isActive()){ scanTimer->stop(); }
+  QHash<QString, Entry> now = readDir(dirpath);
+  QStringList added, removed, modified;
+  QHash<QString, Entry>::const_iterator it;
+  for(it = snapshot.constBegin(); it!=snapshot.constEnd(); ++it){
+    if(!now.contains(it.key())){ removed << it.key(); }
+  }
+  for(it = now.constBegin(); it!=now.constEnd(); ++it){
+    QHash<QString, Entry>::const_iterator old = snapshot.constFind(it.key());
+    if(old==snapshot.constEnd()){ added << it.key(); }
+    else if(old.value().inode!=it.value().inode || old.value().mtime!=it.value().mtime \
+	|| old.value().ctime!=it.value().ctime || old.value().size!=it.value().size || old.value().isdir!=it.value().isdir){
+      modified << it.key();
+    }
+  }
+  snapshot = now;
+  if(added.isEmpty() && removed.isEmpty() && modified.isEmpty()){ return; } //nothing changed
+  sortDirty = true;
+  //Drop any stale thumbnails (these get re-loaded on request)
+  for(int i=0; i<removed.length(); i++){ thumbs.remove(removed[i]); thumbQueue.removeAll(removed[i]); }
+  for(int i=0; i<modified.length(); i++){ thumbs.remove(modified[i]); }
+  //qDebug() << "Desktop Folder Changes:" << "Added:" << added.length() << "Removed:" << removed.length() << "Modified:" << modified.length();
+  if(!removed.isEmpty()){ emit ItemsRemoved(removed); }
+  if(!added.isEmpty()){ emit ItemsAdded(added); }
+  if(!modified.isEmpty()){ emit ItemsModified(modified); }
+  emit FilesChanged();
+}
+
+// ===================
+//  PRIVATE
+// ===================
+QHash<QString, LDesktopFolder::Entry> LDesktopFolder::readDir(QString dir){
+  QHash<QString, Entry> out;
+  if(dir.isEmpty()){ return out; }
+  DIR *dp = opendir( QFile::encodeName(dir).constData() );
+  if(dp==0){ return out; }
+  int fd = dirfd(dp);
+  if(!dir.endsWith("/")){ dir.append("/"); }
+  struct dirent *ent;
+  while( (ent = readdir(dp))!=0 ){
+    if(ent->d_name[0]=='.'){ continue; } //hidden files and "."/".." (same as the QDir listing used before)
+    struct stat st;
+    if(fstatat(fd, ent->d_name, &st, 0)!=0){ continue; } //broken symlink, or removed in the meantime
+    if(!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode)){ continue; } //only files and directories
+    Entry E;
+      E.inode = st.st_ino;
+      E.mtime = st.st_mtime;
+      E.ctime = st.st_ctime;
+      E.size = st.st_size;
+      E.isdir = S_ISDIR(st.st_mode);
+    out.insert(dir+QFile::decodeName(ent->d_name), E);
+  }
+  closedir(dp);
+  return out;
+}
+
+void LDesktopFolder::startNextThumb(){
+  if(thumbLoader->isRunning() || thumbQueue.isEmpty()){ return; }
+  thumbLoading = thumbQueue.takeFirst();
+  thumbLoader->setFuture( QtConcurrent::run(loadThumb, thumbLoading) );
+}
+
+// ===================
+//  PRIVATE SLOTS
+// ===================
+void LDesktopFolder::thumbFinished(){
+  LDesktopThumb thumb = thumbLoader->result();
+  thumbLoading.clear();
+  thumbs.insert(thumb.file, thumb);
+  startNextThumb();
+  emit ThumbnailReady(thumb.file);
+}
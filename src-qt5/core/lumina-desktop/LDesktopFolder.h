@@ -0,0 +1,84 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Snapshot model of the desktop folder (~/Desktop)
+//   - Watcher events are debounced into a single rescan
+//   - Each rescan is diffed against the last snapshot (inode/mtime/ctime/size) and
+//       only the items which actually changed get reported
+//   - Shared (in-memory) thumbnails for image files, decoded at reduced size on a worker thread
+//===========================================
+#ifndef _LUMINA_DESKTOP_DESKTOP_FOLDER_H
+#define _LUMINA_DESKTOP_DESKTOP_FOLDER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QFileInfo>
+#include <QImage>
+#include <QTimer>
+#include <QFutureWatcher>
+
+//Decoded thumbnail (loaded on a background thread)
+struct LDesktopThumb{
+	QString file;
+	qint64 stamp; //modification time of the file when it was loaded (msecs since epoch)
+	QImage img; //null if the file could not be read
+};
+
+class LDesktopFolder : public QObject{
+	Q_OBJECT
+public:
+	LDesktopFolder(QObject *parent = 0);
+	~LDesktopFolder();
+
+	QString path(){ return dirpath; }
+	bool contains(QString file){ return snapshot.contains(file); }
+	QFileInfoList files(); //directories first, then by name (case-insensitive)
+	static QString sortKey(QString file, bool isdir); //key which matches the order of files()
+
+	//Shared thumbnail for an image file (max THUMBSIZE, aspect ratio kept)
+	// - Returns a null image if it is still being loaded (ThumbnailReady() is emitted when done) or could not be read
+	QImage thumbnail(QString file);
+
+public slots:
+	void setPath(QString path); //rescans right away if the path changed
+	void scheduleRescan(); //debounced rescan (for watcher events)
+	void rescan();
+
+private:
+	struct Entry{
+	  quint64 inode;
+	  qint64 mtime, ctime, size;
+	  bool isdir;
+	};
+	QString dirpath;
+	QHash<QString, Entry> snapshot;
+	QFileInfoList sorted;
+	bool sortDirty;
+	QTimer *scanTimer;
+	//Thumbnails
+	QHash<QString, LDesktopThumb> thumbs;
+	QStringList thumbQueue;
+	QString thumbLoading;
+	QFutureWatcher<LDesktopThumb> *thumbLoader;
+
+	static QHash<QString, Entry> readDir(QString dir);
+	void startNextThumb();
+
+private slots:
+	void thumbFinished();
+
+signals:
+	//Full paths of the items
+	void ItemsAdded(QStringList);
+	void ItemsRemoved(QStringList);
+	void ItemsModified(QStringList);
+	void FilesChanged(); //emitted once after any of the above
+	void ThumbnailReady(QString);
+};
+
+#endif
@@ -0,0 +1,122 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LIconAtlas.h"
+
+#include <QImage>
+#include <QPainter>
+
+#include <LuminaXDG.h>
+
+#define MAX_SIZES 4 //number of icon sizes kept in the cache at the same time (launchers and the desktop view can differ)
+
+LIconAtlas::LIconAtlas(QObject *parent) : QObject(parent){
+  statHits = statRasters = statDropped = 0;
+}
+
+LIconAtlas::~LIconAtlas(){
+
+}
+
+QIcon LIconAtlas::icon(QString name, QString fallback, int size, QString emblem, int emblemSize){
+  if(size<1){ size = 1; }
+  if(emblem.isEmpty()){ emblemSize = 0; }
+  else if(emblemSize<1){ emblemSize = qMax(size/3, 1); }
+  QString key = name+"|"+fallback+"|"+emblem+"|"+QString::number(emblemSize);
+  QHash<QString, QIcon> *cache = bucket(size);
+  if(cache->contains(key)){ statHits++; return cache->value(key); }
+  QIcon ico;
+  if(emblem.isEmpty()){
+    ico = QIcon( raster(name, fallback, size) );
+  }else{
+    //Start from the shared plain icon
+    ico = QIcon( composite(icon(name, fallback, size).pixmap(QSize(size,size)), emblem, emblemSize) );
+  }
+  cache->insert(key, ico);
+  return ico;
+}
+
+QIcon LIconAtlas::mimeIcon(QString file, int size, QString emblem, int emblemSize){
+  //Same lookup as LXDG::findMimeIcon() - but only once per file name
+  //  (mime globs match the whole name: "*.tar.gz", "CMakeLists.txt", "Makefile" - the last extension is not enough)
+  QString fname = file.section("/",-1);
+  if(!mimeIcons.contains(fname)){
+    QString mime = LXDG::findAppMimeForFile(fname);
+    if(mime.isEmpty()){ mime = LXDG::findAppMimeForFile(fname.toLower()); }
+    mimeIcons.insert(fname, mime.replace("/","-"));
+  }
+  QString name = mimeIcons.value(fname);
+  if(name.isEmpty()){ return icon("unknown", "", size, emblem, emblemSize); }
+  return icon(name, "unknown", size, emblem, emblemSize);
+}
+
+QIcon LIconAtlas::withEmblem(QPixmap pix, int size, QString emblem, int emblemSize){
+  if(emblemSize<1){ emblemSize = qMax(size/3, 1); }
+  return QIcon( composite(pix, emblem, emblemSize) );
+}
+
+QStringList LIconAtlas::stats(){
+  QStringList out;
+  int count = 0;
+  QStringList szs;
+  for(int i=0; i<sizes.length(); i++){
+    count += atlas.value(sizes[i]).count();
+    szs << QString::number(sizes[i]);
+  }
+  out << QString("Icon Atlas: %1 icons cached (sizes: %2)").arg( QString::number(count), szs.join(", ") );
+  out << QString(" - Rasterized: %1, Shared: %2, Dropped: %3").arg( QString::number(statRasters), QString::number(statHits), QString::number(statDropped) );
+  return out;
+}
+
+// ===================
+//  PUBLIC SLOTS
+// ===================
+void LIconAtlas::clear(){
+  atlas.clear();
+  mimeIcons.clear();
+  emblems.clear();
+  sizes.clear();
+}
+
+// ===================
+//  PRIVATE
+// ===================
+QPixmap LIconAtlas::raster(QString name, QString fallback, int size){
+  statRasters++;
+  QPixmap pix = LXDG::findIcon(name, fallback).pixmap(QSize(size,size));
+  if(!pix.isNull() && pix.height()!=size){ pix = pix.scaledToHeight(size, Qt::SmoothTransformation); }
+  return pix;
+}
+
+QPixmap LIconAtlas::composite(QPixmap base, QString emblem, int emblemSize){
+  if(base.isNull()){ return base; }
+  QString key = emblem+"|"+QString::number(emblemSize);
+  if(!emblems.contains(key)){
+    statRasters++;
+    emblems.insert(key, LXDG::findIcon(emblem,"").pixmap(emblemSize,emblemSize).scaled(emblemSize,emblemSize, Qt::KeepAspectRatio, Qt::SmoothTransformation) );
+  }
+  QImage img = base.toImage();
+  QPainter painter(&img);
+    painter.drawPixmap(img.width()-emblemSize, img.height()-emblemSize, emblems.value(key)); //put it in the bottom-right corner
+  painter.end();
+  return QPixmap::fromImage(img);
+}
+
+QHash<QString, QIcon>* LIconAtlas::bucket(int size){
+  //Keep track of the sizes in use - drop the least recently used one when there are too many
+  int index = sizes.indexOf(size);
+  if(index<0){
+    sizes << size;
+    while(sizes.length()>MAX_SIZES){
+      int old = sizes.takeFirst();
+      statDropped += atlas.value(old).count();
+      atlas.remove(old);
+    }
+  }else if(index != sizes.length()-1){
+    sizes.move(index, sizes.length()-1);
+  }
+  return &atlas[size];
+}
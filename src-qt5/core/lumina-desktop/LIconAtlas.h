@@ -0,0 +1,57 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Shared, size-keyed icon cache for the desktop launchers/icons
+//   - Every unique (icon, size, emblem) combination is rasterized once, and the resulting
+//       QIcon is shared by all the items which use it
+//   - Emblems (sym-link overlay) are composited into the cached image
+//   - Only the most recently used sizes are kept (an icon size change drops the old entries)
+//   - Cleared when the icon theme changes
+//   - "lumina-desktop --icon-stats" prints the cache statistics
+//===========================================
+#ifndef _LUMINA_DESKTOP_ICON_ATLAS_H
+#define _LUMINA_DESKTOP_ICON_ATLAS_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QList>
+#include <QIcon>
+#include <QPixmap>
+
+class LIconAtlas : public QObject{
+	Q_OBJECT
+public:
+	LIconAtlas(QObject *parent = 0);
+	~LIconAtlas();
+
+	//Theme icon (LXDG::findIcon()) scaled to the given height
+	// - emblem: icon name to put in the bottom-right corner (emblemSize 0: a third of the icon size)
+	QIcon icon(QString name, QString fallback, int size, QString emblem = "", int emblemSize = 0);
+	//Mimetype icon for a file name (LXDG::findMimeIcon())
+	QIcon mimeIcon(QString file, int size, QString emblem = "", int emblemSize = 0);
+	//Put an emblem on an image which is not shared (thumbnails)
+	QIcon withEmblem(QPixmap pix, int size, QString emblem, int emblemSize = 0);
+
+	QStringList stats();
+
+public slots:
+	void clear(); //icon theme changed
+
+private:
+	QHash<int, QHash<QString, QIcon> > atlas; //size -> (name|fallback|emblem|emblemSize -> icon)
+	QHash<QString, QString> mimeIcons; //file name -> icon name
+	QHash<QString, QPixmap> emblems; //name|size -> overlay image
+	QList<int> sizes; //sizes in use (most recent last)
+	quint64 statHits, statRasters, statDropped;
+
+	QPixmap raster(QString name, QString fallback, int size);
+	QPixmap composite(QPixmap base, QString emblem, int emblemSize);
+	QHash<QString, QIcon>* bucket(int size);
+};
+
+#endif
@@ -285,6 +285,7 @@ void LPanel::UpdatePanel(bool geomonly){
   this->update();
   this->show(); //make sure the panel is visible now
   if(hidden){ this->move(hidepoint); }
+  LSession::handle()->tickScheduler()->setPaused(this, hidden); //no periodic plugin updates while tucked away
   //Now go through and send the orientation update signal to each plugin
   for(int i=0; i<PLUGINS.length(); i++){
     QTimer::singleShot(0,PLUGINS[i], SLOT(OrientationChange()));
@@ -312,7 +313,10 @@ void LPanel::UpdateTheme(){
 void LPanel::checkPanelFocus(){
   if( !this->geometry().contains(QCursor::pos()) ){
     //Move the panel back to it's "hiding" spot
-    if(hidden){ this->move(hidepoint); this->update(); }
+    if(hidden){
+      this->move(hidepoint); this->update();
+      LSession::handle()->tickScheduler()->setPaused(this, true);
+    }
     //Re-active the old window
     if(LSession::handle()->activeWindow()!=0){
       LSession::handle()->XCB->ActivateWindow(LSession::handle()->activeWindow());
@@ -345,6 +349,7 @@ void LPanel::enterEvent(QEvent *event){
   //qDebug() << "Panel Enter Event:";
   if(hidden){
     //Move the panel out so it is fully available
+    LSession::handle()->tickScheduler()->setPaused(this, false); //catch-up ticks for the plugins
     this->move(showpoint);
     this->update();
   }
@@ -0,0 +1,125 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LPluginSettings.h"
+
+#include <QFileInfo>
+
+#define FLUSH_DELAY 500 //milliseconds to wait for more changes
+#define FLUSH_MAX 3000 //never hold changes longer than this
+
+LPluginSettings::LPluginSettings(QSettings *settings, QObject *parent) : QObject(parent){
+  set = settings;
+  indexed = false;
+  flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(FLUSH_DELAY);
+    connect(flushTimer, SIGNAL(timeout()), this, SLOT(flush()) );
+}
+
+LPluginSettings::~LPluginSettings(){
+  if(pendingSince.isValid()){ flush(); }
+}
+
+QVariant LPluginSettings::value(QString key, QVariant defaultval){
+  if(pending.contains(key)){ return pending.value(key); }
+  if(removedKeys.contains(key) || removedGroups.contains(groupOf(key)) ){ return defaultval; }
+  return set->value(key, defaultval);
+}
+
+bool LPluginSettings::contains(QString key){
+  if(pending.contains(key)){ return true; }
+  if(removedKeys.contains(key) || removedGroups.contains(groupOf(key)) ){ return false; }
+  return set->contains(key);
+}
+
+void LPluginSettings::setValue(QString key, QVariant val){
+  loadIndex();
+  pending.insert(key, val);
+  removedKeys.remove(key);
+  index[groupOf(key)].insert(key);
+  scheduleFlush();
+}
+
+void LPluginSettings::remove(QString key){
+  loadIndex();
+  pending.remove(key);
+  removedKeys.insert(key);
+  QString grp = groupOf(key);
+  if(index.contains(grp)){
+    index[grp].remove(key);
+    if(index[grp].isEmpty()){ index.remove(grp); }
+  }
+  scheduleFlush();
+}
+
+QStringList LPluginSettings::keys(QString prefix){
+  loadIndex();
+  return index.value(groupOf(prefix)).toList();
+}
+
+void LPluginSettings::removeGroup(QString prefix){
+  loadIndex();
+  QString grp = groupOf(prefix);
+  QStringList keys = index.value(grp).toList();
+  for(int i=0; i<keys.length(); i++){ pending.remove(keys[i]); removedKeys.remove(keys[i]); }
+  //Removing the whole group also catches any keys which were written to the QSettings directly
+  removedGroups.insert(grp);
+  index.remove(grp);
+  scheduleFlush();
+}
+
+bool LPluginSettings::isOwnChange(){
+  return (lastWrite.isValid() && QFileInfo(set->fileName()).lastModified()==lastWrite);
+}
+
+void LPluginSettings::reload(){
+  set->sync(); //pick up the new contents (pending changes still get written on top later)
+  indexed = false;
+}
+
+// === PUBLIC SLOTS ===
+void LPluginSettings::flush(){
+  flushTimer->stop();
+  pendingSince = QDateTime();
+  //See if something else changed the file since the last write (the keys might be different now)
+  QDateTime mod = QFileInfo(set->fileName()).lastModified();
+  bool external = lastWrite.isValid() && mod!=lastWrite;
+  //Apply the changes in order: whole plugins removed, single keys removed, new values
+  //  (anything re-set after a removal only exists in the pending values)
+  QStringList list = removedGroups.toList();
+  for(int i=0; i<list.length(); i++){
+    set->beginGroup(list[i]);
+    set->remove("");
+    set->endGroup();
+  }
+  list = removedKeys.toList();
+  for(int i=0; i<list.length(); i++){ set->remove(list[i]); }
+  list = pending.keys();
+  for(int i=0; i<list.length(); i++){ set->setValue(list[i], pending.value(list[i])); }
+  removedGroups.clear();
+  removedKeys.clear();
+  pending.clear();
+  set->sync(); //single write of everything which changed
+  lastWrite = QFileInfo(set->fileName()).lastModified();
+  if(external){ indexed = false; } //re-build the index on the next lookup
+}
+
+// === PRIVATE ===
+void LPluginSettings::loadIndex(){
+  if(indexed){ return; }
+  //One scan of all the keys - everything after this is a hash lookup
+  index.clear();
+  QStringList all = set->allKeys();
+  for(int i=0; i<all.length(); i++){ index[groupOf(all[i])].insert(all[i]); }
+  indexed = true;
+}
+
+void LPluginSettings::scheduleFlush(){
+  if(!pendingSince.isValid()){ pendingSince = QDateTime::currentDateTime(); }
+  if(pendingSince.msecsTo(QDateTime::currentDateTime()) > FLUSH_MAX){ flush(); } //constant changes - do not hold them forever
+  else{ flushTimer->start(); } //restart the countdown
+}
@@ -0,0 +1,66 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Write-behind layer on top of the shared desktop plugin settings
+//   - Keys are indexed by plugin ID (the first key group) so per-plugin lookups/removals never scan all the keys
+//   - Changes are kept in memory (not even handed to QSettings, which would sync on the next event loop pass)
+//       and flushed to disk in a single write once things settle down
+//       (QSettings writes through a temporary file + rename, so the file on disk is always complete)
+//   - Remembers the file timestamp after each flush so the session can ignore its own file changes
+//===========================================
+#ifndef _LUMINA_DESKTOP_PLUGIN_SETTINGS_H
+#define _LUMINA_DESKTOP_PLUGIN_SETTINGS_H
+
+#include <QObject>
+#include <QSettings>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QDateTime>
+
+class LPluginSettings : public QObject{
+	Q_OBJECT
+public:
+	LPluginSettings(QSettings *set, QObject *parent = 0);
+	~LPluginSettings();
+
+	QVariant value(QString key, QVariant defaultval = QVariant());
+	bool contains(QString key);
+	void setValue(QString key, QVariant val); //written to disk a moment later
+	void remove(QString key);
+
+	//Plugin ID-based functions (prefix: "<plugin ID>/")
+	QStringList keys(QString prefix); //all the keys for this plugin
+	void removeGroup(QString prefix); //remove all the keys for this plugin
+
+	QString fileName(){ return set->fileName(); }
+	//Returns true if the file on disk is the one which was last written by this class
+	bool isOwnChange();
+	//Re-read the file after something else changed it (the index is re-built on the next lookup)
+	void reload();
+
+public slots:
+	void flush(); //write any pending changes right now
+
+private:
+	QSettings *set;
+	QHash<QString, QSet<QString> > index; //[plugin ID, keys]
+	QHash<QString, QVariant> pending; //changed values not written yet
+	QSet<QString> removedKeys, removedGroups; //removals not written yet
+	bool indexed;
+	QTimer *flushTimer;
+	QDateTime pendingSince; //first un-flushed change
+	QDateTime lastWrite; //file timestamp right after the last flush
+
+	void loadIndex();
+	void scheduleFlush();
+	static QString groupOf(QString key){ return key.section("/",0,0); }
+};
+
+#endif
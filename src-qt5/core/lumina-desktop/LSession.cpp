@@ -9,13 +9,16 @@
 
 #include <QTime>
 #include <QScreen>
+#include <QIcon>
 #include <QtConcurrent>
 #include "LXcbEventFilter.h"
 #include "BootSplash.h"
+#include "LDesktopBackground.h"
 
 //LibLumina X11 class
 #include <LuminaX11.h>
 #include <LuminaUtils.h>
+#include <LuminaAppRegistry.h>
 
 #include <unistd.h> //for usleep() usage
 
@@ -45,11 +48,23 @@ LSession::LSession(int &argc, char ** argv) : LSingleApplication(argc, argv, "lu
   TrayDmgError = 0;
   lastActiveWin = 0; 
   cleansession = true;
+  bgReady = false;
+  bootLooping = bootRerun = false;
   TrayStopping = false;
   screenTimer = new QTimer(this);
     screenTimer->setSingleShot(true);
     screenTimer->setInterval(50);
     connect(screenTimer, SIGNAL(timeout()), this, SLOT(updateDesktops()) );
+  propTimer = new QTimer(this);
+    propTimer->setSingleShot(true);
+    propTimer->setInterval(16); //about one frame
+    connect(propTimer, SIGNAL(timeout()), this, SLOT(dispatchWindowEvents()) );
+  pendingClientList = pendingActive = false;
+  propActiveWin = 0;
+  ticker = new LTickScheduler(this);
+  icons = new LIconAtlas(this);
+    connect(this, SIGNAL(IconThemeChanged()), icons, SLOT(clear()) );
+  xevCounts.received = xevCounts.batches = xevCounts.windowUpdates = xevCounts.listRefreshes = 0;
   for(int i=1; i<argc; i++){
     if( QString::fromLocal8Bit(argv[i]) == "--noclean" ){ cleansession = false; break; }
   }
@@ -57,9 +72,15 @@ LSession::LSession(int &argc, char ** argv) : LSingleApplication(argc, argv, "lu
   //initialize the empty internal pointers to 0
   appmenu = 0;
   settingsmenu = 0;
+  syscontrols = 0;
+  notifications = 0;
+  autostart = 0;
+  splash = 0;
   currTranslator=0;
   mediaObj=0;
   sessionsettings=0;
+  DPlugStore=0;
+  deskFolder=0;
   //Setup the event filter for Qt5
   evFilter =  new XCBEventFilter(this);
   this->installNativeEventFilter( evFilter );
@@ -77,23 +98,143 @@ LSession::~LSession(){
   appmenu->deleteLater();
   delete currTranslator;
   if(mediaObj!=0){delete mediaObj;}
+  if(syscontrols!=0){ delete syscontrols; }
+  if(DPlugStore!=0){ DPlugStore->flush(); } //write out any pending plugin changes
  }
 }
 
 void LSession::setupSession(){
-  BootSplash splash;
-    splash.showScreen("init");
+  BootTrace::start("session");
+  splash = new BootSplash();
+    splash->showScreen("init");
   qDebug() << "Initializing Session";
   if(QFile::exists("/tmp/.luminastopping")){ QFile::remove("/tmp/.luminastopping"); }
-  QTime* timer = 0;
-  if(DEBUG){ timer = new QTime(); timer->start(); qDebug() << " - Init srand:" << timer->elapsed();}
   //Seed random number generator (if needed)
   qsrand( QTime::currentTime().msec() );
+  //Initialize the internal variables
+  DESKTOPS.clear();
+  //Setup the startup stages (name, dependencies, run on worker thread, function)
+  // - everything touching widgets needs to stay on the GUI thread
+  // - the I/O-heavy stages get run in parallel on worker threads while the GUI stages continue
+  bootStages.clear();
+  addBootStage("settings", QStringList(), false, &LSession::bootSettings);
+  addBootStage("userfiles", QStringList() << "settings", false, &LSession::checkUserFiles);
+  addBootStage("appdb", QStringList() << "settings", true, &LSession::bootAppDatabase);
+  addBootStage("icontheme", QStringList() << "settings", true, &LSession::bootIconTheme);
+  addBootStage("wallpaper", QStringList() << "userfiles", true, &LSession::bootWallpapers);
+  addBootStage("systray", QStringList() << "settings", false, &LSession::startSystemTray);
+  addBootStage("menus", QStringList() << "userfiles", false, &LSession::bootMenus);
+  addBootStage("notifications", QStringList() << "settings", false, &LSession::bootNotifications);
+  addBootStage("desktops", QStringList() << "menus" << "systray" << "notifications", false, &LSession::bootDesktops);
+  addBootStage("backgrounds", QStringList() << "desktops" << "wallpaper", false, &LSession::bootBackgrounds);
+  addBootStage("appmenu", QStringList() << "appdb" << "menus", false, &LSession::bootAppMenu);
+  addBootStage("watchers", QStringList() << "desktops", false, &LSession::bootWatchers);
+  addBootStage("syscontrols", QStringList() << "settings", false, &LSession::bootSystemControls);
+  addBootStage("autostart", QStringList() << "desktops", true, &LSession::launchStartupApps);
+  addBootStage("autostart-launch", QStringList() << "autostart", false, &LSession::bootAutoStartApps);
+  addBootStage("loginaudio", QStringList() << "autostart", false, &LSession::playLoginAudio);
+  runBootStages();
+}
+
+//Re-load the volume from the previous session (worker thread - the OS utilities can take a while)
+//  - the audio system might still be starting up (launched by the autostart entries): retry for up to 10 seconds
+static void restoreAudioVolume(){
+  int vol = LOS::audioVolume();
+  for(int i=0; i<20 && vol<0; i++){
+    QThread::msleep(500);
+    vol = LOS::audioVolume();
+  }
+  if(vol<0){ qDebug() << " - - Audio Volume: not available"; return; } //never set the volume to 0 because of a read error
+  LOS::setAudioVolume(vol);
+  qDebug() << " - - Audio Volume:" << QString::number(vol)+"%";
+}
+
+// === Startup stage management ===
+void LSession::addBootStage(QString name, QStringList deps, bool worker, void (LSession::*func)()){
+  BootStage stage;
+    stage.name = name;
+    stage.deps = deps;
+    stage.worker = worker;
+    stage.func = func;
+  bootStages << stage;
+}
+
+void LSession::runBootStages(){
+  //GUI stages can process events (splash screen) and finish worker stages in the middle of the loop
+  //  - never start a second loop: just flag the running one to check everything again
+  if(bootLooping){ bootRerun = true; return; }
+  bootLooping = true;
+  //Start every stage which has all the dependencies finished (loop until nothing else can be started)
+  bool changed = true;
+  while(changed){
+    changed = bootRerun;
+    bootRerun = false;
+    for(int i=0; i<bootStages.length(); i++){
+      if(bootDone.contains(bootStages[i].name) || bootRunning.contains(bootStages[i].name) ){ continue; }
+      bool ready = true;
+      for(int d=0; d<bootStages[i].deps.length() && ready; d++){ ready = bootDone.contains(bootStages[i].deps[d]); }
+      if(!ready){ continue; }
+      if(bootStages[i].worker){
+        bootRunning << bootStages[i].name;
+        QFutureWatcher<void> *watch = new QFutureWatcher<void>(this);
+          watch->setObjectName(bootStages[i].name);
+          connect(watch, SIGNAL(finished()), this, SLOT(bootStageFinished()) );
+        watch->setFuture( QtConcurrent::run(this, &LSession::runWorkerStage, i) );
+      }else{
+        if(DEBUG){ qDebug() << " - Startup Stage:" << bootStages[i].name; }
+        bootRunning << bootStages[i].name;
+        BootTrace::start(bootStages[i].name);
+        (this->*bootStages[i].func)();
+        BootTrace::finish(bootStages[i].name);
+        bootRunning.removeAll(bootStages[i].name);
+        bootDone << bootStages[i].name;
+      }
+      changed = true;
+    }
+  }
+  bootLooping = false;
+  if(bootDone.length()==bootStages.length()){
+    if(autostart!=0 && !autostart->isFinished()){ return; } //still launching (delayed) autostart entries
+    qDebug() << " - Finished with startup routines";
+    LDesktopBackground::clearPreloaded(); //any wallpapers which were not used by the desktops
+    BootTrace::finish("session");
+    BootTrace::write();
+  }
+}
+
+void LSession::runWorkerStage(int num){
+  //Note: the stage list is not modified after startup begins - safe to read here
+  BootTrace::start(bootStages[num].name);
+  (this->*bootStages[num].func)();
+  BootTrace::finish(bootStages[num].name);
+}
+
+void LSession::bootStageFinished(){
+  QFutureWatcher<void> *watch = static_cast<QFutureWatcher<void>*>(sender());
+  if(watch==0){ return; }
+  bootRunning.removeAll(watch->objectName());
+  bootDone << watch->objectName();
+  watch->deleteLater();
+  runBootStages();
+}
+
+void LSession::autoStartPhaseFinished(int phase){
+  //Session services (audio system) are started in the first phase - restore the volume once it answers
+  if(phase==LAutoStart::Initialization){ QtConcurrent::run(restoreAudioVolume); }
+}
+
+void LSession::autoStartFinished(){
+  //All the autostart entries were launched - the startup trace can be finished now
+  runBootStages();
+}
+
+// === Startup stages ===
+void LSession::bootSettings(){
   //Setup the QSettings default paths
-    splash.showScreen("settings");
-  if(DEBUG){ qDebug() << " - Init QSettings:" << timer->elapsed();}
+    splash->showScreen("settings");
   sessionsettings = new QSettings("lumina-desktop", "sessionsettings");
   DPlugSettings = new QSettings("lumina-desktop","pluginsettings/desktopsettings");
+  DPlugStore = new LPluginSettings(DPlugSettings, this);
   //Load the proper translation files
   if(sessionsettings->value("ForceInitialLocale",false).toBool()){
     //Some system locale override it in place - change the env first
@@ -106,74 +247,107 @@ void LSession::setupSession(){
 				sessionsettings->value("InitLocale/LC_CTYPE","").toString() );
   }
   currTranslator = LUtils::LoadTranslation(this, "lumina-desktop"); 
-//use the system settings
-  //Setup the user's lumina settings directory as necessary
-    splash.showScreen("user");
-  if(DEBUG){ qDebug() << " - Init User Files:" << timer->elapsed();}  
-  checkUserFiles(); //adds these files to the watcher as well
+  //Save the icon theme info for the worker thread (QIcon is GUI-thread only)
+  bootIconName = QIcon::themeName();
+    splash->showScreen("user");
+}
 
-  //Initialize the internal variables
-  DESKTOPS.clear();
-      
-  //Start the background system tray
-    splash.showScreen("systray");
-  if(DEBUG){ qDebug() << " - Init System Tray:" << timer->elapsed();}
-  startSystemTray();
-	
-  //Launch Fluxbox
-    //splash.showScreen("wm");
-  //if(DEBUG){ qDebug() << " - Init WM:" << timer->elapsed();}
-  //WM = new WMProcess();
-    //WM->startWM();
-	
-  //Initialize the global menus
+void LSession::bootAppDatabase(){
+  //Read all the *.desktop files - the AppMenu takes these over later on the GUI thread
+  bootApps = XDGDesktopList::readSystemFiles(this->thread());
+}
+
+void LSession::bootIconTheme(){
+  //Index the icon theme files so the icon lookups on the GUI thread do not need to check every theme directory
+  LXDG::loadIconIndex(bootIconName);
+}
+
+void LSession::bootWallpapers(){
+  //Decode the wallpapers for each screen ahead of time (only for screens with a single wallpaper - the others are random)
+  QSettings dsettings(QSettings::UserScope, "lumina-desktop","desktopsettings");
+  QStringList groups = dsettings.childGroups();
+  QStringList files;
+  for(int i=0; i<groups.length(); i++){
+    if(!groups[i].startsWith("desktop-")){ continue; }
+    QStringList bgL = dsettings.value(groups[i]+"/background/filelist", QStringList()).toStringList();
+    if(bgL.length()>1){ continue; }
+    QString bg = bgL.isEmpty() ? "default" : bgL.first();
+    if(bg=="default"){ bg = LOS::LuminaShare()+"desktop-background.jpg"; }
+    if(!bg.startsWith("rgb(") && !files.contains(bg) && QFile::exists(bg)){ files << bg; }
+  }
+  for(int i=0; i<files.length(); i++){ LDesktopBackground::preloadImage(files[i]); }
+}
+
+void LSession::bootBackgrounds(){
+  //Only the backgrounds wait for the wallpapers - the panels/desktop icons are already up
+  bgReady = true;
+  emit BackgroundsReady();
+}
+
+void LSession::bootMenus(){
+  //Initialize the global menus (the application list gets loaded into the menu later)
   qDebug() << " - Initialize system menus";
-    splash.showScreen("apps");
-  if(DEBUG){ qDebug() << " - Init AppMenu:" << timer->elapsed();}
+    splash->showScreen("apps");
   appmenu = new AppMenu();
-  
-    splash.showScreen("menus");
-  if(DEBUG){ qDebug() << " - Init SettingsMenu:" << timer->elapsed();}
+    splash->showScreen("menus");
   settingsmenu = new SettingsMenu();
-  if(DEBUG){ qDebug() << " - Init SystemWindow:" << timer->elapsed();}
   sysWindow = new SystemWindow();
-  
+}
+
+void LSession::bootDesktops(){
   //Initialize the desktops
-    splash.showScreen("desktop");
-  if(DEBUG){ qDebug() << " - Init Desktops:" << timer->elapsed();}
-  desktopFiles = QDir(QDir::homePath()+"/Desktop").entryInfoList(QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs, QDir::Name | QDir::IgnoreCase | QDir::DirsFirst);
+    splash->showScreen("desktop");
+  deskFolder = new LDesktopFolder(this);
+    deskFolder->setPath(QDir::homePath()+"/Desktop");
+    connect(deskFolder, SIGNAL(FilesChanged()), this, SIGNAL(DesktopFilesChanged()) );
   updateDesktops();
-  
+    splash->showScreen("final");
+  //The desktops/panels are visible now - done with the splash screen
+  splash->deleteLater();
+  splash = 0;
+}
+
+void LSession::bootAppMenu(){
+  appmenu->loadApps(bootApps);
+  bootApps.clear();
+}
+
+void LSession::bootWatchers(){
   //Now setup the system watcher for changes
-    splash.showScreen("final");
   qDebug() << " - Initialize file system watcher";
-  if(DEBUG){ qDebug() << " - Init QFileSystemWatcher:" << timer->elapsed();}
-  watcher = new QFileSystemWatcher(this);
+  watcher = new LFileWatcher(this);
     QString confdir = sessionsettings->fileName().section("/",0,-2);
-    watcherChange(sessionsettings->fileName() );
-    watcherChange( confdir+"/desktopsettings.conf" );
-    watcherChange( confdir+"/fluxbox-init" );
-    watcherChange( confdir+"/fluxbox-keys" );
-    //watcher->addPath( sessionsettings->fileName() );
-    //watcher->addPath( confdir+"/desktopsettings.conf" );
-    //watcher->addPath( confdir+"/fluxbox-init" );
-    //watcher->addPath( confdir+"/fluxbox-keys" );
+    QStringList paths;
+    paths << sessionsettings->fileName() << confdir+"/desktopsettings.conf" << DPlugStore->fileName() << confdir+"/fluxbox-init" << confdir+"/fluxbox-keys";
+    for(int i=0; i<paths.length(); i++){
+      watcher->watchPath(paths[i]); //settings files are watched through their directory (these can be replaced/re-created)
+      watcherChange(paths[i]);
+    }
+    //Desktop folders are only watched if they exist (a missing folder would be watched through the home directory)
     //Try to watch the localized desktop folder too
-    if(QFile::exists(QDir::homePath()+"/"+tr("Desktop"))){ watcherChange( QDir::homePath()+"/"+tr("Desktop") ); }
+    if(QFile::exists(QDir::homePath()+"/"+tr("Desktop"))){ watcher->watchPath( QDir::homePath()+"/"+tr("Desktop") ); watcherChange( QDir::homePath()+"/"+tr("Desktop") ); }
+    if(QFile::exists(QDir::homePath()+"/Desktop")){ watcher->watchPath( QDir::homePath()+"/Desktop" ); }
     watcherChange( QDir::homePath()+"/Desktop" );
 
   //connect internal signals/slots
-  //connect(this->desktop(), SIGNAL(screenCountChanged(int)), this, SLOT(screensChanged()) );
-  //connect(this->desktop(), SIGNAL(resized(int)), this, SLOT(screenResized(int)) );
-  connect(watcher, SIGNAL(directoryChanged(QString)), this, SLOT(watcherChange(QString)) );
-  connect(watcher, SIGNAL(fileChanged(QString)), this, SLOT(watcherChange(QString)) );
+  connect(watcher, SIGNAL(PathChanged(QString)), this, SLOT(watcherChange(QString)) );
   connect(this, SIGNAL(aboutToQuit()), this, SLOT(SessionEnding()) );
-  if(DEBUG){ qDebug() << " - Init Finished:" << timer->elapsed(); delete timer;}
-  QApplication::processEvents();
-  launchStartupApps();
-  //QTimer::singleShot(500, this, SLOT(launchStartupApps()) );
-  //QApplication::processEvents();
-  splash.close(); 
+}
+
+void LSession::bootSystemControls(){
+  //Volume/brightness service (multimedia keys and the OSD)
+  syscontrols = new SystemControls(this);
+  syscontrols->grabKeys();
+}
+
+void LSession::bootNotifications(){
+  //Desktop notifications service (org.freedesktop.Notifications)
+  notifications = new NotificationServer(this);
+  if(!notifications->start(QDBusConnection::sessionBus()) ){
+    qDebug() << " - Could not register the notification service (another notification daemon running?)";
+    delete notifications;
+    notifications = 0;
+  }
 }
 
 void LSession::CleanupSession(){
@@ -258,17 +432,40 @@ void LSession::NewCommunication(QStringList list){
       screensChanged();
     }else if(list[i]=="--show-start"){ 
       emit StartButtonActivated();
+    }else if(list[i]=="--volume-up" && syscontrols!=0){
+      syscontrols->changeVolume(5);
+    }else if(list[i]=="--volume-down" && syscontrols!=0){
+      syscontrols->changeVolume(-5);
+    }else if(list[i]=="--volume-mute" && syscontrols!=0){
+      syscontrols->toggleMute();
+    }else if(list[i]=="--brightness-up" && syscontrols!=0){
+      syscontrols->changeBrightness(5);
+    }else if(list[i]=="--brightness-down" && syscontrols!=0){
+      syscontrols->changeBrightness(-5);
+    }else if(list[i]=="--xevent-stats"){
+      qDebug() << "X Events Received:" << xevCounts.received << "Batches:" << xevCounts.batches \
+		<< "Window Updates:" << xevCounts.windowUpdates << "Client List Refreshes:" << xevCounts.listRefreshes;
+    }else if(list[i]=="--notification-stats" && notifications!=0){
+      QStringList stats = notifications->stats();
+      for(int j=0; j<stats.length(); j++){ qDebug() << stats[j].toLocal8Bit().constData(); }
+    }else if(list[i]=="--tick-stats"){
+      QStringList stats = ticker->stats();
+      for(int j=0; j<stats.length(); j++){ qDebug() << stats[j].toLocal8Bit().constData(); }
+    }else if(list[i]=="--icon-stats"){
+      QStringList stats = icons->stats();
+      for(int j=0; j<stats.length(); j++){ qDebug() << stats[j].toLocal8Bit().constData(); }
     }
   }	  
 }
 
 void LSession::launchStartupApps(){
+  //NOTE: This is run on a worker thread - no GUI/session settings access here
   //First start any system-defined startups, then do user defined
   qDebug() << "Launching startup applications";
-
+  QSettings settings("lumina-desktop", "sessionsettings");
   //Enable Numlock
   if(LUtils::isValidBinary("numlockx")){ //make sure numlockx is installed
-    if(sessionsettings->value("EnableNumlock",false).toBool()){
+    if(settings.value("EnableNumlock",false).toBool()){
       QProcess::startDetached("numlockx on");
     }else{
       QProcess::startDetached("numlockx off");
@@ -279,15 +476,22 @@ void LSession::launchStartupApps(){
     LOS::setScreenBrightness( tmp );
     qDebug() << " - - Screen Brightness:" << QString::number(tmp)+"%";
   }
-  QProcess::startDetached("nice lumina-open -autostart-apps");
-  
-  //Re-load the screen brightness and volume settings from the previous session
-  // Wait until after the XDG-autostart functions, since the audio system might be started that way
-  qDebug() << " - Loading previous settings";
-  tmp = LOS::audioVolume();
-  LOS::setAudioVolume(tmp);
-  qDebug() << " - - Audio Volume:" << QString::number(tmp)+"%";
-  
+  //Read the XDG autostart files here - launched in phases on the GUI thread ("autostart-launch" stage)
+  bootAutoStart = LAutoStart::readEntries();
+  qDebug() << " - - Auto-Start Entries:" << bootAutoStart.length();
+  //Note: the volume from the previous session gets restored after the "Initialization" autostart phase
+  // (the audio system might be started that way)
+}
+
+void LSession::bootAutoStartApps(){
+  autostart = new LAutoStart(this);
+    connect(autostart, SIGNAL(PhaseFinished(int)), this, SLOT(autoStartPhaseFinished(int)) );
+    connect(autostart, SIGNAL(Finished()), this, SLOT(autoStartFinished()) );
+  autostart->start(bootAutoStart);
+  bootAutoStart.clear();
+}
+
+void LSession::playLoginAudio(){
   //Now play the login music since we are finished
   if(sessionsettings->value("PlayStartupAudio",true).toBool()){
     //Make sure to re-set the system volume to the last-used value at outset
@@ -295,7 +499,6 @@ void LSession::launchStartupApps(){
     if(vol>=0){ LOS::setAudioVolume(vol); }
     LSession::playAudioFile(LOS::LuminaShare()+"Login.ogg");
   }
-  qDebug() << " - Finished with startup routines";
 }
 
 void LSession::StartLogout(){
@@ -319,6 +522,7 @@ void LSession::reloadIconTheme(){
   //Wait a moment for things to settle before sending out the signal to the interfaces
   QApplication::processEvents();
   QApplication::processEvents();
+  QtConcurrent::run(&LXDG::loadIconIndex, QIcon::themeName()); //lookups check the disk until the new index is ready
   emit IconThemeChanged();	
 }
 
@@ -335,15 +539,18 @@ void LSession::watcherChange(QString changed){
       else{ setenv("QT_QPA_PLATFORMTHEME", engine.toUtf8().data(),1); } 
     }
     emit SessionConfigChanged();
-  }else if(changed.endsWith("desktopsettings.conf") ){ emit DesktopConfigChanged(); }
-  else if(changed == QDir::homePath()+"/Desktop" || changed == QDir::homePath()+"/"+tr("Desktop") ){ 
-    desktopFiles = QDir(changed).entryInfoList(QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs ,QDir::Name | QDir::IgnoreCase | QDir::DirsFirst);
-    if(DEBUG){ qDebug() << "New Desktop Files:" << desktopFiles.length(); }
-    emit DesktopFilesChanged(); 
+  }else if(DPlugStore!=0 && changed==DPlugStore->fileName()){
+    //Ignore the plugin settings file being re-written by this session
+    if(!DPlugStore->isOwnChange()){ DPlugStore->reload(); emit DesktopConfigChanged(); }
+  }else if(changed.endsWith("desktopsettings.conf") ){
+    emit DesktopConfigChanged();
   }
-  //Now ensure this file was not removed from the watcher
-  if(!watcher->files().contains(changed) && !watcher->directories().contains(changed)){
-    watcher->addPath(changed);
+  else if(changed == QDir::homePath()+"/Desktop" || changed == QDir::homePath()+"/"+tr("Desktop") ){ 
+    //Only the items which changed get reported (DesktopFilesChanged() is emitted by the folder model)
+    if(deskFolder!=0){
+      if(deskFolder->path()!=changed){ deskFolder->setPath(changed); }
+      else{ deskFolder->scheduleRescan(); }
+    }
   }
 }
 
@@ -516,6 +723,7 @@ void LSession::adjustWindowGeom(WId win, bool maximize){
 
 void LSession::SessionEnding(){
   stopSystemTray(); //just in case it was not stopped properly earlier
+  LAppRegistry::unpublish(); //utilities go back to reading the application files themselves
 }
 
 //===============
@@ -527,7 +735,12 @@ void LSession::LaunchApplication(QString cmd){
 }
 
 QFileInfoList LSession::DesktopFiles(){
-  return desktopFiles;	
+  if(deskFolder==0){ return QFileInfoList(); }
+  return deskFolder->files();
+}
+
+LDesktopFolder* LSession::desktopFolder(){
+  return deskFolder;
 }
 
 QRect LSession::screenGeom(int num){
@@ -544,6 +757,34 @@ SettingsMenu* LSession::settingsMenu(){
   return settingsmenu;
 }
 
+QIcon LSession::windowIcon(WId win, int size){
+  //Re-use the cached icon unless it was loaded for a smaller size
+  if(winIcons.contains(win)){
+    int csize = winIconSizes.value(win);
+    if(csize==0 || (size>0 && size<=csize) ){ return winIcons.value(win); }
+  }
+  QIcon ico = XCB->WindowIcon(win, size);
+  winIcons.insert(win, ico);
+  winIconSizes.insert(win, size);
+  return ico;
+}
+
+SystemControls* LSession::systemControls(){
+  return syscontrols;
+}
+
+LTickScheduler* LSession::tickScheduler(){
+  return ticker;
+}
+
+LIconAtlas* LSession::iconAtlas(){
+  return icons;
+}
+
+NotificationServer* LSession::notificationServer(){
+  return notifications;
+}
+
 QSettings* LSession::sessionSettings(){
   return sessionsettings;
 }
@@ -552,6 +793,10 @@ QSettings* LSession::DesktopPluginSettings(){
   return DPlugSettings;
 }
 
+LPluginSettings* LSession::DesktopPluginStore(){
+  return DPlugStore;
+}
+
 WId LSession::activeWindow(){
   //Check the last active window pointer first
   WId active = XCB->ActiveWindow();
@@ -618,6 +863,7 @@ void LSession::RootSizeChange(){
 
 void LSession::WindowPropertyEvent(){
   if(DEBUG){ qDebug() << "Window Property Event"; }
+  xevCounts.listRefreshes++;
   QList<WId> newapps = XCB->WindowList();
   if(RunningApps.length() < newapps.length()){
     //New Window found
@@ -627,6 +873,7 @@ void LSession::WindowPropertyEvent(){
     for(int i=0; i<newapps.length() && !TrayStopping; i++){
       if(!RunningApps.contains(newapps[i])){ 
         checkWin << newapps[i]; 
+        if(skipsLists(newapps[i])){ skipWins.insert(newapps[i]); }
 	XCB->SelectInput(newapps[i]); //make sure we get property/focus events for this window
 	if(DEBUG){ qDebug() << "New Window - check geom in a moment:" << XCB->WindowClass(newapps[i]); }
 	QTimer::singleShot(50, this, SLOT(checkWindowGeoms()) );
@@ -634,20 +881,98 @@ void LSession::WindowPropertyEvent(){
     }
   }
   
+  //Drop the cached icons/states for any windows which are gone
+  QList<WId> cached = winIcons.keys();
+  for(int i=0; i<cached.length(); i++){
+    if(!newapps.contains(cached[i])){ winIcons.remove(cached[i]); winIconSizes.remove(cached[i]); }
+  }
+  cached = skipWins.toList();
+  for(int i=0; i<cached.length(); i++){
+    if(!newapps.contains(cached[i])){ skipWins.remove(cached[i]); }
+  }
   //Now save the list and send out the event
   RunningApps = newapps;
   emit WindowListEvent();
 }
 
-void LSession::WindowPropertyEvent(WId win){
-  //Emit the single-app signal if the window in question is one used by the task manager
-  if(RunningApps.contains(win)){
-    if(DEBUG){ qDebug() << "Single-window property event"; }
-    //emit WindowListEvent();
-    WindowPropertyEvent(); //Run through the entire routine for window checks
-  }else if(RunningTrayApps.contains(win)){
-    emit TrayIconChanged(win);
+void LSession::WindowPropertyEvent(WId win, xcb_atom_t atom){
+  //Just record the change here - it gets dispatched with everything else in this frame
+  xevCounts.received++;
+  if(win == QX11Info::appRootWindow()){
+    if(atom == XCB->EWMH._NET_CLIENT_LIST){ pendingClientList = true; }
+    else if(atom == XCB->EWMH._NET_ACTIVE_WINDOW){ pendingActive = true; }
+    //Other root properties (stacking order changes on every raise/focus) are not used by anything in the session
+  }else{
+    if(atom == XCB->EWMH._NET_WM_ICON){ winIcons.remove(win); winIconSizes.remove(win); } //reload the icon next time
+    QList<xcb_atom_t> &atoms = pendingProps[win];
+    if(!atoms.contains(atom)){ atoms << atom; }
+  }
+  if(!propTimer->isActive()){ propTimer->start(); }
+}
+
+bool LSession::skipsLists(WId win){
+  QList<LXCB::WINDOWSTATE> states = XCB->WM_Get_Window_States(win);
+  return (states.contains(LXCB::S_SKIP_TASKBAR) || states.contains(LXCB::S_SKIP_PAGER));
+}
+
+void LSession::ScreenSaverEvent(xcb_atom_t atom){
+  //xscreensaver publishes its state on the root window: the first value is the BLANK/LOCK atom (0 when unblanked)
+  bool blanked = false;
+  xcb_get_property_cookie_t cookie = xcb_get_property(QX11Info::connection(), 0, QX11Info::appRootWindow(), atom, XCB_GET_PROPERTY_TYPE_ANY, 0, 1);
+  xcb_get_property_reply_t *reply = xcb_get_property_reply(QX11Info::connection(), cookie, NULL);
+  if(reply!=0){
+    if(reply->format==32 && xcb_get_property_value_length(reply)>=4){
+      blanked = ( ((uint32_t*) xcb_get_property_value(reply))[0] != 0 );
+    }
+    free(reply);
+  }
+  if(DEBUG){ qDebug() << "Screen Saver Active:" << blanked; }
+  ticker->setLocked(blanked); //nothing on the screen is visible - no periodic updates needed
+}
+
+void LSession::dispatchWindowEvents(){
+  xevCounts.batches++;
+  if(pendingActive){
+    //Both the previously active window and the new one need to be updated
+    WId active = XCB->ActiveWindow();
+    if(active != propActiveWin){
+      if(propActiveWin!=0){ pendingProps[propActiveWin] << XCB->EWMH._NET_ACTIVE_WINDOW; }
+      if(active!=0){ pendingProps[active] << XCB->EWMH._NET_ACTIVE_WINDOW; }
+      propActiveWin = active;
+    }
+    pendingActive = false;
+  }
+  if(pendingClientList){
+    //Full refresh - this already updates every window (just keep the skip states current)
+    pendingClientList = false;
+    QList<WId> wins = pendingProps.keys();
+    for(int i=0; i<wins.length(); i++){
+      if(!pendingProps[wins[i]].contains(XCB->EWMH._NET_WM_STATE)){ continue; }
+      if(skipsLists(wins[i])){ skipWins.insert(wins[i]); }
+      else{ skipWins.remove(wins[i]); }
+    }
+    pendingProps.clear();
+    WindowPropertyEvent();
+    return;
+  }
+  bool listChanged = false;
+  QHash<WId, QList<xcb_atom_t> >::const_iterator it = pendingProps.constBegin();
+  for( ; it!=pendingProps.constEnd(); ++it){
+    if(!RunningApps.contains(it.key())){ continue; } //not a window in the client list
+    if(it.value().contains(XCB->EWMH._NET_WM_STATE)){
+      //Only this window can have started/stopped skipping the taskbar/pager
+      bool skip = skipsLists(it.key());
+      if(skip != skipWins.contains(it.key())){
+        if(skip){ skipWins.insert(it.key()); }
+        else{ skipWins.remove(it.key()); }
+        listChanged = true;
+      }
+    }
+    xevCounts.windowUpdates++;
+    emit WindowPropertiesChanged(it.key(), it.value());
   }
+  pendingProps.clear();
+  if(listChanged){ emit WindowListEvent(); } //the window list itself is still current
 }
 
 void LSession::SysTrayDockRequest(WId win){
@@ -656,6 +981,7 @@ void LSession::SysTrayDockRequest(WId win){
 }
 
 void LSession::WindowClosedEvent(WId win){
+  winIcons.remove(win); winIconSizes.remove(win);
   if(TrayStopping){ return; }
   removeTrayWindow(win); //Check to see if the window is a tray app
 }
@@ -666,7 +992,7 @@ void LSession::WindowConfigureEvent(WId win){
       if(DEBUG){ qDebug() << "SysTray: Configure Event"; }
       emit TrayIconChanged(win); //trigger a repaint event
     }else if(RunningApps.contains(win)){
-      WindowPropertyEvent();
+      WindowPropertyEvent(win, XCB_ATOM_NONE); //geometry change
     }
 }
 
@@ -685,6 +1011,11 @@ void LSession::WindowSelectionClearEvent(WId win){
   }
 }
 
+bool LSession::KeyPressEvent(xcb_keycode_t keycode){
+  if(syscontrols==0){ return false; }
+  return syscontrols->handleKeyPress(keycode);
+}
+
 
 //======================
 //   SYSTEM TRAY FUNCTIONS
@@ -21,17 +21,30 @@
 #include <QMediaPlayer>
 #include <QThread>
 #include <QUrl>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QFutureWatcher>
 
 #include "Globals.h"
 #include "AppMenu.h"
 #include "SettingsMenu.h"
 #include "SystemWindow.h"
 #include "LDesktop.h"
+#include "BootTrace.h"
+#include "SystemControls.h"
+#include "LPluginSettings.h"
+#include "LDesktopFolder.h"
+#include "LTickScheduler.h"
+#include "LIconAtlas.h"
+#include "LAutoStart.h"
+#include "NotificationServer.h"
 //#include "WMProcess.h"
 //#include "BootSplash.h"
 
 #include <LuminaX11.h>
 #include <LuminaSingleApplication.h>
+#include <LuminaFileWatcher.h>
 
 //SYSTEM TRAY STANDARD DEFINITIONS
 #define SYSTEM_TRAY_REQUEST_DOCK 0
@@ -46,6 +59,8 @@ public:
 	}
 };*/
 
+class BootSplash;
+
 class LSession : public LSingleApplication{
 	Q_OBJECT
 public:
@@ -67,12 +82,14 @@ public:
 	//  (DO NOT USE MANUALLY)
 	void RootSizeChange();
 	void WindowPropertyEvent();
-        void WindowPropertyEvent(WId);
+	void WindowPropertyEvent(WId win, xcb_atom_t atom);
+	void ScreenSaverEvent(xcb_atom_t atom);
 	void SysTrayDockRequest(WId);
 	void WindowClosedEvent(WId);
 	void WindowConfigureEvent(WId);
 	void WindowDamageEvent(WId);
 	void WindowSelectionClearEvent(WId);
+	bool KeyPressEvent(xcb_keycode_t keycode); //returns true if the key was handled by the session
 	
 	//System Access
 	//Return a pointer to the current session
@@ -82,17 +99,27 @@ public:
 	
 	static void LaunchApplication(QString cmd);
 	QFileInfoList DesktopFiles();
+	LDesktopFolder* desktopFolder(); //per-item changes and shared thumbnails for the desktop folder
 	
 	QRect screenGeom(int num);
 	
 	AppMenu* applicationMenu();
 	void systemWindow();
 	SettingsMenu* settingsMenu();
+	SystemControls* systemControls(); //volume/brightness service (0 until the session is started)
+	LTickScheduler* tickScheduler(); //shared timer for the periodic plugin updates
+	LIconAtlas* iconAtlas(); //shared launcher/desktop icons
+	bool backgroundsReady(){ return bgReady; } //startup wallpapers decoded (see BackgroundsReady())
+	NotificationServer* notificationServer(); //desktop notifications (0 if another notification server is running)
 	LXCB *XCB; //class for XCB usage
 	
 	QSettings* sessionSettings();
 	QSettings* DesktopPluginSettings();
+	LPluginSettings* DesktopPluginStore(); //indexed/write-behind access to the desktop plugin settings
 	
+	//Cached window icons (_NET_WM_ICON) - only re-loaded when the window changes its icon
+	QIcon windowIcon(WId win, int size = 0); //size: the icon size which will be shown (0: load all sizes)
+
 	//Keep track of which non-desktop window should be treated as active
 	WId activeWindow(); //This will return the last active window if a desktop element is currently active
 	
@@ -103,20 +130,35 @@ public:
 	void playAudioFile(QString filepath);
 	//Window Adjustment Routine (due to Fluxbox not respecting _NET_WM_STRUT)
 	void adjustWindowGeom(WId win, bool maximize = false);
+
+	//X event statistics (events received vs. work actually performed)
+	struct XEventCounters{
+	  quint64 received; //window property/configure events from the X server
+	  quint64 batches; //number of times the pending events were dispatched
+	  quint64 windowUpdates; //single-window update signals
+	  quint64 listRefreshes; //full client list scans
+	};
+	XEventCounters xeventCounters(){ return xevCounts; }
 	
 private:
 	//WMProcess *WM;
 	QList<LDesktop*> DESKTOPS;
-	QFileSystemWatcher *watcher;
+	LFileWatcher *watcher;
 	QTimer *screenTimer;
 
 	//Internal variable for global usage
 	AppMenu *appmenu;
 	SettingsMenu *settingsmenu;
 	SystemWindow *sysWindow;
+	SystemControls *syscontrols;
+	LTickScheduler *ticker;
+	LIconAtlas *icons;
+	LAutoStart *autostart;
+	NotificationServer *notifications;
 	QTranslator *currTranslator;
 	QMediaPlayer *mediaObj;
 	QSettings *sessionsettings, *DPlugSettings;
+	LPluginSettings *DPlugStore;
 	bool cleansession;
 	//QList<QRect> savedScreens;
 
@@ -132,7 +174,49 @@ private:
 	WId lastActiveWin;
 	QList<WId> RunningApps;
 	QList<WId> checkWin;
-	QFileInfoList desktopFiles;
+	//Coalesced X property changes (dispatched once per frame)
+	QTimer *propTimer;
+	QHash<WId, QList<xcb_atom_t> > pendingProps;
+	bool pendingClientList, pendingActive;
+	WId propActiveWin;
+	QSet<WId> skipWins; //windows which asked to be left out of the taskbar/pager (_NET_WM_STATE)
+	bool skipsLists(WId win);
+	XEventCounters xevCounts;
+	QHash<WId, QIcon> winIcons;
+	QHash<WId, int> winIconSizes; //size which each cached icon was loaded for
+	LDesktopFolder *deskFolder;
+
+	//Startup stages (dependency graph)
+	struct BootStage{
+	  QString name;
+	  QStringList deps; //stages which need to be finished first
+	  bool worker; //run on a worker thread instead of the GUI thread
+	  void (LSession::*func)();
+	};
+	QList<BootStage> bootStages;
+	QStringList bootDone, bootRunning;
+	bool bootLooping, bootRerun; //runBootStages() is active / needs another pass
+	BootSplash *splash;
+	QList<XDGDesktop*> bootApps; //read by the "appdb" stage
+	QString bootIconName; //saved for the "icontheme" stage
+	bool bgReady;
+	QList<LAutoStartEntry> bootAutoStart; //read by the "autostart" stage
+	void addBootStage(QString name, QStringList deps, bool worker, void (LSession::*func)());
+	void runWorkerStage(int num);
+	//Individual stages
+	void bootSettings();
+	void bootAppDatabase();
+	void bootIconTheme();
+	void bootWallpapers();
+	void bootBackgrounds();
+	void bootMenus();
+	void bootDesktops();
+	void bootAppMenu();
+	void bootWatchers();
+	void bootSystemControls();
+	void bootNotifications();
+	void bootAutoStartApps();
+	void playLoginAudio();
 
 	void CleanupSession();
 	
@@ -147,11 +231,16 @@ public slots:
 
 private slots:
 	void NewCommunication(QStringList);
-	void launchStartupApps(); //used during initialization
+	void launchStartupApps(); //used during initialization (worker thread)
+	void runBootStages(); //start any stages which have all dependencies finished
+	void bootStageFinished();
+	void autoStartPhaseFinished(int);
+	void autoStartFinished();
 	void watcherChange(QString);
 	void screensChanged();
 	void screenResized(int);
 	void checkWindowGeoms();
+	void dispatchWindowEvents();
 
 	//System Tray Functions
 	void startSystemTray();
@@ -177,11 +266,12 @@ signals:
 	void StartButtonAvailable();
 	void StartButtonActivated();
 	//Task Manager Signals
-	void WindowListEvent(WId);
-	void WindowListEvent();
+	void WindowListEvent(); //client list changed (full refresh)
+	void WindowPropertiesChanged(WId, QList<xcb_atom_t>); //properties which changed on a single window (XCB_ATOM_NONE: geometry)
 	//General Signals
 	void LocaleChanged();
 	void IconThemeChanged();
+	void BackgroundsReady(); //desktop backgrounds can be loaded now (startup)
 	void DesktopConfigChanged();
 	void SessionConfigChanged();
 	void DesktopFilesChanged();
@@ -0,0 +1,236 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "LTickScheduler.h"
+
+#include <QDateTime>
+#include <QMetaObject>
+#include <QDebug>
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#ifndef TFD_TIMER_CANCEL_ON_SET
+#define TFD_TIMER_CANCEL_ON_SET (1 << 1)
+#endif
+#endif
+
+LTickScheduler::LTickScheduler(QObject *parent) : QObject(parent){
+  locked = false;
+  nextID = 1;
+  wakeups = 0;
+  started = QDateTime::currentMSecsSinceEpoch();
+  tfdNotifier = 0;
+  timer = 0;
+#ifdef __linux__
+  //Wall-clock timer with absolute expirations (boundaries stay aligned, and clock changes get reported)
+  tfd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+#else
+  tfd = -1;
+#endif
+  if(tfd>=0){
+    tfdNotifier = new QSocketNotifier(tfd, QSocketNotifier::Read, this);
+    connect(tfdNotifier, SIGNAL(activated(int)), this, SLOT(timerFired()) );
+  }else{
+    timer = new QTimer(this);
+      timer->setSingleShot(true);
+      timer->setTimerType(Qt::PreciseTimer);
+      connect(timer, SIGNAL(timeout()), this, SLOT(timerFired()) );
+  }
+}
+
+LTickScheduler::~LTickScheduler(){
+  if(tfd>=0){ ::close(tfd); }
+}
+
+int LTickScheduler::registerTick(QString name, QObject *receiver, const char *slot, Alignment align, int interval, int slack){
+  if(receiver==0 || slot==0){ return -1; }
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  Tick T;
+    T.name = name;
+    T.receiver = receiver;
+    T.method = QByteArray(slot+1); //skip the SLOT() type code
+    T.method = T.method.left(T.method.indexOf('('));
+    T.align = align;
+    T.interval = qMax(interval, 1);
+    T.slack = qMax(slack, 0);
+    T.count = 0;
+    T.started = now;
+    T.due = nextDue(T, now);
+  int id = nextID;
+  nextID++;
+  ticks.insert(id, T);
+  connect(receiver, SIGNAL(destroyed(QObject*)), this, SLOT(receiverDestroyed(QObject*)), Qt::UniqueConnection);
+  schedule();
+  return id;
+}
+
+void LTickScheduler::changeTick(int id, Alignment align, int interval, int slack){
+  if(!ticks.contains(id)){ return; }
+  Tick &T = ticks[id];
+  T.align = align;
+  T.interval = qMax(interval, 1);
+  T.slack = qMax(slack, 0);
+  T.due = nextDue(T, QDateTime::currentMSecsSinceEpoch());
+  schedule();
+}
+
+void LTickScheduler::unregisterTick(int id){
+  if(ticks.remove(id)>0){ schedule(); }
+}
+
+void LTickScheduler::setPaused(QObject *container, bool paused){
+  if(container==0 || paused==pausedObjs.contains(container)){ return; }
+  if(paused){
+    pausedObjs.insert(container);
+    connect(container, SIGNAL(destroyed(QObject*)), this, SLOT(pausedDestroyed(QObject*)), Qt::UniqueConnection);
+  }else{
+    pausedObjs.remove(container);
+  }
+  schedule(); //anything which was skipped while paused is overdue now (catch-up tick)
+}
+
+void LTickScheduler::setLocked(bool lock){
+  if(lock==locked){ return; }
+  locked = lock;
+  schedule();
+}
+
+QStringList LTickScheduler::stats(){
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  QStringList out;
+  out << QString("Shared Timer: %1 wakeups/s (%2 total)").arg( QString::number(wakeups/(qMax(now-started, (qint64) 1)/1000.0), 'f', 3), QString::number(wakeups) );
+  QHash<int, Tick>::const_iterator it;
+  for(it = ticks.constBegin(); it!=ticks.constEnd(); ++it){
+    double secs = qMax(now-it.value().started, (qint64) 1)/1000.0;
+    QString line = QString(" - %1: %2 ticks/s (%3 total)").arg(it.value().name, QString::number(it.value().count/secs, 'f', 3), QString::number(it.value().count) );
+    if(isPaused(it.value())){ line.append(" [paused]"); }
+    out << line;
+  }
+  return out;
+}
+
+// ===================
+//  PRIVATE
+// ===================
+bool LTickScheduler::isPaused(const Tick &T){
+  if(locked){ return true; }
+  if(pausedObjs.isEmpty()){ return false; }
+  for(QObject *obj = T.receiver; obj!=0; obj = obj->parent()){
+    if(pausedObjs.contains(obj)){ return true; }
+  }
+  return false;
+}
+
+qint64 LTickScheduler::nextDue(const Tick &T, qint64 now){
+  switch(T.align){
+    case SecondBoundary:
+	return ((now/1000)+1)*1000;
+    case MinuteBoundary:
+	return ((now/60000)+1)*60000;
+    case Interval:
+	break;
+  }
+  return now+T.interval;
+}
+
+qint64 LTickScheduler::period(const Tick &T){
+  switch(T.align){
+    case SecondBoundary:
+	return 1000;
+    case MinuteBoundary:
+	return 60000;
+    case Interval:
+	break;
+  }
+  return T.interval;
+}
+
+void LTickScheduler::schedule(){
+  //Wake up at the end of the earliest slack window: anything else which is due by then gets the same wakeup
+  qint64 wake = -1;
+  QHash<int, Tick>::const_iterator it;
+  for(it = ticks.constBegin(); it!=ticks.constEnd(); ++it){
+    if(isPaused(it.value())){ continue; }
+    qint64 latest = it.value().due + it.value().slack;
+    if(wake<0 || latest<wake){ wake = latest; }
+  }
+#ifdef __linux__
+  if(tfd>=0){
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec)); //all zeros: disarm
+    if(wake>=0){
+      spec.it_value.tv_sec = wake/1000;
+      spec.it_value.tv_nsec = (wake%1000)*1000000;
+    }
+    timerfd_settime(tfd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, 0);
+    return;
+  }
+#endif
+  if(wake<0){ timer->stop(); }
+  else{ timer->start( qMax(wake-QDateTime::currentMSecsSinceEpoch(), (qint64) 0) ); }
+}
+
+// ===================
+//  PRIVATE SLOTS
+// ===================
+void LTickScheduler::timerFired(){
+  bool clockset = false;
+  if(tfd>=0){
+    quint64 expired = 0;
+    if(::read(tfd, &expired, sizeof(expired))<0){
+      if(errno==EAGAIN){ return; } //spurious notification
+      clockset = (errno==ECANCELED); //system clock was changed - boundaries need to be re-calculated
+    }
+  }
+  wakeups++;
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  QList<int> fire;
+  QHash<int, Tick>::iterator it;
+  for(it = ticks.begin(); it!=ticks.end(); ++it){
+    Tick &T = it.value();
+    //Clock changed (reported by the timerfd, or the next tick is more than a period away - the clock went backwards)
+    //  - boundary ticks show the time: deliver them right away, interval ticks just start counting again
+    if(clockset || T.due > now+period(T)){
+      if(T.align==Interval){ T.due = now+T.interval; }
+      else{ T.due = now; }
+    }
+    if(isPaused(T)){ continue; }
+    if(T.due<=now){
+      fire << it.key();
+      T.count++;
+      if(T.align==Interval){
+        //Keep the period steady (the slack only moves the wakeup, not the next due time)
+        T.due += T.interval;
+        if(T.due<=now){ T.due = now+T.interval; } //fell behind (paused/busy) - no burst of catch-up ticks
+      }else{
+        T.due = nextDue(T, now);
+      }
+    }
+  }
+  //Now run the slots (these might change/remove registrations)
+  for(int i=0; i<fire.length(); i++){
+    if(!ticks.contains(fire[i])){ continue; } //removed by one of the earlier slots
+    Tick T = ticks.value(fire[i]);
+    QMetaObject::invokeMethod(T.receiver, T.method.constData(), Qt::DirectConnection);
+  }
+  schedule();
+}
+
+void LTickScheduler::receiverDestroyed(QObject *obj){
+  QList<int> ids = ticks.keys();
+  for(int i=0; i<ids.length(); i++){
+    if(ticks.value(ids[i]).receiver==obj){ ticks.remove(ids[i]); }
+  }
+  pausedObjs.remove(obj);
+  schedule();
+}
+
+void LTickScheduler::pausedDestroyed(QObject *obj){
+  if(pausedObjs.remove(obj)){ schedule(); }
+}
@@ -0,0 +1,81 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Session-wide wakeup scheduler for the periodic plugin updates (clock, battery, system monitor)
+//   - Plugins register for aligned ticks (next second/minute boundary) or an interval with some slack
+//   - Every registration shares a single timer (a timerfd on Linux, a precise QTimer otherwise),
+//       so ticks which are due within each other's slack are delivered on the same wakeup
+//   - Registrations inside a paused widget (hidden panel) or while the screen is locked are skipped,
+//       and get a catch-up tick as soon as they are resumed
+//   - Wakeup counters are kept for each registration ("lumina-desktop --tick-stats")
+//===========================================
+#ifndef _LUMINA_DESKTOP_TICK_SCHEDULER_H
+#define _LUMINA_DESKTOP_TICK_SCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QSocketNotifier>
+
+class LTickScheduler : public QObject{
+	Q_OBJECT
+public:
+	enum Alignment{ SecondBoundary, MinuteBoundary, Interval };
+
+	LTickScheduler(QObject *parent = 0);
+	~LTickScheduler();
+
+	//Call the slot (no arguments: SLOT(update())) on every tick, returns the ID of the registration
+	// - interval/slack (milliseconds) are only used for the "Interval" alignment
+	// - the registration is removed automatically when the receiver is destroyed
+	int registerTick(QString name, QObject *receiver, const char *slot, Alignment align, int interval = 0, int slack = 0);
+	void changeTick(int id, Alignment align, int interval = 0, int slack = 0);
+	void unregisterTick(int id);
+
+	void setPaused(QObject *container, bool paused); //skip every registration inside this object (hidden panels)
+	void setLocked(bool locked); //skip all registrations (screen locked)
+	bool isLocked(){ return locked; }
+
+	QStringList stats(); //wakeups per second for each registration (and the shared timer)
+
+private:
+	struct Tick{
+	  QString name;
+	  QObject *receiver;
+	  QByteArray method;
+	  Alignment align;
+	  int interval, slack;
+	  qint64 due; //msecs since epoch
+	  quint64 count;
+	  qint64 started;
+	};
+	QHash<int, Tick> ticks;
+	QSet<QObject*> pausedObjs;
+	bool locked;
+	int nextID;
+	//Shared timer
+	int tfd; //timerfd (-1 if not available)
+	QSocketNotifier *tfdNotifier;
+	QTimer *timer;
+	quint64 wakeups;
+	qint64 started;
+
+	bool isPaused(const Tick &T);
+	qint64 nextDue(const Tick &T, qint64 now);
+	static qint64 period(const Tick &T); //time between two ticks (milliseconds)
+	void schedule();
+
+private slots:
+	void timerFired();
+	void receiverDestroyed(QObject*);
+	void pausedDestroyed(QObject*);
+};
+
+#endif
@@ -25,10 +25,10 @@ QString  LWinInfo::text(){
   return nm;
 }
 
-QIcon LWinInfo::icon(bool &noicon){
+QIcon LWinInfo::icon(bool &noicon, int size){
   if(window==0){ noicon = true; return QIcon();}
   noicon = false;
-  QIcon ico = LSession::handle()->XCB->WindowIcon(window);
+  QIcon ico = LSession::handle()->windowIcon(window, size);
   //Check for a null icon, and supply one if necessary
   if(ico.isNull()){ ico = LXDG::findIcon( this->Class().toLower(),""); }
   if(ico.isNull()){ico = LXDG::findIcon("preferences-system-windows",""); noicon=true;}
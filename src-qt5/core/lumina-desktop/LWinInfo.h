@@ -41,8 +41,9 @@ public:
 	
 	//Information Retrieval
 	 // Don't cache these results because they can change regularly
+	 // (the window icon is cached by the session and only re-loaded when it changes)
 	QString  text();
-	QIcon icon(bool &noicon);
+	QIcon icon(bool &noicon, int size = 0); //size: icon size which will be shown (0: all sizes)
 	QString Class();
 	LXCB::WINDOWVISIBILITY status(bool update = false);
 };
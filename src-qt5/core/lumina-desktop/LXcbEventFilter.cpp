@@ -50,15 +50,13 @@ bool XCBEventFilter::nativeEventFilter(const QByteArray &eventType, void *messag
 			&& ( ( ((xcb_property_notify_event_t*)ev)->atom == session->XCB->EWMH._NET_CURRENT_DESKTOP) )){
  		  //qDebug() << "Got Workspace Change";
 		  session->emit WorkspaceChanged();
-		}else if( SysNotifyAtoms.contains( ((xcb_property_notify_event_t*)ev)->atom ) ){
-		  //Update the status/list of all running windows
-		  session->WindowPropertyEvent();	
-			
-		//window-specific property change
-		}else if( WinNotifyAtoms.contains( ((xcb_property_notify_event_t*)ev)->atom ) ){
-		  //Ping only that window
-		  //session->WindowPropertyEvent( ((xcb_property_notify_event_t*)ev)->window );
-		  session->WindowPropertyEvent();
+		}else if( ((xcb_property_notify_event_t*)ev)->window == QX11Info::appRootWindow() \
+			&& _SCREENSAVER_STATUS!=0 && ((xcb_property_notify_event_t*)ev)->atom == _SCREENSAVER_STATUS ){
+		  session->ScreenSaverEvent(_SCREENSAVER_STATUS);
+		}else if( SysNotifyAtoms.contains( ((xcb_property_notify_event_t*)ev)->atom ) \
+			|| WinNotifyAtoms.contains( ((xcb_property_notify_event_t*)ev)->atom ) ){
+		  //Queue up the change (gets coalesced with any others on the same window)
+		  session->WindowPropertyEvent( ((xcb_property_notify_event_t*)ev)->window, ((xcb_property_notify_event_t*)ev)->atom );
 	        }
 		break;
 //==============================	    
@@ -82,10 +80,14 @@ bool XCBEventFilter::nativeEventFilter(const QByteArray &eventType, void *messag
 		  session->WindowPropertyEvent( ((xcb_client_message_event_t*)ev)->window );*/
 		}else if( WinNotifyAtoms.contains( ((xcb_client_message_event_t*)ev)->type ) ){
 		  //Ping only that window
-		  //session->WindowPropertyEvent( ((xcb_client_message_event_t*)ev)->window );
-		  session->WindowPropertyEvent();
+		  session->WindowPropertyEvent( ((xcb_client_message_event_t*)ev)->window, ((xcb_client_message_event_t*)ev)->type );
 	        }
 	        break;
+//==============================
+	    case XCB_KEY_PRESS:
+		//Only the multimedia keys grabbed on the root window get here
+		if( session->KeyPressEvent( ((xcb_key_press_event_t*)ev)->detail ) ){ return true; } //handled - stop here
+		break;
 //==============================	    
 	    case XCB_DESTROY_NOTIFY:
 		//qDebug() << "Window Closed Event";
@@ -58,7 +58,7 @@ XCB_CLIENT_MESSAGE
 class XCBEventFilter : public QAbstractNativeEventFilter{
 private:
 	LSession *session;
-	xcb_atom_t _NET_SYSTEM_TRAY_OPCODE;
+	xcb_atom_t _NET_SYSTEM_TRAY_OPCODE, _SCREENSAVER_STATUS;
 	QList<xcb_atom_t> WinNotifyAtoms, SysNotifyAtoms;
 	int TrayDmgFlag; //internal damage event offset value for the system tray
 	bool stopping;
@@ -89,6 +89,14 @@ private:
 	      _NET_SYSTEM_TRAY_OPCODE = r->atom; 
 	      free(r);
 	    }
+	  //_SCREENSAVER_STATUS (xscreensaver blank/lock state on the root window)
+	  _SCREENSAVER_STATUS = 0;
+	  cookie = xcb_intern_atom(QX11Info::connection(), 0, 19,"_SCREENSAVER_STATUS");
+	    r = xcb_intern_atom_reply(QX11Info::connection(), cookie, NULL);
+	    if(r){
+	      _SCREENSAVER_STATUS = r->atom;
+	      free(r);
+	    }
 	}
 	
 public:
@@ -0,0 +1,95 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "NotificationPopup.h"
+
+#include <QApplication>
+#include <QDesktopWidget>
+#include <QCursor>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+#define ICONSIZE 48
+#define MARGIN 10 //distance from the screen edges
+
+NotificationPopup::NotificationPopup(QWidget *parent) : QWidget(parent, Qt::Window | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::X11BypassWindowManagerHint){
+  this->setObjectName("NotificationPopup");
+  this->setWindowTitle("");
+  this->setAttribute(Qt::WA_ShowWithoutActivating);
+  this->setFocusPolicy(Qt::NoFocus);
+  this->setStyleSheet("QWidget#NotificationPopup{background: black; border-radius: 5px;} QLabel{color: white; background: transparent;}");
+  curID = 0;
+  iconL = new QLabel(this);
+    iconL->setFixedSize(ICONSIZE, ICONSIZE);
+  summaryL = new QLabel(this);
+    summaryL->setStyleSheet("font-weight: bold;");
+    summaryL->setTextFormat(Qt::PlainText);
+  bodyL = new QLabel(this);
+    bodyL->setWordWrap(true);
+    bodyL->setTextFormat(Qt::AutoText); //simple markup is allowed in the body
+    bodyL->setMaximumWidth(320);
+  moreL = new QLabel(this);
+    moreL->setStyleSheet("font-style: italic;");
+    moreL->setAlignment(Qt::AlignRight);
+  QVBoxLayout *tlay = new QVBoxLayout;
+    tlay->addWidget(summaryL);
+    tlay->addWidget(bodyL, 1);
+  QHBoxLayout *hlay = new QHBoxLayout;
+    hlay->addWidget(iconL, 0, Qt::AlignTop);
+    hlay->addLayout(tlay, 1);
+  QVBoxLayout *vlay = new QVBoxLayout(this);
+    vlay->setContentsMargins(10,8,10,8);
+    vlay->addLayout(hlay);
+    vlay->addWidget(moreL);
+  this->setMinimumWidth(260);
+  hideTimer = new QTimer(this);
+    hideTimer->setSingleShot(true);
+    connect(hideTimer, SIGNAL(timeout()), this, SLOT(hidePopup()) );
+}
+
+NotificationPopup::~NotificationPopup(){
+
+}
+
+void NotificationPopup::showMessage(uint id, QIcon icon, QString summary, QString body, int merged, int timeout){
+  curID = id;
+  iconL->setPixmap( icon.pixmap(ICONSIZE,ICONSIZE) );
+  summaryL->setText(summary);
+  bodyL->setText(body);
+  bodyL->setVisible(!body.isEmpty());
+  moreL->setText( tr("%1 more notifications").arg(QString::number(merged)) );
+  moreL->setVisible(merged>0);
+  this->adjustSize();
+  //Top-right corner of the screen with the mouse
+  QRect screen = QApplication::desktop()->availableGeometry(QCursor::pos());
+  this->move(screen.right()-this->width()-MARGIN, screen.top()+MARGIN);
+  if(!this->isVisible()){ this->show(); }
+  this->raise();
+  if(timeout>0){ hideTimer->start(timeout); }
+  else{ hideTimer->stop(); }
+}
+
+void NotificationPopup::updateIcon(uint id, QIcon icon){
+  if(id!=curID || !this->isVisible()){ return; }
+  iconL->setPixmap( icon.pixmap(ICONSIZE,ICONSIZE) );
+}
+
+void NotificationPopup::closeMessage(uint id){
+  if(id==curID){ hidePopup(); }
+}
+
+void NotificationPopup::hidePopup(){
+  hideTimer->stop();
+  curID = 0;
+  this->hide();
+}
+
+void NotificationPopup::mouseReleaseEvent(QMouseEvent *ev){
+  uint id = curID;
+  hidePopup();
+  if(id!=0){ emit Clicked(id); }
+  ev->accept();
+}
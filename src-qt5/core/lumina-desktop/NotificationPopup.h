@@ -0,0 +1,47 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Popup for desktop notifications (top-right corner of the screen with the mouse)
+//  The same widget is re-used for every message - the notification server decides how often it gets updated
+//===========================================
+#ifndef _LUMINA_DESKTOP_NOTIFICATION_POPUP_H
+#define _LUMINA_DESKTOP_NOTIFICATION_POPUP_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QTimer>
+#include <QIcon>
+#include <QString>
+#include <QMouseEvent>
+
+class NotificationPopup : public QWidget{
+	Q_OBJECT
+public:
+	NotificationPopup(QWidget *parent = 0);
+	~NotificationPopup();
+
+	//Show a message (merged: number of other messages which were not shown, timeout: 0 to stay until clicked)
+	void showMessage(uint id, QIcon icon, QString summary, QString body, int merged, int timeout);
+	void updateIcon(uint id, QIcon icon); //only if this message is still shown
+	void closeMessage(uint id); //only if this message is still shown
+	uint currentID(){ return curID; }
+
+private:
+	QLabel *iconL, *summaryL, *bodyL, *moreL;
+	QTimer *hideTimer;
+	uint curID;
+
+private slots:
+	void hidePopup();
+
+protected:
+	void mouseReleaseEvent(QMouseEvent *ev);
+
+signals:
+	void Clicked(uint);
+};
+
+#endif
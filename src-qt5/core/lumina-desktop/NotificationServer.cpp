@@ -0,0 +1,394 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "NotificationServer.h"
+
+#include <QtConcurrent>
+#include <QImageReader>
+#include <QPixmap>
+#include <QUrl>
+#include <QDBusArgument>
+#include <QDebug>
+
+#include <LuminaXDG.h>
+#include <LuminaUtils.h>
+
+#define HISTORY 500 //max number of messages kept in the history
+#define BATCH 100 //milliseconds between history updates to the UI
+#define POPUP_INTERVAL 250 //minimum milliseconds between popup updates
+#define DEFAULT_TIMEOUT 5000 //milliseconds (if the application does not specify one)
+#define ICONSIZE 64 //max size for decoded icons
+#define ICON_BATCH 64 //max icons decoded per worker run
+#define ICON_CACHE 200 //max number of decoded image files kept around
+
+// === Worker thread function ===
+static QList<LNotificationIcon> decodeIcons(QList<LNotificationIcon> jobs){
+  for(int i=0; i<jobs.length(); i++){
+    LNotificationIcon &job = jobs[i];
+    if(!job.path.isEmpty()){
+      QImageReader reader(job.path);
+      QSize sz = reader.size();
+      if(sz.isValid() && (sz.width()>ICONSIZE || sz.height()>ICONSIZE) ){
+        reader.setScaledSize( sz.scaled(ICONSIZE, ICONSIZE, Qt::KeepAspectRatio) ); //decode at the reduced size directly
+      }
+      job.img = reader.read();
+    }else if(job.width>0 && job.height>0 && job.bits==8 && (job.channels==3 || job.channels==4) \
+	&& job.rowstride>=job.width*job.channels && job.data.size()>=job.rowstride*(job.height-1)+job.width*job.channels ){
+      //Raw image-data hint (RGB or RGBA, 8 bits per sample)
+      QImage raw((const uchar*) job.data.constData(), job.width, job.height, job.rowstride, job.channels==4 ? QImage::Format_RGBA8888 : QImage::Format_RGB888);
+      if(job.width>ICONSIZE || job.height>ICONSIZE){ job.img = raw.scaled(ICONSIZE, ICONSIZE, Qt::KeepAspectRatio, Qt::SmoothTransformation); }
+      else{ job.img = raw.copy(); } //detach from the data buffer
+    }
+    job.data.clear(); //no need to keep this around
+  }
+  return jobs;
+}
+
+NotificationServer::NotificationServer(QObject *parent) : QObject(parent){
+  ring.resize(HISTORY);
+  for(int i=0; i<ring.size(); i++){ ring[i].id = 0; }
+  head = used = 0;
+  lastID = 0;
+  popupID = 0;
+  popupMerged = 0;
+  lastPopup = 0;
+  statReceived = statReplaced = statMerged = statEvicted = statPopups = statPopupsMerged = statIcons = 0;
+  statLatencyTotal = statLatencyMax = 0;
+  batchTimer = new QTimer(this);
+    batchTimer->setSingleShot(true);
+    batchTimer->setInterval(BATCH);
+    connect(batchTimer, SIGNAL(timeout()), this, SLOT(sendBatch()) );
+  expireTimer = new QTimer(this);
+    expireTimer->setSingleShot(true);
+    connect(expireTimer, SIGNAL(timeout()), this, SLOT(checkExpired()) );
+  popupTimer = new QTimer(this);
+    popupTimer->setSingleShot(true);
+    connect(popupTimer, SIGNAL(timeout()), this, SLOT(showPopup()) );
+  popup = new NotificationPopup();
+    connect(popup, SIGNAL(Clicked(uint)), this, SLOT(popupClicked(uint)) );
+  iconWatcher = new QFutureWatcher<QList<LNotificationIcon> >(this);
+    connect(iconWatcher, SIGNAL(finished()), this, SLOT(iconsFinished()) );
+}
+
+NotificationServer::~NotificationServer(){
+  iconQueue.clear();
+  iconWatcher->waitForFinished();
+  delete popup;
+}
+
+bool NotificationServer::start(QDBusConnection bus){
+  if(!bus.isConnected()){ return false; }
+  if(!bus.registerObject("/org/freedesktop/Notifications", this, QDBusConnection::ExportScriptableSlots | QDBusConnection::ExportScriptableSignals) ){ return false; }
+  if(!bus.registerService("org.freedesktop.Notifications")){
+    bus.unregisterObject("/org/freedesktop/Notifications");
+    return false;
+  }
+  return true;
+}
+
+QList<uint> NotificationServer::history(){
+  QList<uint> out;
+  for(int i=0; i<used; i++){
+    int slot = (head-used+i+HISTORY) % HISTORY;
+    if(ring[slot].id!=0){ out << ring[slot].id; }
+  }
+  return out;
+}
+
+LNotification NotificationServer::notification(uint id){
+  LNotification *note = entry(id);
+  if(note!=0){ return *note; }
+  LNotification empty;
+    empty.id = 0;
+    empty.urgency = 1;
+    empty.timeout = empty.count = 0;
+    empty.closed = true;
+    empty.received = empty.expires = 0;
+    empty.serial = 0;
+  return empty;
+}
+
+QIcon NotificationServer::icon(const LNotification &note){
+  if(!note.icon.isNull()){ return QIcon( QPixmap::fromImage(note.icon) ); }
+  QString name = note.appIcon;
+  if(name.isEmpty() || name.contains("/")){ name = (note.urgency>=2) ? "dialog-warning" : "dialog-information"; } //image file which is not loaded (yet)
+  return LXDG::findIcon(name, "dialog-information");
+}
+
+void NotificationServer::dismiss(uint id){
+  LNotification *note = entry(id);
+  if(note==0){ return; }
+  if(!note->closed){ closeEntry(id, 2); } //dismissed by the user
+  removeEntry(id);
+}
+
+void NotificationServer::clearHistory(){
+  QList<uint> ids = history();
+  for(int i=0; i<ids.length(); i++){ dismiss(ids[i]); }
+}
+
+QStringList NotificationServer::stats(){
+  QStringList out;
+  out << QString("Notifications Received: %1 (replaced: %2, merged with identical messages: %3, dropped from the history: %4)").arg( \
+	QString::number(statReceived), QString::number(statReplaced), QString::number(statMerged), QString::number(statEvicted) );
+  out << QString("Popups Shown: %1 (messages merged into other popups: %2)").arg( QString::number(statPopups), QString::number(statPopupsMerged) );
+  out << QString("Popup Latency: %1 ms average, %2 ms max").arg( \
+	QString::number(statPopups>0 ? statLatencyTotal/((double) statPopups) : 0.0, 'f', 1), QString::number(statLatencyMax) );
+  out << QString("Icons Decoded: %1").arg( QString::number(statIcons) );
+  return out;
+}
+
+// ===================
+//  D-BUS INTERFACE
+// ===================
+QStringList NotificationServer::GetCapabilities(){
+  QStringList caps;
+  caps << "actions" << "body" << "body-markup" << "icon-static" << "persistence";
+  return caps;
+}
+
+uint NotificationServer::Notify(QString app_name, uint replaces_id, QString app_icon, QString summary, QString body, QStringList actions, QVariantMap hints, int expire_timeout){
+  statReceived++;
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  LNotification note;
+    note.id = 0;
+    note.app = app_name;
+    note.appIcon = app_icon;
+    note.summary = summary;
+    note.body = body;
+    note.actions = actions;
+    note.urgency = hints.value("urgency", 1).toInt();
+    note.timeout = (expire_timeout<0) ? DEFAULT_TIMEOUT : expire_timeout;
+    if(note.urgency>=2){ note.timeout = 0; } //critical messages stay until they are closed
+    note.time = QDateTime::currentDateTime();
+    note.count = 1;
+    note.closed = false;
+    note.received = now;
+    note.expires = (note.timeout>0) ? now+note.timeout : 0;
+    note.serial = 0;
+  //Find the entry which this message updates (if any)
+  LNotification *cur = 0;
+  if(replaces_id!=0){
+    cur = entry(replaces_id);
+    if(cur!=0){ statReplaced++; }
+  }
+  if(cur==0){
+    cur = entry( dupes.value(dupeKey(note), 0) );
+    if(cur!=0){ note.count = cur->count+1; statMerged++; }
+  }
+  if(cur!=0){
+    //Update the existing entry in place
+    QString oldkey = dupeKey(*cur);
+    if(dupes.value(oldkey)==cur->id){ dupes.remove(oldkey); }
+    note.id = cur->id;
+    note.serial = cur->serial+1;
+    note.icon = cur->icon; //keep showing the old icon until the new one is decoded
+    *cur = note;
+  }else{
+    //New entry (drop the oldest message if the history is full)
+    lastID++;
+    if(lastID==0){ lastID = 1; } //0 is not a valid ID
+    note.id = lastID;
+    if(ring[head].id!=0){
+      statEvicted++;
+      if(!ring[head].closed){ closeEntry(ring[head].id, 4); } //still open: tell the application it is gone
+      removeEntry(ring[head].id);
+    }
+    ring[head] = note;
+    index.insert(note.id, head);
+    cur = &ring[head];
+    head = (head+1) % HISTORY;
+    if(used<HISTORY){ used++; }
+  }
+  dupes.insert(dupeKey(*cur), cur->id);
+  queueIcon(cur, hints);
+  if(cur->expires>0){
+    expiries.insert(cur->expires, cur->id);
+    if(!expireTimer->isActive() || expiries.firstKey()==cur->expires){ expireTimer->start( qMax(cur->expires-now, (qint64) 0) ); }
+  }
+  uint id = cur->id;
+  queueChange(id);
+  queuePopup(id);
+  return id;
+}
+
+void NotificationServer::CloseNotification(uint id){
+  LNotification *note = entry(id);
+  if(note!=0 && !note->closed){ closeEntry(id, 3); }
+}
+
+QString NotificationServer::GetServerInformation(QString &vendor, QString &version, QString &spec_version){
+  vendor = "Lumina";
+  version = LUtils::LuminaDesktopVersion();
+  spec_version = "1.2";
+  return "lumina-desktop";
+}
+
+// ===================
+//  PRIVATE
+// ===================
+QString NotificationServer::dupeKey(const LNotification &note){
+  return note.app+"\n"+note.summary+"\n"+note.body;
+}
+
+LNotification* NotificationServer::entry(uint id){
+  if(id==0){ return 0; }
+  int slot = index.value(id, -1);
+  if(slot<0){ return 0; }
+  return &ring[slot];
+}
+
+void NotificationServer::removeEntry(uint id){
+  int slot = index.value(id, -1);
+  if(slot<0){ return; }
+  index.remove(id);
+  QString key = dupeKey(ring[slot]);
+  if(dupes.value(key)==id){ dupes.remove(key); }
+  ring[slot] = LNotification(); //release the strings/image
+  ring[slot].id = 0;
+  iconQueue.remove(id);
+  if(popupID==id){ popupID = 0; }
+  popup->closeMessage(id);
+  changed.remove(id);
+  removed.insert(id);
+  if(!batchTimer->isActive()){ batchTimer->start(); }
+}
+
+void NotificationServer::queueIcon(LNotification *note, QVariantMap hints){
+  LNotificationIcon job;
+    job.id = note->id;
+    job.serial = note->serial;
+    job.width = job.height = job.rowstride = job.bits = job.channels = 0;
+    job.alpha = false;
+  //Order of precedence (spec 1.2): image-data, image-path, app_icon (older spec names also accepted)
+  QVariant raw;
+  if(hints.contains("image-data")){ raw = hints.value("image-data"); }
+  else if(hints.contains("image_data")){ raw = hints.value("image_data"); }
+  else if(hints.contains("icon_data")){ raw = hints.value("icon_data"); }
+  if(raw.userType()==qMetaTypeId<QDBusArgument>()){
+    //Only copy the raw values here - the image gets assembled/scaled on the worker thread
+    const QDBusArgument arg = qvariant_cast<QDBusArgument>(raw);
+    arg.beginStructure();
+    arg >> job.width >> job.height >> job.rowstride >> job.alpha >> job.bits >> job.channels >> job.data;
+    arg.endStructure();
+  }else{
+    QString path = hints.value("image-path", hints.value("image_path")).toString();
+    if(path.isEmpty()){ path = note->appIcon; }
+    if(path.startsWith("file://")){ path = QUrl(path).toLocalFile(); }
+    if(!path.startsWith("/")){
+      //Theme icon name (looked up when shown)
+      if(!path.isEmpty()){ note->appIcon = path; }
+      note->icon = QImage();
+      return;
+    }
+    if(iconCache.contains(path)){ note->icon = iconCache.value(path); return; }
+    job.path = path;
+  }
+  iconQueue.insert(note->id, job); //replaces any older request for this message
+  startIcons();
+}
+
+void NotificationServer::startIcons(){
+  if(iconWatcher->isRunning() || iconQueue.isEmpty()){ return; }
+  QList<LNotificationIcon> jobs;
+  QHash<uint, LNotificationIcon>::iterator it = iconQueue.begin();
+  while(it!=iconQueue.end() && jobs.length()<ICON_BATCH){
+    jobs << it.value();
+    it = iconQueue.erase(it);
+  }
+  iconWatcher->setFuture( QtConcurrent::run(decodeIcons, jobs) );
+}
+
+void NotificationServer::queueChange(uint id){
+  changed.insert(id);
+  if(!batchTimer->isActive()){ batchTimer->start(); } //not restarted: at most one update per interval
+}
+
+void NotificationServer::queuePopup(uint id){
+  if(popupID!=0 && popupID!=id){ popupMerged++; statPopupsMerged++; } //the older message never gets its own popup
+  popupID = id;
+  if(!popupTimer->isActive()){
+    qint64 wait = lastPopup+POPUP_INTERVAL - QDateTime::currentMSecsSinceEpoch();
+    popupTimer->start( qMax(wait, (qint64) 0) );
+  }
+}
+
+void NotificationServer::closeEntry(uint id, uint reason){
+  LNotification *note = entry(id);
+  if(note==0){ return; }
+  note->closed = true;
+  note->expires = 0;
+  if(popupID==id){ popupID = 0; }
+  popup->closeMessage(id);
+  queueChange(id);
+  emit NotificationClosed(id, reason);
+}
+
+// ===================
+//  PRIVATE SLOTS
+// ===================
+void NotificationServer::sendBatch(){
+  if(changed.isEmpty() && removed.isEmpty()){ return; }
+  QList<uint> chg = changed.toList();
+  QList<uint> rem = removed.toList();
+  changed.clear();
+  removed.clear();
+  emit NotificationsChanged(chg, rem);
+}
+
+void NotificationServer::showPopup(){
+  LNotification *note = entry(popupID);
+  int merged = popupMerged;
+  popupID = 0;
+  popupMerged = 0;
+  if(note==0 || note->closed){ return; }
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  lastPopup = now;
+  popup->showMessage(note->id, icon(*note), note->summary, note->body, merged, note->timeout);
+  statPopups++;
+  qint64 latency = now - note->received;
+  statLatencyTotal += latency;
+  if(latency>statLatencyMax){ statLatencyMax = latency; }
+}
+
+void NotificationServer::checkExpired(){
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  while(!expiries.isEmpty() && expiries.firstKey()<=now){
+    QMultiMap<qint64, uint>::iterator it = expiries.begin();
+    qint64 when = it.key();
+    uint id = it.value();
+    expiries.erase(it);
+    LNotification *note = entry(id);
+    if(note!=0 && !note->closed && note->expires==when){ closeEntry(id, 1); } //otherwise updated/closed since then
+  }
+  if(!expiries.isEmpty()){ expireTimer->start( qMax(expiries.firstKey()-now, (qint64) 0) ); }
+}
+
+void NotificationServer::iconsFinished(){
+  QList<LNotificationIcon> jobs = iconWatcher->result();
+  for(int i=0; i<jobs.length(); i++){
+    statIcons++;
+    if(!jobs[i].path.isEmpty()){
+      if(iconCache.size()>=ICON_CACHE){ iconCache.clear(); }
+      iconCache.insert(jobs[i].path, jobs[i].img);
+    }
+    LNotification *note = entry(jobs[i].id);
+    if(note==0 || note->serial!=jobs[i].serial){ continue; } //message was updated/removed in the meantime
+    note->icon = jobs[i].img;
+    queueChange(note->id);
+    popup->updateIcon(note->id, icon(*note));
+  }
+  startIcons();
+}
+
+void NotificationServer::popupClicked(uint id){
+  LNotification *note = entry(id);
+  if(note==0){ return; }
+  for(int i=0; i<note->actions.length(); i+=2){
+    if(note->actions[i]=="default"){ emit ActionInvoked(id, "default"); break; }
+  }
+  if(!note->closed){ closeEntry(id, 2); }
+}
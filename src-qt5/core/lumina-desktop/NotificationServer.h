@@ -0,0 +1,138 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Session-resident org.freedesktop.Notifications service (Desktop Notifications Specification 1.2)
+//   - Notify() only records the message: the history is a fixed-size ring buffer (oldest entries get dropped)
+//   - Replacements (replaces_id) and identical messages (same app/summary/body) update the existing entry
+//   - UI updates are batched: NotificationsChanged() gets emitted at most once per batch interval
+//   - Popups are rate-limited: a single popup shows the newest message (and how many were merged into it)
+//   - Icon images (image-data/image-path hints and icon files) are decoded/scaled on a worker thread
+//   - Load test: dev-tools/notification-timing (floods a server on a private session bus)
+//===========================================
+#ifndef _LUMINA_DESKTOP_NOTIFICATION_SERVER_H
+#define _LUMINA_DESKTOP_NOTIFICATION_SERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+#include <QHash>
+#include <QMultiMap>
+#include <QSet>
+#include <QList>
+#include <QImage>
+#include <QIcon>
+#include <QDateTime>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QDBusConnection>
+
+#include "NotificationPopup.h"
+
+struct LNotification{
+	uint id; //0: empty/invalid
+	QString app, appIcon, summary, body;
+	QStringList actions; //pairs of [key, label]
+	int urgency; //0: low, 1: normal, 2: critical
+	int timeout; //milliseconds (0: never expires)
+	QDateTime time; //last update
+	int count; //number of identical messages merged into this one
+	QImage icon; //decoded icon image (null: use the appIcon theme icon)
+	bool closed; //expired or closed (still kept in the history)
+	qint64 received; //latest update (msecs since epoch)
+	qint64 expires; //0: never
+	quint32 serial; //incremented on every update (stale icon decodes get dropped)
+};
+
+//Icon decode job (worker thread)
+struct LNotificationIcon{
+	uint id;
+	quint32 serial;
+	QString path; //image file (empty: raw image-data below)
+	int width, height, rowstride, bits, channels;
+	bool alpha;
+	QByteArray data;
+	QImage img; //result
+};
+
+class NotificationServer : public QObject{
+	Q_OBJECT
+	Q_CLASSINFO("D-Bus Interface", "org.freedesktop.Notifications")
+public:
+	NotificationServer(QObject *parent = 0);
+	~NotificationServer();
+
+	//Register the service/object on the bus (false if another notification server is already running)
+	bool start(QDBusConnection bus);
+
+	//History access (GUI side)
+	QList<uint> history(); //oldest first
+	LNotification notification(uint id); //id==0 if not in the history
+	QIcon icon(const LNotification &note); //decoded image or the theme icon
+	void dismiss(uint id); //removed by the user
+	void clearHistory();
+	QStringList stats();
+
+public slots:
+	//D-Bus interface
+	Q_SCRIPTABLE QStringList GetCapabilities();
+	Q_SCRIPTABLE uint Notify(QString app_name, uint replaces_id, QString app_icon, QString summary, QString body, QStringList actions, QVariantMap hints, int expire_timeout);
+	Q_SCRIPTABLE void CloseNotification(uint id);
+	Q_SCRIPTABLE QString GetServerInformation(QString &vendor, QString &version, QString &spec_version);
+
+private:
+	//History
+	QVector<LNotification> ring;
+	int head, used; //next ring slot, number of used slots
+	QHash<uint, int> index; //id -> ring slot
+	QHash<QString, uint> dupes; //app/summary/body -> id
+	uint lastID;
+	//Batched updates
+	QSet<uint> changed, removed;
+	QTimer *batchTimer;
+	//Expirations
+	QMultiMap<qint64, uint> expiries;
+	QTimer *expireTimer;
+	//Popups
+	NotificationPopup *popup;
+	QTimer *popupTimer;
+	uint popupID; //newest message waiting for a popup
+	int popupMerged; //messages which arrived since the last popup (not shown separately)
+	qint64 lastPopup;
+	//Icons
+	QHash<uint, LNotificationIcon> iconQueue;
+	QFutureWatcher<QList<LNotificationIcon> > *iconWatcher;
+	QHash<QString, QImage> iconCache; //decoded image files
+	//Statistics
+	quint64 statReceived, statReplaced, statMerged, statEvicted, statPopups, statPopupsMerged, statIcons;
+	qint64 statLatencyTotal, statLatencyMax;
+
+	static QString dupeKey(const LNotification &note);
+	LNotification* entry(uint id);
+	void removeEntry(uint id);
+	void queueIcon(LNotification *note, QVariantMap hints);
+	void startIcons();
+	void queueChange(uint id);
+	void queuePopup(uint id);
+	void closeEntry(uint id, uint reason);
+
+private slots:
+	void sendBatch();
+	void showPopup();
+	void checkExpired();
+	void iconsFinished();
+	void popupClicked(uint id);
+
+signals:
+	//D-Bus signals
+	Q_SCRIPTABLE void NotificationClosed(uint id, uint reason);
+	Q_SCRIPTABLE void ActionInvoked(uint id, QString action_key);
+	//Batched history changes (for the message center)
+	void NotificationsChanged(QList<uint> changed, QList<uint> removed);
+};
+
+#endif
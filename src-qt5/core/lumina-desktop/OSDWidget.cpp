@@ -0,0 +1,63 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "OSDWidget.h"
+
+#include <QApplication>
+#include <QDesktopWidget>
+#include <QCursor>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+#include <LuminaXDG.h>
+
+OSDWidget::OSDWidget(QWidget *parent) : QWidget(parent, Qt::Window | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::X11BypassWindowManagerHint){
+  this->setObjectName("OSDWidget");
+  this->setWindowTitle("");
+  this->setAttribute(Qt::WA_ShowWithoutActivating);
+  this->setFocusPolicy(Qt::NoFocus);
+  this->setStyleSheet("QWidget#OSDWidget{background: black; border-radius: 5px;} QLabel{color: white; font-weight: bold; font-size: 13pt; background: transparent;}");
+  iconL = new QLabel(this);
+    iconL->setFixedSize(32,32);
+  textL = new QLabel(this);
+    textL->setAlignment(Qt::AlignCenter);
+  levelBar = new QProgressBar(this);
+    levelBar->setRange(0,100);
+    levelBar->setTextVisible(false);
+    levelBar->setFixedHeight(8);
+  QHBoxLayout *hlay = new QHBoxLayout;
+    hlay->addWidget(iconL);
+    hlay->addWidget(textL, 1);
+  QVBoxLayout *vlay = new QVBoxLayout(this);
+    vlay->setContentsMargins(12,8,12,10);
+    vlay->addLayout(hlay);
+    vlay->addWidget(levelBar);
+  this->setMinimumWidth(240);
+  hideTimer = new QTimer(this);
+    hideTimer->setSingleShot(true);
+    hideTimer->setInterval(800); //same duration as the old lumina-open OSD
+    connect(hideTimer, SIGNAL(timeout()), this, SLOT(hide()) );
+}
+
+OSDWidget::~OSDWidget(){
+
+}
+
+void OSDWidget::showMessage(QString icon, QString text, int percent){
+  iconL->setPixmap( LXDG::findIcon(icon,"").pixmap(32,32) );
+  textL->setText(text);
+  levelBar->setVisible(percent>=0);
+  if(percent>=0){ levelBar->setValue(percent); }
+  if(!this->isVisible()){
+    //Center it on the screen with the mouse (only when first shown - do not jump around during updates)
+    this->adjustSize();
+    QPoint center = QApplication::desktop()->screenGeometry(QCursor::pos()).center();
+    this->move(center.x()-(this->width()/2), center.y()-(this->height()/2));
+    this->show();
+  }
+  this->raise();
+  hideTimer->start(); //restart the countdown
+}
@@ -0,0 +1,35 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  This is a small on-screen display for quick feedback (volume/brightness level and such)
+//  The same widget is re-used for every update - it just restarts the hide timer
+//===========================================
+#ifndef _LUMINA_DESKTOP_OSD_WIDGET_H
+#define _LUMINA_DESKTOP_OSD_WIDGET_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QProgressBar>
+#include <QTimer>
+#include <QString>
+
+class OSDWidget : public QWidget{
+	Q_OBJECT
+public:
+	OSDWidget(QWidget *parent = 0);
+	~OSDWidget();
+
+	//Show the OSD with a level indicator (percent < 0: no level bar)
+	void showMessage(QString icon, QString text, int percent = -1);
+
+private:
+	QLabel *iconL, *textL;
+	QProgressBar *levelBar;
+	QTimer *hideTimer;
+
+};
+
+#endif
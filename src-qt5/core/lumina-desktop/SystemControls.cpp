@@ -0,0 +1,270 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "SystemControls.h"
+
+#include <QX11Info>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <LuminaHardware.h>
+#include <LuminaOS.h>
+#include <LuminaUtils.h>
+
+#include <stdlib.h>
+
+//XF86 multimedia keysyms (from XF86keysym.h - not pulling in Xlib for these)
+#define LKEY_AUDIO_LOWER 0x1008FF11
+#define LKEY_AUDIO_MUTE 0x1008FF12
+#define LKEY_AUDIO_RAISE 0x1008FF13
+#define LKEY_BRIGHT_UP 0x1008FF02
+#define LKEY_BRIGHT_DOWN 0x1008FF03
+
+#define STEP 5 //percent change per key press
+
+// === Worker thread functions (external utilities) ===
+static QList<int> readLevels(bool audio, bool bright){
+  QList<int> out;
+  out << (audio ? LOS::audioVolume() : -1) << (bright ? LOS::ScreenBrightness() : -1);
+  return out;
+}
+
+static QList<int> applyLevels(int vol, int bright){
+  if(vol>=0){ LOS::setAudioVolume(vol); }
+  if(bright>=0){ LOS::setScreenBrightness(bright); }
+  QList<int> out;
+  out << vol << bright;
+  return out;
+}
+
+SystemControls::SystemControls(QObject *parent) : QObject(parent){
+  osd = new OSDWidget();
+  volDiff = brightDiff = muteVol = 0;
+  volDirty = brightDirty = false;
+  //Remote (PICO) sessions need to adjust the remote audio through pulseaudio (LOS handles that)
+  bool remote = !QString(getenv("PICO_CLIENT_LOGIN")).isEmpty();
+  nativeAudio = !remote && LHardware::hasNativeAudio();
+  nativeBright = LHardware::hasNativeBacklight();
+  curVol = nativeAudio ? LHardware::audioVolume() : -1;
+  curBright = nativeBright ? LHardware::backlight() : -1;
+  qDebug() << " - System Controls:" << "Native Audio:" << nativeAudio << "Native Backlight:" << nativeBright << LHardware::backlightInterface();
+  applyTimer = new QTimer(this);
+    applyTimer->setSingleShot(true);
+    applyTimer->setInterval(30); //merge any changes within this interval
+    connect(applyTimer, SIGNAL(timeout()), this, SLOT(applyChanges()) );
+  saveTimer = new QTimer(this);
+    saveTimer->setSingleShot(true);
+    saveTimer->setInterval(1000);
+    connect(saveTimer, SIGNAL(timeout()), this, SLOT(saveBrightness()) );
+  readWatcher = new QFutureWatcher<QList<int> >(this);
+    connect(readWatcher, SIGNAL(finished()), this, SLOT(readFinished()) );
+  applyWatcher = new QFutureWatcher<QList<int> >(this);
+    connect(applyWatcher, SIGNAL(finished()), this, SLOT(applyFinished()) );
+  if(!nativeAudio || !nativeBright){
+    //Load the current values with the external utilities (can take a while)
+    readWatcher->setFuture( QtConcurrent::run(readLevels, !nativeAudio, !nativeBright) );
+  }
+}
+
+SystemControls::~SystemControls(){
+  ungrabKeys();
+  if(saveTimer->isActive()){ saveBrightness(); }
+  readWatcher->waitForFinished();
+  applyWatcher->waitForFinished();
+  delete osd;
+}
+
+void SystemControls::grabKeys(){
+  xcb_connection_t *conn = QX11Info::connection();
+  const xcb_setup_t *setup = xcb_get_setup(conn);
+  xcb_keycode_t min = setup->min_keycode;
+  xcb_keycode_t max = setup->max_keycode;
+  xcb_get_keyboard_mapping_reply_t *reply = xcb_get_keyboard_mapping_reply(conn, xcb_get_keyboard_mapping(conn, min, max-min+1), NULL);
+  if(reply==0){ return; }
+  //Find the keycodes for the multimedia keys
+  QHash<xcb_keysym_t, KeyAction> syms;
+    syms.insert(LKEY_AUDIO_RAISE, VolumeUp);
+    syms.insert(LKEY_AUDIO_LOWER, VolumeDown);
+    syms.insert(LKEY_AUDIO_MUTE, VolumeMute);
+    syms.insert(LKEY_BRIGHT_UP, BrightnessUp);
+    syms.insert(LKEY_BRIGHT_DOWN, BrightnessDown);
+  xcb_keysym_t *map = xcb_get_keyboard_mapping_keysyms(reply);
+  int per = reply->keysyms_per_keycode;
+  for(int kc=min; kc<=max; kc++){
+    for(int i=0; i<per; i++){
+      xcb_keysym_t sym = map[(kc-min)*per + i];
+      if(syms.contains(sym)){ keys.insert(kc, syms.value(sym)); break; }
+    }
+  }
+  free(reply);
+  //Now grab them (any modifier combination)
+  QList<xcb_keycode_t> codes = keys.keys();
+  for(int i=0; i<codes.length(); i++){
+    xcb_generic_error_t *err = xcb_request_check(conn, xcb_grab_key_checked(conn, 1, QX11Info::appRootWindow(), XCB_MOD_MASK_ANY, codes[i], XCB_GRAB_MODE_ASYNC, XCB_GRAB_MODE_ASYNC) );
+    if(err!=0){
+      //Some other client already has this key - leave it alone
+      qDebug() << " - Could not grab multimedia key:" << codes[i];
+      keys.remove(codes[i]);
+      free(err);
+    }
+  }
+}
+
+void SystemControls::ungrabKeys(){
+  if(keys.isEmpty()){ return; }
+  xcb_connection_t *conn = QX11Info::connection();
+  QList<xcb_keycode_t> codes = keys.keys();
+  for(int i=0; i<codes.length(); i++){
+    xcb_ungrab_key(conn, codes[i], QX11Info::appRootWindow(), XCB_MOD_MASK_ANY);
+  }
+  xcb_flush(conn);
+  keys.clear();
+}
+
+bool SystemControls::handleKeyPress(xcb_keycode_t keycode){
+  if(!keys.contains(keycode)){ return false; }
+  switch(keys.value(keycode)){
+    case VolumeUp:
+	changeVolume(STEP); break;
+    case VolumeDown:
+	changeVolume(-STEP); break;
+    case VolumeMute:
+	toggleMute(); break;
+    case BrightnessUp:
+	changeBrightness(STEP); break;
+    case BrightnessDown:
+	changeBrightness(-STEP); break;
+  }
+  return true;
+}
+
+// ===================
+//  PRIVATE
+// ===================
+void SystemControls::scheduleApply(){
+  //Leading-edge: apply right away unless something was just applied (or is still running)
+  if(applyTimer->isActive() || applyWatcher->isRunning()){ return; } //picked up later
+  applyChanges();
+}
+
+bool SystemControls::changing(){
+  return (volDirty || brightDirty || applyTimer->isActive() || applyWatcher->isRunning());
+}
+
+bool SystemControls::reloadLevels(bool audio, bool bright){
+  //Start of a new change: a mixer/xbacklight/etc might have changed the value since the last one
+  if(readWatcher->isRunning()){ return true; }
+  if(changing()){ return false; } //still in the middle of a change - the value here is the current one
+  if(audio && nativeAudio){
+    int vol = LHardware::audioVolume();
+    if(vol>=0 && vol!=curVol){ curVol = vol; muteVol = 0; }
+    audio = false;
+  }
+  if(bright && nativeBright){
+    int val = LHardware::backlight();
+    if(val>0){ curBright = val; }
+    bright = false;
+  }
+  if(!audio && !bright){ return false; }
+  //External utilities (can take a while)
+  readWatcher->setFuture( QtConcurrent::run(readLevels, audio, bright) );
+  return true;
+}
+
+void SystemControls::showVolume(){
+  QString icon = "audio-volume-high";
+  if(curVol<=0){ icon = "audio-volume-muted"; }
+  else if(curVol<33){ icon = "audio-volume-low"; }
+  else if(curVol<66){ icon = "audio-volume-medium"; }
+  osd->showMessage(icon, tr("Audio Volume %1%").arg(QString::number(curVol)), curVol);
+}
+
+void SystemControls::showBrightness(){
+  osd->showMessage("video-display", tr("Screen Brightness %1%").arg(QString::number(curBright)), curBright);
+}
+
+// ===================
+//  PUBLIC SLOTS
+// ===================
+void SystemControls::changeVolume(int diff){
+  if(reloadLevels(true, false) || curVol<0){ volDiff += diff; return; } //still loading the current value
+  setVolume(curVol+diff);
+}
+
+void SystemControls::changeBrightness(int diff){
+  if(reloadLevels(false, true) || curBright<0){ brightDiff += diff; return; } //still loading (or not available)
+  setBrightness(curBright+diff);
+}
+
+void SystemControls::setVolume(int percent){
+  if(percent<0){ percent = 0; }
+  else if(percent>100){ percent = 100; }
+  curVol = percent;
+  muteVol = 0;
+  volDirty = true;
+  showVolume();
+  scheduleApply();
+}
+
+void SystemControls::setBrightness(int percent){
+  if(percent<1){ percent = 1; } //never turn the screen completely off
+  else if(percent>100){ percent = 100; }
+  curBright = percent;
+  brightDirty = true;
+  showBrightness();
+  scheduleApply();
+}
+
+void SystemControls::toggleMute(){
+  if(reloadLevels(true, false) || curVol<0){ return; }
+  if(muteVol>0){ int vol = muteVol; setVolume(vol); }
+  else if(curVol>0){ int vol = curVol; setVolume(0); muteVol = vol; }
+}
+
+// ===================
+//  PRIVATE SLOTS
+// ===================
+void SystemControls::applyChanges(){
+  if(applyWatcher->isRunning()){ return; } //will get re-run when the worker finishes
+  int vol = -1, bright = -1; //values for the external utilities
+  bool changed = (volDirty || brightDirty);
+  if(volDirty){
+    volDirty = false;
+    if(!nativeAudio || !LHardware::setAudioVolume(curVol) ){ nativeAudio = false; vol = curVol; }
+  }
+  if(brightDirty){
+    brightDirty = false;
+    if(!nativeBright || !LHardware::setBacklight(curBright) ){ nativeBright = false; bright = curBright; }
+    else{ saveTimer->start(); }
+  }
+  if(vol>=0 || bright>=0){
+    applyWatcher->setFuture( QtConcurrent::run(applyLevels, vol, bright) );
+  }else if(changed){
+    applyTimer->start(); //merge anything else which comes in for a moment
+  }
+}
+
+void SystemControls::readFinished(){
+  QList<int> vals = readWatcher->result();
+  if(vals.length()>0 && vals[0]>=0 && vals[0]!=curVol){ curVol = vals[0]; muteVol = 0; }
+  if(vals.length()>1 && vals[1]>0){ curBright = vals[1]; }
+  //Now apply any changes which were requested while loading (this is the fresh value - do not re-read it)
+  int diff = volDiff;
+  volDiff = 0;
+  if(diff!=0 && curVol>=0){ setVolume(curVol+diff); }
+  diff = brightDiff;
+  brightDiff = 0;
+  if(diff!=0 && curBright>=0){ setBrightness(curBright+diff); }
+}
+
+void SystemControls::applyFinished(){
+  if(volDirty || brightDirty){ applyChanges(); } //more changes came in while the utilities were running
+}
+
+void SystemControls::saveBrightness(){
+  //Keep the saved value in sync with the LOS functions (used to restore the brightness at login)
+  LUtils::writeFile(QString(getenv("XDG_CONFIG_HOME"))+"/lumina-desktop/.currentxbrightness", QStringList() << QString::number(curBright), true);
+}
@@ -0,0 +1,75 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Session-resident audio volume/screen brightness controls
+//   - Uses the native (in-process) interfaces in LHardware when available
+//   - Falls back on the LOS functions (external utilities) on a worker thread otherwise
+//   - Rapid changes (held-down keys) are coalesced: the first change is applied immediately,
+//       and anything which comes in during the next interval is merged into a single update
+//   - The current values are re-read at the start of every change (other programs can change them too)
+//===========================================
+#ifndef _LUMINA_DESKTOP_SYSTEM_CONTROLS_H
+#define _LUMINA_DESKTOP_SYSTEM_CONTROLS_H
+
+#include <QObject>
+#include <QTimer>
+#include <QHash>
+#include <QList>
+#include <QFutureWatcher>
+
+#include <xcb/xcb.h>
+
+#include "OSDWidget.h"
+
+class SystemControls : public QObject{
+	Q_OBJECT
+public:
+	enum KeyAction{ VolumeUp, VolumeDown, VolumeMute, BrightnessUp, BrightnessDown };
+
+	SystemControls(QObject *parent = 0);
+	~SystemControls();
+
+	//Grab the multimedia keys on the root window (keys already grabbed by another client are skipped)
+	void grabKeys();
+	void ungrabKeys();
+	//Returns true if the key was one of the grabbed keys (and the action was performed)
+	bool handleKeyPress(xcb_keycode_t keycode);
+
+	int volume(){ return curVol; } //-1 if unknown
+	int brightness(){ return curBright; } //-1 if unknown/unavailable
+
+private:
+	OSDWidget *osd;
+	QTimer *applyTimer, *saveTimer;
+	QFutureWatcher<QList<int> > *readWatcher, *applyWatcher;
+	QHash<xcb_keycode_t, KeyAction> keys;
+	bool nativeAudio, nativeBright;
+	int curVol, curBright, muteVol;
+	int volDiff, brightDiff; //changes requested before the current value was known
+	bool volDirty, brightDirty;
+
+	void scheduleApply();
+	bool changing(); //changes still getting merged/applied
+	bool reloadLevels(bool audio, bool bright); //returns true if the values are getting loaded on the worker thread
+	void showVolume();
+	void showBrightness();
+
+public slots:
+	void changeVolume(int diff);
+	void changeBrightness(int diff);
+	void setVolume(int percent);
+	void setBrightness(int percent);
+	void toggleMute();
+
+private slots:
+	void applyChanges();
+	void readFinished();
+	void applyFinished();
+	void saveBrightness();
+
+};
+
+#endif
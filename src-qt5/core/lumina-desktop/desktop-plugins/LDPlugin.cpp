@@ -13,7 +13,7 @@ LDPlugin::LDPlugin(QWidget *parent, QString id) : QFrame(parent){
   PLUGID=id;
   prefix = id.replace("/","_")+"/";
   //qDebug() << "ID:" << PLUGID << prefix;
-  settings = LSession::handle()->DesktopPluginSettings();
+  settings = LSession::handle()->DesktopPluginStore();
   //Setup the plugin system control menu
   menu = new QMenu(this);
   setupMenu();
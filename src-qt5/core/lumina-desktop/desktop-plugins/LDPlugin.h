@@ -27,12 +27,14 @@
 #include <QTimer>
 #include <QMenu>
 
+#include "../LPluginSettings.h"
+
 class LDPlugin : public QFrame{
 	Q_OBJECT
 	
 private:
 	QString PLUGID, prefix;
-	QSettings *settings;
+	LPluginSettings *settings; //shared (write-behind) settings store
 	QMenu *menu;
 	QTimer *dragTimer;
 
@@ -54,8 +56,7 @@ public:
 	}
 	
 	void savePluginGeometry(QRect geom){
-	  settings->setValue(prefix+"geometry/desktopGridPoints", geom);
-	  settings->sync();
+	  settings->setValue(prefix+"geometry/desktopGridPoints", geom); //saved to disk automatically
 	}
 	
 	QRect loadPluginGeometry(){
@@ -64,8 +65,7 @@ public:
 	
 	void saveSetting(QString var, QVariant val){
 	  //qDebug() << "Saving Setting:" << prefix+var+QString(" = ")+val.toString();
-	  settings->setValue(prefix+var, val);
-	  settings->sync();
+	  settings->setValue(prefix+var, val); //saved to disk automatically
 	}
 	
 	QVariant readSetting(QString var, QVariant defaultval){
@@ -81,9 +81,7 @@ public:
 	
 	void removeSettings(bool permanent = false){ //such as when a plugin is deleted
 	  if(permanent){ Cleanup(); }
-	  QStringList list = settings->allKeys().filter(prefix);
-	   for(int i=0; i<list.length(); i++){ settings->remove(list[i]); }
-	
+	  settings->removeGroup(prefix);
 	}
 	
 public slots:
@@ -21,7 +21,7 @@
 #include "audioplayer/PlayerWidget.h"
 #include "systemmonitor/MonitorWidget.h"
 //#include "quickcontainer/QuickDPlugin.h"
-//#include "messagecenter/MessageCenter.h"
+#include "messagecenter/MessageCenter.h"
 #include "rssreader/RSSFeedPlugin.h"
 
 class NewDP{
@@ -45,8 +45,8 @@ public:
 	    plug = new AudioPlayerPlugin(parent, plugin);
 	  }else if(plugin.section("---",0,0)=="systemmonitor"){
 	    plug = new SysMonitorPlugin(parent, plugin);
-	  //}else if(plugin.section("---",0,0)=="messagecenter"){
-	    //plug = new MessageCenterPlugin(parent, plugin);
+	  }else if(plugin.section("---",0,0)=="messagecenter"){
+	    plug = new MessageCenterPlugin(parent, plugin);
 	  //}else if(plugin.section("---",0,0).startsWith("quick-") && LUtils::validQuickPlugin(plugin.section("---",0,0)) ){
 	    //plug = new QuickDPlugin(parent, plugin);
 	  }else if(plugin.section("---",0,0)=="rssreader"){
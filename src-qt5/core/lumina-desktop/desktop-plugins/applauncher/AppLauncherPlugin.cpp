@@ -18,6 +18,9 @@ AppLauncherPlugin::AppLauncherPlugin(QWidget* parent, QString ID) : LDPlugin(par
   button->setContextMenuPolicy(Qt::NoContextMenu);
   watcher = new QFileSystemWatcher(this);
 	connect(watcher, SIGNAL(fileChanged(QString)), this, SLOT( loadButton()) );
+  //Desktop folder items: also pick up new thumbnails/replaced files (in-place edits come through the file watcher)
+  connect(LSession::handle()->desktopFolder(), SIGNAL(ItemsModified(QStringList)), this, SLOT(desktopItemsModified(QStringList)) );
+  connect(LSession::handle()->desktopFolder(), SIGNAL(ThumbnailReady(QString)), this, SLOT(thumbnailReady(QString)) );
 
   connect(this, SIGNAL(PluginActivated()), this, SLOT(buttonClicked()) ); //in case they use the context menu to launch it.
   QTimer::singleShot(200,this, SLOT(loadButton()) );
@@ -37,52 +40,46 @@ void AppLauncherPlugin::loadButton(){
   int icosize = this->height()-4 - 2.2*button->fontMetrics().height();
   button->setFixedSize( this->width()-4, this->height()-4);
   button->setIconSize( QSize(icosize,icosize) );
+  //Icons come from the shared atlas (rasterized once for all the launchers using the same icon/size)
+  LIconAtlas *atlas = LSession::handle()->iconAtlas();
+  QString emblem = QFileInfo(path).isSymLink() ? "emblem-symbolic-link" : ""; //sym-link overlay on the icon
   QString txt;
   if(path.endsWith(".desktop") && ok){
     XDGDesktop file(path);
     ok = !file.name.isEmpty();
     if(!ok){
       button->setWhatsThis("");
-      button->setIcon( QIcon(LXDG::findIcon("quickopen-file","").pixmap(QSize(icosize,icosize)).scaledToHeight(icosize, Qt::SmoothTransformation) ) );
+      button->setIcon( atlas->icon("quickopen-file", "", icosize, emblem) );
       txt = tr("Click to Set");
-      if(!watcher->files().isEmpty()){ watcher->removePaths(watcher->files()); }
+      watchFile("");
     }else{
       button->setWhatsThis(file.filePath);
-      button->setIcon( QIcon(LXDG::findIcon(file.icon,"system-run").pixmap(QSize(icosize,icosize)).scaledToHeight(icosize, Qt::SmoothTransformation) ) );
+      button->setIcon( atlas->icon(file.icon, "system-run", icosize, emblem) );
       txt = file.name;
-      if(!watcher->files().isEmpty()){ watcher->removePaths(watcher->files()); }
-      watcher->addPath(file.filePath); //make sure to update this shortcut if the file changes
+      watchFile(file.filePath); //make sure to update this shortcut if the file changes
     }
   }else if(ok){
     QFileInfo info(path);
     button->setWhatsThis(info.absoluteFilePath());
     if(info.isDir()){
-	button->setIcon( LXDG::findIcon("folder","") );
+	button->setIcon( atlas->icon("folder", "", icosize, emblem) );
     }else if(LUtils::imageExtensions().contains(info.suffix().toLower()) ){
-      QPixmap pix;
-      if(pix.load(path)){ button->setIcon( QIcon(pix.scaled(256,256)) ); } //max size for thumbnails in memory	  
-      else{ button->setIcon( LXDG::findIcon("dialog-cancel","") ); }
+      //Shared thumbnail (use the mime icon until it is loaded)
+      QImage img = LSession::handle()->desktopFolder()->thumbnail(path);
+      if(img.isNull()){ button->setIcon( atlas->mimeIcon(path, icosize, emblem) ); }
+      else if(emblem.isEmpty()){ button->setIcon( QIcon(QPixmap::fromImage(img)) ); }
+      else{ button->setIcon( atlas->withEmblem(QIcon(QPixmap::fromImage(img)).pixmap(QSize(icosize,icosize)), icosize, emblem) ); }
     }else{
-      button->setIcon( QIcon(LXDG::findMimeIcon(path).pixmap(QSize(icosize,icosize)).scaledToHeight(icosize, Qt::SmoothTransformation) ) );
+      button->setIcon( atlas->mimeIcon(path, icosize, emblem) );
     }
     txt = info.fileName();
-    if(!watcher->files().isEmpty()){ watcher->removePaths(watcher->files()); }
-    watcher->addPath(path); //make sure to update this shortcut if the file changes
+    watchFile(path); //make sure to update this shortcut if the file changes
   }else{
     //InValid File
     button->setWhatsThis("");
-    button->setIcon( QIcon(LXDG::findIcon("quickopen","dialog-cancel").pixmap(QSize(icosize,icosize)).scaledToHeight(icosize, Qt::SmoothTransformation) ) );
+    button->setIcon( atlas->icon("quickopen", "dialog-cancel", icosize) );
     button->setText( tr("Click to Set") );
-    if(!watcher->files().isEmpty()){ watcher->removePaths(watcher->files()); }
-  }
-  //If the file is a symlink, put the overlay on the icon
-  if(QFileInfo(path).isSymLink()){
-    QImage img = button->icon().pixmap(QSize(icosize,icosize)).toImage();
-    int oSize = icosize/3; //overlay size
-    QPixmap overlay = LXDG::findIcon("emblem-symbolic-link").pixmap(oSize,oSize).scaled(oSize,oSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    QPainter painter(&img);
-      painter.drawPixmap(icosize-oSize,icosize-oSize,overlay); //put it in the bottom-right corner
-    button->setIcon( QIcon(QPixmap::fromImage(img)) );
+    watchFile("");
   }
   //Now adjust the visible text as necessary based on font/grid sizing
   button->setToolTip(txt);
@@ -125,6 +122,20 @@ void AppLauncherPlugin::loadButton(){
   QTimer::singleShot(100, this, SLOT(update()) ); //Make sure to re-draw the image in a moment
 }
 	
+void AppLauncherPlugin::watchFile(QString path){
+  if(watcher->files().length()==1 && watcher->files().first()==path){ return; } //already watched
+  if(!watcher->files().isEmpty()){ watcher->removePaths(watcher->files()); }
+  if(!path.isEmpty()){ watcher->addPath(path); }
+}
+
+void AppLauncherPlugin::desktopItemsModified(QStringList paths){
+  if(paths.contains(button->whatsThis())){ loadButton(); }
+}
+
+void AppLauncherPlugin::thumbnailReady(QString path){
+  if(path==button->whatsThis()){ loadButton(); }
+}
+
 void AppLauncherPlugin::buttonClicked(){
   QString path = button->whatsThis();
   if(path.isEmpty() || !QFile::exists(path) ){
@@ -33,12 +33,16 @@ public:
 		
 private:
 	QToolButton *button;
-	QFileSystemWatcher *watcher;
+	QFileSystemWatcher *watcher; //only used for files outside of the desktop folder
 	//QMenu *menu;
 
+	void watchFile(QString path); //empty path: stop watching
+
 private slots:
 	void loadButton();
 	void buttonClicked();
+	void desktopItemsModified(QStringList);
+	void thumbnailReady(QString);
 	//void openContextMenu();
 	
 	//void increaseIconSize();
@@ -4,8 +4,8 @@ SOURCES += $$PWD/applauncher/AppLauncherPlugin.cpp \
 	$$PWD/audioplayer/PlayerWidget.cpp \
 	$$PWD/systemmonitor/MonitorWidget.cpp \
 	$$PWD/rssreader/RSSFeedPlugin.cpp \
-	$$PWD/rssreader/RSSObjects.cpp
-#	$$PWD/messagecenter/MessageCenter.cpp
+	$$PWD/rssreader/RSSObjects.cpp \
+	$$PWD/messagecenter/MessageCenter.cpp
 
 HEADERS += $$PWD/calendar/CalendarPlugin.h \
 	$$PWD/applauncher/AppLauncherPlugin.h \
@@ -15,9 +15,9 @@ HEADERS += $$PWD/calendar/CalendarPlugin.h \
 	$$PWD/audioplayer/PlayerWidget.h \
 	$$PWD/systemmonitor/MonitorWidget.h \
 	$$PWD/rssreader/RSSFeedPlugin.h \
-	$$PWD/rssreader/RSSObjects.h
+	$$PWD/rssreader/RSSObjects.h \
+	$$PWD/messagecenter/MessageCenter.h
 #	$$PWD/quickcontainer/QuickDPlugin.h
-#	$$PWD/messagecenter/MessageCenter.h
 
 FORMS += $$PWD/audioplayer/PlayerWidget.ui \
 	$$PWD/systemmonitor/MonitorWidget.ui \
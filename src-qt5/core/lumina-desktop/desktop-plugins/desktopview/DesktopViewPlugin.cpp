@@ -40,7 +40,13 @@ DesktopViewPlugin::DesktopViewPlugin(QWidget* parent, QString ID) : LDPlugin(par
     }
   this->layout()->addWidget(list);
     
-  connect(QApplication::instance(), SIGNAL(DesktopFilesChanged()), this, SLOT(updateContents()) );
+  icosize = 64;
+  loaded = false;
+  LDesktopFolder *folder = LSession::handle()->desktopFolder();
+  connect(folder, SIGNAL(ItemsAdded(QStringList)), this, SLOT(itemsAdded(QStringList)) );
+  connect(folder, SIGNAL(ItemsRemoved(QStringList)), this, SLOT(itemsRemoved(QStringList)) );
+  connect(folder, SIGNAL(ItemsModified(QStringList)), this, SLOT(itemsModified(QStringList)) );
+  connect(folder, SIGNAL(ThumbnailReady(QString)), this, SLOT(thumbnailReady(QString)) );
   connect(list, SIGNAL(itemActivated(QListWidgetItem*)), this, SLOT(runItems()) );
   connect(list, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(showMenu(const QPoint&)) );
   QTimer::singleShot(1000,this, SLOT(updateContents()) ); //wait a second before loading contents
@@ -130,53 +136,68 @@ void DesktopViewPlugin::decreaseIconSize(){
 
 void DesktopViewPlugin::updateContents(){
   list->clear();
-
-  int icosize = this->readSetting("IconSize",64).toInt();
-  QSize gridSZ = QSize(qRound(1.8*icosize),icosize+4+(2*this->fontMetrics().height()) );
+  items.clear();
+  loaded = true;
+  icosize = this->readSetting("IconSize",64).toInt();
+  gridSZ = QSize(qRound(1.8*icosize),icosize+4+(2*this->fontMetrics().height()) );
   //qDebug() << "Icon Size:" << icosize <<"Grid Size:" << gridSZ.width() << gridSZ.height();
   list->setGridSize(gridSZ);
   list->setIconSize(QSize(icosize,icosize));
-  QDir dir(QDir::homePath()+"/Desktop");
-  QFileInfoList files = dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name | QDir::Type | QDir::DirsFirst);
+  QFileInfoList files = LSession::handle()->desktopFolder()->files();
   for(int i=0; i<files.length(); i++){
+    if(items.contains(files[i].absoluteFilePath())){ continue; } //already added while processing events
     QListWidgetItem *it = new QListWidgetItem;
-    it->setSizeHint(gridSZ); //ensure uniform item sizes
-    //it->setForeground(QBrush(Qt::black, Qt::Dense2Pattern)); //Try to use a font color which will always be visible
-    it->setTextAlignment(Qt::AlignCenter);
     it->setWhatsThis(files[i].absoluteFilePath());
-    QString txt;
-    if(files[i].isDir()){
-	it->setIcon( LXDG::findIcon("folder","") );
-	txt = files[i].fileName();
-    }else if(files[i].suffix() == "desktop" ){
-	XDGDesktop desk(files[i].absoluteFilePath());
+    it->setData(Qt::UserRole, LDesktopFolder::sortKey(it->whatsThis(), files[i].isDir()) );
+    updateItem(it);
+    list->addItem(it);
+    items.insert(it->whatsThis(), it);
+    if( (i%10) == 0){ QApplication::processEvents(); }//keep the UI snappy, every 10 items
+  }
+  list->setFlow(QListWidget::TopToBottom); //To ensure this is consistent - issues with putting it in the constructor
+  list->update(); //Re-paint the widget after all items are added 
+}
+
+void DesktopViewPlugin::updateItem(QListWidgetItem *it){
+  QFileInfo info(it->whatsThis());
+  it->setSizeHint(gridSZ); //ensure uniform item sizes
+  //it->setForeground(QBrush(Qt::black, Qt::Dense2Pattern)); //Try to use a font color which will always be visible
+  it->setTextAlignment(Qt::AlignCenter);
+  //Icons come from the shared atlas (rasterized once for all the items using the same icon/size)
+  LIconAtlas *atlas = LSession::handle()->iconAtlas();
+  QString emblem = info.isSymLink() ? "emblem-symbolic-link" : ""; //sym-link overlay on the icon
+  int esize = icosize/2; //overlay size
+  QString txt;
+    if(info.isDir()){
+	it->setIcon( atlas->icon("folder", "", icosize, emblem, esize) );
+	txt = info.fileName();
+    }else if(info.suffix() == "desktop" ){
+	XDGDesktop desk(info.absoluteFilePath());
 	if(desk.isValid()){
-	  it->setIcon( LXDG::findIcon(desk.icon,"unknown") );
+	  it->setIcon( atlas->icon(desk.icon, "unknown", icosize, emblem, esize) );
 	  if(desk.name.isEmpty()){
-	    txt = files[i].fileName();
+	    txt = info.fileName();
 	  }else{
             txt = desk.name;
 	  }
 	}else{
 	  //Revert back to a standard file handling
-          it->setIcon( LXDG::findMimeIcon(files[i].fileName()) );
-          txt = files[i].fileName();		
+          it->setIcon( atlas->mimeIcon(info.fileName(), icosize, emblem, esize) );
+          txt = info.fileName();		
 	}
-    }else if(LUtils::imageExtensions().contains(files[i].suffix().toLower()) ){
-      it->setIcon( QIcon( QPixmap(files[i].absoluteFilePath()).scaled(icosize,icosize,Qt::IgnoreAspectRatio, Qt::SmoothTransformation) ) );
-      txt = files[i].fileName();	    
+    }else if(LUtils::imageExtensions().contains(info.suffix().toLower()) ){
+      //Shared thumbnail (use the mime icon until it is loaded)
+      QImage img = LSession::handle()->desktopFolder()->thumbnail(info.absoluteFilePath());
+      if(img.isNull()){ it->setIcon( atlas->mimeIcon(info.fileName(), icosize, emblem, esize) ); }
+      else{
+        QPixmap pix = QPixmap::fromImage(img.scaled(icosize,icosize,Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        if(emblem.isEmpty()){ it->setIcon( QIcon(pix) ); }
+        else{ it->setIcon( atlas->withEmblem(pix, icosize, emblem, esize) ); }
+      }
+      txt = info.fileName();	    
     }else{
-      it->setIcon( LXDG::findMimeIcon( files[i].fileName() ) );
-      txt = files[i].fileName();
-    }
-    //Add the sym-link overlay to the icon as necessary
-    if(files[i].isSymLink()){
-      QImage img = it->icon().pixmap(QSize(icosize,icosize)).toImage();
-      int oSize = icosize/2; //overlay size
-      QPixmap overlay = LXDG::findIcon("emblem-symbolic-link").pixmap(oSize,oSize).scaled(oSize,oSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-      QPainter painter(&img);
-        painter.drawPixmap(icosize-oSize,icosize-oSize,overlay); //put it in the bottom-right corner
-      it->setIcon( QIcon(QPixmap::fromImage(img)) );
+      it->setIcon( atlas->mimeIcon(info.fileName(), icosize, emblem, esize) );
+      txt = info.fileName();
     }
     //Now adjust the visible text as necessary based on font/grid sizing
     it->setToolTip(txt);
@@ -199,11 +220,55 @@ void DesktopViewPlugin::updateContents(){
       txt.append("\n "); //ensure two lines (2nd one invisible) - keeps formatting sane
     }
     it->setText(txt);
-    list->addItem(it);
-    if( (i%10) == 0){ QApplication::processEvents(); }//keep the UI snappy, every 10 items
+}
+
+void DesktopViewPlugin::insertItem(QString path){
+  QListWidgetItem *it = new QListWidgetItem;
+  it->setWhatsThis(path);
+  QString key = LDesktopFolder::sortKey(path, QFileInfo(path).isDir());
+  it->setData(Qt::UserRole, key);
+  updateItem(it);
+  //Binary search for the sorted position
+  int min = 0; int max = list->count();
+  while(min<max){
+    int mid = (min+max)/2;
+    if(list->item(mid)->data(Qt::UserRole).toString() < key){ min = mid+1; }
+    else{ max = mid; }
   }
-  list->setFlow(QListWidget::TopToBottom); //To ensure this is consistent - issues with putting it in the constructor
-  list->update(); //Re-paint the widget after all items are added 
+  list->insertItem(min, it);
+  items.insert(path, it);
+}
+
+void DesktopViewPlugin::itemsAdded(QStringList paths){
+  if(!loaded){ return; } //initial load not done yet
+  for(int i=0; i<paths.length(); i++){
+    if(items.contains(paths[i])){ updateItem(items[paths[i]]); }
+    else{ insertItem(paths[i]); }
+  }
+}
+
+void DesktopViewPlugin::itemsRemoved(QStringList paths){
+  for(int i=0; i<paths.length(); i++){
+    if(items.contains(paths[i])){ delete items.take(paths[i]); }
+  }
+}
+
+void DesktopViewPlugin::itemsModified(QStringList paths){
+  for(int i=0; i<paths.length(); i++){
+    QListWidgetItem *it = items.value(paths[i],0);
+    if(it==0){ continue; }
+    //A file could have been replaced by a directory (or the reverse) - re-sort in that case
+    if(it->data(Qt::UserRole).toString() != LDesktopFolder::sortKey(paths[i], QFileInfo(paths[i]).isDir()) ){
+      delete items.take(paths[i]);
+      insertItem(paths[i]);
+    }else{
+      updateItem(it);
+    }
+  }
+}
+
+void DesktopViewPlugin::thumbnailReady(QString path){
+  if(items.contains(path)){ updateItem(items[path]); }
 }
 
 void DesktopViewPlugin::displayProperties(){
@@ -14,6 +14,7 @@
 #include <QTimer>
 #include <QFileSystemWatcher>
 #include <QMouseEvent>
+#include <QHash>
 
 #include "../LDPlugin.h"
 
@@ -30,6 +31,13 @@ public:
 private:
 	QListWidget *list;
 	QMenu *menu;
+	QHash<QString, QListWidgetItem*> items; //file path -> item
+	QSize gridSZ;
+	int icosize;
+	bool loaded;
+
+	void updateItem(QListWidgetItem *it); //(re)load the icon/text for a single item
+	void insertItem(QString path); //keeps the list sorted
 
 private slots:
 	void runItems();
@@ -39,9 +47,15 @@ private slots:
 	void showMenu(const QPoint&);
 	void increaseIconSize();
 	void decreaseIconSize();
-	void updateContents();
+	void updateContents(); //full reload (icon size/theme/locale changes)
 	void displayProperties();
 
+	//Incremental updates from the desktop folder model
+	void itemsAdded(QStringList);
+	void itemsRemoved(QStringList);
+	void itemsModified(QStringList);
+	void thumbnailReady(QString);
+
 
 public slots:
 	void LocaleChange(){
@@ -3,8 +3,9 @@
 #include <LuminaXDG.h>
 #include  <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QDBusConnection>
-#include <QDBusConnectionInterface>
+#include <QTextDocument>
+
+#include "LSession.h"
 
 MessageCenterPlugin::MessageCenterPlugin(QWidget* parent, QString ID) : LDPlugin(parent, ID){
   //Setup the UI
@@ -43,23 +44,12 @@ MessageCenterPlugin::MessageCenterPlugin(QWidget* parent, QString ID) : LDPlugin
   connect(tool_clearall, SIGNAL(clicked()), this, SLOT(clearAllMessages()) );
   connect(tool_clearone, SIGNAL(clicked()), this, SLOT(clearSelectedMessage()) );
   
-  //Setup the DBUS signals/slots
-  if(QDBusConnection::sessionBus().isConnected()){
-    if( QDBusConnection::sessionBus().registerService("org.freedesktop.Notifications") ){
-      //Was able to register this service, also register everything it can do...
-      //SUPPORTED: "body", "body-hyperlinks", "body-markup", "icon-static"
-      
-	    
-    }
-    QDBusConnection::sessionBus().connect("", "", "org.freedesktop.Notifications", "Notify", this, SLOT(newMessage(QString, uint, QString, QString, QString, QStringList, dict, int)) );
-    QDBusConnection::sessionBus().interface().call("AddMatch", "interface='org.freedesktop.Notifications',member='Notify',type='method_call',eavesdrop='true'");
-    qDebug() << "Available Session DBUS Services:" << QDBusConnection::sessionBus().interface()->registeredServiceNames().value();
-    //connect(QString(), QString(), 
+  //Setup the connection to the session notification server
+  NotificationServer *server = LSession::handle()->notificationServer();
+  if(server!=0){
+    connect(server, SIGNAL(NotificationsChanged(QList<uint>, QList<uint>)), this, SLOT(messagesChanged(QList<uint>, QList<uint>)) );
   }
-  if(QDBusConnection::systemBus().isConnected()){
-    qDebug() << "Available System DBUS Services:" << QDBusConnection::systemBus().interface()->registeredServiceNames().value();
-  }
-  
+  QTimer::singleShot(0,this, SLOT(loadMessages()) );
   QTimer::singleShot(0,this, SLOT(loadIcons()) );
 }
 
@@ -67,17 +57,70 @@ MessageCenterPlugin::~MessageCenterPlugin(){
 
 }
 
-void MessageCenterPlugin::newMessage(QString summary, QString body){
-  qDebug() << "New Message:" << summary, body;
+void MessageCenterPlugin::updateItem(QListWidgetItem *it, uint id){
+  LNotification note = LSession::handle()->notificationServer()->notification(id);
+  QString body = note.body;
+  if(Qt::mightBeRichText(body)){
+    QTextDocument doc; //strip any markup for the list
+    doc.setHtml(body);
+    body = doc.toPlainText();
+  }
+  QString txt = note.summary;
+  if(note.count>1){ txt.append( QString(" (%1)").arg(QString::number(note.count)) ); }
+  if(!body.isEmpty()){ txt.append("\n"+body.section("\n",0,2) ); } //only the first few lines
+  it->setText(txt);
+  it->setIcon( LSession::handle()->notificationServer()->icon(note) );
+  it->setToolTip( note.app+"\n"+note.time.toString(Qt::DefaultLocaleShortDate) );
+}
+
+void MessageCenterPlugin::loadMessages(){
+  list_messages->clear();
+  items.clear();
+  NotificationServer *server = LSession::handle()->notificationServer();
+  if(server==0){
+    list_messages->addItem( tr("Notification service not available") );
+    return;
+  }
+  QList<uint> ids = server->history(); //oldest first
+  for(int i=ids.length()-1; i>=0; i--){
+    QListWidgetItem *it = new QListWidgetItem();
+    it->setData(Qt::UserRole, ids[i]);
+    updateItem(it, ids[i]);
+    list_messages->addItem(it);
+    items.insert(ids[i], it);
+  }
+}
+
+void MessageCenterPlugin::messagesChanged(QList<uint> changed, QList<uint> removed){
+  for(int i=0; i<removed.length(); i++){
+    if(items.contains(removed[i])){ delete items.take(removed[i]); }
+  }
+  for(int i=0; i<changed.length(); i++){
+    QListWidgetItem *it = items.value(changed[i], 0);
+    if(it==0){
+      //New message (newest at the top)
+      it = new QListWidgetItem();
+      it->setData(Qt::UserRole, changed[i]);
+      list_messages->insertItem(0, it);
+      items.insert(changed[i], it);
+    }
+    updateItem(it, changed[i]);
+  }
 }
 
 void MessageCenterPlugin::clearAllMessages(){
- list_messages->clear();
+  if(LSession::handle()->notificationServer()!=0){ LSession::handle()->notificationServer()->clearHistory(); }
+  list_messages->clear();
+  items.clear();
 }
 
 void MessageCenterPlugin::clearSelectedMessage(){
-  if( list_messages->currentItem()==0){ return; } //nothing selected
-  list_messages->removeItemWidget( list_messages->currentItem() );
+  QListWidgetItem *it = list_messages->currentItem();
+  if(it==0 || LSession::handle()->notificationServer()==0){ return; } //nothing selected
+  uint id = it->data(Qt::UserRole).toUInt();
+  LSession::handle()->notificationServer()->dismiss(id);
+  items.remove(id);
+  delete it;
 }
 
 
@@ -4,7 +4,7 @@
 //  Available under the 3-clause BSD license
 //  See the LICENSE file for full details
 //===========================================
-//  This plugin is a simple DBUS monitor which display's messages that come in
+//  This plugin shows the desktop notifications history (kept by the session notification server)
 //===========================================
 #ifndef _LUMINA_DESKTOP_MESSAGE_CENTER_PLUGIN_H
 #define _LUMINA_DESKTOP_MESSAGE_CENTER_PLUGIN_H
@@ -12,6 +12,8 @@
 #include <QListWidget>
 #include <QToolButton>
 #include <QFrame>
+#include <QHash>
+#include <QList>
 
 #include <QTimer>
 #include "../LDPlugin.h"
@@ -23,14 +25,17 @@ public:
 	~MessageCenterPlugin();
 	
 private:
-	//QDBusConnection *sess, *sys;
 	QListWidget *list_messages;
 	QFrame *frame;
 	QToolButton *tool_clearall; //clear all messages
 	QToolButton *tool_clearone; //clear selected message
+	QHash<uint, QListWidgetItem*> items; //notification ID -> item
+
+	void updateItem(QListWidgetItem *it, uint id);
 
 private slots:
-	//void newMessage(QDBusMessage *message);
+	void loadMessages(); //full reload
+	void messagesChanged(QList<uint>, QList<uint>); //batched updates from the server
 	void clearAllMessages();
 	void clearSelectedMessage();
 
@@ -42,6 +47,7 @@ public slots:
 	}
 	void ThemeChange(){
 	  QTimer::singleShot(0,this, SLOT(loadIcons()));
+	  QTimer::singleShot(0,this, SLOT(loadMessages()));
 	}
 
 };
@@ -45,14 +45,14 @@ RSSFeedPlugin::RSSFeedPlugin(QWidget* parent, QString ID) : LDPlugin(parent, ID)
   QTimer::singleShot(0,this, SLOT(ThemeChange()) );
   //qDebug() << " - Done with init";
   QStringList feeds;
-  if( !LSession::handle()->DesktopPluginSettings()->contains(setprefix+"currentfeeds") ){
+  if( !LSession::handle()->DesktopPluginStore()->contains(setprefix+"currentfeeds") ){
     //First-time run of the plugin - automatically load the default feeds
     feeds = LOS::RSSFeeds();
     for(int i=0; i<feeds.length(); i++){ feeds[i] = feeds[i].section("::::",1,-1); } //just need url right now
     feeds << "http://lumina-desktop.org/?feed=rss2"; //Lumina Desktop blog feed
-    LSession::handle()->DesktopPluginSettings()->setValue(setprefix+"currentfeeds", feeds);
+    LSession::handle()->DesktopPluginStore()->setValue(setprefix+"currentfeeds", feeds);
   }else{
-    feeds = LSession::handle()->DesktopPluginSettings()->value(setprefix+"currentfeeds",QStringList()).toStringList();
+    feeds = LSession::handle()->DesktopPluginStore()->value(setprefix+"currentfeeds",QStringList()).toStringList();
   }
   RSS->addUrls(feeds);
   backToFeeds(); //always load the first page
@@ -100,7 +100,7 @@ void RSSFeedPlugin::updateFeed(QString ID){
   if(ID.isEmpty()){ return; } //nothing to show
 
   //Save the datetime this feed was read
-  LSession::handle()->DesktopPluginSettings()->setValue(setprefix+"feedReads/"+ID, QDateTime::currentDateTime() );
+  LSession::handle()->DesktopPluginStore()->setValue(setprefix+"feedReads/"+ID, QDateTime::currentDateTime() );
   //Get the color to use for hyperlinks (need to specify in html)
   QString color = ui->text_feed->palette().text().color().name(); //keep the hyperlinks the same color as the main text (different formatting still applies)
   QString html;
@@ -187,7 +187,7 @@ void RSSFeedPlugin::openFeedNew(){
 
 void RSSFeedPlugin::openSettings(){
   //Sync the widget with the current settings
-  QSettings *set = LSession::handle()->DesktopPluginSettings();
+  LPluginSettings *set = LSession::handle()->DesktopPluginStore();
 
   ui->check_manual_sync->setChecked( set->value(setprefix+"manual_sync_only", false).toBool() );
   int DI = set->value(setprefix+"default_interval_minutes", 60).toInt();
@@ -210,9 +210,9 @@ void RSSFeedPlugin::addNewFeed(){
     return;
   }
   //Add the URL to the settings file for next login
-  QStringList feeds = LSession::handle()->DesktopPluginSettings()->value(setprefix+"currentfeeds",QStringList()).toStringList();
+  QStringList feeds = LSession::handle()->DesktopPluginStore()->value(setprefix+"currentfeeds",QStringList()).toStringList();
   feeds << url.toString();
-  LSession::handle()->DesktopPluginSettings()->setValue(setprefix+"currentfeeds", feeds);
+  LSession::handle()->DesktopPluginStore()->setValue(setprefix+"currentfeeds", feeds);
 
   //Set this URL as the current selection
   ui->combo_feed->setWhatsThis(url.toString()); //hidden field - will trigger an update in a moment
@@ -235,16 +235,16 @@ void RSSFeedPlugin::removeFeed(){
   RSSchannel info = RSS->dataForID(ID);
   RSS->removeUrl(ID);
   //Remove the URL from the settings file for next login
-  QStringList feeds = LSession::handle()->DesktopPluginSettings()->value(setprefix+"currentfeeds",QStringList()).toStringList();
+  QStringList feeds = LSession::handle()->DesktopPluginStore()->value(setprefix+"currentfeeds",QStringList()).toStringList();
   feeds.removeAll(info.originalURL);
-  LSession::handle()->DesktopPluginSettings()->setValue(setprefix+"currentfeeds", feeds);
-  LSession::handle()->DesktopPluginSettings()->remove(setprefix+"feedReads/"+ID);
+  LSession::handle()->DesktopPluginStore()->setValue(setprefix+"currentfeeds", feeds);
+  LSession::handle()->DesktopPluginStore()->remove(setprefix+"feedReads/"+ID);
   //Now go back to the main page
   backToFeeds();
 }
 
 void RSSFeedPlugin::resyncFeeds(){
-  RSS->addUrls( LSession::handle()->DesktopPluginSettings()->value(setprefix+"currentfeeds",QStringList()).toStringList() );
+  RSS->addUrls( LSession::handle()->DesktopPluginStore()->value(setprefix+"currentfeeds",QStringList()).toStringList() );
   RSS->syncNow();
 }
 
@@ -271,12 +271,11 @@ void RSSFeedPlugin::openFeedPage(){ //Open main website for feed
 }
 
 void RSSFeedPlugin::saveSettings(){
-  QSettings *set = LSession::handle()->DesktopPluginSettings();
+  LPluginSettings *set = LSession::handle()->DesktopPluginStore();
   set->setValue(setprefix+"manual_sync_only", ui->check_manual_sync->isChecked() );
   int DI = ui->spin_synctime->value();
   if(ui->combo_sync_units->currentIndex()==1){ DI = DI*60; } //convert from hours to minutes
   set->setValue(setprefix+"default_interval_minutes", DI);
-  set->sync();
   
   //Now go back to the feeds
   backToFeeds();
@@ -334,7 +333,7 @@ void RSSFeedPlugin::RSSItemChanged(QString ID){
       ui->combo_feed->setItemText(i, info.title);
       ui->combo_feed->setItemIcon(i, info.icon );
       QColor color(Qt::transparent);
-      if( info.lastBuildDate > LSession::handle()->DesktopPluginSettings()->value(setprefix+"feedReads/"+ID,QDateTime()).toDateTime() ){
+      if( info.lastBuildDate > LSession::handle()->DesktopPluginStore()->value(setprefix+"feedReads/"+ID,QDateTime()).toDateTime() ){
         color = QColor(255,10,10,100); //semi-transparent red
         ui->combo_feed->setItemData(i, "notify", Qt::WhatsThisRole);
       }else{
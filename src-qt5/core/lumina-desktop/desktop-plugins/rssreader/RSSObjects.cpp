@@ -7,9 +7,122 @@
 #include "RSSObjects.h"
 #include <QNetworkRequest>
 #include <QXmlStreamReader>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QDir>
 
 #include "LSession.h"
 
+#define CACHE_VERSION 1
+
+static QDateTime RSSDateTime(QString datetime){
+  return QDateTime::fromString(datetime, Qt::RFC2822Date);
+}
+
+//Serialization of the parsed feeds for the on-disk cache
+static QDataStream& operator<<(QDataStream &out, const RSSitem &item){
+  out << item.title << item.link << item.description << item.comments_url << item.author_email << item.author << item.guid << item.pubdate;
+  return out;
+}
+static QDataStream& operator>>(QDataStream &in, RSSitem &item){
+  in >> item.title >> item.link >> item.description >> item.comments_url >> item.author_email >> item.author >> item.guid >> item.pubdate;
+  return in;
+}
+
+//==================
+//  RSSStreamParser
+//==================
+RSSStreamParser::RSSStreamParser(){
+  badformat = false;
+  info.timetolive = -1;
+}
+
+void RSSStreamParser::addData(QByteArray data){
+  if(data.isEmpty() || hasError()){ return; }
+  xml.addData(data);
+  parse();
+}
+
+bool RSSStreamParser::hasError(){
+  return (badformat || (xml.hasError() && xml.error()!=QXmlStreamReader::PrematureDocumentEndError) );
+}
+
+RSSchannel RSSStreamParser::channel(){
+  return info;
+}
+
+void RSSStreamParser::parse(){
+  //Note: We could expand this later to support multiple "channel"s per Feed
+  //   but it seems like there is normally only one channel anyway
+  while(!xml.atEnd() && !badformat){
+    QXmlStreamReader::TokenType type = xml.readNext();
+    if(type==QXmlStreamReader::StartElement){
+      path << xml.name().toString();
+      text.clear();
+      if(path.length()==1){
+        //Root element: only RSS 2.0 (and the compatible 0.91) is supported
+        badformat = !(xml.name() == "rss" && (xml.attributes().value("version") =="2.0" || xml.attributes().value("version") =="0.91") );
+      }else if(path.length()==3 && path[1]=="channel" && path[2]=="item"){
+        item = RSSitem();
+      }
+    }else if(type==QXmlStreamReader::Characters){
+      text.append(xml.text());
+    }else if(type==QXmlStreamReader::EndElement){
+      endElement();
+      if(!path.isEmpty()){ path.removeLast(); }
+      text.clear();
+    }
+  }
+  //PrematureDocumentEndError just means that more data is still on the way
+  if(hasError()){ qDebug() << " - XML Read Error:" << xml.errorString(); }
+}
+
+void RSSStreamParser::endElement(){
+  if(path.length()<3 || path[0]!="rss" || path[1]!="channel"){ return; }
+  QString name = path.last();
+  if(path.length()==3){
+    //Channel elements
+    if(name=="item"){ info.items << item; }
+    else if(name=="title"){ info.title = text; }
+    else if(name=="link"){ 
+      if(!text.isEmpty()){ info.link = text; } 
+    }
+    else if(name=="description"){ info.description = text; }
+    else if(name=="lastBuildDate"){ info.lastBuildDate = RSSDateTime(text); }
+    else if(name=="pubDate"){ info.lastPubDate = RSSDateTime(text); }
+    //else if(name=="skipHours"){ info.link = text; }
+    //else if(name=="skipDays"){ info.link = text; }
+    else if(name=="ttl"){ info.timetolive = text.toInt(); }
+
+  }else if(path.length()==4 && path[2]=="item"){
+    //Item elements
+    if(name=="title"){ item.title = text; }
+    else if(name=="link"){ item.link = text; }
+    else if(name=="description"){ item.description = text; }
+    else if(name=="comments"){ item.comments_url = text; }
+    else if(name=="author"){ 
+      //Special handling - this field can contain both email and name
+      QString raw = text; 
+      if(raw.contains("@")){  
+        item.author_email = raw.split(" ").filter("@").first(); 
+        item.author = raw.remove(item.author_email).remove("(").remove(")").simplified(); //the name is often put within parentheses after the email
+      }else{ item.author = raw; }
+    }
+    else if(name=="guid"){ item.guid = text; }
+    else if(name=="pubDate"){ item.pubdate = RSSDateTime(text); }
+
+  }else if(path.length()==4 && path[2]=="image"){
+    //Image elements
+    if(name=="url"){ info.icon_url = text; }
+    else if(name=="title"){ info.icon_title = text; }
+    else if(name=="link"){ info.icon_link = text; }
+    else if(name=="width"){ info.icon_size.setWidth(text.toInt()); }
+    else if(name=="height"){ info.icon_size.setHeight(text.toInt()); }
+    else if(name=="description"){ info.icon_description = text; }
+  }
+}
+
 //============
 //    PUBLIC
 //============
@@ -19,14 +132,20 @@ RSSReader::RSSReader(QObject *parent, QString settingsPrefix) : QObject(parent){
   connect(NMAN, SIGNAL(sslErrors(QNetworkReply*, const QList<QSslError>&)), this, SLOT(sslErrors(QNetworkReply*, const QList<QSslError>&)) );
 
   setprefix = settingsPrefix;
+  cachedir = QString(qgetenv("XDG_CACHE_HOME"));
+  if(cachedir.isEmpty()){ cachedir = QDir::homePath()+"/.cache"; }
+  cachedir.append("/lumina-desktop/rss/");
+  QDir dir;
+  if(!dir.exists(cachedir)){ dir.mkpath(cachedir); }
   syncTimer = new QTimer(this);
-    syncTimer->setInterval(300000); //5 minutes
+    syncTimer->setSingleShot(true);
+    syncTimer->setInterval(300000); //5 minutes (re-scheduled for the next feed which is due)
     connect(syncTimer, SIGNAL(timeout()), this, SLOT(checkTimes()));
   syncTimer->start();
 }
 
 RSSReader::~RSSReader(){
-
+  qDeleteAll(parsers);
 }
 
 //Information retrieval
@@ -56,17 +175,20 @@ RSSchannel RSSReader::dataForID(QString ID){
 //Initial setup
 void RSSReader::addUrls(QStringList urls){
   //qDebug() << "Add URLS:" << urls;
+  QDateTime cdt = QDateTime::currentDateTime();
   for(int i=0; i<urls.length(); i++){
     //Note: Make sure we get the complete URL form for accurate comparison later
     QString url = QUrl(urls[i]).toString();
     QString key = keyForUrl(url);
     if(hash.contains(key)){ continue; } //already handled
-    RSSchannel blank;
-      blank.originalURL = url;
-    hash.insert(url, blank); //put the empty struct into the hash for now
-    requestRSS(url); //startup the initial request for this url
+    RSSchannel info;
+      info.originalURL = url;
+    bool cached = loadCache(url, &info); //start with the info from the last session (if any)
+    hash.insert(url, info); //put the struct into the hash for now
+    if(!cached || info.nextsync < cdt){ requestRSS(url); } //startup the initial request for this url
   }
   emit newChannelsAvailable();
+  scheduleSync();
 }
 
 void RSSReader::removeUrl(QString ID){
@@ -99,171 +221,177 @@ QString RSSReader::keyForUrl(QString url){
 }
 
 void RSSReader::requestRSS(QString url){
-  if(!outstandingURLS.contains(url)){
-    //qDebug() << "Request URL:" << url;
-    NMAN->get( QNetworkRequest( QUrl(url) ) );
-    outstandingURLS << url;
+  if(outstandingURLS.contains(url)){ return; }
+  //qDebug() << "Request URL:" << url;
+  QNetworkRequest req = QNetworkRequest( QUrl(url) );
+  QString key = keyForUrl(url);
+  if(hash.contains(key) && !hash[key].title.isEmpty()){
+    //We already have this feed - only download it again if it changed
+    if(!hash[key].etag.isEmpty()){ req.setRawHeader("If-None-Match", hash[key].etag.toLatin1()); }
+    if(!hash[key].lastmodified.isEmpty()){ req.setRawHeader("If-Modified-Since", hash[key].lastmodified.toLatin1()); }
   }
+  QNetworkReply *reply = NMAN->get(req);
+  parsers.insert(reply, new RSSStreamParser());
+  connect(reply, SIGNAL(readyRead()), this, SLOT(replyDataAvailable()) );
+  outstandingURLS << url;
 }
 
-//RSS parsing functions
-RSSchannel RSSReader::readRSS(QByteArray bytes){
-  //Note: We could expand this later to support multiple "channel"s per Feed
-  //   but it seems like there is normally only one channel anyway
-  //qDebug() << "Read RSS:" << bytes.left(100);
-  QXmlStreamReader xml(bytes);
-  RSSchannel rssinfo;
-  //qDebug() << "Can Read XML Stream:" << !xml.hasError();
-  if(xml.readNextStartElement()){
-    //qDebug() << " - RSS Element:" << xml.name();
-    if(xml.name() == "rss" && (xml.attributes().value("version") =="2.0" || xml.attributes().value("version") =="0.91") ){
-      while(xml.readNextStartElement()){
-        //qDebug() << " - RSS Element:" << xml.name();
-        if(xml.name()=="channel"){ rssinfo = readRSSChannel(&xml); }
-        else{ xml.skipCurrentElement(); }
-      }
-    }
-  }
-  if(xml.hasError()){ qDebug() << " - XML Read Error:" << xml.errorString() << "\n" << bytes; }
-  return rssinfo;
+void RSSReader::requestIcon(QString url){
+  if(outstandingURLS.contains(url)){ return; }
+  NMAN->get( QNetworkRequest( QUrl(url) ) );
+  outstandingURLS << url;
 }
-RSSchannel RSSReader::readRSSChannel(QXmlStreamReader *rss){
-  RSSchannel info;
-  info.timetolive = -1;
-  while(rss->readNextStartElement()){
-    //qDebug() << " - RSS Element (channel):" <<rss->name();
-    if(rss->name()=="item"){ info.items << readRSSItem(rss); }
-    else if(rss->name()=="title"){ info.title = rss->readElementText(); }
-    else if(rss->name()=="link"){ 
-      QString txt = rss->readElementText(); 
-      if(!txt.isEmpty()){ info.link = txt; } 
-    }
-    else if(rss->name()=="description"){ info.description = rss->readElementText(); }
-    else if(rss->name()=="lastBuildDate"){ info.lastBuildDate = RSSDateTime(rss->readElementText()); }
-    else if(rss->name()=="pubDate"){ info.lastPubDate = RSSDateTime(rss->readElementText()); }
-    else if(rss->name()=="image"){ readRSSImage(&info, rss); }
-    //else if(rss->name()=="skipHours"){ info.link = rss->readElementText(); }
-    //else if(rss->name()=="skipDays"){ info.link = rss->readElementText(); }
-    else if(rss->name()=="ttl"){ info.timetolive = rss->readElementText().toInt(); }
-    else{ rss->skipCurrentElement(); }
+
+void RSSReader::scheduleSync(){
+  //Wake up when the next feed is due (each feed has its own time-to-live)
+  QDateTime cdt = QDateTime::currentDateTime();
+  qint64 msecs = 300000; //5 minutes max
+  QStringList urls = hash.keys();
+  for(int i=0; i<urls.length(); i++){
+    if(hash[urls[i]].nextsync.isNull()){ continue; } //still waiting on the first reply
+    msecs = qMin(msecs, cdt.msecsTo(hash[urls[i]].nextsync) );
   }
-  return info;
+  syncTimer->start( qMax(msecs, (qint64) 60000) ); //no more than once a minute
 }
 
-RSSitem RSSReader::readRSSItem(QXmlStreamReader *rss){
-  RSSitem item;
-  while(rss->readNextStartElement()){
-    //qDebug() << " - RSS Element (Item):" << rss->name();
-    if(rss->name()=="title"){ item.title = rss->readElementText(); }
-    else if(rss->name()=="link"){ item.link = rss->readElementText(); }
-    else if(rss->name()=="description"){ item.description = rss->readElementText(); }
-    else if(rss->name()=="comments"){ item.comments_url = rss->readElementText(); }
-    else if(rss->name()=="author"){ 
-      //Special handling - this field can contain both email and name
-      QString raw = rss->readElementText(); 
-      if(raw.contains("@")){  
-        item.author_email = raw.split(" ").filter("@").first(); 
-        item.author = raw.remove(item.author_email).remove("(").remove(")").simplified(); //the name is often put within parentheses after the email
-      }else{ item.author = raw; }
-    }
-    else if(rss->name()=="guid"){ item.guid = rss->readElementText(); }
-    else if(rss->name()=="pubDate"){ item.pubdate = RSSDateTime(rss->readElementText()); }
-    else{ rss->skipCurrentElement(); }
-  }
-  return item;
+//On-disk cache functions
+QString RSSReader::cacheFile(QString url, QString suffix){
+  return cachedir + QString(QCryptographicHash::hash(url.toUtf8(), QCryptographicHash::Sha1).toHex()) + suffix;
 }
 
-void RSSReader::readRSSImage(RSSchannel *item, QXmlStreamReader *rss){
-  while(rss->readNextStartElement()){
-    //qDebug() << " - RSS Element (Image):" << rss->name();
-    if(rss->name()=="url"){ item->icon_url = rss->readElementText(); }
-    else if(rss->name()=="title"){ item->icon_title = rss->readElementText(); }
-    else if(rss->name()=="link"){ item->icon_link = rss->readElementText(); }
-    else if(rss->name()=="width"){ item->icon_size.setWidth(rss->readElementText().toInt()); }
-    else if(rss->name()=="height"){ item->icon_size.setHeight(rss->readElementText().toInt()); }
-    else if(rss->name()=="description"){ item->icon_description = rss->readElementText(); }
+bool RSSReader::loadCache(QString url, RSSchannel *info){
+  QFile file(cacheFile(url, ".feed"));
+  if(!file.open(QIODevice::ReadOnly)){ return false; }
+  QDataStream in(&file);
+  int version = 0;
+  in >> version;
+  if(version != CACHE_VERSION){ return false; }
+  in >> info->title >> info->link >> info->description >> info->lastBuildDate >> info->lastPubDate >> info->timetolive \
+	>> info->icon_url >> info->icon_title >> info->icon_link >> info->icon_description >> info->icon_size \
+	>> info->items >> info->lastsync >> info->nextsync >> info->etag >> info->lastmodified;
+  file.close();
+  if(in.status()!=QDataStream::Ok){ *info = RSSchannel(); info->originalURL = url; return false; }
+  //Load the channel icon as well
+  QFile icon(cacheFile(url, ".icon"));
+  if(icon.open(QIODevice::ReadOnly)){
+    info->icon = QIcon( QPixmap::fromImage( QImage::fromData(icon.readAll()) ) );
+    icon.close();
   }
-  //Go ahead and kick off the request for the icon
-  if(!item->icon_url.isEmpty()){ requestRSS(item->icon_url); }
+  return true;
 }
 
-QDateTime RSSReader::RSSDateTime(QString datetime){
-  return QDateTime::fromString(datetime, Qt::RFC2822Date);
+void RSSReader::saveCache(const RSSchannel &info){
+  QSaveFile file(cacheFile(info.originalURL, ".feed"));
+  if(!file.open(QIODevice::WriteOnly)){ return; }
+  QDataStream out(&file);
+  out << (int) CACHE_VERSION;
+  out << info.title << info.link << info.description << info.lastBuildDate << info.lastPubDate << info.timetolive \
+	<< info.icon_url << info.icon_title << info.icon_link << info.icon_description << info.icon_size \
+	<< info.items << info.lastsync << info.nextsync << info.etag << info.lastmodified;
+  file.commit(); //atomic replace of the old cache file
+}
+
+void RSSReader::saveIcon(const RSSchannel &info, QByteArray data){
+  QSaveFile file(cacheFile(info.originalURL, ".icon"));
+  if(!file.open(QIODevice::WriteOnly)){ return; }
+  file.write(data);
+  file.commit();
 }
 
 //=================
 //    PRIVATE SLOTS
 //=================
+void RSSReader::replyDataAvailable(){
+  //Parse the feed as the data comes in (instead of buffering the whole reply)
+  QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+  if(reply==0 || !parsers.contains(reply)){ return; }
+  int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if(status>=300){ return; } //redirect or "not modified" - no feed data
+  parsers[reply]->addData(reply->readAll());
+}
+
 void RSSReader::replyFinished(QNetworkReply *reply){
   QString url = reply->request().url().toString();
   //qDebug() << "Got Reply:" << url;
   QString key = keyForUrl(url); //current hash key for this URL
-  QByteArray data = reply->readAll();
   outstandingURLS.removeAll(url);
-  if(data.isEmpty()){
-    //qDebug() << "No data returned:" << url;
-    //see if the URL can be adjusted for known issues
-    bool handled = false;
-    QUrl redirecturl = reply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl();
-    if(redirecturl.isValid() && (redirecturl.toString() != url )){
-      //New URL redirect - make the change and send a new request
-      QString newurl = redirecturl.toString();
-      //qDebug() << " - Redirect to:" << newurl;
-      if(hash.contains(key) && !hash.contains(newurl)){
-        hash.insert(newurl, hash.take(key) ); //just move the data over to the new url
-        requestRSS(newurl);
-        emit newChannelsAvailable();
-        handled = true;
-      }      
-    }
-    if(!handled && hash.contains(key) ){ 
-      emit rssChanged(hash[key].originalURL);
-    }
-    return;
-  }
-
-  if(!hash.contains(key)){ 
-    //qDebug() << " - hash does not contain URL:" << url;
-    //URL removed from list while a request was outstanding?
-    //Could also be an icon fetch response
+  reply->deleteLater(); //clean up
+  RSSStreamParser *parser = parsers.take(reply);
+  if(parser==0){
+    //Icon fetch response
+    QByteArray data = reply->readAll();
+    if(data.isEmpty()){ return; }
     QStringList keys = hash.keys();
     for(int i=0; i<keys.length(); i++){
       //qDebug() << " - Check for icon URL:" << hash[keys[i]].icon_url;
       if(hash[keys[i]].icon_url.toLower() == url.toLower()){ //needs to be case-insensitive
-        //Icon fetch response
         RSSchannel info = hash[keys[i]];
         QImage img = QImage::fromData(data);
         info.icon = QIcon( QPixmap::fromImage(img) );
         //qDebug() << "Got Icon response:" << url << info.icon;
         hash.insert(keys[i], info); //insert back into the hash
+        if(!img.isNull()){ saveIcon(info, data); }
         emit rssChanged( hash[keys[i]].originalURL );
         break;
       }
     }
-    reply->deleteLater();
-  }else{
-    //RSS reply
-    RSSchannel info = readRSS(data); //QNetworkReply can be used as QIODevice
-    reply->deleteLater(); //clean up
-    //Validate the info and announce any changes
-    if(info.title.isEmpty() || info.link.isEmpty() || info.description.isEmpty()){ 
-      qDebug() << "Missing XML Information:" << url << info.title << info.link << info.description;
-      return; 
-    } //bad info/read
-    //Update the bookkeeping elements of the info
-    if(info.timetolive<=0){ info.timetolive = LSession::handle()->DesktopPluginSettings()->value(setprefix+"default_interval_minutes", 60).toInt(); }
-    if(info.timetolive <=0){ info.timetolive = 60; } //error in integer conversion from settings?
-    info.lastsync = QDateTime::currentDateTime(); info.nextsync = info.lastsync.addSecs(info.timetolive * 60); 
-    //Now see if anything changed and save the info into the hash
-    bool changed = (hash[key].lastBuildDate.isNull() || (hash[key].lastBuildDate < info.lastBuildDate) );
-    bool newinfo = false;
-    if(changed){ newinfo = hash[key].title.isEmpty(); } //no previous info from this URL
-    info.originalURL = hash[key].originalURL; //make sure this info gets preserved across updates
-    if(!hash[key].icon.isNull()){ info.icon = hash[key].icon; } //copy over the icon from the previous reply
-    hash.insert(key, info);
-    if(newinfo){ emit newChannelsAvailable(); } //new channel
-    else if(changed){ emit rssChanged(info.originalURL); } //update to existing channel
+    return;
+  }
+
+  //RSS reply
+  int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if(status<300){ parser->addData(reply->readAll()); } //anything which is still left
+  RSSchannel info = parser->channel();
+  bool parseError = parser->hasError();
+  delete parser;
+  if(!hash.contains(key)){ return; } //URL removed from list while a request was outstanding
+  QDateTime cdt = QDateTime::currentDateTime();
+  if(status==304){
+    //Not modified: keep the cached data and just push back the next sync
+    hash[key].lastsync = cdt;
+    hash[key].nextsync = cdt.addSecs(hash[key].timetolive * 60);
+    saveCache(hash[key]);
+    emit rssChanged(hash[key].originalURL);
+    scheduleSync();
+    return;
+  }
+  //See if the URL can be adjusted for known issues
+  QUrl redirecturl = reply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl();
+  if(redirecturl.isValid() && (redirecturl.toString() != url )){
+    //New URL redirect - make the change and send a new request
+    QString newurl = redirecturl.toString();
+    //qDebug() << " - Redirect to:" << newurl;
+    if(!hash.contains(newurl)){
+      hash.insert(newurl, hash.take(key) ); //just move the data over to the new url
+      requestRSS(newurl);
+      emit newChannelsAvailable();
+      return;
+    }
   }
+  //Validate the info and announce any changes
+  if(parseError || info.title.isEmpty() || info.link.isEmpty() || info.description.isEmpty()){ 
+    qDebug() << "Missing XML Information:" << url << info.title << info.link << info.description;
+    emit rssChanged(hash[key].originalURL);
+    return; 
+  } //bad info/read
+  //Update the bookkeeping elements of the info
+  if(info.timetolive<=0){ info.timetolive = LSession::handle()->DesktopPluginStore()->value(setprefix+"default_interval_minutes", 60).toInt(); }
+  if(info.timetolive <=0){ info.timetolive = 60; } //error in integer conversion from settings?
+  info.lastsync = cdt; info.nextsync = info.lastsync.addSecs(info.timetolive * 60); 
+  info.etag = QString::fromLatin1(reply->rawHeader("ETag"));
+  info.lastmodified = QString::fromLatin1(reply->rawHeader("Last-Modified"));
+  //Now see if anything changed and save the info into the hash
+  bool changed = (hash[key].lastBuildDate.isNull() || (hash[key].lastBuildDate < info.lastBuildDate) );
+  bool newinfo = false;
+  if(changed){ newinfo = hash[key].title.isEmpty(); } //no previous info from this URL
+  info.originalURL = hash[key].originalURL; //make sure this info gets preserved across updates
+  if(!hash[key].icon.isNull() && hash[key].icon_url==info.icon_url){ info.icon = hash[key].icon; } //copy over the icon from the previous reply
+  else if(!info.icon_url.isEmpty()){ requestIcon(info.icon_url); } //go ahead and kick off the request for the icon
+  hash.insert(key, info);
+  saveCache(info);
+  if(newinfo){ emit newChannelsAvailable(); } //new channel
+  else if(changed){ emit rssChanged(info.originalURL); } //update to existing channel
+  scheduleSync();
 }
 
 void RSSReader::sslErrors(QNetworkReply *reply, const QList<QSslError> &errors){
@@ -278,10 +406,11 @@ void RSSReader::sslErrors(QNetworkReply *reply, const QList<QSslError> &errors){
 }
 
 void RSSReader::checkTimes(){
-  if(LSession::handle()->DesktopPluginSettings()->value(setprefix+"manual_sync_only", false).toBool()){ return; }
+  if(LSession::handle()->DesktopPluginStore()->value(setprefix+"manual_sync_only", false).toBool()){ syncTimer->start(300000); return; }
   QStringList urls = hash.keys();
   QDateTime cdt = QDateTime::currentDateTime();
   for(int i=0; i<urls.length(); i++){
     if(hash[urls[i]].nextsync < cdt){ requestRSS(urls[i]); }
   }
+  scheduleSync();
 }
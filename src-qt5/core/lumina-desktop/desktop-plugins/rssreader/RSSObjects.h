@@ -16,6 +16,7 @@
 #include <QTimer>
 #include <QXmlStreamReader> //Contained in the Qt "core" module - don't need the full "xml" module for this
 #include <QSslError>
+#include <QHash>
 
 struct RSSitem{
   //Required Fields
@@ -51,6 +52,28 @@ struct RSSchannel{
   //Internal data for bookkeeping
   QDateTime lastsync, nextsync;
   QString originalURL; //in case it was redirected to some "fixed" url later
+  QString etag, lastmodified; //HTTP validators from the last full download (for conditional requests)
+};
+
+//Incremental RSS parser - data can be fed in as it arrives from the network
+class RSSStreamParser{
+public:
+	RSSStreamParser();
+
+	void addData(QByteArray data);
+	bool hasError(); //invalid XML or not an RSS 2.0/0.91 feed
+	RSSchannel channel(); //parsed channel (only complete once all data was added)
+
+private:
+	QXmlStreamReader xml;
+	QStringList path; //current element path (rss/channel/item/title for example)
+	QString text; //text of the current element
+	RSSchannel info;
+	RSSitem item;
+	bool badformat;
+
+	void parse(); //process all currently available tokens
+	void endElement();
 };
 
 class RSSReader : public QObject{
@@ -77,22 +100,25 @@ private:
 	QTimer *syncTimer;	
 	QNetworkAccessManager *NMAN;
         QStringList outstandingURLS;
-
+	QHash<QNetworkReply*, RSSStreamParser*> parsers; //feed replies which are currently being read
+	QString cachedir;
 
 	//Simple hash data search functions
         QString keyForUrl(QString url);
 
-	//Network request function
+	//Network request functions
 	void requestRSS(QString url);
-	
-	//RSS parsing functions
-	RSSchannel readRSS(QByteArray bytes);
-	RSSchannel readRSSChannel(QXmlStreamReader *rss);
-	RSSitem readRSSItem(QXmlStreamReader *rss);
-        void readRSSImage(RSSchannel *item, QXmlStreamReader *rss);
-	QDateTime RSSDateTime(QString datetime);
+	void requestIcon(QString url);
+	void scheduleSync(); //start the timer for the next feed which is due
+
+	//On-disk cache functions ($XDG_CACHE_HOME/lumina-desktop/rss)
+	QString cacheFile(QString url, QString suffix);
+	bool loadCache(QString url, RSSchannel *info);
+	void saveCache(const RSSchannel &info);
+	void saveIcon(const RSSchannel &info, QByteArray data);
 
 private slots:
+	void replyDataAvailable();
 	void replyFinished(QNetworkReply *reply);
 	void sslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
 	void checkTimes();
@@ -6,6 +6,7 @@
 //===========================================
 #include "MonitorWidget.h"
 #include "ui_MonitorWidget.h"
+#include "LSession.h"
 
 
 #include <LuminaXDG.h>
@@ -13,11 +14,9 @@
 
 MonitorWidget::MonitorWidget(QWidget *parent) : QWidget(parent), ui(new Ui::MonitorWidget()){
   ui->setupUi(this); //load the designer form
-  upTimer = new QTimer(this);
-    upTimer->setInterval(2000); //update every 2 seconds
-  connect(upTimer, SIGNAL(timeout()), this, SLOT(UpdateStats()) );
+  //Update every 2 seconds (give or take - shares wakeups with the other plugins)
+  LSession::handle()->tickScheduler()->registerTick("systemmonitor", this, SLOT(UpdateStats()), LTickScheduler::Interval, 2000, 1000);
   LoadIcons();
-  upTimer->start();
 }
 
 MonitorWidget::~MonitorWidget(){
@@ -1,7 +1,7 @@
 include($${PWD}/../../OS-detect.pri)
 
 QT       += core gui network
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets x11extras multimedia concurrent svg
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets x11extras multimedia concurrent svg dbus
 
 
 TARGET = lumina-desktop
@@ -27,6 +27,16 @@ SOURCES += main.cpp \
 	SettingsMenu.cpp \
 	SystemWindow.cpp \
 	BootSplash.cpp \
+	BootTrace.cpp \
+	SystemControls.cpp \
+	OSDWidget.cpp \
+	LPluginSettings.cpp \
+	LDesktopFolder.cpp \
+	LTickScheduler.cpp \
+	LIconAtlas.cpp \
+	LAutoStart.cpp \
+	NotificationServer.cpp \
+	NotificationPopup.cpp \
 	desktop-plugins/LDPlugin.cpp
 
 
@@ -43,6 +53,16 @@ HEADERS  += Globals.h \
 	SettingsMenu.h \
 	SystemWindow.h \
 	BootSplash.h \
+	BootTrace.h \
+	SystemControls.h \
+	OSDWidget.h \
+	LPluginSettings.h \
+	LDesktopFolder.h \
+	LTickScheduler.h \
+	LIconAtlas.h \
+	LAutoStart.h \
+	NotificationServer.h \
+	NotificationPopup.h \
 	panel-plugins/LPPlugin.h \
 	panel-plugins/NewPP.h \
 	panel-plugins/LTBWidget.h \
@@ -73,6 +73,7 @@ int main(int argc, char ** argv)
     setenv("XDG_CURRENT_DESKTOP","Lumina",1);
     unsetenv("QT_QPA_PLATFORMTHEME"); //causes issues with Lumina themes - not many people have this by default...
     //Startup the session
+    BootTrace::init(); //start the startup timeline clock
     LSession a(argc, argv);
     if(!a.isPrimaryProcess()){ return 0; }
     //Setup the log file
@@ -91,13 +92,16 @@ int main(int argc, char ** argv)
     //Setup Log File
     //qInstallMessageHandler(MessageOutput);
     if(DEBUG){ qDebug() << "Theme Init:" << timer->elapsed(); }
+    BootTrace::start("theme");
     LuminaThemeEngine theme(&a);
     QObject::connect(&theme, SIGNAL(updateIcons()), &a, SLOT(reloadIconTheme()) );
+    BootTrace::finish("theme");
     //if(DEBUG){ qDebug() << "Load Locale:" << timer->elapsed(); }
     //LUtils::LoadTranslation(&a, "lumina-desktop");
     if(DEBUG){ qDebug() << "Session Setup:" << timer->elapsed(); }
     a.setupSession();
     theme.refresh();
+    BootTrace::mark("event loop");
     if(DEBUG){ qDebug() << "Exec Time:" << timer->elapsed(); delete timer;}
     int retCode = a.exec();
     //qDebug() << "Stopping the window manager";
@@ -14,17 +14,13 @@ LBattery::LBattery(QWidget *parent, QString id, bool horizontal) : LPPlugin(pare
     label->setScaledContents(true);
     //label->setAlignment(Qt::AlignCenter);
   this->layout()->addWidget(label);
-  //Setup the timer
-  timer = new QTimer();
-  timer->setInterval(5000); //update every 5 seconds
-  connect(timer,SIGNAL(timeout()), this, SLOT(updateBattery()) );
-  timer->start();
+  //Setup the timer: update every 5 seconds (give or take - shares wakeups with the other plugins)
+  tickID = LSession::handle()->tickScheduler()->registerTick("battery", this, SLOT(updateBattery()), LTickScheduler::Interval, 5000, 2500);
   QTimer::singleShot(0,this,SLOT(OrientationChange()) ); //update the sizing/icon
 }
 
 LBattery::~LBattery(){
-  timer->stop();
-  delete timer;
+  LSession::handle()->tickScheduler()->unregisterTick(tickID);
 }
 
 void LBattery::updateBattery(bool force){
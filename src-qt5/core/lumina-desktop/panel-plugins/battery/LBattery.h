@@ -27,7 +27,7 @@ public:
 	~LBattery();
 	
 private:
-	QTimer *timer;
+	int tickID; //registration with the session tick scheduler
 	QLabel *label;
 	int iconOld;
 	
@@ -33,22 +33,18 @@ LClock::LClock(QWidget *parent, QString id, bool horizontal) : LPPlugin(parent,
   this->layout()->setContentsMargins(0,0,0,0); //reserve some space on left/right
   this->layout()->addWidget(button);
 	
-  //Setup the timer
-  timer = new QTimer();
+  //Setup the timer (shared with the other plugins)
+  tickID = LSession::handle()->tickScheduler()->registerTick("clock", this, SLOT(updateTime()), LTickScheduler::MinuteBoundary);
   //Load all the initial settings
   updateFormats();
   LocaleChange();
   ThemeChange();
   OrientationChange();
-  //Now connect/start the timer
-  connect(timer,SIGNAL(timeout()), this, SLOT(updateTime()) );
   connect(QApplication::instance(), SIGNAL(SessionConfigChanged()), this, SLOT(updateFormats()) );
-  timer->start();
 }
 
 LClock::~LClock(){
-  timer->stop();
-  delete timer;
+  LSession::handle()->tickScheduler()->unregisterTick(tickID);
 }
 
 
@@ -103,12 +99,12 @@ void LClock::updateFormats(){
   datefmt = LSession::handle()->sessionSettings()->value("DateFormat","").toString();
   deftime = timefmt.simplified().isEmpty();
   defdate = datefmt.simplified().isEmpty();
-  //Adjust the timer interval based on the smallest unit displayed
-  if(deftime){ timer->setInterval(500); } //1/2 second
-  else if(timefmt.contains("z")){ timer->setInterval(1); } //every millisecond (smallest unit)
-  else if(timefmt.contains("s")){ timer->setInterval(500); } //1/2 second
-  else if(timefmt.contains("m")){ timer->setInterval(2000); } //2 seconds
-  else{ timer->setInterval(1000); } //unknown format - use 1 second interval
+  //Adjust the tick alignment based on the smallest unit displayed
+  QString fmt = deftime ? QLocale().timeFormat(QLocale::ShortFormat) : timefmt;
+  LTickScheduler *ticks = LSession::handle()->tickScheduler();
+  if(fmt.contains("z")){ ticks->changeTick(tickID, LTickScheduler::Interval, 50); } //milliseconds - no point in going faster than the screen can show
+  else if(fmt.contains("s")){ ticks->changeTick(tickID, LTickScheduler::SecondBoundary); }
+  else{ ticks->changeTick(tickID, LTickScheduler::MinuteBoundary); } //the date only changes on a minute boundary too
   datetimeorder = LSession::handle()->sessionSettings()->value("DateTimeOrder", "timeonly").toString().toLower();
   //this->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
   updateTime(true);
@@ -29,7 +29,7 @@ public:
 	~LClock();
 	
 private:
-	QTimer *timer;
+	int tickID; //registration with the session tick scheduler
 	QToolButton *button;
 	QString timefmt, datefmt, datetimeorder;
 	bool deftime, defdate;
@@ -5,11 +5,10 @@
 //  See the LICENSE file for full details
 //===========================================
 #include "LSysDashboard.h"
+#include "../../LSession.h"
 
 LSysDashboard::LSysDashboard(QWidget *parent, QString id, bool horizontal) : LPPlugin(parent, id, horizontal){
-  upTimer = new QTimer(this);
-    upTimer->setInterval(10000); //10 second update ping
-    connect(upTimer, SIGNAL(timeout()), this, SLOT(updateIcon()));
+  tickID = -1; //10 second update ping (only registered if a battery is present)
   button = new QToolButton(this);
     button->setAutoRaise(true);
     button->setToolButtonStyle(Qt::ToolButtonIconOnly);
@@ -66,12 +65,12 @@ void LSysDashboard::updateIcon(bool force){
       }
     //Save the values for comparison later
     batcharging = charging;
-    if( !upTimer->isActive() ){ upTimer->start(); } //only use the timer if a battery is present
+    if(tickID<0){ tickID = LSession::handle()->tickScheduler()->registerTick("systemdashboard", this, SLOT(updateIcon()), LTickScheduler::Interval, 10000, 5000); } //only use the timer if a battery is present
 
   // No battery - just use/set the normal icon
   }else if(force || button->icon().isNull()){
     resetIcon();
-    if(upTimer->isActive() ){ upTimer->stop(); } //no battery available - no refresh timer needed
+    if(tickID>=0){ LSession::handle()->tickScheduler()->unregisterTick(tickID); tickID = -1; } //no battery available - no refresh timer needed
   }
   
 }
@@ -41,7 +41,7 @@ private:
 	QWidgetAction *mact;
 	LSysMenuQuick *sysmenu;
 	QToolButton *button;
-	QTimer *upTimer;
+	int tickID; //registration with the session tick scheduler (-1: none)
 	
 private slots:
 	void updateIcon(bool force = false);
@@ -26,7 +26,7 @@ LStartButtonPlugin::LStartButtonPlugin(QWidget *parent, QString id, bool horizon
     connect(startmenu, SIGNAL(CloseMenu()), this, SLOT(closeMenu()) );
     connect(startmenu, SIGNAL(UpdateQuickLaunch(QStringList)), this, SLOT(updateQuickLaunch(QStringList)));
   menu->setContents(startmenu);
-  QSize saved = LSession::handle()->DesktopPluginSettings()->value("panelPlugs/"+this->type()+"/MenuSize", QSize(0,0)).toSize();
+  QSize saved = LSession::handle()->DesktopPluginStore()->value("panelPlugs/"+this->type()+"/MenuSize", QSize(0,0)).toSize();
   if(!saved.isNull()){ startmenu->setFixedSize(saved); } //re-load the previously saved value
   
   button->setMenu(menu);
@@ -105,7 +105,7 @@ void LStartButtonPlugin::RemoveQuick(QString file){
 
 void LStartButtonPlugin::SaveMenuSize(QSize sz){
   //Save this size for the menu
-  LSession::handle()->DesktopPluginSettings()->setValue("panelPlugs/"+this->type()+"/MenuSize", sz);
+  LSession::handle()->DesktopPluginStore()->setValue("panelPlugs/"+this->type()+"/MenuSize", sz);
 }
 
 // ========================
@@ -25,7 +25,7 @@ StartMenu::StartMenu(QWidget *parent) : QWidget(parent), ui(new Ui::StartMenu){
   connect(searchTimer, SIGNAL(timeout()), this, SLOT(startSearch()) );
   connect(LSession::handle()->applicationMenu(), SIGNAL(AppMenuUpdated()), this, SLOT(UpdateApps()) );
   //Need to load the last used setting of the application list
-  QString state = LSession::handle()->DesktopPluginSettings()->value("panelPlugs/systemstart/showcategories", "partial").toString();
+  QString state = LSession::handle()->DesktopPluginStore()->value("panelPlugs/systemstart/showcategories", "partial").toString();
   if(state=="partial"){ui->check_apps_showcats->setCheckState(Qt::PartiallyChecked); }
   else if(state=="true"){ ui->check_apps_showcats->setCheckState(Qt::Checked); }
   else{ ui->check_apps_showcats->setCheckState(Qt::Unchecked); }
@@ -555,7 +555,7 @@ void StartMenu::catViewChanged(){
     default:
 	state = "false";
   }
-  LSession::handle()->DesktopPluginSettings()->setValue("panelPlugs/systemstart/showcategories", state);
+  LSession::handle()->DesktopPluginStore()->setValue("panelPlugs/systemstart/showcategories", state);
   //Now kick off the reload of the apps list
   UpdateApps();
   //QtConcurrent::run(this, &StartMenu::UpdateApps); //this was a direct user change - keep it thread safe
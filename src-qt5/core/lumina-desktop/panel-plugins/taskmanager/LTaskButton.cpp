@@ -97,7 +97,7 @@ void LTaskButton::UpdateButton(){
     }
     if(i==0 && !statusOnly){
       //Update the button visuals from the first window
-      this->setIcon(WINLIST[i].icon(noicon));
+      this->setIcon(WINLIST[i].icon(noicon, this->iconSize().height()));
       cname = WINLIST[i].Class();
       if(cname.isEmpty()){ 
 	//Special case (chrome/chromium does not register *any* information with X except window title)
@@ -107,7 +107,7 @@ void LTaskButton::UpdateButton(){
       this->setToolTip(cname);
     }
     bool junk;
-    QAction *tmp = winMenu->addAction( WINLIST[i].icon(junk), WINLIST[i].text() );
+    QAction *tmp = winMenu->addAction( WINLIST[i].icon(junk, this->iconSize().height()), WINLIST[i].text() ); //same cached icon as the button
       tmp->setData(i); //save which number in the WINLIST this entry is for
     LXCB::WINDOWVISIBILITY stat = WINLIST[i].status(true); //update the saved state for the window
     if(stat<LXCB::ACTIVE && WINLIST[i].windowID() == LSession::handle()->activeWindow()){ stat = LXCB::ACTIVE; }
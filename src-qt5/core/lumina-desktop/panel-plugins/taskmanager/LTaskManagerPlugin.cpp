@@ -15,7 +15,7 @@ LTaskManagerPlugin::LTaskManagerPlugin(QWidget *parent, QString id, bool horizon
   usegroups = true; //backwards-compatible default value
   if(id.contains("-nogroups")){ usegroups = false; }
   connect(LSession::handle(), SIGNAL(WindowListEvent()), this, SLOT(checkWindows()) );
-  connect(LSession::handle(), SIGNAL(WindowListEvent(WId)), this, SLOT(UpdateButton(WId)) );
+  connect(LSession::handle(), SIGNAL(WindowPropertiesChanged(WId, QList<xcb_atom_t>)), this, SLOT(UpdateButton(WId)) );
   this->layout()->setContentsMargins(0,0,0,0);
   QTimer::singleShot(0,this, SLOT(UpdateButtons()) ); //perform an initial sync
   //QTimer::singleShot(100,this, SLOT(OrientationChange()) ); //perform an initial sync
@@ -129,7 +129,7 @@ void LTaskManagerPlugin::UpdateButtons(){
 void LTaskManagerPlugin::UpdateButton(WId win){
   for(int i=0; i<BUTTONS.length(); i++){
     if(BUTTONS[i]->windows().contains(win)){
-      qDebug() << "Update Task Manager Button (single window ping)";
+      //qDebug() << "Update Task Manager Button (single window ping)";
       QTimer::singleShot(0,BUTTONS[i], SLOT(UpdateButton()) );
       break;
     }
@@ -1,6 +1,6 @@
 include("$${PWD}/../../OS-detect.pri")
 
-QT       += core gui
+QT       += core gui network
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets x11extras
 
 
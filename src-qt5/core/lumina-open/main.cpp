@@ -28,6 +28,9 @@
 #include <LuminaUtils.h>
 #include <LuminaOS.h>
 #include <LuminaThemes.h>
+#include <LuminaHardware.h>
+#include <LuminaSingleApplication.h>
+
 
 void printUsageInfo(){
   qDebug() << "lumina-open: Application launcher for the Lumina Desktop Environment";
@@ -53,11 +56,7 @@ void ShowErrorDialog(int argc, char **argv, QString message){
     exit(1);
 }
 
-void showOSD(int argc, char **argv, QString message){
-  //Setup the application
-  QApplication App(argc, argv);
-    LUtils::LoadTranslation(&App,"lumina-open");
-
+void showOSD(QApplication *App, QString message){
   //Display the OSD
   QPixmap pix(":/icons/OSD.png");
   QLabel splash(0, Qt::Window | Qt::WindowStaysOnTopHint | Qt::X11BypassWindowManagerHint);
@@ -69,16 +68,52 @@ void showOSD(int argc, char **argv, QString message){
   qDebug() << "Display OSD";
   splash.setText(message);
   //Make sure it is centered on the current screen
-  QPoint center = App.desktop()->screenGeometry(QCursor::pos()).center();
+  QPoint center = App->desktop()->screenGeometry(QCursor::pos()).center();
   splash.move(center.x()-(splash.sizeHint().width()/2), center.y()-(splash.sizeHint().height()/2));
   splash.show();
   //qDebug() << " - show message";
   //qDebug() << " - loop";
   QDateTime end = QDateTime::currentDateTime().addMSecs(800);
-  while(QDateTime::currentDateTime() < end){ App.processEvents(); }
+  while(QDateTime::currentDateTime() < end){ App->processEvents(); }
   splash.hide();
 }
 
+bool forwardToSession(int &argc, char **argv, QString flag){
+  //Send the flag to the running lumina-desktop session (LSingleApplication framework)
+  QCoreApplication App(argc, argv); //no X connection needed for this
+  return LSingleApplication::sendInputs("lumina-desktop", QStringList() << flag);
+}
+
+void changeLevel(int argc, char **argv, QString flag){
+  bool audio = flag.startsWith("-volume");
+  int diff = flag.endsWith("up") ? 5 : -5;
+  //Let the desktop session handle it if possible (native controls and a persistent OSD)
+  if( forwardToSession(argc, argv, QString(audio ? "--volume-" : "--brightness-")+(diff>0 ? "up" : "down")) ){ return; }
+  //Setup the application
+  QApplication App(argc, argv);
+    LUtils::LoadTranslation(&App,"lumina-open");
+  QString msg;
+  if(audio){
+    //Try the native mixer first, then the OS utilities
+    bool native = QString(getenv("PICO_CLIENT_LOGIN")).isEmpty() && LHardware::hasNativeAudio();
+    int vol = (native ? LHardware::audioVolume() : LOS::audioVolume()) + diff;
+    if(vol>100){ vol=100; }
+    else if(vol<0){ vol=0; }
+    if(!native || !LHardware::setAudioVolume(vol)){ LOS::setAudioVolume(vol); }
+    msg = QString(QObject::tr("Audio Volume %1%")).arg(QString::number(vol));
+  }else{
+    bool native = LHardware::hasNativeBacklight();
+    int bright = native ? LHardware::backlight() : LOS::ScreenBrightness();
+    if(bright <= 0){ return; } //brightness control not available
+    bright = bright+diff;
+    if(bright>100){ bright = 100; }
+    else if(bright<0){ bright = 0; }
+    if(!native || !LHardware::setBacklight(bright)){ LOS::setScreenBrightness(bright); }
+    msg = QString(QObject::tr("Screen Brightness %1%")).arg(QString::number(bright));
+  }
+  showOSD(&App, msg);
+}
+
 void LaunchAutoStart(){
   QList<XDGDesktop*> xdgapps = LXDG::findAutoStartFiles();
   for(int i=0; i<xdgapps.length(); i++){
@@ -181,35 +216,9 @@ void getCMD(int argc, char ** argv, QString& binary, QString& args, QString& pat
       }else if(QString(argv[i]).simplified() == "-autostart-apps"){
 	LaunchAutoStart();
 	return;
-      }else if(QString(argv[i]).simplified() == "-volumeup"){
-	int vol = LOS::audioVolume()+5; //increase 5%
-	if(vol>100){ vol=100; }
-	LOS::setAudioVolume(vol);
-	showOSD(argc,argv, QString(QObject::tr("Audio Volume %1%")).arg(QString::number(vol)) );
-	return;
-      }else if(QString(argv[i]).simplified() == "-volumedown"){
-	int vol = LOS::audioVolume()-5; //decrease 5%
-	if(vol<0){ vol=0; }
-	LOS::setAudioVolume(vol);
-	showOSD(argc,argv, QString(QObject::tr("Audio Volume %1%")).arg(QString::number(vol)) );
-	return;
-      }else if(QString(argv[i]).simplified() == "-brightnessup"){
-	int bright = LOS::ScreenBrightness();
-	if(bright > 0){ //brightness control available
-	  bright = bright+5; //increase 5%
-	  if(bright>100){ bright = 100; }
-	  LOS::setScreenBrightness(bright);
-	  showOSD(argc,argv, QString(QObject::tr("Screen Brightness %1%")).arg(QString::number(bright)) );
-	}
-	return;
-      }else if(QString(argv[i]).simplified() == "-brightnessdown"){
-	int bright = LOS::ScreenBrightness();
-	if(bright > 0){ //brightness control available
-	  bright = bright-5; //decrease 5%
-	  if(bright<0){ bright = 0; }
-	  LOS::setScreenBrightness(bright);
-	  showOSD(argc,argv, QString(QObject::tr("Screen Brightness %1%")).arg(QString::number(bright)) );
-	}
+      }else if(QString(argv[i]).simplified() == "-volumeup" || QString(argv[i]).simplified() == "-volumedown" \
+		|| QString(argv[i]).simplified() == "-brightnessup" || QString(argv[i]).simplified() == "-brightnessdown"){
+	changeLevel(argc, argv, QString(argv[i]).simplified());
 	return;
       }else if( (QString(argv[i]).simplified() =="-action") && (argc>(i+1)) ){
         ActionID = QString(argv[i+1]);
@@ -0,0 +1,352 @@
+//===========================================
+//  Lumina Desktop source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "CalcEngine.h"
+
+#include <QVarLengthArray>
+
+#include <math.h>
+#define BADVALUE NAN
+
+static const double PI = (::acos(1.0)+::acos(-1.0));
+
+//Supported functions (index = function ID in the program)
+static const char* FUNCS[] = { "ln", "log", "sqrt", "sin", "cos", "tan", "asin", "acos", "atan", "sinh", "cosh", "tanh", 0 };
+
+CalcEquation::CalcEquation(){
+  stackSize = 0;
+  pos = 0;
+}
+
+CalcEquation::~CalcEquation(){
+
+}
+
+bool CalcEquation::compile(QString eq, QString var){
+  prog.clear();
+  toks.clear();
+  errmsg.clear();
+  stackSize = 0;
+  pos = 0;
+  bool ok = tokenize(eq, var) && parseExpr();
+  if(ok && toks[pos].type!=T_END){
+    errmsg = (toks[pos].type==T_RPAREN) ? QString("Unbalanced parentheses") : QString("Unexpected input");
+    ok = false;
+  }
+  toks.clear();
+  if(ok){
+    //Figure out how deep the stack gets
+    int depth = 0;
+    for(int i=0; i<prog.length(); i++){
+      switch(prog[i].op){
+        case OP_NUM: case OP_VAR: case OP_HIST:
+          depth++; break;
+        case OP_NEG: case OP_PERCENT: case OP_FUNC:
+          break;
+        default:
+          depth--; //binary operation
+      }
+      if(depth>stackSize){ stackSize = depth; }
+    }
+  }else{
+    prog.clear();
+  }
+  return ok;
+}
+
+double CalcEquation::evaluate(const QList<double> &history, double var) const{
+  if(prog.isEmpty()){ return BADVALUE; }
+  QVarLengthArray<double, 32> stack(stackSize);
+  int sp = 0;
+  for(int i=0; i<prog.length(); i++){
+    const Instr &in = prog[i];
+    switch(in.op){
+      case OP_NUM:
+	stack[sp++] = in.val; break;
+      case OP_VAR:
+	stack[sp++] = var; break;
+      case OP_HIST:
+	stack[sp++] = historyValue(history, in.hist); break;
+      case OP_NEG:
+	stack[sp-1] = -stack[sp-1]; break;
+      case OP_PERCENT:
+	stack[sp-1] = stack[sp-1]/100.0; break;
+      case OP_FUNC:
+	stack[sp-1] = applyFunc(in.func, stack[sp-1]); break;
+      default:
+	sp--;
+	stack[sp-1] = applyOp(in.op, stack[sp-1], stack[sp]);
+    }
+  }
+  return stack[0];
+}
+
+QVector<double> CalcEquation::evaluateRange(double start, double step, int count, const QList<double> &history) const{
+  if(prog.isEmpty() || count<1){ return QVector<double>(); }
+  //Each stack slot holds the values for the whole range
+  QVector< QVector<double> > stack(stackSize);
+  int sp = 0;
+  for(int i=0; i<prog.length(); i++){
+    const Instr &in = prog[i];
+    if(in.op==OP_NUM || in.op==OP_VAR || in.op==OP_HIST){
+      QVector<double> &out = stack[sp++];
+      out.resize(count);
+      double *o = out.data();
+      if(in.op==OP_VAR){
+        for(int j=0; j<count; j++){ o[j] = start + (j*step); }
+      }else{
+        out.fill( in.op==OP_NUM ? in.val : historyValue(history, in.hist) );
+      }
+      continue;
+    }
+    if(in.op==OP_NEG || in.op==OP_PERCENT || in.op==OP_FUNC){
+      double *o = stack[sp-1].data();
+      if(in.op==OP_NEG){ for(int j=0; j<count; j++){ o[j] = -o[j]; } }
+      else if(in.op==OP_PERCENT){ for(int j=0; j<count; j++){ o[j] = o[j]/100.0; } }
+      else{ for(int j=0; j<count; j++){ o[j] = applyFunc(in.func, o[j]); } }
+      continue;
+    }
+    //Binary operation (simple loops for the common operators - the compiler can vectorize these)
+    sp--;
+    double *L = stack[sp-1].data();
+    const double *R = stack[sp].constData();
+    switch(in.op){
+      case OP_ADD:
+	for(int j=0; j<count; j++){ L[j] = L[j] + R[j]; } break;
+      case OP_SUB:
+	for(int j=0; j<count; j++){ L[j] = L[j] - R[j]; } break;
+      case OP_MUL:
+	for(int j=0; j<count; j++){ L[j] = L[j] * R[j]; } break;
+      case OP_DIV:
+	for(int j=0; j<count; j++){ L[j] = L[j] / R[j]; } break;
+      default:
+	for(int j=0; j<count; j++){ L[j] = applyOp(in.op, L[j], R[j]); }
+    }
+  }
+  return stack[0];
+}
+
+QStringList CalcEquation::functions(){
+  QStringList out;
+  for(int i=0; FUNCS[i]!=0; i++){ out << QString(FUNCS[i]); }
+  return out;
+}
+
+bool CalcEquation::validVariable(QString name){
+  if(name.isEmpty() || name=="e" || name=="x" || functions().contains(name)){ return false; }
+  for(int i=0; i<name.length(); i++){
+    if(name[i]<'a' || name[i]>'z'){ return false; }
+  }
+  return true;
+}
+
+// ===============
+//   PRIVATE
+// ===============
+bool CalcEquation::tokenize(QString eq, QString var){
+  QStringList names = functions();
+  int i=0;
+  while(i<eq.length()){
+    QChar ch = eq[i];
+    Token tok;
+    tok.num = 0;
+    tok.val = 0;
+    if(ch.isSpace()){ i++; continue; }
+    else if(ch.isDigit() || ch=='.'){
+      //Number (with optional base-10 exponent: "1.5E-3")
+      int start = i;
+      while(i<eq.length() && (eq[i].isDigit() || eq[i]=='.') ){ i++; }
+      if(i+1<eq.length() && eq[i]=='E'){
+        int exp = i+1;
+        if(exp<eq.length() && (eq[exp]=='+' || eq[exp]=='-') ){ exp++; }
+        if(exp<eq.length() && eq[exp].isDigit()){
+          i = exp;
+          while(i<eq.length() && eq[i].isDigit()){ i++; }
+        }
+      }
+      bool ok = false;
+      tok.type = T_NUM;
+      tok.val = eq.mid(start, i-start).toDouble(&ok);
+      if(!ok){ errmsg = QString("Invalid number: %1").arg(eq.mid(start, i-start)); return false; }
+      toks << tok;
+    }else if(ch==QChar(0x03C0)){
+      tok.type = T_NUM;
+      tok.val = PI;
+      toks << tok;
+      i++;
+    }else if(ch=='#'){
+      //History reference (no number: last result)
+      int start = ++i;
+      while(i<eq.length() && eq[i].isDigit()){ i++; }
+      tok.type = T_HIST;
+      tok.num = (i>start) ? eq.mid(start, i-start).toInt() : 0;
+      toks << tok;
+    }else if(ch>='a' && ch<='z'){
+      //Run of letters: split into the longest known names ("xsin" -> "x" "sin")
+      int end = i;
+      while(end<eq.length() && eq[end]>='a' && eq[end]<='z'){ end++; }
+      while(i<end){
+        QString run = eq.mid(i, end-i);
+        int len = 0;
+        for(int f=0; f<names.length(); f++){
+          if(run.startsWith(names[f]) && names[f].length()>len){ len = names[f].length(); tok.type = T_FUNC; tok.num = f; }
+        }
+        if(!var.isEmpty() && run.startsWith(var) && var.length()>len){ len = var.length(); tok.type = T_VAR; }
+        if(len==0 && (run[0]=='x' || run[0]=='e') ){ len = 1; tok.type = T_OP; tok.op = run[0]; }
+        if(len==0){ errmsg = QString("Unknown function: %1").arg(run); return false; }
+        toks << tok;
+        i+=len;
+      }
+    }else if(ch=='('){ tok.type = T_LPAREN; toks << tok; i++; }
+    else if(ch==')'){ tok.type = T_RPAREN; toks << tok; i++; }
+    else if(QString("+-*/^%E").contains(ch)){ tok.type = T_OP; tok.op = ch; toks << tok; i++; }
+    else{ errmsg = QString("Invalid character: %1").arg(ch); return false; }
+  }
+  Token end;
+  end.type = T_END;
+  end.num = 0;
+  end.val = 0;
+  toks << end;
+  return true;
+}
+
+//Grammar (lowest to highest precedence):
+//  expr    = term { ("+"|"-") term }
+//  term    = unary { ("*"|"x"|"/"|"e"|"E") unary | <implicit multiply> unary }
+//  unary   = ("-"|"+") unary | power
+//  power   = primary { "%" } [ "^" unary ]   (right-associative)
+//  primary = number | pi | variable | "#"[n] | function "(" expr ")" | "(" expr ")"
+bool CalcEquation::parseExpr(){
+  if(!parseTerm()){ return false; }
+  while(toks[pos].type==T_OP && (toks[pos].op=='+' || toks[pos].op=='-') ){
+    QChar op = toks[pos++].op;
+    if(!parseTerm()){ return false; }
+    addInstr(op=='+' ? OP_ADD : OP_SUB);
+  }
+  return true;
+}
+
+bool CalcEquation::parseTerm(){
+  if(!parseUnary()){ return false; }
+  while(true){
+    const Token &tok = toks[pos];
+    quint8 op;
+    if(tok.type==T_OP && (tok.op=='*' || tok.op=='x') ){ op = OP_MUL; pos++; }
+    else if(tok.type==T_OP && tok.op=='/'){ op = OP_DIV; pos++; }
+    else if(tok.type==T_OP && tok.op=='e'){ op = OP_EXPE; pos++; }
+    else if(tok.type==T_OP && tok.op=='E'){ op = OP_EXP10; pos++; }
+    else if(startsOperand(pos)){ op = OP_MUL; } //implicit multiplication: "2π", "3(1+2)", "2sin(1)"
+    else{ break; }
+    if(!parseUnary()){ return false; }
+    addInstr(op);
+  }
+  return true;
+}
+
+bool CalcEquation::parseUnary(){
+  if(toks[pos].type==T_OP && (toks[pos].op=='-' || toks[pos].op=='+') ){
+    bool neg = (toks[pos++].op=='-');
+    if(!parseUnary()){ return false; }
+    if(neg){ addInstr(OP_NEG); }
+    return true;
+  }
+  return parsePower();
+}
+
+bool CalcEquation::parsePower(){
+  if(!parsePrimary()){ return false; }
+  while(toks[pos].type==T_OP && toks[pos].op=='%'){ addInstr(OP_PERCENT); pos++; }
+  if(toks[pos].type==T_OP && toks[pos].op=='^'){
+    pos++;
+    if(!parseUnary()){ return false; }
+    addInstr(OP_POW);
+  }
+  return true;
+}
+
+bool CalcEquation::parsePrimary(){
+  const Token tok = toks[pos];
+  switch(tok.type){
+    case T_NUM:
+      pos++; addInstr(OP_NUM, tok.val); return true;
+    case T_VAR:
+      pos++; addInstr(OP_VAR); return true;
+    case T_HIST:
+      pos++; addInstr(OP_HIST, 0, tok.num); return true;
+    case T_FUNC:
+      pos++;
+      if(toks[pos].type!=T_LPAREN){ errmsg = QString("Missing function argument"); return false; }
+      if(!parsePrimary()){ return false; } //parenthesized argument
+      addInstr(OP_FUNC, 0, tok.num);
+      return true;
+    case T_LPAREN:
+      pos++;
+      if(!parseExpr()){ return false; }
+      if(toks[pos].type!=T_RPAREN){ errmsg = QString("Unbalanced parentheses"); return false; }
+      pos++;
+      return true;
+    default:
+      break;
+  }
+  errmsg = (tok.type==T_END) ? QString("Incomplete equation") : QString("Unexpected input");
+  return false;
+}
+
+bool CalcEquation::startsOperand(int index){
+  TokType type = toks[index].type;
+  return (type==T_NUM || type==T_VAR || type==T_HIST || type==T_FUNC || type==T_LPAREN);
+}
+
+void CalcEquation::addInstr(quint8 op, double val, int num){
+  Instr in;
+  in.op = op;
+  in.func = (op==OP_FUNC) ? num : 0;
+  in.hist = (op==OP_HIST) ? num : 0;
+  in.val = val;
+  prog << in;
+}
+
+double CalcEquation::applyOp(quint8 op, double LHS, double RHS){
+  switch(op){
+    case OP_ADD: return (LHS+RHS);
+    case OP_SUB: return (LHS-RHS);
+    case OP_MUL: return (LHS*RHS);
+    case OP_DIV: return (LHS/RHS);
+    case OP_POW: return ::pow(LHS, RHS);
+    case OP_EXPE: return (LHS * ::exp(RHS) );
+    case OP_EXP10: return (LHS * ::pow(10.0, RHS) );
+  }
+  return BADVALUE;
+}
+
+double CalcEquation::applyFunc(int func, double arg){
+  double res;
+  switch(func){
+    case 0: return ::log(arg);
+    case 1: return ::log10(arg);
+    case 2: return ::sqrt(arg);
+    case 3: res = ::sin(arg); break; //needs rounding check
+    case 4: res = ::cos(arg); break; //needs rounding check
+    case 5: return ::tan(arg);
+    case 6: return ::asin(arg);
+    case 7: return ::acos(arg);
+    case 8: return ::atan(arg);
+    case 9: return ::sinh(arg);
+    case 10: return ::cosh(arg);
+    case 11: return ::tanh(arg);
+    default: return BADVALUE;
+  }
+  //Special cases:
+  // PI is itself a rounded number, so sin(PI) and such come out as tiny values instead of 0
+  if(::fabs(res) < 0.000000000000001){ return 0; }
+  return res;
+}
+
+double CalcEquation::historyValue(const QList<double> &history, int num){
+  if(history.isEmpty()){ return BADVALUE; }
+  if(num<1 || num>history.length()){ num = history.length(); } //use the last history item
+  return history[num-1];
+}
@@ -0,0 +1,78 @@
+//===========================================
+//  Lumina Desktop source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Equation compiler/evaluator for the calculator
+//   - The equation is tokenized and parsed once into a compact postfix program
+//   - History references ("#n", "#" = last result) stay as operands and are looked up at evaluation time
+//   - An optional named variable can be bound to a range of values for batch (table) evaluation
+//===========================================
+#ifndef _LUMINA_CALCULATOR_ENGINE_H
+#define _LUMINA_CALCULATOR_ENGINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+
+class CalcEquation{
+public:
+	CalcEquation();
+	~CalcEquation();
+
+	//Compile the equation (var: optional variable name which can be used in it)
+	bool compile(QString eq, QString var = "");
+	bool isValid(){ return !prog.isEmpty(); }
+	QString errorString(){ return errmsg; }
+
+	//Evaluate with the given variable value and history results (NaN on failure)
+	double evaluate(const QList<double> &history = QList<double>(), double var = 0) const;
+	//Evaluate for "count" values of the variable: start, start+step, ...
+	//  (each instruction is run over the whole range at once)
+	QVector<double> evaluateRange(double start, double step, int count, const QList<double> &history = QList<double>()) const;
+
+	//List of the supported functions ("sin", "sqrt", etc)
+	static QStringList functions();
+	//Check whether the name can be used as a variable
+	static bool validVariable(QString name);
+
+private:
+	enum OpCode{ OP_NUM, OP_VAR, OP_HIST, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_EXPE, OP_EXP10, OP_NEG, OP_PERCENT, OP_FUNC };
+	struct Instr{
+		quint8 op;
+		quint8 func; //OP_FUNC: function index
+		int hist; //OP_HIST: history number (<1: last result)
+		double val; //OP_NUM: constant
+	};
+	enum TokType{ T_NUM, T_VAR, T_HIST, T_FUNC, T_OP, T_LPAREN, T_RPAREN, T_END };
+	struct Token{
+		TokType type;
+		QChar op; //T_OP: operator symbol
+		int num; //T_FUNC: function index, T_HIST: history number
+		double val; //T_NUM: value
+	};
+
+	QVector<Instr> prog;
+	int stackSize; //max stack depth needed by the program
+	QString errmsg;
+	//Parser state (only used during compile)
+	QList<Token> toks;
+	int pos;
+
+	bool tokenize(QString eq, QString var);
+	bool parseExpr();
+	bool parseTerm();
+	bool parseUnary();
+	bool parsePower();
+	bool parsePrimary();
+	bool startsOperand(int index);
+	void addInstr(quint8 op, double val = 0, int num = 0);
+
+	static double applyOp(quint8 op, double LHS, double RHS);
+	static double applyFunc(int func, double arg);
+	static double historyValue(const QList<double> &history, int num);
+};
+
+#endif
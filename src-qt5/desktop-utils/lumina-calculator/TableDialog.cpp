@@ -0,0 +1,104 @@
+//===========================================
+//  Lumina Desktop source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "TableDialog.h"
+
+#include <QFormLayout>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QPushButton>
+#include <QHeaderView>
+
+#include <LuminaXDG.h>
+#include "CalcEngine.h"
+
+#include <math.h>
+
+#define MAXROWS 100000 //keep the table widget responsive
+
+static QDoubleSpinBox* newSpinBox(QWidget *parent, double value){
+  QDoubleSpinBox *spin = new QDoubleSpinBox(parent);
+    spin->setRange(-1000000000, 1000000000);
+    spin->setDecimals(6);
+    spin->setValue(value);
+  return spin;
+}
+
+TableDialog::TableDialog(QWidget *parent, QString eq, QList<double> hist) : QDialog(parent){
+  this->setWindowTitle(tr("Function Table"));
+  this->setWindowIcon( LXDG::findIcon("formula","") );
+  history = hist;
+  line_eq = new QLineEdit(eq, this);
+    line_eq->setPlaceholderText(tr("Equation using the variable (example: 2t^2+sin(t))"));
+  line_var = new QLineEdit("t", this);
+  spin_start = newSpinBox(this, 0);
+  spin_end = newSpinBox(this, 10);
+  spin_step = newSpinBox(this, 1);
+  QPushButton *button = new QPushButton(LXDG::findIcon("media-playback-start",""), tr("Calculate"), this);
+  table = new QTableWidget(this);
+    table->setColumnCount(2);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  label_status = new QLabel(this);
+  //Now lay it all out
+  QFormLayout *form = new QFormLayout;
+    form->addRow(tr("Equation:"), line_eq);
+    form->addRow(tr("Variable:"), line_var);
+  QHBoxLayout *range = new QHBoxLayout;
+    range->addWidget(new QLabel(tr("From:"), this));
+    range->addWidget(spin_start);
+    range->addWidget(new QLabel(tr("To:"), this));
+    range->addWidget(spin_end);
+    range->addWidget(new QLabel(tr("Step:"), this));
+    range->addWidget(spin_step);
+    range->addWidget(button);
+  QVBoxLayout *vlay = new QVBoxLayout(this);
+    vlay->addLayout(form);
+    vlay->addLayout(range);
+    vlay->addWidget(table);
+    vlay->addWidget(label_status);
+  connect(button, SIGNAL(clicked()), this, SLOT(calculate()) );
+  connect(line_eq, SIGNAL(returnPressed()), this, SLOT(calculate()) );
+  this->resize(480, 400);
+}
+
+TableDialog::~TableDialog(){
+
+}
+
+void TableDialog::calculate(){
+  QString var = line_var->text().simplified();
+  if(!CalcEquation::validVariable(var)){
+    label_status->setText(tr("Invalid variable name (lowercase letters only, not a function name)"));
+    return;
+  }
+  CalcEquation calc;
+  if(!calc.compile(line_eq->text(), var)){
+    label_status->setText(QString(tr("Invalid equation: %1")).arg(calc.errorString()) );
+    return;
+  }
+  double start = spin_start->value();
+  double step = spin_step->value();
+  double end = spin_end->value();
+  if(step==0 || (end-start)/step < 0){
+    label_status->setText(tr("Invalid range"));
+    return;
+  }
+  double num = ::floor( ((end-start)/step) + 1.0000001 ); //include the end point (allow for rounding)
+  bool capped = !(num<=MAXROWS); //also catches inf/NaN (huge ranges)
+  int count = capped ? MAXROWS : (int) num; //only convert once it is known to fit
+  QVector<double> vals = calc.evaluateRange(start, step, count, history);
+  table->clear();
+  table->setHorizontalHeaderLabels(QStringList() << var << tr("Result"));
+  table->setRowCount(vals.length());
+  for(int i=0; i<vals.length(); i++){
+    table->setItem(i, 0, new QTableWidgetItem( QString::number(start+(i*step), 'G') ));
+    table->setItem(i, 1, new QTableWidgetItem( QString::number(vals[i], 'G') ));
+  }
+  if(capped){ label_status->setText(QString(tr("Only the first %1 values are shown")).arg(QString::number(MAXROWS)) ); }
+  else{ label_status->clear(); }
+}
@@ -0,0 +1,36 @@
+//===========================================
+//  Lumina Desktop source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Small dialog for tabulating an equation over a range of values for a variable
+//===========================================
+#ifndef _LUMINA_CALCULATOR_TABLE_DIALOG_H
+#define _LUMINA_CALCULATOR_TABLE_DIALOG_H
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QDoubleSpinBox>
+#include <QTableWidget>
+#include <QLabel>
+#include <QList>
+
+class TableDialog : public QDialog{
+	Q_OBJECT
+public:
+	TableDialog(QWidget *parent, QString eq, QList<double> history);
+	~TableDialog();
+
+private:
+	QLineEdit *line_eq, *line_var;
+	QDoubleSpinBox *spin_start, *spin_end, *spin_step;
+	QTableWidget *table;
+	QLabel *label_status;
+	QList<double> history;
+
+private slots:
+	void calculate();
+};
+
+#endif
@@ -6,10 +6,14 @@ TARGET  = lumina-calculator
 target.path = $${L_BINDIR}
 
 HEADERS	+= mainUI.h \
+		CalcEngine.h \
+		TableDialog.h \
 		EqValidator.h
 		
 SOURCES	+= main.cpp \
-			mainUI.cpp 
+			mainUI.cpp \
+			CalcEngine.cpp \
+			TableDialog.cpp
 
 FORMS		+= mainUI.ui 
 
@@ -10,19 +10,16 @@
 #include <QDebug>
 #include <QClipboard>
 #include <QFileDialog>
+#include <QToolTip>
 
 #include <LuminaUtils.h>
 #include <LuminaXDG.h>
 #include "EqValidator.h"
-
-#include <math.h>
-#define BADVALUE NAN
+#include "CalcEngine.h"
+#include "TableDialog.h"
 
 #define OPS QString("+-*/x^%")
 
-
-const double PI = (::acos(1.0)+::acos(-1.0));
-
 mainUI::mainUI() : QMainWindow(), ui(new Ui::mainUI()){
   ui->setupUi(this);
   advMenu = 0;
@@ -111,16 +108,23 @@ void mainUI::updateMenus(){
     tmp->setWhatsThis("cosh(");
   tmp = advMenu->addAction( QString(tr("Hyperbolic Tangent %1")).arg("\ttanh(") );
     tmp->setWhatsThis("tanh(");
+  advMenu->addSeparator();
+  advMenu->addAction( LXDG::findIcon("view-form-table",""), tr("Function Table..."), this, SLOT(showTable()) );
 }
 
 void mainUI::start_calc(){
   if(ui->line_eq->text().isEmpty()){ return; } //nothing to do
-  QString eq = ui->line_eq->text();
-    eq.replace("%","/(100)");
-  double result = strToNumber(eq);
+  CalcEquation calc;
+  if(!calc.compile(ui->line_eq->text())){
+    //Show the problem right below the equation
+    QToolTip::showText(ui->line_eq->mapToGlobal(QPoint(0, ui->line_eq->height())), QString(tr("Invalid equation: %1")).arg(calc.errorString()), ui->line_eq);
+    return;
+  }
+  double result = calc.evaluate( historyValues() );
   if(result!=result){ return; } //bad calculation - NaN's values are special in that they don't equal itself
   QString res = "[#%1]  %2 \t= [ %3 ]";
   ui->list_results->addItem(res.arg(QString::number(ui->list_results->count()+1), QString::number(result, 'G'), ui->line_eq->text()));
+  ui->list_results->item( ui->list_results->count()-1 )->setData(Qt::UserRole, result); //exact value for history references
   ui->list_results->scrollToItem( ui->list_results->item( ui->list_results->count()-1) );
   ui->line_eq->clear();
 }
@@ -177,160 +181,22 @@ void mainUI::saveHistory(){
   LUtils::writeFile(file, history, true);
 }
 
+void mainUI::showTable(){
+  //Start with the current equation (if any)
+  TableDialog *dlg = new TableDialog(this, ui->line_eq->text(), historyValues());
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+  dlg->show();
+}
+
 // =====================
 //   PRIVATE FUNCTIONS
 // =====================
-double mainUI::performOperation(double LHS, double RHS, QChar symbol){
-  //qDebug() << "Perform Operation:" << LHS << symbol << RHS;
-  if(symbol== '+'){ return (LHS+RHS); }
-  else if(symbol== '-'){ return (LHS-RHS); }
-  else if(symbol== '*' || symbol=='x'){ return (LHS*RHS); }
-  else if(symbol== '/'){ return (LHS/RHS); }
-  else if(symbol== '^'){ return ::pow(LHS, RHS); }
-  else if(symbol=='e'){ return (LHS * ::exp(RHS) ); }
-  //else if(symbol== '%'){ return (LHS%RHS); }
-  qDebug() << "Invalid Symbol:" << symbol;
-  return BADVALUE;
-}
-
-double mainUI::performSciOperation(QString func, double arg){
-  //This function is for performing calculations of scientific functions "<function>(<arg>)"
-  //qDebug() << "Perform Sci Op:" << func << arg;
-  double res;
-  if(func=="ln"){ return ::log(arg); }
-  else if(func=="log"){ return ::log10(arg); }
-  else if(func=="sqrt"){ return ::sqrt(arg); }
-  else if(func=="sin"){ res = ::sin(arg); } //needs rounding check
-  else if(func=="cos"){ res = ::cos(arg); } //needs rounding check
-  else if(func=="tan"){ return ::tan(arg); }
-  else if(func=="asin"){ return ::asin(arg); }
-  else if(func=="acos"){ return ::acos(arg); }
-  else if(func=="atan"){ return ::atan(arg); }
-  else if(func=="sinh"){ return ::sinh(arg); }
-  else if(func=="cosh"){ return ::cosh(arg); }
-  else if(func=="tanh"){ return ::tanh(arg); }
-  else{ 
-    qDebug() << "Unknown Scientific Function:" << func; 
-    return BADVALUE;
-  }
-  //Special cases:
-  // Check for whether "PI" was input as an argument (in some form) and round off the answer as needed
-  //  since PI is itself a rounded number
-  if(res < 0.000000000000001){ return 0; }
-  return res;
-}
-
-
-double mainUI::strToNumber(QString str){
-  //qDebug() << "String To Number:" << str;
-  //Look for history replacements first
-  while(str.contains("#")){
-    int index = str.indexOf("#");
-    int num = -1; //history number
-    for(int i=index+1; i<str.length(); i++){
-      if(!str[i].isNumber() ||  i==(str.length()-1) ){
-        if(!str[i].isNumber()){ i--; } //go back to the last valid char
-        //qDebug() << "Replace History:" << str << index << i << str.mid(index+1, i-index);
-        num = str.mid(index+1, i-index).toInt();
-        //qDebug() << " H number:" << num;
-        str.replace(index, i-index+1, getHistory(num));
-        //qDebug() << " After Replace:" << str;
-        break; //finished with this history item
-      }
-    }
-    if(num<1){ return BADVALUE; } //could not perform substitution
-  }
-  //Look for perentheses first
-  //qDebug() << "String to Number: " << str;
-  if(str.indexOf("(")>=0){
-    //qDebug() << "Found Parenthesis";
-    int start = str.indexOf("(");
-    int need = 1;
-    int end = -1;
-    for(int i=start+1; i<str.length() && need>0; i++){
-      if(str[i]=='('){ need++; }
-      else if(str[i]==')'){ need--; }
-      //qDebug() << "Check char:" << str[i] << need;
-      if(need==0){ end = i; }
-    }
-    if(end<start){ return BADVALUE; }
-    //qDebug() << "Replace value:" << str << start << end << str.mid(start+1,end-start);
-    double tmp = strToNumber( str.mid(start+1, end-start-1));
-    if(tmp!=tmp){ return BADVALUE; } //not a number
-    //Now check really quick if this was an argument to a scientific operation
-    for(int i=start-1; i>=0; i-- ){
-      if( !str[i].isLower() || i==0 ){
-        if(!str[i].isLower()){ i++; }//don't need the invalid character
-        if(start-i<2){ continue; } //not long enough - 2+ chars for sci functions
-        //Got a scientific operation - run it through the routine
-        tmp = performSciOperation( str.mid(i, start-i), tmp);
-        if(tmp!=tmp){ return BADVALUE; } //got a bad value
-        start = i; //new start point for the replacement
-        break;
-      }
-    }
-    str.replace(start, end-start+1, QString::number( tmp, 'E', 16) ); //need as high precision as possible here - internal only, never seen
-    //qDebug() << "Replaced:" << str;
-  }
-  //  -------------------------------------
-  // NOTE: the order of operations appears reversed here due to the recursive nature of the algorithm
-  //     the first operation *found* is actually the last one *evaluated*
-  // --------------------------------------
-  //Now look for add/subtract
-  int sym = -1;
-  QStringList symbols; symbols << "+" << "-";
-  //qDebug() << "Get operator:" << str;
-  for(int i=0; i<symbols.length(); i++){
-    int tmp = str.indexOf(symbols[i]);
-    while(tmp==0 || (tmp>0 && str[tmp-1].toLower()=='e') ){ tmp = str.indexOf(symbols[i], tmp+1); } //catch scientific notation
-    if(sym < tmp){ 
-      //qDebug() << " - found:" << tmp << sym;
-      sym = tmp;
-    }
-  }
-  if(sym>0){  return performOperation( strToNumber(str.left(sym)), strToNumber(str.right(str.length()-sym-1)), str[sym]); }
-  if(sym==0){ return BADVALUE; }
-  //Now look for multiply/divide/power
-  symbols.clear(); symbols << "x" << "*" << "/" << "^" << "e";
-  for(int i=0; i<symbols.length(); i++){
-    int tmp = str.indexOf(symbols[i]);
-    if(sym < tmp){ sym = tmp; }
-  }
-  if(sym>0){  return performOperation( strToNumber(str.left(sym)), strToNumber(str.right(str.length()-sym-1)), str[sym]); }
-  if(sym==0){ return BADVALUE; }
-
-  //Could not find any operations - must be a raw number
-  //qDebug() << " - Found Number:" << str;// << str.toDouble();
-  if(str=="\u03C0"){ return PI; }
-  //else if(str.endsWith("\u03C0")){
-     //return performOperation( strToNumber(str.section("\u03C0",0,-2)), PI, '*'); 
-  else if(str.contains("\u03C0")){
-     qDebug() << " Has Pi:" << str.count("\u03C0");
-    //Pi is mixed into the number - need to multiply it all out
-    double res = 1;
-    QStringList vals = str.split("\u03C0", QString::SkipEmptyParts);
-    for(int i=0; i<vals.length(); i++){ res = res * strToNumber(vals[i]); }
-    //Now multiply in the PI's
-    for(int i=0; i<str.count("\u03C0"); i++){
-      res = res * PI;
-    }
-    return res;
-  }
-  return str.toDouble();
-}
-
-QString mainUI::getHistory(int number){
-  if(number <1 || number > ui->list_results->count()){
-    //use the last history item
-    number = ui->list_results->count();
-  }
-  QString ans = ui->list_results->item(number-1)->text().section("=",0,0).section("]",-1).simplified();
-  QString eq = ui->list_results->item(number-1)->text().section("[",-1).section("]",0,0).simplified();
-  //See if the text answer is accurate enough (does not look rounded)
-  if(ans.length()<7){ 
-    return ("("+ans+")"); //short enough answer that it was probably not rounded
-  }else{
-    //need to re-calculate the last equation instead for exact result
-    return ("("+eq+")");
+QList<double> mainUI::historyValues(){
+  QList<double> vals;
+  for(int i=0; i<ui->list_results->count(); i++){
+    QVariant val = ui->list_results->item(i)->data(Qt::UserRole);
+    if(val.isValid()){ vals << val.toDouble(); }
+    else{ vals << ui->list_results->item(i)->text().section("=",0,0).section("]",-1).simplified().toDouble(); } //displayed value
   }
+  return vals;
 }
@@ -52,14 +52,12 @@ private slots:
 	void checkInput(const QString&);
 
 	void saveHistory();
+	void showTable();
 
 private:
 	Ui::mainUI *ui;
 	QMenu *advMenu;
 
-	double performOperation(double LHS, double RHS, QChar symbol);
-	double performSciOperation(QString func, double arg);
-	double strToNumber(QString str); //this is highly-recursive
-	QString getHistory(int number = -1);
+	QList<double> historyValues(); //exact results for all the history items
 };
 #endif
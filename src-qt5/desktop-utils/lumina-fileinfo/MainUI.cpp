@@ -23,6 +23,7 @@ MainUI::MainUI() : QDialog(), ui(new Ui::MainUI){
   UpdateIcons(); //Set all the icons in the dialog
   SetupConnections();
   INFO = 0;
+  DESK = 0;
 }
 
 MainUI::~MainUI(){
@@ -37,7 +38,10 @@ void MainUI::LoadFile(QString path, QString type){
   
   //Do the first file information tab
   qDebug() << "Load File:" << path << type;
+  if(INFO!=0){ delete INFO; }
   INFO = new LFileInfo(path);
+  if(DESK!=0){ DESK->deleteLater(); }
+  DESK = new XDGDesktop(INFO->isDesktopFile() ? INFO->absoluteFilePath() : "", this);
   if(INFO->exists()){ canwrite = INFO->isWritable(); }
   else if(!INFO->filePath().isEmpty()){
     //See if the containing directory can be written
@@ -48,8 +52,8 @@ void MainUI::LoadFile(QString path, QString type){
   }
   if(!INFO->exists() && !type.isEmpty()){
     //Set the proper type flag on the shortcut
-    if(type=="APP"){ INFO->XDG()->type = XDGDesktop::APP; }
-    else if(type=="LINK"){ INFO->XDG()->type = XDGDesktop::LINK; }
+    if(type=="APP"){ DESK->type = XDGDesktop::APP; }
+    else if(type=="LINK"){ DESK->type = XDGDesktop::LINK; }
   }
 	  
   //First load the general file information
@@ -107,12 +111,12 @@ void MainUI::LoadFile(QString path, QString type){
   //qDebug() << INFO->isDesktopFile() << type;
   if(INFO->isDesktopFile() || !type.isEmpty()){
   
-    if(INFO->XDG()->type == XDGDesktop::APP){
-      ui->line_xdg_command->setText(INFO->XDG()->exec);
-      ui->line_xdg_wdir->setText(INFO->XDG()->path);
-      ui->check_xdg_useTerminal->setChecked( INFO->XDG()->useTerminal );
-      ui->check_xdg_startupNotify->setChecked( INFO->XDG()->startupNotify );
-    }else if(INFO->XDG()->type==XDGDesktop::LINK){
+    if(DESK->type == XDGDesktop::APP){
+      ui->line_xdg_command->setText(DESK->exec);
+      ui->line_xdg_wdir->setText(DESK->path);
+      ui->check_xdg_useTerminal->setChecked( DESK->useTerminal );
+      ui->check_xdg_startupNotify->setChecked( DESK->startupNotify );
+    }else if(DESK->type==XDGDesktop::LINK){
       //Hide the options that are unavailable for links
       //Command  line (exec)
       ui->line_xdg_command->setVisible(false);
@@ -124,13 +128,13 @@ void MainUI::LoadFile(QString path, QString type){
       ui->check_xdg_startupNotify->setVisible(false);
       //Now load the variables for this type of shortcut
       ui->lblWorkingDir->setText(tr("URL:"));
-      ui->line_xdg_wdir->setText( INFO->XDG()->url );
+      ui->line_xdg_wdir->setText( DESK->url );
       ui->tool_xdg_getDir->setVisible(false); //the dir selection button
       
     }
-    ui->line_xdg_name->setText(INFO->XDG()->name);	
-    ui->line_xdg_comment->setText(INFO->XDG()->comment);
-    ui->push_xdg_getIcon->setWhatsThis( INFO->XDG()->icon );
+    ui->line_xdg_name->setText(DESK->name);	
+    ui->line_xdg_comment->setText(DESK->comment);
+    ui->push_xdg_getIcon->setWhatsThis( DESK->icon );
     ReloadAppIcon();
     ui->push_save->setVisible(true);
     ui->push_save->setEnabled(false);
@@ -251,9 +255,9 @@ void MainUI::on_push_save_clicked(){
     if(!filePath.endsWith(".desktop")){ filePath.append(".desktop"); }
     //Update the file paths in the data structure
     INFO->setFile(filePath);
-    INFO->XDG()->filePath = filePath;
+    DESK->filePath = filePath;
   }
-  XDGDesktop *XDG = INFO->XDG();
+  XDGDesktop *XDG = DESK;
   //Now change the structure
   XDG->name = ui->line_xdg_name->text();
   XDG->genericName = ui->line_xdg_name->text().toLower();
@@ -35,6 +35,7 @@ public slots:
 private:
 	Ui::MainUI *ui;
 	LFileInfo *INFO;
+	XDGDesktop *DESK; //editable copy of the desktop entry (the one from LFileInfo is shared)
 
 	bool canwrite;
 	bool terminate_thread; //flag for terminating the GetDirSize task
@@ -14,12 +14,16 @@
 #include <LuminaUtils.h>
 
 Browser::Browser(QObject *parent) : QObject(parent){
-  watcher = new QFileSystemWatcher(this);
-  connect(watcher, SIGNAL(fileChanged(const QString&)), this, SLOT(fileChanged(QString)) );
-  connect(watcher, SIGNAL(directoryChanged(const QString&)), this, SLOT(dirChanged(QString)) );
+  watcher = new LFileWatcher(this);
+    watcher->setDelay(200);
+  connect(watcher, SIGNAL(ItemsChanged(QStringList)), this, SLOT(itemsChanged(QStringList)) );
+  connect(watcher, SIGNAL(ItemsRemoved(QStringList)), this, SLOT(itemsRemoved(QStringList)) );
+  connect(watcher, SIGNAL(ItemMoved(QString, QString)), this, SLOT(itemMoved(QString, QString)) );
+  connect(watcher, SIGNAL(RescanNeeded(QString)), this, SLOT(loadDirectory(QString)) ); //events were lost
   showHidden = false;
   imageFormats = LUtils::imageExtensions(false); //lowercase suffixes
-  connect(this, SIGNAL(threadDone(QString, QByteArray)), this, SLOT(futureFinished(QString, QByteArray)), Qt::QueuedConnection); //will always be between different threads
+  qRegisterMetaType<LFileInfo>("LFileInfo");
+  connect(this, SIGNAL(threadDone(LFileInfo, QByteArray)), this, SLOT(futureFinished(LFileInfo, QByteArray)), Qt::QueuedConnection); //will always be between different threads
 }
 
 Browser::~Browser(){
@@ -61,27 +65,37 @@ void Browser::loadItem(QString info){
   }
   if(item.icon.isNull()){ item.icon = LXDG::findIcon(item.info.mimetype(), "unknown"); }*/
   //qDebug() << " - done with item:" << info;
-  emit threadDone(info, bytes);
+  LFileInfo finfo(info);
+  finfo.iconfile(); //resolve the mimetype/icon here (shared with the copy sent to the main thread)
+  emit threadDone(finfo, bytes);
   //return item;
 }
 
 // PRIVATE SLOTS
-void Browser::fileChanged(QString file){
-  if(file.startsWith(currentDir+"/") ){ 
-    if(QFile::exists(file) ){ QtConcurrent::run(this, &Browser::loadItem, file ); } //file modified but not removed
-    else{ QTimer::singleShot(0, this, SLOT(loadDirectory()) ); } //file removed - need to update entire dir
-  }else if(file==currentDir){ QTimer::singleShot(0, this, SLOT(loadDirectory()) ); }
+void Browser::itemsChanged(QStringList items){
+  for(int i=0; i<items.length(); i++){
+    if(!showHidden && items[i].section("/",-1).startsWith(".") ){ continue; }
+    if(!oldFiles.contains(items[i])){ oldFiles << items[i]; }
+    QtConcurrent::run(this, &Browser::loadItem, items[i] );
+  }
 }
 
-void Browser::dirChanged(QString dir){
-  if(dir==currentDir){ QTimer::singleShot(500, this, SLOT(loadDirectory()) ); }
-  else if(dir.startsWith(currentDir)){ QtConcurrent::run(this, &Browser::loadItem, dir ); }
+void Browser::itemsRemoved(QStringList items){
+  for(int i=0; i<items.length(); i++){
+    if(items[i]==QDir::cleanPath(currentDir)){ QTimer::singleShot(0, this, SLOT(loadDirectory()) ); return; } //dir itself was removed
+    oldFiles.removeAll(items[i]);
+    emit itemRemoved(items[i]);
+  }
 }
 
-void Browser::futureFinished(QString name, QByteArray icon){
+void Browser::itemMoved(QString from, QString to){
+  itemsRemoved(QStringList() << from);
+  itemsChanged(QStringList() << to);
+}
+
+void Browser::futureFinished(LFileInfo info, QByteArray icon){
   //Note: this will be called once for every item that loads
       QIcon ico;
-      LFileInfo info(name);
       if(!icon.isEmpty()){
         QPixmap pix;
         if(pix.loadFromData(icon) ){ ico.addPixmap(pix); }
@@ -105,9 +119,11 @@ void Browser::loadDirectory(QString dir){
     emit clearItems(); 
   } 
   currentDir = dir; //save this for later
-  //clean up the watcher first
-  QStringList watched; watched << watcher->files() << watcher->directories();
-  if(!watched.isEmpty()){ watcher->removePaths(watched); }
+  //Only the directory itself needs to be watched (changes to the items inside are reported individually)
+  if(watcher->paths() != QStringList(QDir::cleanPath(dir)) ){
+    watcher->clear();
+    watcher->watchPath(dir);
+  }
   QStringList old = oldFiles; //copy this over for the moment (both lists will change in a moment)
   oldFiles.clear(); //get ready for re-creating this list
   // read the given directory
@@ -119,7 +135,6 @@ void Browser::loadDirectory(QString dir){
     emit itemsLoading(files.length());
     QCoreApplication::processEvents();
     for(int i=0; i<files.length(); i++){
-      watcher->addPath(directory.absoluteFilePath(files[i]));
       //qDebug() << "Future Starting:" << files[i];
       QString path = directory.absoluteFilePath(files[i]);
       if(old.contains(path)){ old.removeAll(path); }
@@ -127,7 +142,6 @@ void Browser::loadDirectory(QString dir){
       QtConcurrent::run(this, &Browser::loadItem, path );
       QCoreApplication::sendPostedEvents();
     }
-    watcher->addPath(directory.absolutePath());
     if(!old.isEmpty()){
       old.removeAll(directory.absolutePath());
       for(int i=0; i<old.length(); i++){
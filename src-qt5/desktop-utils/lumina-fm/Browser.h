@@ -11,11 +11,11 @@
 
 #include <QObject>
 #include <QString>
-#include <QFileSystemWatcher>
 #include <QIcon>
 //#include <QFutureWatcher>
 
 #include <LuminaXDG.h>
+#include <LuminaFileWatcher.h>
 /*class FileItem{
 public:
 	QString name;
@@ -39,17 +39,19 @@ public:
 
 private:
 	QString currentDir;
-	QFileSystemWatcher *watcher;
+	LFileWatcher *watcher; //current directory (items get reported individually)
 	bool showHidden;
 	QStringList imageFormats, oldFiles;
 
 	void loadItem(QString info); //this is the main loader class - multiple instances each run in a separate thread
 
 private slots:
-	void fileChanged(QString); //tied into the watcher - for file change notifications
-	void dirChanged(QString); // tied into the watcher - for new/removed files in the current dir
+	//Watcher notifications for the items in the current dir
+	void itemsChanged(QStringList); //new or modified items
+	void itemsRemoved(QStringList);
+	void itemMoved(QString, QString);
 
-	void futureFinished(QString, QByteArray);
+	void futureFinished(LFileInfo, QByteArray);
 
 public slots:
 	void loadDirectory(QString dir = "");
@@ -64,7 +66,7 @@ signals:
 	void itemsLoading(int); //number of items which are getting loaded
 
 	//Internal signal for the alternate threads
-	void threadDone(QString, QByteArray);
+	void threadDone(LFileInfo, QByteArray);
 };
 
 #endif
@@ -9,10 +9,13 @@
 #include <QVBoxLayout>
 #include <QTimer>
 #include <QSettings>
+#include <QPainter>
 
 #include <LuminaUtils.h>
 #include <LuminaOS.h>
 
+#include "gitCompat.h"
+
 BrowserWidget::BrowserWidget(QString objID, QWidget *parent) : QWidget(parent){
   //Setup the Widget/UI
   this->setLayout( new QVBoxLayout(this) );
@@ -24,6 +27,7 @@ BrowserWidget::BrowserWidget(QString objID, QWidget *parent) : QWidget(parent){
   connect(BROWSER, SIGNAL(itemDataAvailable(QIcon, LFileInfo)), this, SLOT(itemDataAvailable(QIcon, LFileInfo)) );
   connect(BROWSER, SIGNAL(itemsLoading(int)), this, SLOT(itemsLoading(int)) );
   connect(this, SIGNAL(dirChange(QString)), BROWSER, SLOT(loadDirectory(QString)) );
+  connect(GitStatusCache::instance(), SIGNAL(StatusChanged(QString)), this, SLOT(gitStatusChanged(QString)) );
   listWidget = 0;
   treeWidget = 0;
   readDateFormat();
@@ -239,6 +243,32 @@ QString BrowserWidget::DTtoString(QDateTime dt){
   }
 }
 
+QIcon BrowserWidget::gitIcon(QIcon ico, QString path){
+  QString emblem;
+  switch( GitStatusCache::instance()->state(gitRoot, path) ){
+    case GitStatusCache::Modified:
+      emblem = "vcs-locally-modified"; break;
+    case GitStatusCache::Added:
+      emblem = "vcs-added"; break;
+    case GitStatusCache::Conflict:
+      emblem = "vcs-conflicting"; break;
+    default:
+      break; //no emblem for clean/untracked files
+  }
+  if(emblem.isEmpty() || ico.isNull()){ return ico; }
+  QSize sz(64,64);
+  if(listWidget!=0){ sz = listWidget->iconSize(); }
+  else if(treeWidget!=0){ sz = treeWidget->iconSize(); }
+  QPixmap pix = ico.pixmap(sz);
+  if(pix.isNull()){ return ico; }
+  //Paint the emblem in the bottom-right corner
+  int esz = qMax(8, pix.width()/2);
+  QPainter P(&pix);
+  P.drawPixmap(pix.width()-esz, pix.height()-esz, LXDG::findIcon(emblem, "emblem-important").pixmap(esz,esz) );
+  P.end();
+  return QIcon(pix);
+}
+
 // =================
 //    PRIVATE SLOTS
 // =================
@@ -272,12 +302,14 @@ void BrowserWidget::itemDataAvailable(QIcon ico, LFileInfo info){
       QListWidgetItem *it = listWidget->findItems(info.fileName(), Qt::MatchExactly).first();
       it->setText(info.fileName());
       it->setWhatsThis(info.absoluteFilePath());
-      it->setIcon(ico);
+      it->setData(Qt::UserRole+1, ico); //base icon (without any emblems)
+      it->setIcon( gitIcon(ico, info.absoluteFilePath()) );
     }else{
       //New item
-      QListWidgetItem *it = new CQListWidgetItem(ico, info.fileName(), listWidget);
+      QListWidgetItem *it = new CQListWidgetItem(gitIcon(ico, info.absoluteFilePath()), info.fileName(), listWidget);
         it->setWhatsThis(info.absoluteFilePath());
         it->setData(Qt::UserRole, (info.isDir() ? "dir" : "file")); //used for sorting
+        it->setData(Qt::UserRole+1, ico); //base icon (without any emblems)
       listWidget->addItem(it);
     }
     num = listWidget->count();
@@ -290,7 +322,8 @@ void BrowserWidget::itemDataAvailable(QIcon ico, LFileInfo info){
       treeWidget->addTopLevelItem(it);
     }
     //Now set/update all the data
-    it->setIcon(0, ico);
+    it->setIcon(0, gitIcon(ico, info.absoluteFilePath()) );
+    it->setData(0, Qt::UserRole+1, ico); //base icon (without any emblems)
     it->setText(1, info.isDir() ? "" : LUtils::BytesToDisplaySize(info.size()) ); //size (1)
     it->setText(2, info.mimetype() ); //type (2)
     it->setText(3, DTtoString(info.lastModified() )); //modification date (3)
@@ -358,6 +391,9 @@ void BrowserWidget::itemDataAvailable(QIcon ico, LFileInfo info){
 void BrowserWidget::itemsLoading(int total){
   qDebug() << "Got number of items loading:" << total;
   numItems = total; //save this for later
+  //Resolve the repository once for the whole listing (all the items are in this directory)
+  gitRoot = GIT::repoRoot(BROWSER->currentDirectory());
+  if(!gitRoot.isEmpty()){ GitStatusCache::instance()->request(gitRoot); } //runs in the background
   if(total<1){
     emit updateDirectoryStatus( tr("No Directory Contents") );
     this->setEnabled(true);
@@ -368,6 +404,22 @@ void BrowserWidget::selectionChanged(){
   emit hasFocus(ID); //let the parent know the widget is "active" with the user
 }
 
+void BrowserWidget::gitStatusChanged(QString root){
+  if(root!=gitRoot){ return; } //different repository
+  //Re-apply the emblems to all the items
+  if(listWidget!=0){
+    for(int i=0; i<listWidget->count(); i++){
+      QListWidgetItem *it = listWidget->item(i);
+      it->setIcon( gitIcon(it->data(Qt::UserRole+1).value<QIcon>(), it->whatsThis()) );
+    }
+  }else if(treeWidget!=0){
+    for(int i=0; i<treeWidget->topLevelItemCount(); i++){
+      QTreeWidgetItem *it = treeWidget->topLevelItem(i);
+      it->setIcon(0, gitIcon(it->data(0, Qt::UserRole+1).value<QIcon>(), it->whatsThis(0)) );
+    }
+  }
+}
+
 void BrowserWidget::resizeEvent(QResizeEvent *ev){
   QWidget::resizeEvent(ev); //do the normal processing first
   //The list widget needs to be poked to rearrange the items to fit the new size
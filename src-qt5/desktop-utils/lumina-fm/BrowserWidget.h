@@ -22,6 +22,7 @@ private:
 	//QThread *bThread; //browserThread
 	int numItems; //used for checking if all the items have loaded yet
 	QString ID, statustip;
+	QString gitRoot; //repository containing the current directory (empty if none)
 	QStringList date_format, historyList;
 	bool freshload;
 
@@ -30,6 +31,7 @@ private:
 	DDTreeWidget *treeWidget;
 
 	QString DTtoString(QDateTime dt);  //QDateTime to string simplification routine
+	QIcon gitIcon(QIcon ico, QString path); //add the git status emblem (if any) to the icon
 
 public:
 	BrowserWidget(QString objID, QWidget *parent = 0);
@@ -73,6 +75,7 @@ private slots:
 	void itemDataAvailable(QIcon, LFileInfo);
 	void itemsLoading(int total);
 	void selectionChanged();
+	void gitStatusChanged(QString root);
 
 protected:
 	void resizeEvent(QResizeEvent *ev);
@@ -18,6 +18,8 @@
 #include <LuminaXDG.h>
 #include <LuminaUtils.h>
 
+#include "ZFSCache.h"
+
 #define ZSNAPDIR QString("/.zfs/snapshot/")
 
 #define DIR_DEBUG 0
@@ -32,7 +34,6 @@ public:
 	QString dirpath; //directory this structure was reading
 	QString snapdir; //base snapshot directory (if one was requested/found)
 	bool hashidden;
-	QStringList mntpoints;
 
 	//Access Functions
 	LDirInfoList(QString path = ""){
@@ -40,11 +41,6 @@ public:
 	  list.clear();
 	  fileNames.clear();
 	  hashidden = false;
-	  //Generate the list of all mountpoints if possible
-	  if(LUtils::isValidBinary("zfs")){
-	    mntpoints = LUtils::getCmdOutput("zfs list -H -o mountpoint").filter("/");
-	    mntpoints.removeDuplicates();
-	  }
 	}
 	~LDirInfoList(){}
 
@@ -78,21 +74,8 @@ public:
 	}
 	
 	void findSnapDir(){
-	  //Search the filesystem
-	  if(dirpath.contains(ZSNAPDIR)){
-	    snapdir = dirpath.section(ZSNAPDIR,0,0)+ZSNAPDIR; //no need to go looking for it
-	  }else if(mntpoints.isEmpty()){ 
-	    snapdir.clear(); //no zfs dirs available
-	  }else{
-	    //Only check the mountpoint associated with this directory
-	    QString mnt;
-	    for(int i=0; i<mntpoints.length(); i++){ 
-	      if(dirpath == mntpoints[i]){ mnt = mntpoints[i]; break; }
-	      else if(dirpath.startsWith(mntpoints[i]) && mntpoints[i].length()>mnt.length()){ mnt = mntpoints[i]; }
-	    }
-	    if(QFile::exists(mnt+ZSNAPDIR)){ snapdir = mnt+ZSNAPDIR; }
-	    else{ snapdir.clear(); } //none found
-	  }	  
+	  //Only check the ZFS dataset associated with this directory (mount table is cached)
+	  snapdir = ZFSCache::snapshotDir(dirpath);
 	}
 
 };
@@ -161,23 +144,15 @@ public slots:
 	    }
 	    //Now read off all the available snapshots
 	    if(HASH.value(dirpath).snapdir != "-" && !HASH.value(dirpath).snapdir.isEmpty()){
-	      //Good snapshot directory found - read off the current snapshots (can change regularly - don't cache this)
+	      //Good snapshot directory found - read off the current snapshots (the cache takes care of refreshing these)
 	      base = HASH.value(dirpath).snapdir;
-	      QDir dir(base);
 	      QString canon = QFileInfo(dirpath).canonicalFilePath();
-	      QString dcanon = QString(dir.canonicalPath()+"/").section(ZSNAPDIR,0,0);
-	      QString relpath = canon.section( dcanon+"/" ,-1);
-	      //qDebug() << "Snapshot Dir:" << base << dcanon << "Dir:" << dirpath << canon << "Relpath:" << relpath;
-	      snaps = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Time |QDir::Reversed );
-	      //Also remove any "empty" snapshots (might be leftover by tools like "zfsnap")
-	      for(int i=0; i<snaps.length(); i++){
-		dir.cd(base+"/"+snaps[i]);
-	        if(relpath.isEmpty()){
-		  //Make sure the snapshot is not empty
-		  if(dir.count() < 3 && dir.exists() ){ snaps.removeAt(i); i--; } // "." and ".." are always in the count
-		//Make sure the snapshot contains the directory we are looking for
-	        }else if(!dir.exists(relpath)){ snaps.removeAt(i); i--; }
-	      }
+	      QString relpath;
+	      if(canon.contains(ZSNAPDIR)){ relpath = canon.section(ZSNAPDIR,1,-1).section("/",1,-1); } //strip off the snapshot name
+	      else if(canon.startsWith(base.section(ZSNAPDIR,0,0)+"/")){ relpath = canon.mid( base.section(ZSNAPDIR,0,0).length()+1 ); }
+	      //qDebug() << "Snapshot Dir:" << base << "Dir:" << dirpath << canon << "Relpath:" << relpath;
+	      //Also removes any "empty" snapshots (might be leftover by tools like "zfsnap") or ones without this dir
+	      snaps = ZFSCache::snapshots(base, relpath);
 	      //NOTE: snaps are sorted oldest -> newest
 	    }
 	    
@@ -12,16 +12,32 @@
 
 #include <ScrollDialog.h>
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <linux/fs.h> //FICLONE
+#endif
+
 #define DEBUG 0
 
 FODialog::FODialog(QWidget *parent) : QDialog(parent), ui(new Ui::FODialog){
   ui->setupUi(this); //load the designer file
   ui->label->setText(tr("Calculating"));
   ui->progressBar->setVisible(false);
+  byteProgress = false;
   ui->push_stop->setIcon( LXDG::findIcon("edit-delete","") );
   WorkThread = new QThread();
   Worker = new FOWorker();
     connect(Worker, SIGNAL(startingItem(int,int,QString,QString)), this, SLOT(UpdateItem(int,int,QString,QString)) );
+    connect(Worker, SIGNAL(progressBytes(qint64,qint64,qint64)), this, SLOT(UpdateBytes(qint64,qint64,qint64)) );
     connect(Worker, SIGNAL(finished(QStringList)), this, SLOT(WorkDone(QStringList)) );
   Worker->moveToThread(WorkThread);
     WorkThread->start();
@@ -141,9 +157,11 @@ bool FODialog::CheckOverwrite(){
 }
 
 void FODialog::UpdateItem(int cur, int tot, QString oitem, QString nitem){
-  ui->progressBar->setRange(0,tot);
-  ui->progressBar->setValue(cur);
-  ui->progressBar->setVisible(true);
+  if(!byteProgress){
+    ui->progressBar->setRange(0,tot);
+    ui->progressBar->setValue(cur);
+    ui->progressBar->setVisible(true);
+  }
   QString msg;
   if(Worker->isRM){ msg = tr("Removing: %1"); }
   else if(Worker->isCP){ msg = tr("Copying: %1 to %2"); }
@@ -158,6 +176,15 @@ void FODialog::UpdateItem(int cur, int tot, QString oitem, QString nitem){
   ui->label->setText( msg );
 }
 
+void FODialog::UpdateBytes(qint64 done, qint64 total, qint64 msecs){
+  if(total<=0){ return; }
+  byteProgress = true;
+  ui->progressBar->setRange(0,1000);
+  ui->progressBar->setValue( qMin(done,total)*1000/total );
+  ui->progressBar->setFormat( FOWorker::progressText(done, total, msecs) );
+  ui->progressBar->setVisible(true);
+}
+
 void FODialog::WorkDone(QStringList errlist){
   if(!errlist.isEmpty()){
     QString msg;
@@ -181,29 +208,142 @@ void FODialog::on_push_stop_clicked(){
 // ===================
 // ==== FOWorker Class ====
 // ===================
-QStringList FOWorker::subfiles(QString dirpath, bool dirsfirst){
-  //NOTE: dirpath (input) is always the first/last item in the output as well!
-  QStringList out;
-  if(dirsfirst){ out << dirpath; }
-  if( QFileInfo(dirpath).isDir() ){
-    QDir dir(dirpath);
-    if(dirsfirst){
-      //Now recursively add any subdirectories and their contents
-      QStringList subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDir::NoSort);
-      for(int i=0; i<subdirs.length(); i++){ out << subfiles(dir.absoluteFilePath(subdirs[i]), dirsfirst); }
+#define FO_SMALLFILE (1024*1024) //files below this size are copied on the thread pool
+#define FO_BUFSIZE (1024*1024) //buffer size for the read/write fallback
+#define FO_CHUNK (16*1024*1024) //copy_file_range() chunk size (progress granularity)
+
+//Small-file copy job for the thread pool (both file descriptors are owned by the job)
+class FOCopyJob : public QRunnable{
+public:
+	FOCopyJob(FOWorker *wrk, int sfd, int dfd, qint64 sz, mode_t md, QString path) : QRunnable(){
+	  worker = wrk; srcfd = sfd; destfd = dfd; size = sz; mode = md; oldpath = path;
+	}
+	void run(){
+	  if( !worker->copyFileData(srcfd, destfd, size) && !worker->stopped ){ worker->addError(oldpath); }
+	  ::fchmod(destfd, mode);
+	  ::close(srcfd);
+	  ::close(destfd);
+	  worker->releaseJobSlot();
+	}
+private:
+	FOWorker *worker;
+	int srcfd, destfd;
+	qint64 size;
+	mode_t mode;
+	QString oldpath;
+};
+
+//Recursive size/count scan of an open directory (takes ownership of the descriptor)
+static void scanDirAt(int fd, qint64 *bytes, qint64 *items, bool *stopped){
+  DIR *dir = ::fdopendir(fd);
+  if(dir==0){ ::close(fd); return; }
+  struct dirent *ent;
+  while( !(*stopped) && (ent = ::readdir(dir))!=0 ){
+    if( strcmp(ent->d_name,".")==0 || strcmp(ent->d_name,"..")==0 ){ continue; }
+    struct stat st;
+    if( ::fstatat(dirfd(dir), ent->d_name, &st, AT_SYMLINK_NOFOLLOW)!=0 ){ continue; }
+    *items += 1;
+    if(S_ISREG(st.st_mode)){ *bytes += st.st_size; }
+    else if(S_ISDIR(st.st_mode)){
+      int sub = ::openat(dirfd(dir), ent->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+      if(sub>=0){ scanDirAt(sub, bytes, items, stopped); }
     }
-    //List the files
-    QStringList files = dir.entryList(QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System, QDir::NoSort);
-    for(int i=0; i<files.length(); i++){ out << dir.absoluteFilePath(files[i]); }
-    
-    if(!dirsfirst){
-      //Now recursively add any subdirectories and their contents
-      QStringList subdirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDir::NoSort);
-      for(int i=0; i<subdirs.length(); i++){ out << subfiles(dir.absoluteFilePath(subdirs[i]), dirsfirst); }
+  }
+  ::closedir(dir);
+}
+
+FOWorker::FOWorker() : QObject(){
+  isRM = isCP = isRESTORE = isMV = stopped = false;
+  overwrite = -1; //auto
+  bytesTotal = itemsDone = itemsTotal = 0;
+  skipDev = skipIno = 0;
+  pool = new QThreadPool(this);
+  pool->setMaxThreadCount( qBound(2, QThread::idealThreadCount(), 8) );
+  jobSlots.release(4*pool->maxThreadCount());
+}
+
+FOWorker::~FOWorker(){
+  stopped = true;
+  pool->waitForDone();
+}
+
+bool FOWorker::copyFileData(int srcfd, int destfd, qint64 size){
+#ifdef FICLONE
+  //Reflink the whole file if the filesystem supports it (btrfs/xfs: no data gets copied at all)
+  if(size>0 && ::ioctl(destfd, FICLONE, srcfd)==0){
+    bytesDone.fetchAndAddRelaxed(size);
+    return true;
+  }
+#endif
+#ifdef __linux__
+  //In-kernel copy (no round-trip through userspace, server-side copy on NFS)
+  qint64 copied = 0;
+  while(!stopped){
+    ssize_t num = ::copy_file_range(srcfd, NULL, destfd, NULL, FO_CHUNK, 0);
+    if(num>0){ copied+=num; bytesDone.fetchAndAddRelaxed(num); reportProgress(); continue; }
+    if(num==0){ return true; } //EOF
+    if(errno==EINTR){ continue; }
+    if(copied==0 && (errno==EXDEV || errno==ENOSYS || errno==EINVAL || errno==EOPNOTSUPP || errno==EBADF) ){ break; } //not supported - use the fallback
+    return false;
+  }
+  if(stopped){ return false; }
+#else
+  Q_UNUSED(size);
+#endif
+  //Fallback: large, page-aligned buffered copy
+  void *buf = 0;
+  if( ::posix_memalign(&buf, 4096, FO_BUFSIZE)!=0 ){ return false; }
+#ifdef POSIX_FADV_SEQUENTIAL
+  ::posix_fadvise(srcfd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  bool ok = true;
+  while(ok && !stopped){
+    ssize_t num = ::read(srcfd, buf, FO_BUFSIZE);
+    if(num<0){
+      if(errno==EINTR){ continue; }
+      ok = false; break;
+    }else if(num==0){ break; } //EOF
+    char *ptr = (char*)buf;
+    while(num>0){
+      ssize_t wr = ::write(destfd, ptr, num);
+      if(wr<0){
+        if(errno==EINTR){ continue; }
+        ok = false; break;
+      }
+      ptr+=wr; num-=wr;
+      bytesDone.fetchAndAddRelaxed(wr);
     }
+    reportProgress();
+  }
+  ::free(buf);
+  return (ok && !stopped);
+}
+
+void FOWorker::addError(QString path){
+  QMutexLocker lock(&errMutex);
+  jobErrors << path;
+}
+
+QString FOWorker::progressText(qint64 done, qint64 total, qint64 msecs){
+  QString txt = LUtils::BytesToDisplaySize(done)+" / "+LUtils::BytesToDisplaySize(total);
+  if(msecs>1000 && done>0){
+    qint64 rate = (done*1000)/msecs; //bytes per second
+    txt.append(" ("+LUtils::BytesToDisplaySize(rate)+"/s");
+    if(rate>0 && total>done){ txt.append(", "+tr("%1 left").arg(LUtils::SecondsToDisplay( (total-done)/rate )) ); }
+    txt.append(")");
+  }
+  return txt;
+}
+
+void FOWorker::scanTotals(QString path, qint64 *bytes, qint64 *items){
+  struct stat st;
+  if( ::lstat(QFile::encodeName(path).constData(), &st)!=0 ){ return; }
+  *items += 1;
+  if(S_ISREG(st.st_mode)){ *bytes += st.st_size; }
+  else if(S_ISDIR(st.st_mode)){
+    int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if(fd>=0){ scanDirAt(fd, bytes, items, &stopped); }
   }
-  if(!dirsfirst){ out << dirpath; }
-  return out;
 }
 
 QString FOWorker::newFileName(QString path){
@@ -220,80 +360,168 @@ QString FOWorker::newFileName(QString path){
 
 QStringList FOWorker::removeItem(QString path, bool recursive){
   //qDebug() << "Remove Path:" << path;
-  QStringList items;
-  if(recursive){ items = subfiles(path,false); }
-  else{ items << path; } //only the given path
-  //qDebug() << " - Subfiles:" << items;
-  QStringList err;	
-  for(int i=0; i<items.length(); i++){
-    if(QFileInfo(items[i]).isDir()){
-      if(items[i]==path){
-        //Current Directory Removal
-        QDir dir;
-        if( !dir.rmdir(items[i]) ){ err << items[i]; }		      
-      }else{
-        //Recursive Directory Removal
-        err << removeItem(items[i], recursive);	      
-      }
-    }else{
-      //Simple File Removal
-      if( !QFile::remove(items[i]) ){ err << items[i]; }	    
+  QStringList err;
+  QByteArray cpath = QFile::encodeName(path);
+  struct stat st;
+  if( ::lstat(cpath.constData(), &st)!=0 ){ err << path; return err; }
+  if(S_ISDIR(st.st_mode)){
+    if(recursive){
+      int fd = ::open(cpath.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+      if(fd<0){ err << path; return err; }
+      removeDirAt(fd, path, &err);
     }
+    if( !stopped && ::rmdir(cpath.constData())!=0 ){ err << path; }
+  }else{
+    //Simple File Removal (symlinks are removed - never followed)
+    if( ::unlink(cpath.constData())!=0 ){ err << path; }
   }
+  itemsDone++;
   return err;
 }
 
+bool FOWorker::removeDirAt(int fd, QString dirpath, QStringList *err){
+  DIR *dir = ::fdopendir(fd);
+  if(dir==0){ ::close(fd); *err << dirpath; return false; }
+  bool ok = true;
+  struct dirent *ent;
+  while( !stopped && (ent = ::readdir(dir))!=0 ){
+    if( strcmp(ent->d_name,".")==0 || strcmp(ent->d_name,"..")==0 ){ continue; }
+    QString child = dirpath+"/"+QFile::decodeName(ent->d_name);
+    struct stat st;
+    if( ::fstatat(dirfd(dir), ent->d_name, &st, AT_SYMLINK_NOFOLLOW)!=0 ){ *err << child; ok = false; continue; }
+    if(S_ISDIR(st.st_mode)){
+      //Recursive Directory Removal
+      int sub = ::openat(dirfd(dir), ent->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+      if(sub<0){ *err << child; ok = false; continue; }
+      if( !removeDirAt(sub, child, err) ){ ok = false; continue; }
+      if( ::unlinkat(dirfd(dir), ent->d_name, AT_REMOVEDIR)!=0 ){ *err << child; ok = false; }
+    }else if( ::unlinkat(dirfd(dir), ent->d_name, 0)!=0 ){ *err << child; ok = false; }
+    itemsDone++;
+    if(isRM && lastReport.elapsed()>100){
+      lastReport.restart();
+      emit startingItem( (int) itemsDone, (int) itemsTotal, child, "");
+    }
+  }
+  ::closedir(dir);
+  return ok;
+}
+
 QStringList FOWorker::copyItem(QString oldpath, QString newpath){
   QStringList err;
   if(oldpath == newpath){ return err; } //copy something onto itself - just skip it 
-  if(QFileInfo(oldpath).isDir()){
-    //Create a new directory with the same name (no way to copy dir+contents)
-    QDir dir;
-    if( !dir.mkpath(newpath) ){ err << oldpath; }
-  }else{
-    //Copy the file and reset permissions as necessary
-    if( !QFile::copy(oldpath, newpath) ){ err << oldpath; }
-    else{
-      if(isCP){
-	QFile::setPermissions(newpath, QFile::permissions(oldpath));
-	//Nothing special for copies at the moment (might be something we run into later)
-      }else if(isRESTORE){
-	QFile::setPermissions(newpath, QFile::permissions(oldpath));
-	//Nothing special for restores at the moment (might be something we run into later)
-      }
+  skipDev = skipIno = 0;
+  copyEntryAt(AT_FDCWD, QFile::encodeName(oldpath), AT_FDCWD, QFile::encodeName(newpath), oldpath, &err);
+  return err;
+}
+
+bool FOWorker::copyEntryAt(int srcdir, const QByteArray &name, int destdir, const QByteArray &newname, QString oldpath, QStringList *err){
+  struct stat st;
+  if( ::fstatat(srcdir, name.constData(), &st, AT_SYMLINK_NOFOLLOW)!=0 ){ *err << oldpath; return false; }
+  if(S_ISDIR(st.st_mode) && st.st_dev==skipDev && st.st_ino==skipIno){ return true; } //the copy destination inside the source dir
+  itemsDone++;
+  if(S_ISDIR(st.st_mode)){
+    //Create the new directory (writable until the contents are copied), then walk the old one
+    if( ::mkdirat(destdir, newname.constData(), S_IRWXU)!=0 && errno!=EEXIST ){ *err << oldpath; return false; }
+    int srcfd = ::openat(srcdir, name.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    int destfd = ::openat(destdir, newname.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(srcfd<0 || destfd<0){
+      if(srcfd>=0){ ::close(srcfd); }
+      if(destfd>=0){ ::close(destfd); }
+      *err << oldpath; return false; 
+    }
+    if(skipIno==0){
+      struct stat dst;
+      if(::fstat(destfd, &dst)==0){ skipDev = dst.st_dev; skipIno = dst.st_ino; }
     }
+    bool ok = copyDirAt(srcfd, destfd, oldpath, err);
+    ::fchmod(destfd, st.st_mode & 07777);
+    ::close(destfd);
+    return ok;
+
+  }else if(S_ISLNK(st.st_mode)){
+    //Re-create the link itself (do not follow it)
+    QByteArray target(st.st_size>0 ? st.st_size+1 : PATH_MAX, '\0');
+    ssize_t len = ::readlinkat(srcdir, name.constData(), target.data(), target.size());
+    if(len<0){ *err << oldpath; return false; }
+    target.truncate(len);
+    if( ::symlinkat(target.constData(), destdir, newname.constData())!=0 ){ *err << oldpath; return false; }
+    return true;
+
+  }else if(S_ISREG(st.st_mode)){
+    int srcfd = ::openat(srcdir, name.constData(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if(srcfd<0){ *err << oldpath; return false; }
+    int destfd = ::openat(destdir, newname.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if(destfd<0){ ::close(srcfd); *err << oldpath; return false; }
+    if(st.st_size < FO_SMALLFILE){
+      //Hand off small files to the pool (bounded number of queued jobs)
+      while( !jobSlots.tryAcquire(1, 100) ){ reportProgress(); }
+      pool->start( new FOCopyJob(this, srcfd, destfd, st.st_size, st.st_mode & 07777, oldpath) );
+      return true;
+    }
+    bool ok = copyFileData(srcfd, destfd, st.st_size);
+    ::fchmod(destfd, st.st_mode & 07777);
+    ::close(srcfd);
+    ::close(destfd);
+    if(!ok && !stopped){ *err << oldpath; }
+    return ok;
   }
+  //Sockets/fifos/devices cannot be copied
+  *err << oldpath;
+  return false;
+}
+
+bool FOWorker::copyDirAt(int srcfd, int destfd, QString oldpath, QStringList *err){
+  DIR *dir = ::fdopendir(srcfd);
+  if(dir==0){ ::close(srcfd); *err << oldpath; return false; }
+  bool ok = true;
+  struct dirent *ent;
+  while( !stopped && (ent = ::readdir(dir))!=0 ){
+    if( strcmp(ent->d_name,".")==0 || strcmp(ent->d_name,"..")==0 ){ continue; }
+    QByteArray name(ent->d_name);
+    if( !copyEntryAt(dirfd(dir), name, destfd, name, oldpath+"/"+QFile::decodeName(name), err) ){ ok = false; }
+    reportProgress();
+  }
+  ::closedir(dir);
+  return ok;
+}
+
+QStringList FOWorker::moveItem(QString oldpath, QString newpath){
+  QStringList err;
+  //Same filesystem: a single rename of the top-level item
+  if( ::rename(QFile::encodeName(oldpath).constData(), QFile::encodeName(newpath).constData())==0 ){ itemsDone++; return err; }
+  if(errno!=EXDEV){ err << oldpath; return err; }
+  //Different filesystem: copy the whole tree over, then remove the original
+  scanTotals(oldpath, &bytesTotal, &itemsTotal);
+  err << copyItem(oldpath, newpath);
+  while( !pool->waitForDone(100) ){ reportProgress(); }
+  errMutex.lock();
+  err << jobErrors;
+  jobErrors.clear();
+  errMutex.unlock();
+  if(err.isEmpty() && !stopped){ err << removeItem(oldpath, true); }
   return err;
 }
 
+void FOWorker::reportProgress(bool force){
+  if(QThread::currentThread() != this->thread()){ return; } //only the worker thread itself reports (not pool jobs)
+  if(!force && lastReport.elapsed()<100){ return; }
+  lastReport.restart();
+  if(bytesTotal>0){ emit progressBytes(bytesDone.load(), bytesTotal, elapsed.elapsed()); }
+}
+
 // ==== PRIVATE SLOTS ====
 void FOWorker::slotStartOperations(){
   if(DEBUG){ qDebug() << "Start File operations" << isRM << isCP << isMV << ofiles << nfiles << overwrite; }
-  //Now setup the UI
-  /*ui->progressBar->setRange(0,ofiles.length());
-  ui->progressBar->setValue(0);
-  ui->progressBar->setVisible(true);
-  QApplication::processEvents();*/
-  /*if(!isRM && overwrite==-1){
-    //Check if the new files already exist, and prompt for action
-    QStringList existing;
-    for(int i=0; i<nfiles.length(); i++){
-      if(QFile::exists(nfiles[i])){ existing << nfiles[i].section("/",-1); }
-    }
-    if(!existing.isEmpty()){
-      //Prompt for whether to overwrite, not overwrite, or cancel
-      QMessageBox::StandardButton ans = QMessageBox::question(this, tr("Overwrite Files?"), tr("Do you want to overwrite the existing files?")+"\n"+tr("Note: It will just add a number to the filename otherwise.")+"\n\n"+existing.join(", "), QMessageBox::YesToAll | QMessageBox::NoToAll | QMessageBox::Cancel, QMessageBox::NoToAll);
-      if(ans==QMessageBox::NoToAll){ overwrite = 0; } //don't overwrite
-      else if(ans==QMessageBox::YesToAll){ overwrite = 1; } //overwrite
-      else{ emit finished(QStringList()); return; } //cancel operations
-    }
-  }*/
-	
-  //Get the complete number of items to be operated on (better tracking)
+  elapsed.start();
+  lastReport.start();
+  bytesDone.store(0);
+  bytesTotal = itemsDone = itemsTotal = 0;
+  jobErrors.clear();
+  //Validate the top-level items (the trees themselves get walked as they are processed)
   QStringList olist, nlist; //old/new list to actually be used (not inputs - modified/added as necessary)
   for(int i=0; i<ofiles.length() && !stopped; i++){
     if(isRM){ //only old files
-      olist << subfiles(ofiles[i], false); //dirs need to be last for removals
+      olist << ofiles[i];
     }else if(isCP || isRESTORE){
       if(QFile::exists(nfiles[i])){
 	if(overwrite!=1){
@@ -306,13 +534,8 @@ void FOWorker::slotStartOperations(){
 	//Trying to copy a file/dir to itself - skip it
 	continue;
       }
-      QStringList subs = subfiles(ofiles[i], true); //dirs need to be first for additions
-      for(int s=0; s<subs.length(); s++){
-        olist << subs[s];
-	QString newsub = subs[s].section(ofiles[i],0,100, QString::SectionSkipEmpty); 
-	    newsub.prepend(nfiles[i]);
-	nlist << newsub;
-      }
+      olist << ofiles[i];
+      nlist << nfiles[i];
     }else{ //Move/rename
       if( nfiles[i].startsWith(ofiles[i]+"/") ){
 	//This is trying to move a directory into itself  (not possible)
@@ -332,31 +555,25 @@ void FOWorker::slotStartOperations(){
       }
     }
   }
+  //Get the complete size of the operation (better tracking - streaming walk, no file lists)
+  if(!isMV){
+    for(int i=0; i<olist.length() && !stopped; i++){ scanTotals(olist[i], &bytesTotal, &itemsTotal); }
+  }
   //Now start iterating over the operations
   QStringList errlist;
   for(int i=0; i<olist.length() && !stopped; i++){
     if(isRM){
-      /*ui->label->setText( QString(tr("Removing: %1")).arg(olist[i].section("/",-1)) );
-      QApplication::processEvents();*/
-      emit startingItem(i+1,olist.length(), olist[i], "");
-      errlist << removeItem(olist[i]);
+      emit startingItem( (int) itemsDone, (int) itemsTotal, olist[i], "");
+      errlist << removeItem(olist[i], true);
     }else if(isCP || isRESTORE){
-      /*ui->label->setText( QString(tr("Copying: %1 to %2")).arg(olist[i].section("/",-1), nlist[i].section("/",-1)) );
-      QApplication::processEvents();*/
       emit startingItem(i+1,olist.length(), olist[i],nlist[i]);
       if(QFile::exists(nlist[i])){
 	if(overwrite==1){
 	  errlist << removeItem(nlist[i], true); //recursively remove the file/dir since we are supposed to overwrite it
 	}
       }
-      //If a parent directory fails to copy, skip all the children as well (they will also fail)
-      //QApplication::processEvents();
-      if( !errlist.contains(olist[i].section("/",0,-1)) ){ 
-        errlist << copyItem(olist[i], nlist[i]);
-      }
+      errlist << copyItem(olist[i], nlist[i]);
     }else if(isMV){
-      /*ui->label->setText( QString(tr("Moving: %1 to %2")).arg(ofiles[i].section("/",-1), nfiles[i].section("/",-1)) );
-      QApplication::processEvents();*/
       emit startingItem(i+1,olist.length(), olist[i], nlist[i]);
       //Clean up any overwritten files/dirs
       if(QFile::exists(nlist[i])){
@@ -364,16 +581,20 @@ void FOWorker::slotStartOperations(){
 	  errlist << removeItem(nlist[i], true); //recursively remove the file/dir since we are supposed to overwrite it
 	}
       }
-      //Perform the move if no error yet (including skipping all children)
-      if( !errlist.contains(olist[i].section("/",0,-1)) ){ 
-        if( !QFile::rename(ofiles[i], nfiles[i]) ){
-          errlist << ofiles[i];
-        }
+      //Perform the move if no error yet
+      if( !errlist.contains(olist[i]) ){ 
+        errlist << moveItem(olist[i], nlist[i]);
       }	
     }
-    //ui->progressBar->setValue(i+1);
-    //QApplication::processEvents();
+    reportProgress();
   }
+  //Wait for any queued small-file copies to finish
+  while( !pool->waitForDone(100) ){ reportProgress(); }
+  reportProgress(true);
+  errMutex.lock();
+  errlist << jobErrors;
+  jobErrors.clear();
+  errMutex.unlock();
   //All finished, emit the signal
   errlist.removeAll(""); //make sure to clear any empty items
   emit finished(errlist);
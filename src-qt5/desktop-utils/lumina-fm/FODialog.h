@@ -18,6 +18,11 @@
 #include <QDir>
 #include <QFile>
 #include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QAtomicInteger>
 
 // libLumina includes
 #include <LuminaXDG.h>
@@ -33,23 +38,42 @@ public:
 	int overwrite; // [-1= auto, 0= no overwrite, 1= overwrite]
 
 
-	FOWorker() : QObject(){
-	  isRM = isCP = isRESTORE = isMV = stopped = false;
-	  overwrite = -1; //auto
-	}
-	~FOWorker(){}
-		
+	FOWorker();
+	~FOWorker();
+
+	//Copy engine internals (also used by the small-file copy jobs on the thread pool)
+	bool copyFileData(int srcfd, int destfd, qint64 size); //copy the contents of one open file into another
+	void addError(QString path);
+	void releaseJobSlot(){ jobSlots.release(); }
+
+	static QString progressText(qint64 done, qint64 total, qint64 msecs); //"<done> / <total> (<rate>/s, <time> left)"
+
 public slots:
 	void slotStartOperations();
 
 private:
-	QStringList subfiles(QString dirpath, bool dirsfirst = false); //recursive function for fetching all "child" files/dirs (dirs last by default)
+	QThreadPool *pool; //small-file copy jobs
+	QSemaphore jobSlots; //bounds the number of queued jobs (and open file descriptors)
+	QMutex errMutex;
+	QStringList jobErrors; //errors reported by pool jobs
+	QAtomicInteger<qint64> bytesDone;
+	qint64 bytesTotal, itemsDone, itemsTotal;
+	QElapsedTimer elapsed, lastReport;
+	quint64 skipDev, skipIno; //destination directory to skip while walking (copy of a dir into itself)
+
+	void scanTotals(QString path, qint64 *bytes, qint64 *items); //streaming walk to size up an operation
 	QString newFileName(QString path);
 	QStringList removeItem(QString path, bool recursive = false);
+	bool removeDirAt(int dirfd, QString dirpath, QStringList *err); //remove the contents of an open directory
 	QStringList copyItem(QString oldpath, QString newpath);
+	bool copyEntryAt(int srcdir, const QByteArray &name, int destdir, const QByteArray &newname, QString oldpath, QStringList *err);
+	bool copyDirAt(int srcfd, int destfd, QString oldpath, QStringList *err); //copy the contents of an open directory
+	QStringList moveItem(QString oldpath, QString newpath);
+	void reportProgress(bool force = false);
 
 signals:
 	void startingItem(int, int, QString, QString); //current number, total number, Old File, New File (if appropriate)
+	void progressBytes(qint64, qint64, qint64); //bytes done, bytes total, elapsed time (ms)
 	void finished(QStringList); //errors returned
 };
 
@@ -75,12 +99,14 @@ private:
 	Ui::FODialog *ui;
 	QThread *WorkThread;
 	FOWorker *Worker;
+	bool byteProgress; //progress bar is showing bytes instead of items
 
 	bool CheckOverwrite(); //Returns "true" if it is ok to start the procedure
 
 private slots:
 	void on_push_stop_clicked();
 	void UpdateItem(int, int, QString, QString);
+	void UpdateBytes(qint64, qint64, qint64);
 	void WorkDone(QStringList);
 };
 
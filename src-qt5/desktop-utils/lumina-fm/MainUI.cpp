@@ -611,7 +611,25 @@ void MainUI::on_menuGit_aboutToShow(){
 }
 
 void MainUI::on_actionRepo_Status_triggered(){
-  QString status = GIT::status( FindActiveBrowser()->currentDir() );
+  //Run this in the background - can take a while on large repositories
+  QProcess *P = new QProcess(this);
+    P->setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+    P->setWorkingDirectory( FindActiveBrowser()->currentDir() );
+    P->setProcessChannelMode(QProcess::MergedChannels);
+  connect(P, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(gitStatusFinished()) );
+  P->start("git", QStringList() << "status");
+  if(!P->waitForStarted()){
+    //finished() never gets emitted for this process
+    P->deleteLater();
+    QMessageBox::warning(this, tr("Git Repository Status"), tr("Could not start the git utility"));
+  }
+}
+
+void MainUI::gitStatusFinished(){
+  QProcess *P = qobject_cast<QProcess*>(sender());
+  if(P==0){ return; }
+  QString status = P->readAllStandardOutput();
+  P->deleteLater();
   QMessageBox::information(this, tr("Git Repository Status"), status);
 }
 
@@ -138,6 +138,7 @@ private slots:
 	//Git Menu options
 	void on_menuGit_aboutToShow();
 	void on_actionRepo_Status_triggered();
+	void gitStatusFinished();
 	void on_actionClone_Repository_triggered();	
 
 	//Tab interactions
@@ -16,6 +16,7 @@ OPWidget::OPWidget(QWidget *parent) : QWidget(parent), ui(new Ui::OPWidget()){
   worker = 0;
   workthread = 0;
   dlg = 0;
+  byteProgress = false;
   //Now create the widget
   ui->setupUi(this);
   ui->tool_close->setIcon( LXDG::findIcon("dialog-close","view-close") );
@@ -41,6 +42,7 @@ void OPWidget::setupOperation(QString optype, QStringList oldF, QStringList newF
   if(worker==0){
     worker = new FOWorker();
     connect(worker, SIGNAL(startingItem(int,int,QString,QString)), this, SLOT(opUpdate(int,int,QString,QString)) );
+    connect(worker, SIGNAL(progressBytes(qint64,qint64,qint64)), this, SLOT(opBytes(qint64,qint64,qint64)) );
     connect(worker, SIGNAL(finished(QStringList)), this, SLOT(opFinished(QStringList)) );
     worker->moveToThread(workthread);
   }
@@ -109,9 +111,19 @@ void OPWidget::opFinished(QStringList errors){
 }
 
 void OPWidget::opUpdate(int cur, int tot, QString ofile, QString nfile){ //current, total, old file, new file
-  ui->progressBar->setRange(0,tot);
-  ui->progressBar->setValue(cur);
+  if(!byteProgress){
+    ui->progressBar->setRange(0,tot);
+    ui->progressBar->setValue(cur);
+  }
   QString txt = tract +": "+ofile.section("/",-1);
   if(!nfile.isEmpty()){txt.append(" -> "+nfile.section("/",-1) ); }
   ui->label->setText( txt);
 }
+
+void OPWidget::opBytes(qint64 done, qint64 total, qint64 msecs){ //bytes done, bytes total, elapsed time (ms)
+  if(total<=0){ return; }
+  byteProgress = true;
+  ui->progressBar->setRange(0,1000);
+  ui->progressBar->setValue( qMin(done,total)*1000/total );
+  ui->progressBar->setFormat( FOWorker::progressText(done, total, msecs) );
+}
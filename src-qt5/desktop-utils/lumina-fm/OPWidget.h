@@ -46,12 +46,14 @@ private:
 	qint64 starttime, endtime;  //in ms
 	QStringList Errors;
 	QString tract; //translated action
+	bool byteProgress; //progress bar is showing bytes instead of items
 
 private slots:
 	void closeWidget();
 	void showErrors();
 	void opFinished(QStringList); //errors
 	void opUpdate(int, int, QString, QString); //current, total, old file, new file
+	void opBytes(qint64, qint64, qint64); //bytes done, bytes total, elapsed time (ms)
 
 signals:
 	void starting(QString);
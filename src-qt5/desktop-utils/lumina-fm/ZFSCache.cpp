@@ -0,0 +1,234 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "ZFSCache.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QFile>
+#include <QDateTime>
+#include <QtAlgorithms>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <poll.h>
+#else
+#include <sys/param.h>
+#include <sys/ucred.h>
+#include <sys/mount.h>
+#endif
+
+#ifndef AT_NO_AUTOMOUNT
+#define AT_NO_AUTOMOUNT 0 //Linux only: do not trigger a snapshot mount just to stat the entry
+#endif
+
+#define ZSNAPDIR QString("/.zfs/snapshot/")
+#define SNAP_TTL 5000 //milliseconds to re-use a snapshot listing
+#define MOUNT_TTL 2000 //milliseconds to re-use the mount table (systems without change notifications)
+
+struct SnapList{
+	qint64 checked; //msecs since epoch
+	QList< QPair<qint64, QString> > snaps; //[creation time, name]
+};
+
+static QMutex zfsMutex;
+static QStringList zfsMounts;
+static qint64 zfsMountsChecked = -1;
+static QHash<QString, SnapList> zfsSnaps; //[snapdir, list]
+static QHash<QString, bool> zfsContains; //["snapdir/snapshot@time/relpath", exists] (snapshots are read-only)
+#ifdef __linux__
+static int mountinfoFD = -1;
+#endif
+
+// === Internal functions (mutex already locked) ===
+#ifdef __linux__
+static QString unescapeMount(QByteArray path){
+  //mountinfo escapes spaces and such as "\ooo" (octal)
+  QByteArray out;
+  for(int i=0; i<path.length(); i++){
+    if(path[i]=='\\' && i+3<path.length()){
+      out.append( (char) path.mid(i+1,3).toInt(0,8) );
+      i+=3;
+    }else{
+      out.append(path[i]);
+    }
+  }
+  return QString::fromLocal8Bit(out);
+}
+#endif
+
+static bool mountTableChanged(){
+  if(zfsMountsChecked<0){ return true; }
+#ifdef __linux__
+  if(mountinfoFD>=0){
+    //The kernel flags the open mountinfo file whenever the mount table changes
+    struct pollfd pfd;
+    pfd.fd = mountinfoFD;
+    pfd.events = POLLPRI;
+    pfd.revents = 0;
+    return (poll(&pfd, 1, 0)>0 && (pfd.revents & (POLLERR | POLLPRI)) );
+  }
+#endif
+  return (QDateTime::currentMSecsSinceEpoch() - zfsMountsChecked) > MOUNT_TTL;
+}
+
+static void readMountTable(){
+  QStringList mnts;
+#ifdef __linux__
+  if(mountinfoFD<0){ mountinfoFD = open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC); }
+  if(mountinfoFD>=0){
+    QByteArray data;
+    char buf[8192];
+    lseek(mountinfoFD, 0, SEEK_SET);
+    ssize_t len;
+    while( (len = read(mountinfoFD, buf, sizeof(buf))) > 0 ){ data.append(buf, len); }
+    QList<QByteArray> lines = data.split('\n');
+    for(int i=0; i<lines.length(); i++){
+      //Format: <id> <parent> <dev> <root> <mountpoint> <options> [optional fields] - <fstype> <source> <super options>
+      int sep = lines[i].indexOf(" - ");
+      if(sep<0){ continue; }
+      if(!lines[i].mid(sep+3).startsWith("zfs ")){ continue; }
+      QList<QByteArray> fields = lines[i].left(sep).split(' ');
+      if(fields.length()>4){ mnts << unescapeMount(fields[4]); }
+    }
+  }
+#else
+  struct statfs *fs;
+  int num = getmntinfo(&fs, MNT_NOWAIT);
+  for(int i=0; i<num; i++){
+    if(QString(fs[i].f_fstypename)=="zfs"){ mnts << QString::fromLocal8Bit(fs[i].f_mntonname); }
+  }
+#endif
+  mnts.removeDuplicates();
+  if(mnts!=zfsMounts){
+    //Datasets changed - any snapshot listings could be stale now
+    zfsSnaps.clear();
+    zfsMounts = mnts;
+  }
+  zfsMountsChecked = QDateTime::currentMSecsSinceEpoch();
+}
+
+static QStringList currentMounts(){
+  if(mountTableChanged()){ readMountTable(); }
+  return zfsMounts;
+}
+
+static bool snapshotContains(int snapfd, QString snap, QString relpath){
+  if(relpath.isEmpty()){
+    //Dataset root: make sure the snapshot is not empty (can be left over by tools like "zfsnap")
+    int fd = openat(snapfd, snap.toLocal8Bit().constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(fd<0){ return false; }
+    DIR *dir = fdopendir(fd);
+    if(dir==0){ close(fd); return false; }
+    bool found = false;
+    struct dirent *ent;
+    while( !found && (ent = readdir(dir))!=0 ){
+      found = (strcmp(ent->d_name, ".")!=0 && strcmp(ent->d_name, "..")!=0);
+    }
+    closedir(dir); //also closes fd
+    return found;
+  }else{
+    struct stat st;
+    return (fstatat(snapfd, QString(snap+"/"+relpath).toLocal8Bit().constData(), &st, 0)==0);
+  }
+}
+
+// === Public functions ===
+QStringList ZFSCache::mountpoints(){
+  QMutexLocker lock(&zfsMutex);
+  return currentMounts();
+}
+
+QString ZFSCache::datasetMount(QString path){
+  QMutexLocker lock(&zfsMutex);
+  QStringList mnts = currentMounts();
+  QString mnt;
+  for(int i=0; i<mnts.length(); i++){
+    if(path == mnts[i]){ return mnts[i]; }
+    QString prefix = mnts[i].endsWith("/") ? mnts[i] : mnts[i]+"/";
+    if(path.startsWith(prefix) && mnts[i].length()>mnt.length()){ mnt = mnts[i]; }
+  }
+  return mnt;
+}
+
+QString ZFSCache::snapshotDir(QString path){
+  if(path.contains(ZSNAPDIR)){ return path.section(ZSNAPDIR,0,0)+ZSNAPDIR; }
+  QString mnt = datasetMount(path);
+  if(mnt.isEmpty()){ return ""; }
+  if(mnt.endsWith("/")){ mnt.chop(1); }
+  struct stat st;
+  if(lstat( QString(mnt+ZSNAPDIR).toLocal8Bit().constData(), &st)!=0){ return ""; } //snapdir=hidden still allows this
+  return mnt+ZSNAPDIR;
+}
+
+QStringList ZFSCache::snapshots(QString snapdir, QString relpath){
+  QMutexLocker lock(&zfsMutex);
+  currentMounts(); //flush the cache if the datasets changed
+  while(relpath.startsWith("/")){ relpath.remove(0,1); }
+  while(relpath.endsWith("/")){ relpath.chop(1); }
+  int snapfd = open(snapdir.toLocal8Bit().constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if(snapfd<0){ return QStringList(); }
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if( !zfsSnaps.contains(snapdir) || (now - zfsSnaps[snapdir].checked) > SNAP_TTL ){
+    //(Re)read the snapshot names - only the control directory itself gets listed
+    SnapList list;
+    list.checked = now;
+    DIR *dir = fdopendir( dup(snapfd) );
+    if(dir!=0){
+      struct dirent *ent;
+      while( (ent = readdir(dir))!=0 ){
+        if(strcmp(ent->d_name, ".")==0 || strcmp(ent->d_name, "..")==0){ continue; }
+        struct stat st;
+        //Entry times are the snapshot creation time (do not follow into the snapshot)
+        if(fstatat(snapfd, ent->d_name, &st, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT)!=0){ continue; }
+        list.snaps << qMakePair( (qint64) st.st_mtime, QString::fromLocal8Bit(ent->d_name) );
+      }
+      closedir(dir);
+    }
+    qSort(list.snaps); //oldest -> newest (name as a tie-breaker)
+    if(zfsSnaps.contains(snapdir)){
+      //Forget the lookups for any snapshots which have been destroyed
+      QStringList keys = zfsContains.keys();
+      for(int i=0; i<keys.length(); i++){
+        if(!keys[i].startsWith(snapdir)){ continue; }
+        QString snap = keys[i].mid(snapdir.length()).section("/",0,0);
+        bool found = false;
+        for(int j=0; j<list.snaps.length() && !found; j++){
+          found = (snap == list.snaps[j].second+"@"+QString::number(list.snaps[j].first));
+        }
+        if(!found){ zfsContains.remove(keys[i]); }
+      }
+    }
+    zfsSnaps.insert(snapdir, list);
+  }
+  QList< QPair<qint64, QString> > snaps = zfsSnaps.value(snapdir).snaps;
+  QStringList out;
+  for(int i=0; i<snaps.length(); i++){
+    //Note: the creation time is part of the key in case a snapshot gets re-created with the same name
+    QString key = snapdir+snaps[i].second+"@"+QString::number(snaps[i].first)+"/"+relpath;
+    if(!zfsContains.contains(key)){ zfsContains.insert(key, snapshotContains(snapfd, snaps[i].second, relpath) ); }
+    if(zfsContains.value(key)){ out << snaps[i].second; }
+  }
+  close(snapfd);
+  return out;
+}
+
+void ZFSCache::clear(){
+  QMutexLocker lock(&zfsMutex);
+  zfsMountsChecked = -1;
+  zfsMounts.clear();
+  zfsSnaps.clear();
+  zfsContains.clear();
+}
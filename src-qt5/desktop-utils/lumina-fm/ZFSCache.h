@@ -0,0 +1,36 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+//  Shared cache of the ZFS layout (dataset mountpoints and snapshots)
+//   - Mountpoints come straight from the kernel mount table (no "zfs list" process)
+//       and are only re-read when the mount table changes
+//   - Snapshot names are read from the ".zfs/snapshot" directory of the dataset
+//       (the snapshots themselves are not entered) and kept for a few seconds
+//   - Snapshot contents never change, so "does <relpath> exist in <snapshot>" is remembered
+//  All functions are thread-safe
+//===========================================
+#ifndef _LUMINA_FM_ZFS_CACHE_H
+#define _LUMINA_FM_ZFS_CACHE_H
+
+#include <QString>
+#include <QStringList>
+
+class ZFSCache{
+public:
+	//List of all the mounted ZFS datasets
+	static QStringList mountpoints();
+	//Mountpoint of the ZFS dataset which contains the given path (empty if not on ZFS)
+	static QString datasetMount(QString path);
+	//The "<mountpoint>/.zfs/snapshot/" directory for the given path (empty if not available)
+	static QString snapshotDir(QString path);
+	//Names of the snapshots (oldest -> newest) of the dataset which contain the relative path
+	//  relpath: path within the dataset (empty: the dataset root - empty snapshots are skipped)
+	static QStringList snapshots(QString snapdir, QString relpath = "");
+	//Forget everything (next call re-reads the system)
+	static void clear();
+};
+
+#endif
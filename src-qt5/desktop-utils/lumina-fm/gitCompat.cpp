@@ -8,6 +8,8 @@
 //===========================================
 #include "gitCompat.h"
 #include <QApplication>
+#include <QFileInfo>
+#include <QPair>
 
 #define TMPFILE QString("/tmp/.")
 GitProcess::GitProcess() : QProcess(){
@@ -43,3 +45,135 @@ void GitProcess::setSSHPassword(QString pass){
 void GitProcess::cleanup(){
   if(tmpfile.exists()){ tmpfile.remove(); } //ensure that password file never gets left behind
 }
+
+// ============
+//   GIT (static functions)
+// ============
+#define ROOT_CACHE_TIME 5 //seconds to trust a cached "not a repository" result
+#define ROOT_CACHE_MAX 200 //max number of directories kept in the cache
+
+QString GIT::repoRoot(QString dir){
+  static QHash<QString, QPair<QDateTime, QString> > cache; //[dir, [checked, root]]
+  if(dir.isEmpty()){ return ""; }
+  if(dir.endsWith("/") && dir.length()>1){ dir.chop(1); }
+  if(cache.contains(dir)){
+    QPair<QDateTime, QString> info = cache.value(dir);
+    if(!info.second.isEmpty()){
+      if(QFile::exists(info.second+"/.git")){ return info.second; } //still a repository
+    }else if(info.first.secsTo(QDateTime::currentDateTime()) < ROOT_CACHE_TIME){ return ""; }
+  }
+  //Walk up the directory tree looking for the ".git" dir (or file for worktrees/submodules)
+  QString root;
+  QString path = dir;
+  while(!path.isEmpty()){
+    if(cache.contains(path) && !cache.value(path).second.isEmpty() && path!=dir){ root = cache.value(path).second; break; }
+    if(QFile::exists(path+"/.git")){ root = path; break; }
+    if(path=="/"){ break; }
+    path = path.section("/",0,-2);
+    if(path.isEmpty()){ path = "/"; }
+  }
+  if(!root.isEmpty() && !isAvailable()){ root.clear(); } //no way to use it anyway
+  if(cache.size()>=ROOT_CACHE_MAX){ cache.clear(); } //start over (only visited directories get added again)
+  cache.insert(dir, qMakePair(QDateTime::currentDateTime(), root) );
+  return root;
+}
+
+// ============
+//   GitStatusCache
+// ============
+#define STATUS_MAX_AGE 10 //seconds before re-checking the status even if the index did not change
+
+GitStatusCache* GitStatusCache::instance(){
+  static GitStatusCache *inst = 0;
+  if(inst==0){ inst = new GitStatusCache(); }
+  return inst;
+}
+
+GitStatusCache::GitStatusCache() : QObject(){
+
+}
+
+GitStatusCache::~GitStatusCache(){
+  QList<QProcess*> procs = running.values();
+  for(int i=0; i<procs.length(); i++){ procs[i]->kill(); procs[i]->deleteLater(); }
+}
+
+void GitStatusCache::request(QString dir){
+  QString root = GIT::repoRoot(dir);
+  if(root.isEmpty() || running.contains(root)){ return; }
+  if(repos.contains(root)){
+    RepoStatus stat = repos.value(root);
+    if(stat.indexTime==indexTime(root) && stat.checked.secsTo(QDateTime::currentDateTime()) < STATUS_MAX_AGE){ return; } //still current
+  }
+  QProcess *P = new QProcess(this);
+    P->setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+    P->setWorkingDirectory(root);
+    P->setProperty("root", root);
+    P->setProperty("indexTime", indexTime(root)); //time before the run (the run itself might refresh the index)
+  connect(P, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(processFinished()) );
+  connect(P, SIGNAL(error(QProcess::ProcessError)), this, SLOT(processFinished()) );
+  running.insert(root, P);
+  P->start("git", QStringList() << "status" << "--porcelain=v2" << "-z");
+}
+
+GitStatusCache::FileState GitStatusCache::state(QString root, QString path){
+  if(root.isEmpty() || !repos.contains(root) || !path.startsWith(root+"/")){ return Clean; }
+  QString rel = path.mid(root.length()+1);
+  if(rel.endsWith("/")){ rel.chop(1); }
+  return repos[root].files.value(rel, Clean);
+}
+
+qint64 GitStatusCache::indexTime(QString root){
+  QString gitdir = root+"/.git";
+  if(!QFileInfo(gitdir).isDir()){
+    //Worktree/submodule: ".git" is a file pointing at the real directory
+    QString link = LUtils::readFile(gitdir).filter("gitdir:").join("").section("gitdir:",1,-1).trimmed();
+    if(!link.isEmpty()){ gitdir = link.startsWith("/") ? link : root+"/"+link; }
+  }
+  return QFileInfo(gitdir+"/index").lastModified().toMSecsSinceEpoch();
+}
+
+void GitStatusCache::setState(QHash<QString, FileState> *files, QString path, FileState state){
+  if(path.endsWith("/")){ path.chop(1); }
+  files->insert(path, state);
+  //Now flag all the parent directories as well (conflicts > modified > added > untracked)
+  while(path.contains("/")){
+    path = path.section("/",0,-2);
+    FileState cur = files->value(path, Clean);
+    if(cur==Clean || (cur!=Conflict && state==Conflict) || (state==Modified && (cur==Added || cur==Untracked)) || (state==Added && cur==Untracked) ){
+      files->insert(path, state);
+    }
+  }
+}
+
+void GitStatusCache::processFinished(){
+  QProcess *P = qobject_cast<QProcess*>(sender());
+  if(P==0){ return; }
+  QString root = P->property("root").toString();
+  if(running.value(root)!=P){ return; } //already handled (errors can be followed by a finished signal)
+  running.remove(root);
+  P->deleteLater();
+  if(P->error()==QProcess::FailedToStart || P->exitStatus()!=QProcess::NormalExit || P->exitCode()!=0){ repos.remove(root); return; }
+  RepoStatus stat;
+  stat.indexTime = P->property("indexTime").toLongLong();
+  stat.checked = QDateTime::currentDateTime();
+  //Porcelain v2 with NUL-terminated records:
+  //  "1 XY sub mH mI mW hH hI path", "2 XY sub mH mI mW hH hI Xscore path" + NUL + origPath,
+  //  "u XY sub m1 m2 m3 mW h1 h2 h3 path", "? path"
+  QList<QByteArray> recs = P->readAllStandardOutput().split('\0');
+  for(int i=0; i<recs.length(); i++){
+    QString rec = QString::fromUtf8(recs[i]);
+    if(rec.length()<3){ continue; }
+    QChar type = rec[0];
+    if(type=='?'){ setState(&stat.files, rec.mid(2), Untracked); }
+    else if(type=='u'){ setState(&stat.files, rec.section(" ",10,-1), Conflict); }
+    else if(type=='1' || type=='2'){
+      QString xy = rec.section(" ",1,1);
+      FileState state = (xy.startsWith("A") && xy.endsWith(".")) ? Added : Modified;
+      setState(&stat.files, rec.section(" ", (type=='1' ? 8 : 9), -1), state);
+      if(type=='2'){ i++; } //skip the original path of the rename/copy
+    }
+  }
+  repos.insert(root, stat);
+  emit StatusChanged(root);
+}
@@ -14,6 +14,8 @@
 #include <QProcessEnvironment>
 #include <QDebug>
 #include <QTemporaryFile>
+#include <QHash>
+#include <QDateTime>
 #include <LuminaUtils.h>
 
 #include <unistd.h>
@@ -49,17 +51,16 @@ public:
 	  return LUtils::isValidBinary(bin);
 	}
 
+	//Return the top-level directory of the repository containing this dir (empty if not in a repository)
+	//  (just looks for ".git" in the parent directories - results are cached)
+	static QString repoRoot(QString dir);
+
 	//Return if the current directory is a git repository
 	static bool isRepo(QString dir){
-	  QProcess P;
-	  P.setProcessEnvironment(QProcessEnvironment::systemEnvironment());
-	  P.setWorkingDirectory(dir);
-	  P.start("git",QStringList() <<"status" << "--porcelain" );
-	  P.waitForFinished();
-          return (0==P.exitCode());
+	  return !repoRoot(dir).isEmpty();
 	}
 
-	//Return the current status of the repository
+	//Return the current status of the repository (blocking - see GitStatusCache for the background version)
 	static QString status(QString dir){
 	  QProcess P;
 	  P.setProcessEnvironment(QProcessEnvironment::systemEnvironment());
@@ -85,4 +86,40 @@ public:
  	  return P;
 	}
 };
+
+//Background "git status" runner with the results cached per repository
+//  - Only re-runs when the repository index changes (or the results are more than a few seconds old)
+//  - Emits StatusChanged(root) when new results are available
+class GitStatusCache : public QObject{
+	Q_OBJECT
+public:
+	enum FileState{ Clean, Modified, Added, Untracked, Conflict };
+
+	static GitStatusCache* instance(); //shared by all the browsers
+
+	//Start loading the status of the repository containing this directory (if needed)
+	void request(QString dir);
+	//Current (cached) state of a file or directory within the given repository root (GIT::repoRoot()) - never waits on git
+	FileState state(QString root, QString path);
+
+private:
+	struct RepoStatus{
+		qint64 indexTime; //mtime of the index file when the status was read
+		QDateTime checked;
+		QHash<QString, FileState> files; //relative path -> state (directories get the "worst" state of their contents)
+	};
+	QHash<QString, RepoStatus> repos; //[root, status]
+	QHash<QString, QProcess*> running; //[root, process]
+
+	GitStatusCache();
+	~GitStatusCache();
+	static qint64 indexTime(QString root);
+	static void setState(QHash<QString, FileState> *files, QString path, FileState state);
+
+private slots:
+	void processFinished();
+
+signals:
+	void StatusChanged(QString); //repository root
+};
 #endif
@@ -21,13 +21,15 @@ SOURCES += main.cpp \
 		Browser.cpp \
 		BrowserWidget.cpp \
 		TrayUI.cpp \
-		OPWidget.cpp
+		OPWidget.cpp \
+		ZFSCache.cpp
 
 HEADERS  += MainUI.h \
 		FODialog.h \
 		BMMDialog.h \
 		ScrollDialog.h \
 		DirData.h \
+		ZFSCache.h \
 		widgets/DDListWidgets.h \
 		widgets/MultimediaWidget.h \
 		widgets/SlideshowWidget.h \
@@ -438,17 +438,31 @@ void DirWidget::fileCheckSums(){
   QStringList files = currentBrowser()->currentSelection();
   if(files.isEmpty()){ return; }
   qDebug() << "Run Checksums:" << files;
-  QStringList info = LOS::Checksums(files);
-  qDebug() << " - Info:" << info;
-  if(info.isEmpty() || (info.length() != files.length()) ){ return; }
-  for(int i=0; i<info.length(); i++){
-    info[i] = QString("%2\n\t(%1)").arg(files[i].section("/",-1), info[i]);
+  if(!csumDlg.isNull()){ csumDlg->close(); } //cancel the previous run
+  //Show the dialog right away and fill in the sums as they finish (hashing runs on a thread pool)
+  csumFiles = files;
+  csumInfo.clear();
+  for(int i=0; i<files.length(); i++){
+    csumInfo << QString("%2\n\t(%1)").arg(files[i].section("/",-1), tr("Calculating..."));
   }
-  ScrollDialog dlg(this);
-    dlg.setWindowTitle( tr("File Checksums:") );
-    dlg.setWindowIcon( LXDG::findIcon("document-encrypted","") );
-    dlg.setText(info.join("\n"));
-  dlg.exec();
+  csumDlg = new ScrollDialog(this);
+    csumDlg->setAttribute(Qt::WA_DeleteOnClose); //also cancels any remaining checksums
+    csumDlg->setWindowTitle( tr("File Checksums:") );
+    csumDlg->setWindowIcon( LXDG::findIcon("document-encrypted","") );
+    csumDlg->setText(csumInfo.join("\n"));
+  LChecksums *sums = new LChecksums(csumDlg);
+  connect(sums, SIGNAL(FileFinished(QString, QString)), this, SLOT(fileCheckSumAvailable(QString, QString)) );
+  csumDlg->show();
+  sums->start(files, LChecksums::MD5);
+}
+
+void DirWidget::fileCheckSumAvailable(QString file, QString sum){
+  if(csumDlg.isNull()){ return; } //dialog already closed
+  int index = csumFiles.indexOf(file);
+  if(index<0){ return; }
+  if(sum.isEmpty()){ sum = tr("Could not read file"); }
+  csumInfo[index] = QString("%2\n\t(%1)").arg(file.section("/",-1), sum);
+  csumDlg->setText(csumInfo.join("\n"));
 }
 
 void DirWidget::fileProperties(){
@@ -17,8 +17,10 @@
 #include <QFileSystemWatcher>
 #include <QTimer>
 #include <QFuture>
+#include <QPointer>
 
 #include "../BrowserWidget.h"
+#include "../ScrollDialog.h"
 
 
 #define ZSNAPDIR QString("/.zfs/snapshot/")
@@ -68,6 +70,8 @@ private:
 	QString ID, cBID; //unique ID assigned by the parent, and currently active browser widget
 	QString normalbasedir, snapbasedir, snaprelpath; //for maintaining directory context while moving between snapshots
 	QStringList snapshots, needThumbs, tmpSel;
+	QPointer<ScrollDialog> csumDlg; //checksum results (filled in as they finish)
+	QStringList csumFiles, csumInfo;
 	bool canmodify;
 
 	//The Toolbar and associated items
@@ -112,6 +116,7 @@ private slots:
 
 	// - Other Actions without a specific button on the side
 	void fileCheckSums();
+	void fileCheckSumAvailable(QString, QString); //file path, checksum
 	void fileProperties();
 	void openTerminal();
 	
@@ -8,17 +8,176 @@
 #include "ui_SlideshowWidget.h"
 
 #include <QImageWriter>
+#include <QImageReader>
 #include <QMessageBox>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+#include <string.h> //memcmp
+
+#define JPEG_HEADER_SIZE 131072 //amount of the file to read when looking for the EXIF data
+
+// ========================
+//  JPEG/EXIF ORIENTATION (internal)
+// ========================
+//Rotating a JPEG just changes the EXIF orientation tag (1-8) - the image data is never re-encoded
+static const int ORIENT_CW[9] = {1, 6, 7, 8, 5, 2, 3, 4, 1};
+static const int ORIENT_CCW[9] = {1, 8, 5, 6, 7, 4, 1, 2, 3};
+
+struct JpegHeader{
+  qint64 orientPos; //file offset of the 2-byte orientation value (-1: not found)
+  bool littleEndian;
+  bool hasExif;
+  int insertPos; //where a new EXIF segment can go (-1: unknown)
+};
+
+static quint16 readU16(const uchar *p, bool le){ return le ? (p[0] | (p[1]<<8)) : ((p[0]<<8) | p[1]); }
+static quint32 readU32(const uchar *p, bool le){
+  return le ? (p[0] | (p[1]<<8) | (p[2]<<16) | ((quint32)p[3]<<24)) : (((quint32)p[0]<<24) | (p[1]<<16) | (p[2]<<8) | p[3]);
+}
+
+static bool isJpeg(const QByteArray &data){
+  return (data.size()>3 && (uchar)data[0]==0xFF && (uchar)data[1]==0xD8);
+}
+
+static JpegHeader parseJpegHeader(const QByteArray &data){
+  JpegHeader info;
+  info.orientPos = -1; info.littleEndian = false; info.hasExif = false; info.insertPos = -1;
+  if(!isJpeg(data)){ return info; }
+  const uchar *d = (const uchar*) data.constData();
+  int len = data.size();
+  int pos = 2; int insert = 2;
+  while(pos+4 <= len){
+    if(d[pos]!=0xFF){ return info; } //corrupt
+    uchar marker = d[pos+1];
+    if(marker==0xFF){ pos++; continue; } //fill byte
+    if(marker==0xDA || marker==0xD9){ info.insertPos = insert; return info; } //start of image data - no more headers
+    int seglen = (d[pos+2]<<8) | d[pos+3];
+    if(seglen<2){ return info; }
+    if(marker==0xE0){ insert = pos+2+seglen; } //keep the JFIF segment first
+    if(marker==0xE1 && pos+10<=len && memcmp(d+pos+4, "Exif\0\0", 6)==0){
+      info.hasExif = true;
+      int tiff = pos+10;
+      int end = qMin(len, pos+2+seglen);
+      if(tiff+8>end){ return info; }
+      bool le = (d[tiff]=='I');
+      int ifd = tiff + readU32(d+tiff+4, le);
+      if(ifd<tiff || ifd+2>end){ return info; }
+      int count = readU16(d+ifd, le);
+      for(int i=0; i<count; i++){
+        int entry = ifd+2+i*12;
+        if(entry+12>end){ break; }
+        //Tag 0x0112: one SHORT (stored within the entry itself)
+        if(readU16(d+entry, le)==0x0112 && readU16(d+entry+2, le)==3 && readU32(d+entry+4, le)==1){
+          info.orientPos = entry+8;
+          info.littleEndian = le;
+          break;
+        }
+      }
+      return info;
+    }
+    pos += 2+seglen;
+  }
+  return info;
+}
+
+static QByteArray readHeader(QString filepath){
+  QFile file(filepath);
+  if(!file.open(QIODevice::ReadOnly)){ return QByteArray(); }
+  return file.read(JPEG_HEADER_SIZE);
+}
+
+static int jpegOrientation(const QByteArray &header){
+  JpegHeader info = parseJpegHeader(header);
+  if(info.orientPos<0){ return 1; }
+  int val = readU16( (const uchar*) header.constData()+info.orientPos, info.littleEndian);
+  return (val>=1 && val<=8) ? val : 1;
+}
+
+static bool setJpegOrientation(QString filepath, int orient){
+  QByteArray header = readHeader(filepath);
+  JpegHeader info = parseJpegHeader(header);
+  if(info.orientPos>=0){
+    //Just change the existing value in place (2 bytes)
+    QFile file(filepath);
+    if(!file.open(QIODevice::ReadWrite) || !file.seek(info.orientPos)){ return false; }
+    char val[2];
+    if(info.littleEndian){ val[0] = orient; val[1] = 0; }
+    else{ val[0] = 0; val[1] = orient; }
+    return (file.write(val, 2)==2);
+  }else if(!info.hasExif && info.insertPos>0){
+    //No EXIF data yet - insert a minimal segment with just the orientation tag
+    QByteArray seg;
+    seg.append("\xFF\xE1\x00\x22", 4); //APP1 marker + length (34)
+    seg.append("Exif\0\0", 6);
+    seg.append("MM\x00\x2A\x00\x00\x00\x08", 8); //big-endian TIFF header, IFD0 at offset 8
+    seg.append("\x00\x01", 2); //1 entry
+    seg.append("\x01\x12\x00\x03\x00\x00\x00\x01", 8); //orientation, SHORT, count 1
+    seg.append((char) 0); seg.append((char) orient); seg.append("\x00\x00", 2); //value
+    seg.append("\x00\x00\x00\x00", 4); //no next IFD
+    QFile file(filepath);
+    if(!file.open(QIODevice::ReadOnly)){ return false; }
+    QByteArray data = file.readAll();
+    file.close();
+    data.insert(info.insertPos, seg);
+    QSaveFile out(filepath);
+    if(!out.open(QIODevice::WriteOnly)){ return false; }
+    out.write(data);
+    return out.commit();
+  }
+  return false; //EXIF data without an orientation tag - needs the IFD rewritten
+}
+
+static QImage applyOrientation(QImage img, int orient){
+  switch(orient){
+    case 2: return img.mirrored(true, false);
+    case 3: return img.mirrored(true, true);
+    case 4: return img.mirrored(false, true);
+    case 5: return img.mirrored(true, false).transformed(QTransform().rotate(270));
+    case 6: return img.transformed(QTransform().rotate(90));
+    case 7: return img.mirrored(true, false).transformed(QTransform().rotate(90));
+    case 8: return img.transformed(QTransform().rotate(270));
+  }
+  return img;
+}
+
+// ========================
+//  DECODING (worker thread)
+// ========================
+static SlideImage decodeImage(SlideImage info){
+  QImageReader reader(info.file);
+#if QT_VERSION >= 0x050500
+  reader.setAutoTransform(false); //orientation is handled below
+#endif
+  QByteArray header = readHeader(info.file);
+  int orient = isJpeg(header) ? jpegOrientation(header) : 1;
+  bool swap = (orient>=5); //rotated 90 degrees - width/height are swapped
+  QSize full = reader.size();
+  if(full.isValid()){ info.fullsize = swap ? full.transposed() : full; }
+  if(!info.target.isEmpty() && info.fullsize.isValid()){
+    //Let the decoder do the scaling (JPEG can skip most of the work for large reductions)
+    if(info.fullsize.width()>info.target.width() || info.fullsize.height()>info.target.height()){
+      QSize sz = info.fullsize.scaled(info.target, Qt::KeepAspectRatio);
+      reader.setScaledSize( swap ? sz.transposed() : sz );
+    }
+  }
+  info.img = applyOrientation(reader.read(), orient);
+  if(!info.fullsize.isValid()){ info.fullsize = info.img.size(); }
+  return info;
+}
 
 SlideshowWidget::SlideshowWidget(QWidget *parent) : QWidget(parent), ui(new Ui::SlideshowWidget){
   ui->setupUi(this); //load the designer file
   zoom = 1;
+  loader = new QFutureWatcher<SlideImage>(this);
+    connect(loader, SIGNAL(finished()), this, SLOT(loadFinished()) );
   UpdateIcons();
   UpdateText();	
 }
 
 SlideshowWidget::~SlideshowWidget(){
-	
+  loadQueue.clear();
+  loader->waitForFinished();
 }
 
 // ================
@@ -26,6 +185,9 @@ SlideshowWidget::~SlideshowWidget(){
 // ================
 void SlideshowWidget::ClearImages(){
   ui->combo_image_name->clear();	
+  loadQueue.clear();
+  cache.clear();
+  fullImg = SlideImage();
 }
 
 void SlideshowWidget::LoadImages(QList<LFileInfo> list){
@@ -62,14 +224,106 @@ void SlideshowWidget::UpdateText(){
 // =================
 //       PRIVATE
 // =================
+QSize SlideshowWidget::viewSize(){
+  return ui->scrollArea->contentsRect().size();
+}
+
+void SlideshowWidget::queueLoad(QString file, QSize target, bool priority){
+  if(loader->isRunning() && loading.file==file && loading.target==target){ return; } //already running
+  for(int i=0; i<loadQueue.length(); i++){
+    if(loadQueue[i].file==file && loadQueue[i].target==target){
+      if(priority){ loadQueue.move(i, 0); }
+      startNextLoad();
+      return;
+    }
+  }
+  SlideImage info;
+    info.file = file;
+    info.target = target;
+  if(priority){ loadQueue.prepend(info); }
+  else{ loadQueue << info; }
+  startNextLoad();
+}
+
+void SlideshowWidget::startNextLoad(){
+  if(loader->isRunning()){ return; }
+  int index = ui->combo_image_name->currentIndex();
+  while(!loadQueue.isEmpty()){
+    loading = loadQueue.takeFirst();
+    //Skip anything which is not near the current image anymore (paging quickly through the list)
+    bool keep = false;
+    for(int i=index-1; i<=index+1 && !keep; i++){
+      keep = (i>=0 && i<ui->combo_image_name->count() && ui->combo_image_name->itemData(i).toString()==loading.file);
+    }
+    if(!keep){ continue; }
+    loader->setFuture( QtConcurrent::run(decodeImage, loading) );
+    return;
+  }
+}
+
+void SlideshowWidget::showImage(){
+  QString file = ui->combo_image_name->currentData().toString();
+  if(!cache.contains(file)){ return; }
+  SlideImage info = cache.value(file);
+  if(info.img.isNull()){ ui->label_image->setPixmap(QPixmap()); return; } //could not be read
+  QSize sz = viewSize();
+  if( sz.width()>info.fullsize.width() || sz.height()>info.fullsize.height()){ sz = info.fullsize; } //100% size already - apply zoom after this
+  sz = sz*zoom;
+  QImage src = info.img;
+  QSize out = info.fullsize.scaled(sz, Qt::KeepAspectRatio);
+  if(out.width()>src.width() || out.height()>src.height()){
+    //Zoomed in past the viewport-sized version: use the full-resolution image
+    if(fullImg.file==file && !fullImg.img.isNull()){ src = fullImg.img; }
+    else{ queueLoad(file, QSize(), true); } //show the scaled-up version until it is ready
+  }
+  if(src.size()==out){ ui->label_image->setPixmap( QPixmap::fromImage(src) ); }
+  else{ ui->label_image->setPixmap( QPixmap::fromImage(src.scaled(out, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)) ); }
+}
+
+void SlideshowWidget::rotateImage(bool clockwise){
+  QString file = ui->combo_image_name->currentData().toString();
+  QByteArray header = readHeader(file);
+  bool done = false;
+  if(isJpeg(header)){
+    //Lossless: just change the EXIF orientation
+    int orient = jpegOrientation(header);
+    done = setJpegOrientation(file, clockwise ? ORIENT_CW[orient] : ORIENT_CCW[orient]);
+  }
+  if(!done){
+    //Rotate the image data itself (90 degree steps are exact) and save it back to the same file
+    QImage img(file);
+    img = img.transformed( QTransform().rotate(clockwise ? 90 : -90) );
+    img.save(file);
+  }
+  //Now re-load the image in the UI
+  cache.remove(file);
+  if(fullImg.file==file){ fullImg = SlideImage(); }
+  UpdateImage();
+}
+
 void SlideshowWidget::UpdateImage(){
   QString file = ui->combo_image_name->currentData().toString();
   qDebug() << "Show Image:" << file << "Zoom:" << zoom;
-  QPixmap pix(file);
-    QSize sz = ui->scrollArea->contentsRect().size();
-    if( sz.width()>pix.size().width() || sz.height()>pix.size().height()){ sz = pix.size(); } //100% size already - apply zoom after this
-    pix = pix.scaled(sz*zoom, Qt::KeepAspectRatio, Qt::SmoothTransformation); 
-  ui->label_image->setPixmap(pix);
+  QSize view = viewSize();
+  int index = ui->combo_image_name->currentIndex();
+  //Only keep the current image and its neighbors around
+  QStringList ring;
+  for(int i=index-1; i<=index+1; i++){
+    if(i>=0 && i<ui->combo_image_name->count()){ ring << ui->combo_image_name->itemData(i).toString(); }
+  }
+  QStringList cached = cache.keys();
+  for(int i=0; i<cached.length(); i++){
+    if(!ring.contains(cached[i])){ cache.remove(cached[i]); }
+  }
+  if(fullImg.file!=file){ fullImg = SlideImage(); }
+  //Show the image (or start loading it)
+  if(cache.contains(file)){ showImage(); } //otherwise keep the last image up until this one is ready
+  if(!cache.contains(file) || cache[file].target!=view){ queueLoad(file, view, true); }
+  //Decode the neighbors ahead of time
+  for(int i=0; i<ring.length(); i++){
+    if(ring[i]==file){ continue; }
+    if(!cache.contains(ring[i]) || cache[ring[i]].target!=view){ queueLoad(ring[i], view); }
+  }
   //Now set/load the buttons
   ui->tool_image_goBegin->setEnabled(ui->combo_image_name->currentIndex()>0);
   ui->tool_image_goPrev->setEnabled(ui->combo_image_name->currentIndex()>0);
@@ -81,7 +335,8 @@ void SlideshowWidget::UpdateImage(){
     writeableformats  = QImageWriter::supportedImageFormats();
     qDebug() << "Writeable image formats:" << writeableformats;
   }
-  bool canwrite = writeableformats.contains(file.section(".",-1).toLower().toLocal8Bit()); //compare the suffix with the list
+  QString suffix = file.section(".",-1).toLower();
+  bool canwrite = (suffix=="jpg" || suffix=="jpeg") || writeableformats.contains(suffix.toLocal8Bit()); //JPEG gets rotated without re-encoding
   bool isUserWritable = QFileInfo(file).isWritable();
   ui->tool_image_remove->setEnabled(isUserWritable);
   ui->tool_image_rotateleft->setEnabled(isUserWritable && canwrite);
@@ -94,6 +349,25 @@ void SlideshowWidget::UpdateImage(){
 // =================
 //    PRIVATE SLOTS
 // =================
+void SlideshowWidget::loadFinished(){
+  SlideImage info = loader->result();
+  QString file = ui->combo_image_name->currentData().toString();
+  if(!info.target.isValid()){
+    if(info.file==file){ fullImg = info; }
+  }else{
+    //Make sure it is still one of the images around the current one
+    int index = ui->combo_image_name->currentIndex();
+    for(int i=index-1; i<=index+1; i++){
+      if(i>=0 && i<ui->combo_image_name->count() && ui->combo_image_name->itemData(i).toString()==info.file){
+        cache.insert(info.file, info);
+        break;
+      }
+    }
+  }
+  if(info.file==file){ showImage(); }
+  startNextLoad();
+}
+
 // Picture rotation options
 void SlideshowWidget::on_combo_image_name_currentIndexChanged(int index){
   if(index>=0 && !ui->combo_image_name->currentData().toString().isEmpty()){
@@ -126,35 +400,18 @@ void SlideshowWidget::on_tool_image_remove_clicked(){
     return; //cancelled
   }
   if( QFile::remove(file) ){
+    cache.remove(file);
     int index = ui->combo_image_name->currentIndex();
     ui->combo_image_name->removeItem( index );
   }
 }
 
 void SlideshowWidget::on_tool_image_rotateleft_clicked(){
-  //First load the file fresh (not the scaled version in the UI)
-  QString file = ui->combo_image_name->currentData().toString();
-  QPixmap pix(file);	
-  //Now rotate the image 90 degrees counter-clockwise
-  QTransform trans;
-  pix = pix.transformed( trans.rotate(-90) , Qt::SmoothTransformation);
-  //Now save the image back to the same file
-  pix.save(file);
-  //Now re-load the image in the UI
-  UpdateImage();	
+  rotateImage(false); //90 degrees counter-clockwise
 }
 
 void SlideshowWidget::on_tool_image_rotateright_clicked(){
-  //First load the file fresh (not the scaled version in the UI)
-  QString file = ui->combo_image_name->currentData().toString();
-  QPixmap pix(file);	
-  //Now rotate the image 90 degrees counter-clockwise
-  QTransform trans;
-  pix = pix.transformed( trans.rotate(90) , Qt::SmoothTransformation);
-  //Now save the image back to the same file
-  pix.save(file);
-  //Now re-load the image in the UI
-  UpdateImage();	
+  rotateImage(true); //90 degrees clockwise
 }
 
 void SlideshowWidget::on_tool_image_zoomin_clicked(){
@@ -10,6 +10,9 @@
 #include <QList>
 #include <QWidget>
 #include <QObject>
+#include <QHash>
+#include <QImage>
+#include <QFutureWatcher>
 
 #include "../DirData.h"
 
@@ -17,6 +20,14 @@ namespace Ui{
 	class SlideshowWidget;
 };
 
+//Decoded image (loaded on a background thread)
+struct SlideImage{
+	QString file;
+	QImage img; //image with the orientation already applied
+	QSize fullsize; //full-resolution size of the image (after orientation)
+	QSize target; //requested size (invalid: full resolution)
+};
+
 class SlideshowWidget : public QWidget{
 	Q_OBJECT
 public:
@@ -37,8 +48,22 @@ private:
 	Ui::SlideshowWidget *ui;
 	void UpdateImage();
 	double zoom;
-	
+	//Decoding pipeline
+	QHash<QString, SlideImage> cache; //viewport-sized images (current and neighbors)
+	SlideImage fullImg; //full-resolution version of the current image (only loaded when zoomed in)
+	QList<SlideImage> loadQueue; //pending decodes (file/target only)
+	QFutureWatcher<SlideImage> *loader;
+	SlideImage loading; //decode currently running
+
+	QSize viewSize();
+	void queueLoad(QString file, QSize target, bool priority = false);
+	void startNextLoad();
+	void showImage();
+	void rotateImage(bool clockwise);
+
 private slots:
+	void loadFinished();
+
 	// Picture rotation options
 	void on_combo_image_name_currentIndexChanged(int index);
 	void on_tool_image_goEnd_clicked();
@@ -54,4 +79,4 @@ private slots:
 	void on_tool_image_zoomout_clicked();
 
 };
-#endif
\ No newline at end of file
+#endif
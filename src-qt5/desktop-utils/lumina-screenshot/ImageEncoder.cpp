@@ -0,0 +1,169 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+#include "ImageEncoder.h"
+
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QVector>
+#include <QThread>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <zlib.h>
+
+#define PNG_STRIP_MINROWS 64 //never split the image into strips smaller than this
+#define PNG_IDAT_MAXSIZE 1048576 //split the compressed data into 1MB IDAT chunks
+
+//One horizontal band of the image: filtered and deflated independently of the others
+struct PNGStrip{
+  const QImage *img;
+  int firstrow, lastrow, bpp, level;
+  bool last; //last strip in the image (terminates the deflate stream)
+  QByteArray data; //raw deflate output
+  quint32 adler; //adler32 of the uncompressed (filtered) rows
+  qint64 rawlen; //length of the uncompressed (filtered) rows
+};
+
+// === PNG utility functions ===
+static void appendUInt32(QByteArray *out, quint32 val){
+  out->append( (char) ((val>>24) & 0xFF) );
+  out->append( (char) ((val>>16) & 0xFF) );
+  out->append( (char) ((val>>8) & 0xFF) );
+  out->append( (char) (val & 0xFF) );
+}
+
+static void writeChunk(QSaveFile *file, const char *type, const char *data, int len){
+  QByteArray head;
+  appendUInt32(&head, len);
+  head.append(type, 4);
+  uLong crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc, (const Bytef*) type, 4);
+  if(len>0){ crc = crc32(crc, (const Bytef*) data, len); }
+  QByteArray tail;
+  appendUInt32(&tail, crc);
+  file->write(head);
+  if(len>0){ file->write(data, len); }
+  file->write(tail);
+}
+
+static void deflateStrip(PNGStrip &strip){
+  //Filter all the rows with the "Sub" filter (cheap, and does well on screen contents)
+  int rowlen = strip.img->width()*strip.bpp;
+  QByteArray raw;
+  raw.resize( (rowlen+1) * (strip.lastrow-strip.firstrow) );
+  uchar *out = (uchar*) raw.data();
+  for(int y=strip.firstrow; y<strip.lastrow; y++){
+    const uchar *line = strip.img->constScanLine(y);
+    *out = 1; out++; //filter type
+    for(int i=0; i<strip.bpp && i<rowlen; i++){ out[i] = line[i]; }
+    for(int i=strip.bpp; i<rowlen; i++){ out[i] = line[i] - line[i-strip.bpp]; }
+    out += rowlen;
+  }
+  strip.rawlen = raw.size();
+  strip.adler = adler32(adler32(0L, Z_NULL, 0), (const Bytef*) raw.constData(), raw.size());
+  //Now compress the strip as a raw deflate stream
+  //  Every strip but the last ends on a byte boundary (sync flush) so they can be concatenated
+  z_stream zs;
+  zs.zalloc = Z_NULL; zs.zfree = Z_NULL; zs.opaque = Z_NULL;
+  if(Z_OK != deflateInit2(&zs, strip.level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) ){ return; }
+  strip.data.resize( deflateBound(&zs, raw.size()) + 16 );
+  zs.next_in = (Bytef*) raw.data();
+  zs.avail_in = raw.size();
+  zs.next_out = (Bytef*) strip.data.data();
+  zs.avail_out = strip.data.size();
+  deflate(&zs, strip.last ? Z_FINISH : Z_SYNC_FLUSH);
+  strip.data.resize( strip.data.size() - zs.avail_out );
+  deflateEnd(&zs);
+}
+
+//==============
+//  PUBLIC
+//==============
+bool ImageEncoder::Save(QImage img, QString filepath, Options opts){
+  QString suffix = QFileInfo(filepath).suffix().toLower();
+  if(suffix=="jpg" || suffix=="jpeg"){ return SaveWithQuality(img, filepath, "jpg", opts.quality); }
+  else if(suffix=="webp"){ return SaveWithQuality(img, filepath, "webp", opts.quality); }
+  else{ return SavePNG(img, filepath, opts.pngLevel, opts.pngThreads); }
+}
+
+bool ImageEncoder::SavePNG(QImage img, QString filepath, int level, bool threaded){
+  if(img.isNull()){ return false; }
+  if(level<0){ level = 0; }
+  else if(level>9){ level = 9; }
+  //Convert to a byte-ordered format which PNG can use directly (RGB or RGBA, 8 bits per channel)
+  bool alpha = img.hasAlphaChannel();
+  img = img.convertToFormat( alpha ? QImage::Format_RGBA8888 : QImage::Format_RGB888 );
+  int bpp = alpha ? 4 : 3;
+  //Split the image into strips
+  int nstrips = 1;
+  if(threaded){
+    nstrips = qMin(QThread::idealThreadCount(), img.height()/PNG_STRIP_MINROWS);
+    if(nstrips<1){ nstrips = 1; }
+  }
+  QVector<PNGStrip> strips(nstrips);
+  int rows = img.height()/nstrips;
+  for(int i=0; i<nstrips; i++){
+    strips[i].img = &img;
+    strips[i].firstrow = i*rows;
+    strips[i].lastrow = (i==nstrips-1) ? img.height() : (i+1)*rows;
+    strips[i].bpp = bpp;
+    strips[i].level = level;
+    strips[i].last = (i==nstrips-1);
+    strips[i].adler = 1;
+    strips[i].rawlen = 0;
+  }
+  if(nstrips>1){ QtConcurrent::blockingMap(strips, deflateStrip); }
+  else{ deflateStrip(strips[0]); }
+  //Assemble the zlib stream: header + strips + combined adler32 checksum
+  QByteArray zdata;
+  zdata.append( (char) 0x78 ); zdata.append( (char) 0x9C );
+  uLong adler = adler32(0L, Z_NULL, 0);
+  for(int i=0; i<nstrips; i++){
+    if(strips[i].data.isEmpty()){ qDebug() << "Could not compress image:" << filepath; return false; }
+    zdata.append(strips[i].data);
+    adler = adler32_combine(adler, strips[i].adler, strips[i].rawlen);
+    strips[i].data.clear(); //free the memory as we go
+  }
+  appendUInt32(&zdata, adler);
+  //Now write the file
+  QSaveFile file(filepath);
+  if( !file.open(QIODevice::WriteOnly) ){ return false; }
+  file.write("\x89PNG\r\n\x1a\n", 8);
+  QByteArray ihdr;
+  appendUInt32(&ihdr, img.width());
+  appendUInt32(&ihdr, img.height());
+  ihdr.append( (char) 8 ); //bit depth
+  ihdr.append( (char) (alpha ? 6 : 2) ); //color type: RGBA or RGB
+  ihdr.append( (char) 0 ); //compression
+  ihdr.append( (char) 0 ); //filter method
+  ihdr.append( (char) 0 ); //no interlace
+  writeChunk(&file, "IHDR", ihdr.constData(), ihdr.size());
+  for(int i=0; i<zdata.size(); i+=PNG_IDAT_MAXSIZE){
+    writeChunk(&file, "IDAT", zdata.constData()+i, qMin(PNG_IDAT_MAXSIZE, zdata.size()-i) );
+  }
+  writeChunk(&file, "IEND", 0, 0);
+  return file.commit();
+}
+
+bool ImageEncoder::SaveWithQuality(QImage img, QString filepath, QByteArray format, int quality){
+  if(img.isNull()){ return false; }
+  QImageWriter writer(filepath, format);
+  if(!writer.canWrite()){ qDebug() << "Cannot write image format:" << format << writer.errorString(); return false; }
+  writer.setQuality(quality);
+  if(format=="jpg" && img.hasAlphaChannel()){ img = img.convertToFormat(QImage::Format_RGB32); }
+  return writer.write(img);
+}
+
+QStringList ImageEncoder::availableFormats(){
+  QStringList formats;
+  formats << "png";
+  QList<QByteArray> supported = QImageWriter::supportedImageFormats();
+  if(supported.contains("jpg")){ formats << "jpg"; }
+  if(supported.contains("webp")){ formats << "webp"; }
+  return formats;
+}
@@ -0,0 +1,40 @@
+//===========================================
+//  Lumina-DE source code
+//  Copyright (c) 2016, Ken Moore
+//  Available under the 3-clause BSD license
+//  See the LICENSE file for full details
+//===========================================
+// This is a set of static functions for writing screenshots to disk
+//   (thread-safe - intended to be run off the GUI thread)
+// PNG files are written directly with zlib so that the compression level can be chosen
+//   and large images can be deflated in parallel strips
+//===========================================
+#ifndef _LUMINA_SCREENSHOT_IMAGE_ENCODER_H
+#define _LUMINA_SCREENSHOT_IMAGE_ENCODER_H
+
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+class ImageEncoder{
+public:
+	struct Options{
+	  int pngLevel; //0-9 (zlib compression level)
+	  int quality; //1-100 (JPEG/WebP)
+	  bool pngThreads; //compress PNG strips in parallel
+	  Options(){ pngLevel = 6; quality = 90; pngThreads = true; }
+	};
+
+	//Save the image - the format is determined from the file extension (PNG by default)
+	static bool Save(QImage img, QString filepath, Options opts);
+
+	//Individual encoders
+	static bool SavePNG(QImage img, QString filepath, int level, bool threaded);
+	static bool SaveWithQuality(QImage img, QString filepath, QByteArray format, int quality);
+
+	//List of the formats which can be written (lowercase file extensions: "png", "jpg", "webp")
+	static QStringList availableFormats();
+};
+
+#endif
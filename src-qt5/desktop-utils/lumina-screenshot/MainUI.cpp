@@ -8,6 +8,7 @@
 #include "ui_MainUI.h"
 
 #include <LuminaX11.h>
+#include <QtConcurrent>
 
 MainUI::MainUI() : QMainWindow(), ui(new Ui::MainUI){
   ui->setupUi(this); //load the designer file
@@ -17,6 +18,8 @@ MainUI::MainUI() : QMainWindow(), ui(new Ui::MainUI){
   ui->scrollArea->setWidget(IMG);
   ui->tabWidget->setCurrentWidget(ui->tab_view);
   ppath = QDir::homePath();
+  saveWatcher = new QFutureWatcher<bool>(this);
+  openAfterSave = false;
 
   setupIcons();
   ui->spin_monitor->setMaximum(QApplication::desktop()->screenCount());
@@ -35,6 +38,7 @@ MainUI::MainUI() : QMainWindow(), ui(new Ui::MainUI){
   connect(ui->actionTake_Screenshot, SIGNAL(triggered()), this, SLOT(startScreenshot()) );
   connect(ui->tool_crop, SIGNAL(clicked()), IMG, SLOT(cropImage()) );
   connect(IMG, SIGNAL(selectionChanged(bool)), this, SLOT(imgselchanged(bool)) );
+  connect(saveWatcher, SIGNAL(finished()), this, SLOT(saveFinished()) );
 
   settings = new QSettings("lumina-desktop", "lumina-screenshot",this);
   if(settings->value("screenshot-target", "window").toString() == "window") {
@@ -43,15 +47,23 @@ MainUI::MainUI() : QMainWindow(), ui(new Ui::MainUI){
 	ui->radio_all->setChecked(true);
   }
   ui->spin_delay->setValue(settings->value("screenshot-delay", 0).toInt());
+  ui->spin_png_level->setValue(settings->value("png-compression", 6).toInt());
+  ui->spin_quality->setValue(settings->value("image-quality", 90).toInt());
+  ui->check_png_threads->setChecked(settings->value("png-threads", true).toBool());
+  connect(ui->spin_png_level, SIGNAL(valueChanged(int)), this, SLOT(saveOptionsChanged()) );
+  connect(ui->spin_quality, SIGNAL(valueChanged(int)), this, SLOT(saveOptionsChanged()) );
+  connect(ui->check_png_threads, SIGNAL(toggled(bool)), this, SLOT(saveOptionsChanged()) );
 
   ui->tool_resize->setVisible(false); //not implemented yet
   this->show();
   IMG->setDefaultSize(ui->scrollArea->maximumViewportSize());
-  IMG->LoadImage( QApplication::screens().at(0)->grabWindow(QApplication::desktop()->winId()).toImage() ); //initial screenshot
+  IMG->LoadImage( XCB->WindowImage() ); //initial screenshot
   //ui->label_screenshot->setPixmap( cpic.scaled(ui->label_screenshot->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation) );
 }
 
-MainUI::~MainUI(){}
+MainUI::~MainUI(){
+  saveWatcher->waitForFinished(); //make sure the last file gets written out completely
+}
 
 void MainUI::setupIcons(){
   //Setup the icons
@@ -69,26 +81,74 @@ void MainUI::setupIcons(){
   //ui->actionEdit->setIcon( LXDG::findIcon("applications-graphics","") );
 }
 
+ImageEncoder::Options MainUI::saveOptions(){
+  ImageEncoder::Options opts;
+  opts.pngLevel = ui->spin_png_level->value();
+  opts.quality = ui->spin_quality->value();
+  opts.pngThreads = ui->check_png_threads->isChecked();
+  return opts;
+}
+
+void MainUI::startSave(QString filepath, bool openfile){
+  //Encode/write the image in the background - large PNG's can take a while
+  savepath = filepath;
+  openAfterSave = openfile;
+  ui->tool_save->setEnabled(false);
+  ui->tool_quicksave->setEnabled(false);
+  ui->statusbar->showMessage( QString(tr("Saving: %1")).arg(filepath) );
+  saveWatcher->setFuture( QtConcurrent::run(&ImageEncoder::Save, IMG->image(), filepath, saveOptions()) );
+}
+
 //==============
 //  PRIVATE SLOTS
 //==============
 void MainUI::saveScreenshot(){
-  if(mousegrabbed){ return; }
-  QString filepath = QFileDialog::getSaveFileName(this, tr("Save Screenshot"), ppath, tr("PNG Files (*.png);;AllFiles (*)") );
+  if(mousegrabbed || saveWatcher->isRunning()){ return; }
+  QStringList formats = ImageEncoder::availableFormats();
+  QStringList filters;
+  filters << tr("PNG Files (*.png)");
+  if(formats.contains("jpg")){ filters << tr("JPEG Files (*.jpg *.jpeg)"); }
+  if(formats.contains("webp")){ filters << tr("WebP Files (*.webp)"); }
+  filters << tr("AllFiles (*)");
+  QString filter;
+  QString filepath = QFileDialog::getSaveFileName(this, tr("Save Screenshot"), ppath, filters.join(";;"), &filter );
   if(filepath.isEmpty()){ return; }
-  if(!filepath.endsWith(".png")){ filepath.append(".png"); }
-  IMG->image().save(filepath, "png");
+  QString suffix = QFileInfo(filepath).suffix().toLower();
+  if(suffix!="png" && suffix!="jpg" && suffix!="jpeg" && suffix!="webp"){
+    //Use the extension from the selected filter (PNG by default)
+    if(filter.contains("*.jpg")){ filepath.append(".jpg"); }
+    else if(filter.contains("*.webp")){ filepath.append(".webp"); }
+    else{ filepath.append(".png"); }
+  }
+  startSave(filepath, false);
   ppath = filepath;
 }
+
 void MainUI::quicksave(){
-  if(mousegrabbed){ return; }
+  if(mousegrabbed || saveWatcher->isRunning()){ return; }
     QString savedir = QDir::homePath()+"/";
     if(QFile::exists(savedir + "Pictures/")){ savedir.append("Pictures/"); }
     else if(QFile::exists(savedir + "Images/")){ savedir.append("Images/"); }
 
     QString path = savedir + QString( "Screenshot-%1.png" ).arg( QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss") );
-    IMG->image().save(path, "png");
-    QProcess::startDetached("lumina-open \""+path+"\"");
+    startSave(path, true);
+}
+
+void MainUI::saveFinished(){
+  ui->tool_save->setEnabled(true);
+  ui->tool_quicksave->setEnabled(true);
+  if(saveWatcher->result()){
+    ui->statusbar->showMessage( QString(tr("Saved: %1")).arg(savepath), 5000);
+    if(openAfterSave){ QProcess::startDetached("lumina-open \""+savepath+"\""); }
+  }else{
+    ui->statusbar->showMessage( QString(tr("Could not save: %1")).arg(savepath) );
+  }
+}
+
+void MainUI::saveOptionsChanged(){
+  settings->setValue("png-compression", ui->spin_png_level->value());
+  settings->setValue("image-quality", ui->spin_quality->value());
+  settings->setValue("png-threads", ui->check_png_threads->isChecked());
 }
 
 void MainUI::startScreenshot(){
@@ -125,28 +185,24 @@ bool MainUI::getWindow(){
 }
 
 void MainUI::getPixmap(){
-  QScreen *scrn = QApplication::screens().at(0);
-  QPixmap cpic;
+  //Only read the area which is actually needed straight from the X server
+  QImage cpic;
   if( (cwin==0 && ui->radio_window->isChecked() ) || ui->radio_all->isChecked() ){
     //Grab the whole screen
-    cpic = scrn->grabWindow(QApplication::desktop()->winId());
+    cpic = XCB->WindowImage();
   }else if(cwin==0 && ui->radio_monitor->isChecked()){
     QRect geom = QApplication::desktop()->screenGeometry(ui->spin_monitor->value()-1);
-    cpic = scrn->grabWindow(QApplication::desktop()->winId(), geom.x(), geom.y(), geom.width(), geom.height() );
+    cpic = XCB->WindowImage(0, geom);
   }else{
-    //Grab just the designated window
-    if(ui->check_frame->isChecked()){
-      QRect geom = XCB->WindowGeometry(cwin, true); //include the frame
-      cpic = scrn->grabWindow(QApplication::desktop()->winId(), geom.x(), geom.y(), geom.width(), geom.height() );
-    }else{
-      cpic = scrn->grabWindow(cwin);
-    }
+    //Grab just the designated window (as seen on the screen)
+    QRect geom = XCB->WindowGeometry(cwin, ui->check_frame->isChecked());
+    cpic = XCB->WindowImage(0, geom);
   }
   this->show();
   this->setGeometry(lastgeom);
   ui->tabWidget->setCurrentWidget(ui->tab_view); //view it right now
   //Now display the pixmap on the label as well
-  IMG->LoadImage( cpic.toImage() );
+  IMG->LoadImage( cpic );
 }
 
 void MainUI::mouseReleaseEvent(QMouseEvent *ev){
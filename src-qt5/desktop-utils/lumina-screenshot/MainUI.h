@@ -18,12 +18,15 @@
 #include <QSettings>
 #include <QAction>
 #include <QScreen>
+#include <QFutureWatcher>
+#include <QFileInfo>
 
 #include <LuminaXDG.h>
 #include <LuminaUtils.h>
 #include <LuminaX11.h>
 
 #include "ImageEditor.h"
+#include "ImageEncoder.h"
 
 namespace Ui{
 	class MainUI;
@@ -50,6 +53,14 @@ private:
 	//Image Editor widget
 	ImageEditor *IMG;
 
+	//Background save operation
+	QFutureWatcher<bool> *saveWatcher;
+	QString savepath; //file currently being written
+	bool openAfterSave;
+
+	ImageEncoder::Options saveOptions();
+	void startSave(QString filepath, bool openfile);
+
 private slots:
 	//Button Slots
 	void closeApplication(){
@@ -57,6 +68,8 @@ private slots:
 	}
 	void saveScreenshot();
 	void quicksave();
+	void saveFinished();
+	void saveOptionsChanged();
 
 	void startScreenshot();
 
@@ -1,6 +1,6 @@
 include("$${PWD}/../../OS-detect.pri")
 
-QT       += core gui network
+QT       += core gui network concurrent
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets x11extras
 
 
@@ -11,14 +11,16 @@ TEMPLATE = app
 
 SOURCES += main.cpp \
 		MainUI.cpp \
-		ImageEditor.cpp
+		ImageEditor.cpp \
+		ImageEncoder.cpp
 
 HEADERS  += MainUI.h \
-			ImageEditor.h
+			ImageEditor.h \
+			ImageEncoder.h
 
 FORMS    += MainUI.ui
 
-LIBS     += -lLuminaUtils
+LIBS     += -lLuminaUtils -lz
 
 DEPENDPATH	+= ../libLumina
 
@@ -13,6 +13,7 @@
 #include <QDebug>
 #include <QApplication>
 #include <QMessageBox>
+#include <QFileInfo>
 
 #include <LuminaUtils.h>
 
@@ -23,9 +24,11 @@ PlainTextEditor::PlainTextEditor(QSettings *set, QWidget *parent) : QPlainTextEd
   settings = set;
   LNW = new LNWidget(this);
   showLNW = true;
-  watcher = new QFileSystemWatcher(this);
+  LNWmargin = -1;
+  watcher = new LFileWatcher(this);
   hasChanges = false;
   lastSaveContents.clear();
+  lastSaveSize = -1;
   matchleft = matchright = -1;
   this->setTabStopWidth( 8 * this->fontMetrics().width(" ") ); //8 character spaces per tab (UNIX standard)
   //this->setObjectName("PlainTextEditor");
@@ -37,7 +40,7 @@ PlainTextEditor::PlainTextEditor(QSettings *set, QWidget *parent) : QPlainTextEd
   connect(this, SIGNAL(cursorPositionChanged()), this, SLOT(checkMatchChar()) );
   connect(this, SIGNAL(cursorPositionChanged()), this, SLOT(cursorMoved()) );
   connect(this, SIGNAL(textChanged()), this, SLOT(textChanged()) );
-  connect(watcher, SIGNAL(fileChanged(const QString&)), this, SLOT(fileChanged()) );
+  connect(watcher, SIGNAL(PathChanged(QString)), this, SLOT(fileChanged()) );
   LNW_updateWidth();
   LNW_highlightLine();
 }
@@ -64,7 +67,7 @@ void PlainTextEditor::updateSyntaxColors(){
 
 //File loading/setting options
 void PlainTextEditor::LoadFile(QString filepath){
-  if( !watcher->files().isEmpty() ){  watcher->removePaths(watcher->files()); }
+  watcher->clear();
   bool diffFile = (filepath != this->whatsThis());
   this->setWhatsThis(filepath);
   this->clear();
@@ -83,7 +86,8 @@ void PlainTextEditor::LoadFile(QString filepath){
     this->centerCursor(); //scroll until cursor is centered (if possible)
   }
   hasChanges = false;
-  watcher->addPath(filepath);
+  saveFileStamp();
+  watcher->watchPath(filepath);
   emit FileLoaded(this->whatsThis());
 }
 
@@ -97,11 +101,11 @@ void PlainTextEditor::SaveFile(bool newname){
     SYNTAX->loadRules( Custom_Syntax::ruleForFile(this->whatsThis().section("/",-1)) );
     SYNTAX->rehighlight();
   }
-  if( !watcher->files().isEmpty() ){ watcher->removePaths(watcher->files()); }
+  watcher->clear();
   bool ok = LUtils::writeFile(this->whatsThis(), this->toPlainText().split("\n"), true);
   hasChanges = !ok;
-  if(ok){ lastSaveContents = this->toPlainText(); emit FileLoaded(this->whatsThis()); }
-  watcher->addPath(currentFile());
+  if(ok){ lastSaveContents = this->toPlainText(); saveFileStamp(); emit FileLoaded(this->whatsThis()); }
+  watcher->watchPath(currentFile());
   //qDebug() << " - Success:" << ok << hasChanges;
 }
 
@@ -147,6 +151,12 @@ void PlainTextEditor::paintLNW(QPaintEvent *ev){
 //==============
 //       PRIVATE
 //==============
+void PlainTextEditor::saveFileStamp(){
+  QFileInfo info(currentFile());
+  lastSaveTime = info.lastModified();
+  lastSaveSize = info.exists() ? info.size() : -1;
+}
+
 void PlainTextEditor::clearMatchData(){
   if(matchleft>=0 || matchright>=0){
     QList<QTextEdit::ExtraSelection> sel = this->extraSelections();
@@ -163,29 +173,11 @@ void PlainTextEditor::highlightMatch(QChar ch, bool forward, int fromPos, QChar
   if(forward){ matchleft = fromPos;  }
   else{ matchright = fromPos; }
   
-  int nested = 1; //always start within the first nest (the primary nest)
-  int tmpFromPos = fromPos;
-  //if(!forward){ tmpFromPos++; } //need to include the initial location
-  QString doc = this->toPlainText();
-  while( nested>0 && tmpFromPos<doc.length() && ( (tmpFromPos>=fromPos && forward) || ( tmpFromPos<=fromPos && !forward ) ) ){
-    if(forward){
-      QTextCursor cur = this->document()->find(ch, tmpFromPos);
-      if(!cur.isNull()){
-	nested += doc.mid(tmpFromPos+1, cur.position()-tmpFromPos).count(startch) -1;
-	if(nested==0){ matchright = cur.position(); }
-	else{ tmpFromPos = cur.position(); }
-      }else{ break; }
-    }else{
-      QTextCursor cur = this->document()->find(ch, tmpFromPos, QTextDocument::FindBackward);
-      if(!cur.isNull()){ 
-        QString mid = doc.mid(cur.position()-1, tmpFromPos-cur.position()+1);
-        //qDebug() << "Found backwards match:" << nested << startch << ch << mid;
-        //qDebug() << doc.mid(cur.position(),1) << doc.mid(tmpFromPos,1);
-	nested += (mid.count(startch) - mid.count(ch));
-	if(nested==0){ matchleft = cur.position(); }
-	else{ tmpFromPos = cur.position()-1; }
-      }else{ break; }
-    }
+  int match = findMatch(ch, forward, fromPos, startch);
+  if(match>=0){
+    //Note: the other end is stored as the cursor position just past the matching character
+    if(forward){ matchright = match+1; }
+    else{ matchleft = match+1; }
   }
   
   //Now highlight the two characters
@@ -215,20 +207,63 @@ void PlainTextEditor::highlightMatch(QChar ch, bool forward, int fromPos, QChar
   this->setExtraSelections(sels);
 }
 
+int PlainTextEditor::findMatch(QChar ch, bool forward, int fromPos, QChar startch){
+  //Walk the per-block bracket index, skipping any block which cannot contain the match
+  int type = BracketData::typeFor(ch);
+  if(type<0){ return -1; }
+  QTextBlock block = this->document()->findBlock(fromPos);
+  BracketData tmp;
+  int nested = 0;
+  bool first = true;
+  while(block.isValid()){
+    const BracketData *data = BracketData::forBlock(block, &tmp);
+    if(!first){
+      //Whole-block skip: the nesting never gets back down to zero within this block
+      if(forward && (nested + data->minPrefix[type]) > 0){ nested += data->net[type]; block = block.next(); continue; }
+      if(!forward && (nested + data->minSuffix[type]) > 0){ nested -= data->net[type]; block = block.previous(); continue; }
+    }
+    int rel = fromPos - block.position();
+    if(forward){
+      for(int i=0; i<data->brackets.length(); i++){
+        if(first && data->brackets[i].pos < rel){ continue; } //before the starting character
+        if(data->brackets[i].ch == startch){ nested++; }
+        else if(data->brackets[i].ch == ch){
+          nested--;
+          if(nested==0){ return block.position()+data->brackets[i].pos; }
+        }
+      }
+      block = block.next();
+    }else{
+      for(int i=data->brackets.length()-1; i>=0; i--){
+        if(first && data->brackets[i].pos > rel){ continue; } //after the starting character
+        if(data->brackets[i].ch == startch){ nested++; }
+        else if(data->brackets[i].ch == ch){
+          nested--;
+          if(nested==0){ return block.position()+data->brackets[i].pos; }
+        }
+      }
+      block = block.previous();
+    }
+    first = false;
+  }
+  return -1; //no match
+}
+
 //===================
 //       PRIVATE SLOTS
 //===================
 //Functions for managing the line number widget
 void PlainTextEditor::LNW_updateWidth(){
-  if(showLNW){
-    this->setViewportMargins( LNWWidth(), 0, 0, 0); //the LNW is contained within the left margin
-  }else{
-    this->setViewportMargins( 0, 0, 0, 0); //the LNW is contained within the left margin
-  }
+  int margin = (showLNW ? LNWWidth() : 0); //the LNW is contained within the left margin
+  if(margin == LNWmargin){ return; } //no change - skip the re-layout
+  LNWmargin = margin;
+  this->setViewportMargins( margin, 0, 0, 0);
 }
 
 void PlainTextEditor::LNW_highlightLine(){
   if(this->isReadOnly()){ return; }
+  QList<QTextEdit::ExtraSelection> sels = this->extraSelections();
+  if(!sels.isEmpty() && sels.first().cursor.block() == this->textCursor().block()){ return; } //still on the same line
   QColor highC = QColor(0,0,0,50); //just darken the line a bit
   QTextEdit::ExtraSelection sel;
   sel.format.setBackground(highC);
@@ -239,10 +274,12 @@ void PlainTextEditor::LNW_highlightLine(){
 }
 
 void PlainTextEditor::LNW_update(const QRect &rect, int dy){
+  if(!showLNW){ return; }
   if(dy!=0){ LNW->scroll(0,dy); } //make sure to scroll the line widget the same amount as the editor
   else{
-    //Some other reason we need to repaint the widget
-    LNW->update(0,rect.y(), LNW->width(), rect.height()); //also repaint the LNW in the same area
+    //Some other reason we need to repaint the widget - only repaint the visible part of the same area
+    QRect area = QRect(0, rect.y(), LNW->width(), rect.height()).intersected(LNW->rect());
+    if(!area.isEmpty()){ LNW->update(area); }
   }
   if(rect.contains(this->viewport()->rect())){
     //Something in the currently-viewed area needs updating - make sure the LNW width is still correct
@@ -293,6 +330,10 @@ void PlainTextEditor::cursorMoved(){
 
 //Function for prompting the user if the file changed externally
 void PlainTextEditor::fileChanged(){
+  //Events are delivered after a short delay: ignore the ones for our own save (file not touched since then)
+  //  Note: the contents cannot be compared - writeFile()/readFile() do not round-trip a trailing empty line
+  QFileInfo info(currentFile());
+  if(info.exists() && info.lastModified()==lastSaveTime && info.size()==lastSaveSize){ return; }
   qDebug() << "File Changed:" << currentFile();
   bool update = !hasChanges; //Go ahead and reload the file automatically - no custom changes in the editor
   QString text = tr("The following file has been changed by some other utility. Do you want to re-load it?");
@@ -11,7 +11,9 @@
 #include <QWidget>
 #include <QResizeEvent>
 #include <QPaintEvent>
-#include <QFileSystemWatcher>
+#include <QDateTime>
+
+#include <LuminaFileWatcher.h>
 
 #include "syntaxSupport.h"
 
@@ -41,9 +43,13 @@ public:
 private:
 	QWidget *LNW; //Line Number Widget
 	bool showLNW;
+	int LNWmargin; //current left viewport margin (avoids re-layouts when unchanged)
 	QSettings *settings;
 	QString lastSaveContents;
-	QFileSystemWatcher *watcher;
+	QDateTime lastSaveTime; //file modification time right after the last load/save
+	qint64 lastSaveSize; //file size right after the last load/save
+	LFileWatcher *watcher;
+	void saveFileStamp();
 	//Syntax Highlighting class
 	Custom_Syntax *SYNTAX;
 
@@ -51,6 +57,7 @@ private:
 	int matchleft, matchright; //positions within the document
 	void clearMatchData();
 	void highlightMatch(QChar ch, bool forward, int fromPos, QChar startch);
+	int findMatch(QChar ch, bool forward, int fromPos, QChar startch); //uses the per-block bracket index
 
 	//Flags to keep track of changes
 	bool hasChanges;
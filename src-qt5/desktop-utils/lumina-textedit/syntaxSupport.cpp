@@ -6,6 +6,53 @@
 //===========================================
 #include "syntaxSupport.h"
 
+//==========================
+//   BracketData
+//==========================
+void BracketData::scan(const QString &text){
+  brackets.clear();
+  int run[3], back[3];
+  for(int t=0; t<3; t++){ net[t] = minPrefix[t] = minSuffix[t] = run[t] = back[t] = 0; }
+  //Forward pass: positions and lowest running count (for forward searches)
+  for(int i=0; i<text.length(); i++){
+    int type = typeFor(text[i]);
+    if(type<0){ continue; }
+    Bracket br; br.pos = i; br.ch = text[i];
+    brackets << br;
+    bool open = (text[i]==QChar('(') || text[i]==QChar('{') || text[i]==QChar('[') );
+    run[type] += (open ? 1 : -1);
+    if(run[type] < minPrefix[type]){ minPrefix[type] = run[type]; }
+  }
+  //Backward pass over the brackets only (for backward searches)
+  for(int i=brackets.length()-1; i>=0; i--){
+    QChar ch = brackets[i].ch;
+    int type = typeFor(ch);
+    bool open = (ch==QChar('(') || ch==QChar('{') || ch==QChar('[') );
+    back[type] += (open ? -1 : 1);
+    if(back[type] < minSuffix[type]){ minSuffix[type] = back[type]; }
+  }
+  for(int t=0; t<3; t++){ net[t] = run[t]; }
+}
+
+int BracketData::typeFor(QChar ch){
+  if(ch==QChar('(') || ch==QChar(')')){ return 0; }
+  else if(ch==QChar('{') || ch==QChar('}')){ return 1; }
+  else if(ch==QChar('[') || ch==QChar(']')){ return 2; }
+  return -1;
+}
+
+const BracketData* BracketData::forBlock(const QTextBlock &block, BracketData *tmp){
+  BracketData *data = static_cast<BracketData*>(block.userData());
+  if(data!=0){ return data; }
+  //Not highlighted yet - scan it on the fly
+  tmp->scan(block.text());
+  return tmp;
+}
+
+//==========================
+//   Custom_Syntax
+//==========================
+
 QStringList Custom_Syntax::availableRules(){
   QStringList avail;
     avail << "C++";
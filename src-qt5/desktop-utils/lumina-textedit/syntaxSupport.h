@@ -9,6 +9,9 @@
 
 #include <QSyntaxHighlighter>
 #include <QTextDocument>
+#include <QTextBlock>
+#include <QTextBlockUserData>
+#include <QVector>
 #include <QTextCharFormat>
 #include <QString>
 #include <QSettings>
@@ -25,6 +28,27 @@ struct SyntaxRuleSplit{
   QTextCharFormat format;
 };
 
+//Bracket structure of a single text block (kept up to date by the syntax highlighter)
+//  Types: 0 = "()", 1 = "{}", 2 = "[]"
+class BracketData : public QTextBlockUserData{
+public:
+	struct Bracket{
+	  int pos; //position within the block
+	  QChar ch;
+	};
+	QVector<Bracket> brackets; //all brackets in the block (in order)
+	int net[3]; //opening - closing brackets
+	int minPrefix[3]; //lowest running (opening - closing) count from the start of the block (<= 0)
+	int minSuffix[3]; //lowest running (closing - opening) count from the end of the block (<= 0)
+
+	BracketData(){ scan(QString()); }
+	~BracketData(){}
+
+	void scan(const QString &text);
+	static int typeFor(QChar ch); //-1 for non-bracket characters
+	static const BracketData* forBlock(const QTextBlock &block, BracketData *tmp); //uses "tmp" if the block was not indexed yet
+};
+
 class Custom_Syntax : public QSyntaxHighlighter{
 	Q_OBJECT
 private:
@@ -51,6 +75,10 @@ public:
 protected:
 	void highlightBlock(const QString &text){
           //qDebug() << "Highlight Block:" << text;
+	  //Update the bracket index for this block first (used for bracket matching)
+	  BracketData *brackets = static_cast<BracketData*>(currentBlockUserData());
+	  if(brackets==0){ brackets = new BracketData(); setCurrentBlockUserData(brackets); }
+	  brackets->scan(text);
 	  //Now look for any multi-line patterns (starting/continuing/ending)
 	  int start = 0;
 	  int splitactive = previousBlockState();